@@ -0,0 +1,1342 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <glib/gstdio.h>
+#include <json-glib/json-glib.h>
+#include <locale.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* cmdline defaults */
+#define GSTD_BENCH_DEFAULT_ADDRESS "127.0.0.1"
+#define GSTD_BENCH_DEFAULT_UNIX_BASE_NAME "gstd_unix_socket"
+#define GSTD_BENCH_DEFAULT_TCP_PORT 5000
+#define GSTD_BENCH_DEFAULT_UNIX_PORT 0
+#define GSTD_BENCH_DEFAULT_HTTP_PORT 5001
+#define GSTD_BENCH_DEFAULT_PROTOCOLS "tcp,unix"
+#define GSTD_BENCH_DEFAULT_CLIENTS 4
+#define GSTD_BENCH_DEFAULT_DURATION 10
+#define GSTD_BENCH_DEFAULT_WARMUP 2
+#define GSTD_BENCH_DEFAULT_SEED 1
+#define GSTD_BENCH_DEFAULT_MIX \
+  "create=1,play=1,set=4,get=4,bus_read=2,delete=1"
+#define GSTD_BENCH_DEFAULT_PIPELINE "fakesrc name=src ! fakesink name=sink"
+#define GSTD_BENCH_DEFAULT_PROPERTY "sink silent true"
+#define GSTD_BENCH_DEFAULT_GSTD "gstd"
+#define GSTD_BENCH_MAX_RESPONSE 10485760        /* 10*1024*1024 */
+#define GSTD_BENCH_START_TIMEOUT 50     /* 100ms attempts */
+
+typedef enum _GstdBenchProtocol GstdBenchProtocol;
+typedef enum _GstdBenchOp GstdBenchOp;
+typedef enum _GstdBenchPhase GstdBenchPhase;
+typedef struct _GstdBench GstdBench;
+typedef struct _GstdBenchClient GstdBenchClient;
+typedef struct _GstdBenchDaemonStats GstdBenchDaemonStats;
+
+enum _GstdBenchProtocol
+{
+  GSTD_BENCH_TCP,
+  GSTD_BENCH_UNIX,
+  GSTD_BENCH_HTTP,
+  GSTD_BENCH_N_PROTOCOLS
+};
+
+enum _GstdBenchOp
+{
+  GSTD_BENCH_CREATE,
+  GSTD_BENCH_PLAY,
+  GSTD_BENCH_SET,
+  GSTD_BENCH_GET,
+  GSTD_BENCH_BUS_READ,
+  GSTD_BENCH_DELETE,
+  GSTD_BENCH_N_OPS
+};
+
+enum _GstdBenchPhase
+{
+  GSTD_BENCH_WARMUP,
+  GSTD_BENCH_MEASURE,
+  GSTD_BENCH_STOP
+};
+
+static const gchar *protocol_names[GSTD_BENCH_N_PROTOCOLS] = {
+  "tcp", "unix", "http"
+};
+
+static const gchar *op_names[GSTD_BENCH_N_OPS] = {
+  "create", "play", "set", "get", "bus_read", "delete"
+};
+
+struct _GstdBench
+{
+  /* Options */
+  gint clients;
+  gint duration;
+  gint warmup;
+  guint32 seed;
+  gchar *address;
+  gint tcp_port;
+  gint http_port;
+  gchar *unix_path;
+  gint unix_port;
+  gchar *pipeline;
+  gchar *element;
+  gchar *property;
+  gchar *value;
+  guint weights[GSTD_BENCH_N_OPS];
+  guint total_weight;
+  gboolean json;
+  gboolean locks;
+
+  /* Daemon being measured, 0 if unknown */
+  GPid pid;
+
+  /* One of GstdBenchPhase, shared with the client threads */
+  gint phase;
+};
+
+struct _GstdBenchClient
+{
+  GstdBench *bench;
+  GstdBenchProtocol protocol;
+  gint id;
+  GThread *thread;
+  GRand *rand;
+
+  GSocketClient *socket_client;
+  GSocketConnection *con;
+  GDataInputStream *http_stream;
+
+  gboolean has_pipeline;
+  guint generation;
+  gchar *name;
+
+  /* Request latencies in nanoseconds, measured phase only */
+  GArray *latencies[GSTD_BENCH_N_OPS];
+  guint64 errors[GSTD_BENCH_N_OPS];
+  GError *error;
+};
+
+struct _GstdBenchDaemonStats
+{
+  guint64 cpu_ticks;
+  guint64 rss;
+  guint64 rss_peak;
+};
+
+static guint64
+gstd_bench_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return (guint64) ts.tv_sec * G_GUINT64_CONSTANT (1000000000) + ts.tv_nsec;
+}
+
+static gboolean
+gstd_bench_parse_mix (GstdBench * bench, const gchar * mix, GError ** error)
+{
+  gchar **entries;
+  gchar **entry;
+  gchar **pair;
+  gint op;
+  gboolean ret = TRUE;
+
+  memset (bench->weights, 0, sizeof (bench->weights));
+  bench->total_weight = 0;
+
+  entries = g_strsplit (mix, ",", -1);
+  for (entry = entries; *entry && ret; entry++) {
+    pair = g_strsplit (*entry, "=", 2);
+
+    for (op = 0; op < GSTD_BENCH_N_OPS; op++) {
+      if (!g_strcmp0 (op_names[op], g_strstrip (pair[0]))) {
+        break;
+      }
+    }
+
+    if (op == GSTD_BENCH_N_OPS || !pair[1]) {
+      g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+          "Invalid mix entry \"%s\", expected <command>=<weight> with "
+          "command one of create, play, set, get, bus_read, delete", *entry);
+      ret = FALSE;
+    } else {
+      bench->weights[op] = g_ascii_strtoull (pair[1], NULL, 10);
+      bench->total_weight += bench->weights[op];
+    }
+    g_strfreev (pair);
+  }
+  g_strfreev (entries);
+
+  if (ret && 0 == bench->total_weight) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "The command mix has no weight");
+    ret = FALSE;
+  }
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_parse_protocols (const gchar * protocols,
+    gboolean enabled[GSTD_BENCH_N_PROTOCOLS], GError ** error)
+{
+  gchar **names;
+  gchar **name;
+  gint protocol;
+  gboolean ret = TRUE;
+
+  memset (enabled, 0, sizeof (gboolean) * GSTD_BENCH_N_PROTOCOLS);
+
+  names = g_strsplit (protocols, ",", -1);
+  for (name = names; *name && ret; name++) {
+    for (protocol = 0; protocol < GSTD_BENCH_N_PROTOCOLS; protocol++) {
+      if (!g_strcmp0 (protocol_names[protocol], g_strstrip (*name))) {
+        enabled[protocol] = TRUE;
+        break;
+      }
+    }
+
+    if (protocol == GSTD_BENCH_N_PROTOCOLS) {
+      g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+          "Unknown protocol \"%s\", expected tcp, unix or http", *name);
+      ret = FALSE;
+    }
+  }
+  g_strfreev (names);
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_daemon_stats (GPid pid, GstdBenchDaemonStats * stats)
+{
+  gchar *path;
+  gchar *contents = NULL;
+  gchar **fields;
+  gchar **lines;
+  gchar **line;
+  const gchar *end;
+
+  memset (stats, 0, sizeof (GstdBenchDaemonStats));
+
+  if (0 == pid) {
+    return FALSE;
+  }
+
+  /* The command name may contain spaces, fields start after it */
+  path = g_strdup_printf ("/proc/%d/stat", pid);
+  g_file_get_contents (path, &contents, NULL, NULL);
+  g_free (path);
+  if (!contents || !(end = strrchr (contents, ')'))) {
+    g_free (contents);
+    return FALSE;
+  }
+
+  /* utime and stime are the 14th and 15th fields, 12th and 13th after
+   * the command name */
+  fields = g_strsplit (end + 2, " ", -1);
+  if (g_strv_length (fields) > 12) {
+    stats->cpu_ticks = g_ascii_strtoull (fields[11], NULL, 10) +
+        g_ascii_strtoull (fields[12], NULL, 10);
+  }
+  g_strfreev (fields);
+  g_free (contents);
+
+  path = g_strdup_printf ("/proc/%d/status", pid);
+  contents = NULL;
+  g_file_get_contents (path, &contents, NULL, NULL);
+  g_free (path);
+  if (!contents) {
+    return FALSE;
+  }
+
+  lines = g_strsplit (contents, "\n", -1);
+  for (line = lines; *line; line++) {
+    if (g_str_has_prefix (*line, "VmRSS:")) {
+      stats->rss = g_ascii_strtoull (*line + strlen ("VmRSS:"), NULL, 10);
+    } else if (g_str_has_prefix (*line, "VmHWM:")) {
+      stats->rss_peak = g_ascii_strtoull (*line + strlen ("VmHWM:"), NULL, 10);
+    }
+  }
+  g_strfreev (lines);
+  g_free (contents);
+
+  return TRUE;
+}
+
+static gboolean
+gstd_bench_connect (GstdBenchClient * client, GError ** error)
+{
+  GstdBench *bench = client->bench;
+  GSocketAddress *address;
+  gchar *path;
+
+  g_clear_object (&client->http_stream);
+  g_clear_object (&client->con);
+
+  if (GSTD_BENCH_UNIX == client->protocol) {
+    g_socket_client_set_family (client->socket_client, G_SOCKET_FAMILY_UNIX);
+    path = g_strdup_printf ("%s_%d", bench->unix_path, bench->unix_port);
+    address = g_unix_socket_address_new (path);
+    g_free (path);
+
+    client->con = g_socket_client_connect (client->socket_client,
+        G_SOCKET_CONNECTABLE (address), NULL, error);
+    g_object_unref (address);
+  } else {
+    client->con = g_socket_client_connect_to_host (client->socket_client,
+        bench->address, GSTD_BENCH_HTTP == client->protocol ?
+        bench->http_port : bench->tcp_port, NULL, error);
+  }
+
+  if (!client->con) {
+    return FALSE;
+  }
+
+  if (GSTD_BENCH_HTTP == client->protocol) {
+    client->http_stream =
+        g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM
+            (client->con)));
+    g_data_input_stream_set_newline_type (client->http_stream,
+        G_DATA_STREAM_NEWLINE_TYPE_CR_LF);
+  }
+
+  return TRUE;
+}
+
+static gchar *
+gstd_bench_send_socket (GstdBenchClient * client, const gchar * cmd,
+    GError ** error)
+{
+  GInputStream *istream;
+  GOutputStream *ostream;
+  GString *response;
+  gchar buffer[1024];
+  gssize read;
+
+  istream = g_io_stream_get_input_stream (G_IO_STREAM (client->con));
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (client->con));
+
+  if (!g_output_stream_write_all (ostream, cmd, strlen (cmd), NULL, NULL,
+          error)) {
+    return NULL;
+  }
+
+  response = g_string_new ("");
+  do {
+    read = g_input_stream_read (istream, buffer, sizeof (buffer), NULL, error);
+    if (read <= 0) {
+      if (0 == read) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED,
+            "The daemon closed the connection");
+      }
+      g_string_free (response, TRUE);
+      return NULL;
+    }
+
+    g_string_append_len (response, buffer, read);
+
+    if (response->len >= GSTD_BENCH_MAX_RESPONSE) {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+          "Response exceeded %d bytes limit", GSTD_BENCH_MAX_RESPONSE);
+      g_string_free (response, TRUE);
+      return NULL;
+    }
+  } while (buffer[read - 1] != '\0');
+
+  return g_string_free (response, FALSE);
+}
+
+static gchar *
+gstd_bench_send_http (GstdBenchClient * client, const gchar * method,
+    const gchar * resource, GError ** error)
+{
+  GOutputStream *ostream;
+  gchar *request;
+  gchar *line;
+  gchar *response;
+  gssize length = -1;
+  gboolean reconnect = FALSE;
+  gboolean headers = FALSE;
+  gboolean ret;
+  gsize read;
+
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (client->con));
+
+  request = g_strdup_printf ("%s %s HTTP/1.1\r\nHost: %s\r\n"
+      "Content-Length: 0\r\n\r\n", method, resource, client->bench->address);
+  ret = g_output_stream_write_all (ostream, request, strlen (request), NULL,
+      NULL, error);
+  g_free (request);
+  if (!ret) {
+    return NULL;
+  }
+
+  /* Status line and headers, up to the empty line */
+  while (!headers && (line = g_data_input_stream_read_line
+          (client->http_stream, NULL, NULL, error))) {
+    headers = '\0' == line[0];
+
+    if (!g_ascii_strncasecmp (line, "Content-Length:",
+            strlen ("Content-Length:"))) {
+      length = g_ascii_strtoll (line + strlen ("Content-Length:"), NULL, 10);
+    } else if (!g_ascii_strncasecmp (line, "Connection:",
+            strlen ("Connection:"))) {
+      reconnect = NULL != strstr (line, "close");
+    }
+    g_free (line);
+  }
+
+  if (!headers) {
+    if (error && !*error) {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED,
+          "The daemon closed the connection");
+    }
+    return NULL;
+  }
+
+  if (length < 0 || length >= GSTD_BENCH_MAX_RESPONSE) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Missing or invalid Content-Length in the response");
+    return NULL;
+  }
+
+  response = g_malloc (length + 1);
+  if (!g_input_stream_read_all (G_INPUT_STREAM (client->http_stream),
+          response, length, &read, NULL, error) || read != (gsize) length) {
+    g_free (response);
+    return NULL;
+  }
+  response[length] = '\0';
+
+  /* Reconnect lazily before the next request */
+  if (reconnect) {
+    g_clear_object (&client->http_stream);
+    g_clear_object (&client->con);
+  }
+
+  return response;
+}
+
+static gint
+gstd_bench_response_code (const gchar * response)
+{
+  const gchar *code;
+
+  code = strstr (response, "\"code\" : ");
+  if (!code) {
+    return -1;
+  }
+
+  return atoi (code + strlen ("\"code\" : "));
+}
+
+static gchar *
+gstd_bench_request (GstdBenchClient * client, GstdBenchOp op, GError ** error)
+{
+  GstdBench *bench = client->bench;
+  const gchar *method = NULL;
+  gchar *cmd = NULL;
+  gchar *escaped;
+  gchar *response;
+
+  if (GSTD_BENCH_HTTP != client->protocol) {
+    switch (op) {
+      case GSTD_BENCH_CREATE:
+        cmd = g_strdup_printf ("pipeline_create %s %s", client->name,
+            bench->pipeline);
+        break;
+      case GSTD_BENCH_PLAY:
+        cmd = g_strdup_printf ("pipeline_play %s", client->name);
+        break;
+      case GSTD_BENCH_SET:
+        cmd = g_strdup_printf ("element_set %s %s %s %s", client->name,
+            bench->element, bench->property, bench->value);
+        break;
+      case GSTD_BENCH_GET:
+        cmd = g_strdup_printf ("element_get %s %s %s", client->name,
+            bench->element, bench->property);
+        break;
+      case GSTD_BENCH_BUS_READ:
+        cmd = g_strdup_printf ("bus_read %s", client->name);
+        break;
+      case GSTD_BENCH_DELETE:
+        cmd = g_strdup_printf ("pipeline_delete %s", client->name);
+        break;
+      default:
+        g_return_val_if_reached (NULL);
+    }
+
+    response = gstd_bench_send_socket (client, cmd, error);
+    g_free (cmd);
+
+    return response;
+  }
+
+  switch (op) {
+    case GSTD_BENCH_CREATE:
+      method = "POST";
+      escaped = g_uri_escape_string (bench->pipeline, NULL, FALSE);
+      cmd = g_strdup_printf ("/pipelines?name=%s&description=%s",
+          client->name, escaped);
+      g_free (escaped);
+      break;
+    case GSTD_BENCH_PLAY:
+      method = "PUT";
+      cmd = g_strdup_printf ("/pipelines/%s/state?name=playing",
+          client->name);
+      break;
+    case GSTD_BENCH_SET:
+      method = "PUT";
+      escaped = g_uri_escape_string (bench->value, NULL, FALSE);
+      cmd = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s?name=%s",
+          client->name, bench->element, bench->property, escaped);
+      g_free (escaped);
+      break;
+    case GSTD_BENCH_GET:
+      method = "GET";
+      cmd = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s",
+          client->name, bench->element, bench->property);
+      break;
+    case GSTD_BENCH_BUS_READ:
+      method = "GET";
+      cmd = g_strdup_printf ("/pipelines/%s/bus/message", client->name);
+      break;
+    case GSTD_BENCH_DELETE:
+      method = "DELETE";
+      cmd = g_strdup_printf ("/pipelines?name=%s", client->name);
+      break;
+    default:
+      g_return_val_if_reached (NULL);
+  }
+
+  response = gstd_bench_send_http (client, method, cmd, error);
+  g_free (cmd);
+
+  return response;
+}
+
+/* Sends a single request outside of the measured clients, through its
+ * own connection so it does not disturb their command sequences */
+static gchar *
+gstd_bench_control (GstdBench * bench, GstdBenchProtocol protocol,
+    const gchar * cmd, const gchar * method, const gchar * resource,
+    GError ** error)
+{
+  GstdBenchClient client;
+  gchar *response = NULL;
+
+  memset (&client, 0, sizeof (client));
+  client.bench = bench;
+  client.protocol = protocol;
+  client.socket_client = g_socket_client_new ();
+
+  if (gstd_bench_connect (&client, error)) {
+    if (GSTD_BENCH_HTTP == protocol) {
+      response = gstd_bench_send_http (&client, method, resource, error);
+    } else {
+      response = gstd_bench_send_socket (&client, cmd, error);
+    }
+  }
+
+  g_clear_object (&client.http_stream);
+  g_clear_object (&client.con);
+  g_object_unref (client.socket_client);
+
+  if (response && gstd_bench_response_code (response)) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+        "The daemon refused \"%s\", does it support lock statistics?", cmd);
+    g_free (response);
+    response = NULL;
+  }
+
+  return response;
+}
+
+static gboolean
+gstd_bench_locks_enable (GstdBench * bench, GstdBenchProtocol protocol,
+    gboolean enable)
+{
+  GError *error = NULL;
+  gchar *response;
+
+  response = gstd_bench_control (bench, protocol,
+      enable ? "debug_locks true" : "debug_locks false", "PUT",
+      enable ? "/debug/locks/enabled?name=true" :
+      "/debug/locks/enabled?name=false", &error);
+  if (!response) {
+    g_printerr ("%s locks: %s\n", protocol_names[protocol], error->message);
+    g_error_free (error);
+    return FALSE;
+  }
+  g_free (response);
+
+  return TRUE;
+}
+
+/* Returns the statistics node of the daemon response, NULL on error */
+static JsonNode *
+gstd_bench_locks_read (GstdBench * bench, GstdBenchProtocol protocol)
+{
+  GError *error = NULL;
+  JsonParser *parser;
+  JsonNode *root;
+  JsonNode *locks = NULL;
+  gchar *response;
+
+  response = gstd_bench_control (bench, protocol, "read /debug/locks", "GET",
+      "/debug/locks", &error);
+  if (!response) {
+    g_printerr ("%s locks: %s\n", protocol_names[protocol], error->message);
+    g_error_free (error);
+    return NULL;
+  }
+
+  parser = json_parser_new ();
+  if (json_parser_load_from_data (parser, response, -1, &error)) {
+    root = json_parser_get_root (parser);
+    if (JSON_NODE_HOLDS_OBJECT (root)
+        && json_object_has_member (json_node_get_object (root), "response")) {
+      locks = json_node_copy (json_object_get_member (json_node_get_object
+              (root), "response"));
+    }
+  } else {
+    g_printerr ("%s locks: %s\n", protocol_names[protocol], error->message);
+    g_error_free (error);
+  }
+  g_object_unref (parser);
+  g_free (response);
+
+  return locks;
+}
+
+static void
+gstd_bench_report_locks (GstdBench * bench, JsonNode * locks)
+{
+  JsonArray *sites;
+  JsonObject *site;
+  gchar *json;
+  guint i;
+
+  if (bench->json) {
+    json = json_to_string (locks, FALSE);
+    g_print ("    \"locks\" : %s,\n", json);
+    g_free (json);
+    return;
+  }
+
+  if (!JSON_NODE_HOLDS_OBJECT (locks)
+      || !json_object_has_member (json_node_get_object (locks), "sites")) {
+    return;
+  }
+
+  g_print ("  %-20s %12s %10s %12s %12s %12s\n", "lock site", "acquired",
+      "contended", "wait (us)", "wait max", "hold max");
+
+  /* Sites never reached during the run are left out */
+  sites = json_object_get_array_member (json_node_get_object (locks),
+      "sites");
+  for (i = 0; i < json_array_get_length (sites); i++) {
+    site = json_array_get_object_element (sites, i);
+    if (0 == json_object_get_int_member (site, "acquisitions")) {
+      continue;
+    }
+
+    g_print ("  %-20s %12" G_GINT64_FORMAT " %10" G_GINT64_FORMAT
+        " %12.1f %12.1f %12.1f\n",
+        json_object_get_string_member (site, "name"),
+        json_object_get_int_member (site, "acquisitions"),
+        json_object_get_int_member (site, "contended"),
+        json_object_get_int_member (site, "wait-ns") / 1000.0,
+        json_object_get_int_member (site, "wait-max-ns") / 1000.0,
+        json_object_get_int_member (site, "hold-max-ns") / 1000.0);
+  }
+}
+
+/* Sends a request through a fresh connection if the previous one was
+ * dropped, returns the gstd return code or -1 on a transport error */
+static gint
+gstd_bench_execute (GstdBenchClient * client, GstdBenchOp op)
+{
+  gchar *response;
+  gint code;
+
+  if (!client->con && !gstd_bench_connect (client, &client->error)) {
+    return -1;
+  }
+
+  response = gstd_bench_request (client, op, &client->error);
+  if (!response) {
+    return -1;
+  }
+
+  code = gstd_bench_response_code (response);
+  g_free (response);
+
+  return code;
+}
+
+/* Bus reads must not block the client, so the pipeline bus is polled */
+static gint
+gstd_bench_setup_pipeline (GstdBenchClient * client)
+{
+  gchar *response;
+  gchar *cmd;
+  gint code;
+
+  if (!client->con && !gstd_bench_connect (client, &client->error)) {
+    return -1;
+  }
+
+  if (GSTD_BENCH_HTTP == client->protocol) {
+    cmd = g_strdup_printf ("/pipelines/%s/bus/timeout?name=0", client->name);
+    response = gstd_bench_send_http (client, "PUT", cmd, &client->error);
+  } else {
+    cmd = g_strdup_printf ("bus_timeout %s 0", client->name);
+    response = gstd_bench_send_socket (client, cmd, &client->error);
+  }
+  g_free (cmd);
+
+  if (!response) {
+    return -1;
+  }
+
+  code = gstd_bench_response_code (response);
+  g_free (response);
+
+  return code;
+}
+
+static GstdBenchOp
+gstd_bench_next_op (GstdBenchClient * client)
+{
+  GstdBench *bench = client->bench;
+  guint pick;
+  gint op;
+
+  pick = g_rand_int_range (client->rand, 0, bench->total_weight);
+  for (op = 0; op < GSTD_BENCH_N_OPS - 1; op++) {
+    if (pick < bench->weights[op]) {
+      break;
+    }
+    pick -= bench->weights[op];
+  }
+
+  /* Each client owns at most one pipeline at a time: commands on a
+   * missing pipeline create it, and creating over an existing one
+   * deletes it instead */
+  if (!client->has_pipeline) {
+    op = GSTD_BENCH_CREATE;
+  } else if (GSTD_BENCH_CREATE == op) {
+    op = GSTD_BENCH_DELETE;
+  }
+
+  return op;
+}
+
+static gpointer
+gstd_bench_client_run (gpointer user_data)
+{
+  GstdBenchClient *client = user_data;
+  GstdBench *bench = client->bench;
+  GstdBenchOp op;
+  GstdBenchPhase phase;
+  guint64 start;
+  guint64 latency;
+  gint code;
+
+  while (GSTD_BENCH_STOP != (phase = g_atomic_int_get (&bench->phase))) {
+    op = gstd_bench_next_op (client);
+
+    if (GSTD_BENCH_CREATE == op) {
+      g_free (client->name);
+      client->name = g_strdup_printf ("bench_%d_%u", client->id,
+          client->generation++);
+    }
+
+    start = gstd_bench_now ();
+    code = gstd_bench_execute (client, op);
+    latency = gstd_bench_now () - start;
+
+    if (code < 0) {
+      client->errors[op]++;
+      break;
+    }
+
+    if (GSTD_BENCH_MEASURE == phase) {
+      g_array_append_val (client->latencies[op], latency);
+      if (code) {
+        client->errors[op]++;
+      }
+    }
+
+    if (GSTD_BENCH_CREATE == op && !code) {
+      client->has_pipeline = TRUE;
+      if (gstd_bench_setup_pipeline (client) < 0) {
+        break;
+      }
+    } else if (GSTD_BENCH_DELETE == op) {
+      client->has_pipeline = FALSE;
+    }
+  }
+
+  /* Leave the daemon as we found it */
+  if (client->has_pipeline && !client->error) {
+    gstd_bench_execute (client, GSTD_BENCH_DELETE);
+  }
+
+  return NULL;
+}
+
+static gint
+gstd_bench_compare (gconstpointer a, gconstpointer b)
+{
+  guint64 x = *(const guint64 *) a;
+  guint64 y = *(const guint64 *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* Nearest rank percentile over a sorted array, in microseconds */
+static gdouble
+gstd_bench_percentile (GArray * sorted, gdouble percentile)
+{
+  guint rank;
+
+  if (0 == sorted->len) {
+    return 0;
+  }
+
+  rank = (guint) (percentile * sorted->len + 0.999999);
+  rank = CLAMP (rank, 1, sorted->len);
+
+  return g_array_index (sorted, guint64, rank - 1) / 1000.0;
+}
+
+static void
+gstd_bench_report_row (GstdBench * bench, const gchar * name,
+    GArray * sorted, guint64 errors, gboolean last)
+{
+  gdouble p50 = gstd_bench_percentile (sorted, 0.50);
+  gdouble p99 = gstd_bench_percentile (sorted, 0.99);
+  gdouble p999 = gstd_bench_percentile (sorted, 0.999);
+
+  if (bench->json) {
+    g_print ("      \"%s\" : { \"count\" : %u, \"errors\" : %" G_GUINT64_FORMAT
+        ", \"p50_us\" : %.1f, \"p99_us\" : %.1f, \"p999_us\" : %.1f }%s\n",
+        name, sorted->len, errors, p50, p99, p999, last ? "" : ",");
+  } else {
+    g_print ("  %-10s %10u %8" G_GUINT64_FORMAT " %10.1f %10.1f %10.1f\n",
+        name, sorted->len, errors, p50, p99, p999);
+  }
+}
+
+static gboolean
+gstd_bench_run_protocol (GstdBench * bench, GstdBenchProtocol protocol,
+    gboolean first)
+{
+  GstdBenchClient *clients;
+  GstdBenchClient *client;
+  GstdBenchDaemonStats before;
+  GstdBenchDaemonStats after;
+  GArray *sorted[GSTD_BENCH_N_OPS];
+  GArray *all;
+  guint64 errors[GSTD_BENCH_N_OPS] = { 0 };
+  guint64 total_errors = 0;
+  guint64 start;
+  gdouble elapsed;
+  gdouble cpu = 0;
+  gboolean have_stats;
+  JsonNode *locks = NULL;
+  gboolean ret = TRUE;
+  gint i;
+  gint op;
+
+  g_atomic_int_set (&bench->phase, GSTD_BENCH_WARMUP);
+
+  clients = g_new0 (GstdBenchClient, bench->clients);
+  for (i = 0; i < bench->clients; i++) {
+    client = &clients[i];
+    client->bench = bench;
+    client->protocol = protocol;
+    client->id = i;
+    /* Same sequence of commands for every run with the same seed */
+    client->rand = g_rand_new_with_seed (bench->seed + i);
+    client->socket_client = g_socket_client_new ();
+    for (op = 0; op < GSTD_BENCH_N_OPS; op++) {
+      client->latencies[op] = g_array_new (FALSE, FALSE, sizeof (guint64));
+    }
+    client->thread = g_thread_new ("gstd-bench", gstd_bench_client_run,
+        client);
+  }
+
+  g_usleep ((gulong) bench->warmup * G_USEC_PER_SEC);
+
+  /* Enabling clears what the warmup accounted */
+  if (bench->locks && !gstd_bench_locks_enable (bench, protocol, TRUE)) {
+    ret = FALSE;
+  }
+
+  have_stats = gstd_bench_daemon_stats (bench->pid, &before);
+  start = gstd_bench_now ();
+  g_atomic_int_set (&bench->phase, GSTD_BENCH_MEASURE);
+
+  g_usleep ((gulong) bench->duration * G_USEC_PER_SEC);
+
+  g_atomic_int_set (&bench->phase, GSTD_BENCH_STOP);
+  elapsed = (gstd_bench_now () - start) / 1e9;
+  have_stats = have_stats && gstd_bench_daemon_stats (bench->pid, &after);
+
+  if (bench->locks && ret) {
+    locks = gstd_bench_locks_read (bench, protocol);
+    gstd_bench_locks_enable (bench, protocol, FALSE);
+  }
+
+  for (op = 0; op < GSTD_BENCH_N_OPS; op++) {
+    sorted[op] = g_array_new (FALSE, FALSE, sizeof (guint64));
+  }
+  all = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  for (i = 0; i < bench->clients; i++) {
+    client = &clients[i];
+    g_thread_join (client->thread);
+
+    if (client->error) {
+      g_printerr ("%s client %d: %s\n", protocol_names[protocol], i,
+          client->error->message);
+      g_error_free (client->error);
+      ret = FALSE;
+    }
+
+    for (op = 0; op < GSTD_BENCH_N_OPS; op++) {
+      g_array_append_vals (sorted[op], client->latencies[op]->data,
+          client->latencies[op]->len);
+      g_array_append_vals (all, client->latencies[op]->data,
+          client->latencies[op]->len);
+      errors[op] += client->errors[op];
+      total_errors += client->errors[op];
+      g_array_free (client->latencies[op], TRUE);
+    }
+
+    g_free (client->name);
+    g_clear_object (&client->http_stream);
+    g_clear_object (&client->con);
+    g_object_unref (client->socket_client);
+    g_rand_free (client->rand);
+  }
+  g_free (clients);
+
+  if (have_stats) {
+    cpu = 100.0 * (after.cpu_ticks - before.cpu_ticks) /
+        sysconf (_SC_CLK_TCK) / elapsed;
+  }
+
+  if (bench->json) {
+    g_print ("%s  {\n    \"protocol\" : \"%s\",\n    \"clients\" : %d,\n"
+        "    \"seconds\" : %.3f,\n    \"requests\" : %u,\n"
+        "    \"errors\" : %" G_GUINT64_FORMAT ",\n"
+        "    \"throughput\" : %.1f,\n", first ? "" : ",\n",
+        protocol_names[protocol], bench->clients, elapsed, all->len,
+        total_errors, all->len / elapsed);
+    if (have_stats) {
+      g_print ("    \"daemon_cpu_percent\" : %.1f,\n"
+          "    \"daemon_rss_kb\" : %" G_GUINT64_FORMAT ",\n"
+          "    \"daemon_rss_peak_kb\" : %" G_GUINT64_FORMAT ",\n", cpu,
+          after.rss, after.rss_peak);
+    }
+    if (locks) {
+      gstd_bench_report_locks (bench, locks);
+    }
+    g_print ("    \"latency\" : {\n");
+  } else {
+    g_print ("%s: %d clients, %.1f s, %u requests, %.1f req/s, %"
+        G_GUINT64_FORMAT " errors\n", protocol_names[protocol],
+        bench->clients, elapsed, all->len, all->len / elapsed, total_errors);
+    g_print ("  %-10s %10s %8s %10s %10s %10s\n", "command", "count",
+        "errors", "p50 (us)", "p99 (us)", "p999 (us)");
+  }
+
+  for (op = 0; op < GSTD_BENCH_N_OPS; op++) {
+    g_array_sort (sorted[op], gstd_bench_compare);
+    gstd_bench_report_row (bench, op_names[op], sorted[op], errors[op],
+        FALSE);
+    g_array_free (sorted[op], TRUE);
+  }
+  g_array_sort (all, gstd_bench_compare);
+  gstd_bench_report_row (bench, "all", all, total_errors, TRUE);
+  g_array_free (all, TRUE);
+
+  if (bench->json) {
+    g_print ("    }\n  }");
+  } else if (have_stats) {
+    g_print ("  daemon: %.1f %% cpu, %" G_GUINT64_FORMAT " kB rss (peak %"
+        G_GUINT64_FORMAT " kB)\n", cpu, after.rss, after.rss_peak);
+  }
+
+  if (locks) {
+    if (!bench->json) {
+      gstd_bench_report_locks (bench, locks);
+    }
+    json_node_free (locks);
+  }
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_wait_daemon (GstdBench * bench, gboolean
+    enabled[GSTD_BENCH_N_PROTOCOLS])
+{
+  GstdBenchClient client;
+  gint protocol;
+  gint attempt;
+  gint status;
+  gboolean ready = FALSE;
+
+  memset (&client, 0, sizeof (client));
+  client.bench = bench;
+
+  for (protocol = 0; protocol < GSTD_BENCH_N_PROTOCOLS; protocol++) {
+    if (!enabled[protocol]) {
+      continue;
+    }
+
+    client.protocol = protocol;
+    ready = FALSE;
+    for (attempt = 0; attempt < GSTD_BENCH_START_TIMEOUT && !ready; attempt++) {
+      /* The daemon exited, probably a bad option or a busy port */
+      if (waitpid (bench->pid, &status, WNOHANG) == bench->pid) {
+        bench->pid = 0;
+        return FALSE;
+      }
+
+      client.socket_client = g_socket_client_new ();
+      ready = gstd_bench_connect (&client, NULL);
+      g_clear_object (&client.http_stream);
+      g_clear_object (&client.con);
+      g_object_unref (client.socket_client);
+
+      if (!ready) {
+        g_usleep (100000);
+      }
+    }
+
+    if (!ready) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gstd_bench_spawn_daemon (GstdBench * bench, const gchar * gstd,
+    gboolean enabled[GSTD_BENCH_N_PROTOCOLS], GError ** error)
+{
+  GPtrArray *argv;
+  gboolean ret;
+
+  argv = g_ptr_array_new_with_free_func (g_free);
+  g_ptr_array_add (argv, g_strdup (gstd));
+  g_ptr_array_add (argv, g_strdup ("--quiet"));
+
+  if (enabled[GSTD_BENCH_TCP]) {
+    g_ptr_array_add (argv, g_strdup ("--enable-tcp-protocol"));
+    g_ptr_array_add (argv, g_strdup_printf ("--tcp-address=%s",
+            bench->address));
+    g_ptr_array_add (argv, g_strdup_printf ("--tcp-base-port=%d",
+            bench->tcp_port));
+  }
+
+  if (enabled[GSTD_BENCH_UNIX]) {
+    g_ptr_array_add (argv, g_strdup ("--enable-unix-protocol"));
+    g_ptr_array_add (argv, g_strdup_printf ("--unix-base-path=%s",
+            bench->unix_path));
+  }
+
+  if (enabled[GSTD_BENCH_HTTP]) {
+    g_ptr_array_add (argv, g_strdup ("--enable-http-protocol"));
+    g_ptr_array_add (argv, g_strdup_printf ("--http-address=%s",
+            bench->address));
+    g_ptr_array_add (argv, g_strdup_printf ("--http-port=%d",
+            bench->http_port));
+  }
+  g_ptr_array_add (argv, NULL);
+
+  ret = g_spawn_async (NULL, (gchar **) argv->pdata, NULL,
+      G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL,
+      &bench->pid, error);
+  g_ptr_array_unref (argv);
+
+  if (ret && !gstd_bench_wait_daemon (bench, enabled)) {
+    g_set_error (error, G_SPAWN_ERROR, G_SPAWN_ERROR_FAILED,
+        "%s did not start listening, is another daemon using the ports?",
+        gstd);
+    ret = FALSE;
+  }
+
+  return ret;
+}
+
+static void
+gstd_bench_stop_daemon (GstdBench * bench)
+{
+  gint status;
+
+  if (0 == bench->pid) {
+    return;
+  }
+
+  kill (bench->pid, SIGTERM);
+  waitpid (bench->pid, &status, 0);
+  g_spawn_close_pid (bench->pid);
+  bench->pid = 0;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstdBench bench;
+  GError *error = NULL;
+  GOptionContext *context;
+  gboolean enabled[GSTD_BENCH_N_PROTOCOLS];
+  gboolean first = TRUE;
+  gint ret = EXIT_SUCCESS;
+  gint protocol;
+  gchar **property = NULL;
+  gchar *tmpdir = NULL;
+  gchar *unix_socket = NULL;
+
+  /* Cmdline options */
+  gboolean spawn = FALSE;
+  gint pid = 0;
+  gchar *gstd = NULL;
+  gchar *protocols = NULL;
+  gchar *mix = NULL;
+  gchar *set = NULL;
+
+  GOptionEntry entries[] = {
+    {"spawn", 's', 0, G_OPTION_ARG_NONE, &spawn,
+          "Start a private daemon for the run instead of attaching to a "
+          "running one", NULL}
+    ,
+    {"gstd", 'g', 0, G_OPTION_ARG_FILENAME, &gstd,
+          "The daemon to spawn (defaults to " GSTD_BENCH_DEFAULT_GSTD
+          " in PATH)", "path"}
+    ,
+    {"pid", 0, 0, G_OPTION_ARG_INT, &pid,
+          "PID of the attached daemon, to report its CPU and RSS", "pid"}
+    ,
+    {"protocols", 'P', 0, G_OPTION_ARG_STRING, &protocols,
+          "Comma separated protocols to run, one after the other: tcp, unix "
+          "and/or http (defaults to " GSTD_BENCH_DEFAULT_PROTOCOLS ")",
+        "list"}
+    ,
+    {"clients", 'c', 0, G_OPTION_ARG_INT, &bench.clients,
+        "Number of concurrent clients (default 4)", "clients"}
+    ,
+    {"duration", 'd', 0, G_OPTION_ARG_INT, &bench.duration,
+          "Measured seconds per protocol (default 10)", "seconds"}
+    ,
+    {"warmup", 'w', 0, G_OPTION_ARG_INT, &bench.warmup,
+          "Unmeasured seconds before each protocol run (default 2)",
+        "seconds"}
+    ,
+    {"seed", 0, 0, G_OPTION_ARG_INT, &bench.seed,
+          "Seed for the command sequence, keep it fixed to compare runs "
+          "(default 1)", "seed"}
+    ,
+    {"mix", 'm', 0, G_OPTION_ARG_STRING, &mix,
+          "Relative command weights (defaults to " GSTD_BENCH_DEFAULT_MIX
+          ")", "mix"}
+    ,
+    {"pipeline", 'l', 0, G_OPTION_ARG_STRING, &bench.pipeline,
+          "Pipeline description, for example "
+          "\"videotestsrc ! fakesink name=sink\" (defaults to \""
+          GSTD_BENCH_DEFAULT_PIPELINE "\")", "description"}
+    ,
+    {"set", 0, 0, G_OPTION_ARG_STRING, &set,
+          "Element, property and value used by the set and get commands "
+          "(defaults to \"" GSTD_BENCH_DEFAULT_PROPERTY "\")",
+        "\"element property value\""}
+    ,
+    {"tcp-address", 'a', 0, G_OPTION_ARG_STRING, &bench.address,
+          "The IP address of the daemon for tcp and http (defaults to "
+          GSTD_BENCH_DEFAULT_ADDRESS ")", "address"}
+    ,
+    {"tcp-port", 'p', 0, G_OPTION_ARG_INT, &bench.tcp_port,
+        "The tcp port of the daemon (default 5000)", "tcp-port"}
+    ,
+    {"http-port", 0, 0, G_OPTION_ARG_INT, &bench.http_port,
+        "The http port of the daemon (default 5001)", "http-port"}
+    ,
+    {"unix-base-path", 'b', 0, G_OPTION_ARG_STRING, &bench.unix_path,
+          "The daemon unix path (defaults to a private directory with "
+          "--spawn, " GSTD_BENCH_DEFAULT_UNIX_BASE_NAME " in the run state "
+          "directory otherwise)", "path"}
+    ,
+    {"unix-port", 'e', 0, G_OPTION_ARG_INT, &bench.unix_port,
+        "The daemon unix port (default 0)", "unix-port"}
+    ,
+    {"json", 'j', 0, G_OPTION_ARG_NONE, &bench.json,
+        "Print the results as JSON", NULL}
+    ,
+    {"locks", 0, 0, G_OPTION_ARG_NONE, &bench.locks,
+          "Account the daemon lock contention during the measured phase "
+          "and report it per lock site", NULL}
+    ,
+    {NULL}
+  };
+
+  /* Internationalization */
+  setlocale (LC_ALL, "");
+
+  memset (&bench, 0, sizeof (bench));
+  bench.clients = GSTD_BENCH_DEFAULT_CLIENTS;
+  bench.duration = GSTD_BENCH_DEFAULT_DURATION;
+  bench.warmup = GSTD_BENCH_DEFAULT_WARMUP;
+  bench.seed = GSTD_BENCH_DEFAULT_SEED;
+  bench.tcp_port = GSTD_BENCH_DEFAULT_TCP_PORT;
+  bench.http_port = GSTD_BENCH_DEFAULT_HTTP_PORT;
+  bench.unix_port = GSTD_BENCH_DEFAULT_UNIX_PORT;
+
+  context = g_option_context_new ("- gstd load generator");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_option_context_free (context);
+    goto error;
+  }
+  g_option_context_free (context);
+
+  if (bench.clients < 1 || bench.duration < 1 || bench.warmup < 0) {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "clients and duration must be positive");
+    goto error;
+  }
+
+  if (!gstd_bench_parse_protocols (protocols ? protocols :
+          GSTD_BENCH_DEFAULT_PROTOCOLS, enabled, &error)) {
+    goto error;
+  }
+
+  if (!gstd_bench_parse_mix (&bench, mix ? mix : GSTD_BENCH_DEFAULT_MIX,
+          &error)) {
+    goto error;
+  }
+
+  property = g_strsplit (set ? set : GSTD_BENCH_DEFAULT_PROPERTY, " ", 3);
+  if (g_strv_length (property) != 3) {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "--set expects \"element property value\"");
+    goto error;
+  }
+  bench.element = property[0];
+  bench.property = property[1];
+  bench.value = property[2];
+
+  if (!bench.pipeline) {
+    bench.pipeline = g_strdup (GSTD_BENCH_DEFAULT_PIPELINE);
+  }
+
+  if (!bench.address) {
+    bench.address = g_strdup (GSTD_BENCH_DEFAULT_ADDRESS);
+  }
+
+  if (!bench.unix_path) {
+    if (spawn) {
+      tmpdir = g_dir_make_tmp ("gstd-bench-XXXXXX", &error);
+      if (!tmpdir) {
+        goto error;
+      }
+      bench.unix_path = g_build_filename (tmpdir,
+          GSTD_BENCH_DEFAULT_UNIX_BASE_NAME, NULL);
+    } else {
+      bench.unix_path = g_strdup_printf ("%s/%s", GSTD_RUN_STATE_DIR,
+          GSTD_BENCH_DEFAULT_UNIX_BASE_NAME);
+    }
+  }
+
+  if (spawn) {
+    if (!gstd_bench_spawn_daemon (&bench, gstd ? gstd :
+            GSTD_BENCH_DEFAULT_GSTD, enabled, &error)) {
+      goto error;
+    }
+  } else {
+    bench.pid = pid;
+  }
+
+  if (bench.json) {
+    g_print ("{\n\"seed\" : %u,\n\"mix\" : \"%s\",\n\"runs\" : [\n",
+        bench.seed, mix ? mix : GSTD_BENCH_DEFAULT_MIX);
+  }
+
+  for (protocol = 0; protocol < GSTD_BENCH_N_PROTOCOLS; protocol++) {
+    if (enabled[protocol]) {
+      if (!gstd_bench_run_protocol (&bench, protocol, first)) {
+        ret = EXIT_FAILURE;
+      }
+      first = FALSE;
+    }
+  }
+
+  if (bench.json) {
+    g_print ("\n]\n}\n");
+  }
+
+  goto out;
+
+error:
+  g_printerr ("%s\n", error->message);
+  g_error_free (error);
+  ret = EXIT_FAILURE;
+
+out:
+  gstd_bench_stop_daemon (&bench);
+
+  if (tmpdir) {
+    unix_socket = g_strdup_printf ("%s_%d", bench.unix_path, bench.unix_port);
+    g_unlink (unix_socket);
+    g_free (unix_socket);
+    g_rmdir (tmpdir);
+    g_free (tmpdir);
+  }
+
+  g_strfreev (property);
+  g_free (bench.unix_path);
+  g_free (bench.address);
+  g_free (bench.pipeline);
+  g_free (protocols);
+  g_free (mix);
+  g_free (set);
+  g_free (gstd);
+
+  return ret;
+}
@@ -0,0 +1,247 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <gst/gst.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "gstd_benchmark.h"
+
+#define GSTD_BENCHMARK_DEFAULT_MIN_TIME 200     /* ms */
+
+static gint min_time = GSTD_BENCHMARK_DEFAULT_MIN_TIME;
+static gchar *filter = NULL;
+static gboolean header = FALSE;
+
+#ifdef __GLIBC__
+/* Every malloc in the process, GLib and GStreamer included, resolves to
+ * these wrappers. The libc entry points do the actual work. */
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void *__libc_memalign (size_t alignment, size_t size);
+
+static guint64 allocations = 0;
+
+void *
+malloc (size_t size)
+{
+  __atomic_add_fetch (&allocations, 1, __ATOMIC_RELAXED);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  __atomic_add_fetch (&allocations, 1, __ATOMIC_RELAXED);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  __atomic_add_fetch (&allocations, 1, __ATOMIC_RELAXED);
+  return __libc_realloc (ptr, size);
+}
+
+int
+posix_memalign (void **memptr, size_t alignment, size_t size)
+{
+  void *ptr;
+
+  __atomic_add_fetch (&allocations, 1, __ATOMIC_RELAXED);
+  ptr = __libc_memalign (alignment, size);
+  if (!ptr) {
+    return ENOMEM;
+  }
+  *memptr = ptr;
+
+  return 0;
+}
+
+gint64
+gstd_benchmark_allocations (void)
+{
+  return __atomic_load_n (&allocations, __ATOMIC_RELAXED);
+}
+#else
+gint64
+gstd_benchmark_allocations (void)
+{
+  return -1;
+}
+#endif
+
+guint64
+gstd_benchmark_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return (guint64) ts.tv_sec * G_GUINT64_CONSTANT (1000000000) + ts.tv_nsec;
+}
+
+gint64
+gstd_benchmark_rss (void)
+{
+  gchar *contents = NULL;
+  gchar **fields;
+  gint64 rss = -1;
+
+  if (!g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL)) {
+    return -1;
+  }
+
+  /* Total program size followed by the resident pages */
+  fields = g_strsplit (contents, " ", 3);
+  if (g_strv_length (fields) > 1) {
+    rss = g_ascii_strtoll (fields[1], NULL, 10) * sysconf (_SC_PAGESIZE);
+  }
+  g_strfreev (fields);
+  g_free (contents);
+
+  return rss;
+}
+
+gint64
+gstd_benchmark_heap (void)
+{
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ (2, 33)
+  return mallinfo2 ().uordblks;
+#endif
+#endif
+  return -1;
+}
+
+gboolean
+gstd_benchmark_filter (const gchar * name)
+{
+  g_return_val_if_fail (name, FALSE);
+
+  return !filter || strstr (name, filter);
+}
+
+gboolean
+gstd_benchmark_init (gint * argc, gchar ** argv[],
+    const GOptionEntry * entries)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  gboolean ret;
+
+  GOptionEntry common[] = {
+    {"min-time", 't', 0, G_OPTION_ARG_INT, &min_time,
+          "Minimum measured time per benchmark in milliseconds (default 200)",
+        "ms"}
+    ,
+    {"filter", 'f', 0, G_OPTION_ARG_STRING, &filter,
+        "Only run the benchmarks whose name contains this string", "filter"}
+    ,
+    {NULL}
+  };
+
+  /* Slices would otherwise hide most allocations in magazines */
+  g_setenv ("G_SLICE", "always-malloc", TRUE);
+
+  context = g_option_context_new ("- gstd benchmarks");
+  g_option_context_add_main_entries (context, common, NULL);
+  if (entries) {
+    g_option_context_add_main_entries (context, entries, NULL);
+  }
+  g_option_context_add_group (context, gst_init_get_option_group ());
+
+  ret = g_option_context_parse (context, argc, argv, &error);
+  g_option_context_free (context);
+
+  if (!ret) {
+    g_printerr ("%s\n", error->message);
+    g_error_free (error);
+    return FALSE;
+  }
+
+  if (min_time < 1) {
+    g_printerr ("The minimum time must be positive\n");
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+void
+gstd_benchmark_run (const gchar * name, GstdBenchmarkFunc func,
+    gpointer user_data)
+{
+  guint64 iterations = 1;
+  guint64 i;
+  guint64 start;
+  guint64 elapsed;
+  gint64 allocs;
+
+  g_return_if_fail (name);
+  g_return_if_fail (func);
+
+  if (!gstd_benchmark_filter (name)) {
+    return;
+  }
+
+  if (!header) {
+    g_print ("%-48s %12s %12s %12s\n", "benchmark", "iterations", "ns/op",
+        "allocs/op");
+    header = TRUE;
+  }
+
+  /* The short rounds double as warm up */
+  while (TRUE) {
+    allocs = gstd_benchmark_allocations ();
+    start = gstd_benchmark_now ();
+    for (i = 0; i < iterations; i++) {
+      func (user_data);
+    }
+    elapsed = gstd_benchmark_now () - start;
+
+    if (elapsed >= (guint64) min_time * G_GUINT64_CONSTANT (1000000)
+        || iterations >= G_MAXUINT32) {
+      break;
+    }
+    iterations *= 2;
+  }
+
+  if (allocs < 0) {
+    g_print ("%-48s %12" G_GUINT64_FORMAT " %12.1f %12s\n", name, iterations,
+        (gdouble) elapsed / iterations, "-");
+  } else {
+    allocs = gstd_benchmark_allocations () - allocs;
+    g_print ("%-48s %12" G_GUINT64_FORMAT " %12.1f %12.2f\n", name,
+        iterations, (gdouble) elapsed / iterations,
+        (gdouble) allocs / iterations);
+  }
+}
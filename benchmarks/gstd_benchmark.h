@@ -0,0 +1,106 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_BENCHMARK_H__
+#define __GSTD_BENCHMARK_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GstdBenchmarkFunc:
+ * @user_data: the data given to gstd_benchmark_run()
+ *
+ * A single operation under measurement.
+ */
+typedef void (*GstdBenchmarkFunc) (gpointer user_data);
+
+/**
+ * gstd_benchmark_init:
+ * @argc: the program argument count
+ * @argv: the program arguments
+ * @entries: (nullable): additional benchmark specific options
+ *
+ * Parses the common benchmark options (--min-time, --filter) and
+ * initializes GStreamer. Must be called before any allocation is
+ * measured.
+ *
+ * Returns: TRUE on success, FALSE if the options were invalid
+ */
+gboolean gstd_benchmark_init (gint * argc, gchar ** argv[],
+    const GOptionEntry * entries);
+
+/**
+ * gstd_benchmark_run:
+ * @name: the benchmark name, as reported
+ * @func: the operation to measure
+ * @user_data: data passed to @func
+ *
+ * Repeats @func until the minimum run time is reached, doubling the
+ * iteration count from one, and prints the time and heap allocations
+ * per operation of the last round.
+ */
+void gstd_benchmark_run (const gchar * name, GstdBenchmarkFunc func,
+    gpointer user_data);
+
+/**
+ * gstd_benchmark_now:
+ *
+ * Returns: the monotonic time in nanoseconds
+ */
+guint64 gstd_benchmark_now (void);
+
+/**
+ * gstd_benchmark_allocations:
+ *
+ * Returns: the number of heap allocations done by the process so far,
+ * or -1 if they can't be counted on this platform
+ */
+gint64 gstd_benchmark_allocations (void);
+
+/**
+ * gstd_benchmark_rss:
+ *
+ * Returns: the resident set size of the process in bytes, or -1 if
+ * unknown
+ */
+gint64 gstd_benchmark_rss (void);
+
+/**
+ * gstd_benchmark_heap:
+ *
+ * Returns: the bytes currently allocated from the heap, or -1 if the
+ * allocator can't tell. Unlike the RSS it drops as soon as memory is
+ * freed.
+ */
+gint64 gstd_benchmark_heap (void);
+
+/**
+ * gstd_benchmark_filter:
+ * @name: a benchmark name
+ *
+ * Returns: TRUE if @name was selected with --filter, or no filter was
+ * given
+ */
+gboolean gstd_benchmark_filter (const gchar * name);
+
+G_END_DECLS
+#endif /* __GSTD_BENCHMARK_H__ */
@@ -0,0 +1,300 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstd_action.h"
+#include "gstd_benchmark.h"
+#include "gstd_property.h"
+#include "gstd_session.h"
+#include "gstd_signal.h"
+
+#define GSTD_FOOTPRINT_DEFAULT_SIZES "10,50,100,250,500,1000"
+#define GSTD_FOOTPRINT_DEFAULT_REPEAT 3
+
+typedef struct _GstdFootprint GstdFootprint;
+typedef struct _GstdFootprintCounts GstdFootprintCounts;
+
+/* One measurement of building --repeat pipelines, either with
+ * gst_parse_launch alone or through gstd */
+struct _GstdFootprint
+{
+  guint64 time;
+  gint64 allocations;
+  gint64 heap;
+  gint64 rss;
+};
+
+struct _GstdFootprintCounts
+{
+  guint objects;
+  guint properties;
+  guint signals;
+  guint actions;
+};
+
+static gchar *sizes = NULL;
+static gint repeat = GSTD_FOOTPRINT_DEFAULT_REPEAT;
+
+/* Only tracked with GOBJECT_DEBUG=instance-count */
+static guint
+count_instances (GType type)
+{
+  GType *children;
+  guint n_children;
+  guint count;
+  guint i;
+
+  count = g_type_get_instance_count (type);
+
+  children = g_type_children (type, &n_children);
+  for (i = 0; i < n_children; i++) {
+    count += count_instances (children[i]);
+  }
+  g_free (children);
+
+  return count;
+}
+
+static void
+count_mirror (GstdFootprintCounts * counts)
+{
+  counts->objects = count_instances (GSTD_TYPE_OBJECT);
+  counts->properties = count_instances (GSTD_TYPE_PROPERTY);
+  counts->signals = count_instances (GSTD_TYPE_SIGNAL);
+  counts->actions = count_instances (GSTD_TYPE_ACTION);
+}
+
+/* Top level chains of four elements alternate with bins of three, so
+ * a quarter of the elements reach gstd through GstChildProxy */
+static gchar *
+make_description (gint size, gint * elements)
+{
+  GString *description;
+  gint groups;
+  gint i;
+
+  groups = MAX (size / 8, 1);
+  description = g_string_new (NULL);
+
+  for (i = 0; i < groups; i++) {
+    g_string_append_printf (description,
+        "fakesrc ! identity ! identity ! fakesink "
+        "bin.( name=bin%d fakesrc ! identity ! fakesink ) ", i);
+  }
+  *elements = groups * 8;
+
+  return g_string_free (description, FALSE);
+}
+
+static void
+footprint_begin (GstdFootprint * footprint)
+{
+  footprint->rss = gstd_benchmark_rss ();
+  footprint->heap = gstd_benchmark_heap ();
+  footprint->allocations = gstd_benchmark_allocations ();
+  footprint->time = gstd_benchmark_now ();
+}
+
+static void
+footprint_end (GstdFootprint * footprint)
+{
+  footprint->time = gstd_benchmark_now () - footprint->time;
+  footprint->allocations = gstd_benchmark_allocations () -
+      footprint->allocations;
+  footprint->heap = gstd_benchmark_heap () - footprint->heap;
+  footprint->rss = gstd_benchmark_rss () - footprint->rss;
+
+  footprint->time /= repeat;
+  footprint->allocations /= repeat;
+  footprint->heap /= repeat;
+  footprint->rss /= repeat;
+}
+
+static gboolean
+measure_gst (const gchar * description, GstdFootprint * footprint)
+{
+  GstElement **pipelines;
+  GError *error = NULL;
+  gboolean ret = TRUE;
+  gint i;
+
+  pipelines = g_new0 (GstElement *, repeat);
+
+  /* Every copy is kept alive, so the RSS grows with each of them */
+  footprint_begin (footprint);
+  for (i = 0; i < repeat && ret; i++) {
+    pipelines[i] = gst_parse_launch (description, &error);
+    if (error) {
+      g_printerr ("Unable to build the pipeline: %s\n", error->message);
+      g_clear_error (&error);
+      ret = FALSE;
+    }
+  }
+  footprint_end (footprint);
+
+  for (i = 0; i < repeat; i++) {
+    if (pipelines[i]) {
+      gst_object_unref (pipelines[i]);
+    }
+  }
+  g_free (pipelines);
+
+  return ret;
+}
+
+static gboolean
+measure_gstd (GstdObject * list, const gchar * description,
+    GstdFootprint * footprint, GstdFootprintCounts * counts)
+{
+  GstdFootprintCounts before;
+  GstdReturnCode ret = GSTD_EOK;
+  gchar *name;
+  gint i;
+
+  count_mirror (&before);
+
+  footprint_begin (footprint);
+  for (i = 0; i < repeat && GSTD_EOK == ret; i++) {
+    name = g_strdup_printf ("footprint%d", i);
+    ret = gstd_object_create (list, name, description);
+    g_free (name);
+  }
+  footprint_end (footprint);
+
+  count_mirror (counts);
+  counts->objects = (counts->objects - before.objects) / repeat;
+  counts->properties = (counts->properties - before.properties) / repeat;
+  counts->signals = (counts->signals - before.signals) / repeat;
+  counts->actions = (counts->actions - before.actions) / repeat;
+
+  for (i = 0; i < repeat; i++) {
+    name = g_strdup_printf ("footprint%d", i);
+    gstd_object_delete (list, name);
+    g_free (name);
+  }
+
+  if (GSTD_EOK != ret) {
+    g_printerr ("Unable to create the pipeline: %s\n",
+        gstd_return_code_to_string (ret));
+  }
+
+  return GSTD_EOK == ret;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstdSession *session;
+  GstdObject *list;
+  GstdFootprint gst;
+  GstdFootprint gstd;
+  GstdFootprintCounts counts;
+  gchar **size;
+  gchar **size_list;
+  gchar *description;
+  gchar *name;
+  gboolean counted;
+  gint elements;
+  gint ret = EXIT_SUCCESS;
+
+  GOptionEntry entries[] = {
+    {"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes,
+          "Comma separated pipeline sizes in elements (defaults to "
+          GSTD_FOOTPRINT_DEFAULT_SIZES ")", "sizes"}
+    ,
+    {"repeat", 'r', 0, G_OPTION_ARG_INT, &repeat,
+          "Pipelines built per size, results are averaged (default 3)",
+        "count"}
+    ,
+    {NULL}
+  };
+
+  if (!gstd_benchmark_init (&argc, &argv, entries)) {
+    return EXIT_FAILURE;
+  }
+
+  if (repeat < 1) {
+    g_printerr ("At least one pipeline per size is needed\n");
+    return EXIT_FAILURE;
+  }
+
+  counted = NULL != strstr (g_getenv ("GOBJECT_DEBUG") ?
+      g_getenv ("GOBJECT_DEBUG") : "", "instance-count");
+  if (!counted) {
+    g_printerr ("Run with GOBJECT_DEBUG=instance-count to count the gstd "
+        "objects\n");
+  }
+
+  session = gstd_session_new ("Footprint Session");
+  gstd_get_by_uri (session, "/pipelines", &list);
+
+  /* Per pipeline averages. The mirror columns are gstd minus plain
+   * GStreamer: the cost of the GstdObject tree alone */
+  g_print ("%-24s %8s %10s %10s %10s %8s %8s %8s %8s %10s %10s %10s\n",
+      "benchmark", "elements", "gst us", "gstd us", "mirror us", "objects",
+      "props", "signals", "actions", "allocs", "heap kB", "rss kB");
+
+  size_list = g_strsplit (sizes ? sizes : GSTD_FOOTPRINT_DEFAULT_SIZES, ",",
+      -1);
+  for (size = size_list; *size && EXIT_SUCCESS == ret; size++) {
+    name = g_strdup_printf ("footprint/%s", g_strstrip (*size));
+    if (!gstd_benchmark_filter (name)) {
+      g_free (name);
+      continue;
+    }
+
+    description = make_description (atoi (*size), &elements);
+
+    if (!measure_gst (description, &gst) ||
+        !measure_gstd (list, description, &gstd, &counts)) {
+      ret = EXIT_FAILURE;
+    } else if (counted) {
+      g_print ("%-24s %8d %10.1f %10.1f %10.1f %8u %8u %8u %8u %10"
+          G_GINT64_FORMAT " %10.1f %10.1f\n", name, elements,
+          gst.time / 1e3, gstd.time / 1e3, ((gdouble) gstd.time -
+              gst.time) / 1e3, counts.objects, counts.properties,
+          counts.signals, counts.actions, gstd.allocations - gst.allocations,
+          (gstd.heap - gst.heap) / 1024.0, (gstd.rss - gst.rss) / 1024.0);
+    } else {
+      g_print ("%-24s %8d %10.1f %10.1f %10.1f %8s %8s %8s %8s %10"
+          G_GINT64_FORMAT " %10.1f %10.1f\n", name, elements,
+          gst.time / 1e3, gstd.time / 1e3, ((gdouble) gstd.time -
+              gst.time) / 1e3, "-", "-", "-", "-",
+          gstd.allocations - gst.allocations,
+          (gstd.heap - gst.heap) / 1024.0, (gstd.rss - gst.rss) / 1024.0);
+    }
+
+    g_free (description);
+    g_free (name);
+  }
+  g_strfreev (size_list);
+
+  gst_object_unref (list);
+  gst_object_unref (session);
+  g_free (sizes);
+
+  return ret;
+}
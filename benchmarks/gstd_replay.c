@@ -0,0 +1,655 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstd_journal.h"
+
+/* cmdline defaults */
+#define GSTD_REPLAY_DEFAULT_ADDRESS "127.0.0.1"
+#define GSTD_REPLAY_DEFAULT_UNIX_BASE_NAME "gstd_unix_socket"
+#define GSTD_REPLAY_DEFAULT_TCP_PORT 5000
+#define GSTD_REPLAY_DEFAULT_UNIX_PORT 0
+#define GSTD_REPLAY_DEFAULT_PROTOCOL "tcp"
+#define GSTD_REPLAY_MAX_RESPONSE 10485760       /* 10*1024*1024 */
+
+typedef struct _GstdReplay GstdReplay;
+typedef struct _GstdReplayCommand GstdReplayCommand;
+typedef struct _GstdReplayConnection GstdReplayConnection;
+typedef struct _GstdReplayStats GstdReplayStats;
+
+struct _GstdReplay
+{
+  /* Options */
+  gboolean unix_socket;
+  gchar *address;
+  gint tcp_port;
+  gchar *unix_path;
+  gint unix_port;
+  gboolean fast;
+  gdouble speed;
+  gboolean json;
+
+  /* Monotonic time the replay started at */
+  gint64 start;
+};
+
+struct _GstdReplayCommand
+{
+  /* Microseconds since the journal was opened */
+  gint64 time;
+  gchar *command;
+};
+
+/* The commands of one recorded connection, replayed in order through
+ * a connection of its own so the original concurrency is kept */
+struct _GstdReplayConnection
+{
+  GstdReplay *replay;
+  guint id;
+  GArray *commands;
+  GThread *thread;
+
+  GSocketClient *socket_client;
+  GSocketConnection *con;
+
+  /* Results by normalized command */
+  GHashTable *stats;
+  /* Microseconds the connection fell behind the original pacing */
+  gint64 lag;
+  GError *error;
+};
+
+struct _GstdReplayStats
+{
+  /* Request latencies in nanoseconds */
+  GArray *latencies;
+  guint64 errors;
+};
+
+static GstdReplayStats *
+gstd_replay_stats_new (void)
+{
+  GstdReplayStats *stats = g_new0 (GstdReplayStats, 1);
+
+  stats->latencies = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  return stats;
+}
+
+static void
+gstd_replay_stats_free (gpointer data)
+{
+  GstdReplayStats *stats = data;
+
+  g_array_free (stats->latencies, TRUE);
+  g_free (stats);
+}
+
+static void
+gstd_replay_command_clear (gpointer data)
+{
+  GstdReplayCommand *command = data;
+
+  g_free (command->command);
+}
+
+static GstdReplayConnection *
+gstd_replay_connection_new (GstdReplay * replay, guint id)
+{
+  GstdReplayConnection *connection = g_new0 (GstdReplayConnection, 1);
+
+  connection->replay = replay;
+  connection->id = id;
+  connection->commands =
+      g_array_new (FALSE, FALSE, sizeof (GstdReplayCommand));
+  g_array_set_clear_func (connection->commands, gstd_replay_command_clear);
+  connection->socket_client = g_socket_client_new ();
+  connection->stats = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, gstd_replay_stats_free);
+
+  return connection;
+}
+
+static void
+gstd_replay_connection_free (gpointer data)
+{
+  GstdReplayConnection *connection = data;
+
+  g_array_free (connection->commands, TRUE);
+  g_clear_object (&connection->con);
+  g_object_unref (connection->socket_client);
+  g_hash_table_unref (connection->stats);
+  g_clear_error (&connection->error);
+  g_free (connection);
+}
+
+/* Groups the journal by connection. Commands that did not arrive
+ * through an IPC are grouped together, as connection 0 */
+static GList *
+gstd_replay_load (GstdReplay * replay, const gchar * filename,
+    guint * count, GError ** error)
+{
+  GstdJournalReader *reader;
+  GstdJournalRecord record;
+  GstdReplayConnection *connection;
+  GstdReplayCommand command;
+  GHashTable *connections;
+  GList *list;
+
+  reader = gstd_journal_reader_new (filename, error);
+  if (!reader) {
+    return NULL;
+  }
+
+  connections = g_hash_table_new (g_direct_hash, g_direct_equal);
+  *count = 0;
+
+  while (gstd_journal_reader_next (reader, &record, error)) {
+    connection = g_hash_table_lookup (connections,
+        GUINT_TO_POINTER (record.connection));
+    if (!connection) {
+      connection = gstd_replay_connection_new (replay, record.connection);
+      g_hash_table_insert (connections, GUINT_TO_POINTER (record.connection),
+          connection);
+    }
+
+    command.time = record.time;
+    command.command = record.command;
+    g_array_append_val (connection->commands, command);
+    (*count)++;
+  }
+  gstd_journal_reader_free (reader);
+
+  list = g_hash_table_get_values (connections);
+  g_hash_table_unref (connections);
+
+  if (error && *error) {
+    g_list_free_full (list, gstd_replay_connection_free);
+    return NULL;
+  }
+
+  return list;
+}
+
+/* Reduces a command to its kind: the command name, plus the URI of low
+ * level CRUD commands with the names that follow a collection replaced
+ * by '*', so setting any property of any element lands in one row */
+static gchar *
+gstd_replay_normalize (const gchar * command)
+{
+  static const gchar *const collections[] = {
+    "pipelines", "elements", "properties", "signals", NULL
+  };
+  GString *kind;
+  gchar **tokens;
+  gchar **segments;
+  gint i;
+
+  tokens = g_strsplit (command, " ", 3);
+  if (!tokens[0]) {
+    g_strfreev (tokens);
+    return g_strdup ("");
+  }
+
+  kind = g_string_new (tokens[0]);
+  if (tokens[1] && '/' == tokens[1][0] &&
+      (!g_strcmp0 (tokens[0], "create") || !g_strcmp0 (tokens[0], "read")
+          || !g_strcmp0 (tokens[0], "update")
+          || !g_strcmp0 (tokens[0], "delete"))) {
+    segments = g_strsplit (tokens[1], "/", -1);
+    for (i = 1; segments[i]; i++) {
+      g_string_append_c (kind, i > 1 ? '/' : ' ');
+      if (g_strv_contains (collections, segments[i - 1])) {
+        g_string_append_c (kind, '*');
+      } else {
+        if (1 == i) {
+          g_string_append_c (kind, '/');
+        }
+        g_string_append (kind, segments[i]);
+      }
+    }
+    g_strfreev (segments);
+  }
+  g_strfreev (tokens);
+
+  return g_string_free (kind, FALSE);
+}
+
+static gboolean
+gstd_replay_connect (GstdReplayConnection * connection, GError ** error)
+{
+  GstdReplay *replay = connection->replay;
+  GSocketAddress *address;
+  gchar *path;
+
+  g_clear_object (&connection->con);
+
+  if (replay->unix_socket) {
+    g_socket_client_set_family (connection->socket_client,
+        G_SOCKET_FAMILY_UNIX);
+    path = g_strdup_printf ("%s_%d", replay->unix_path, replay->unix_port);
+    address = g_unix_socket_address_new (path);
+    g_free (path);
+
+    connection->con = g_socket_client_connect (connection->socket_client,
+        G_SOCKET_CONNECTABLE (address), NULL, error);
+    g_object_unref (address);
+  } else {
+    connection->con =
+        g_socket_client_connect_to_host (connection->socket_client,
+        replay->address, replay->tcp_port, NULL, error);
+  }
+
+  return NULL != connection->con;
+}
+
+/* Returns the gstd return code, or -1 on a transport error */
+static gint
+gstd_replay_send (GstdReplayConnection * connection, const gchar * cmd,
+    GError ** error)
+{
+  GInputStream *istream;
+  GOutputStream *ostream;
+  GString *response;
+  const gchar *code;
+  gchar buffer[1024];
+  gssize read;
+  gint ret = -1;
+
+  istream = g_io_stream_get_input_stream (G_IO_STREAM (connection->con));
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (connection->con));
+
+  if (!g_output_stream_write_all (ostream, cmd, strlen (cmd), NULL, NULL,
+          error)) {
+    return -1;
+  }
+
+  response = g_string_new ("");
+  do {
+    read = g_input_stream_read (istream, buffer, sizeof (buffer), NULL, error);
+    if (read <= 0) {
+      if (0 == read) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED,
+            "The daemon closed the connection");
+      }
+      goto out;
+    }
+
+    g_string_append_len (response, buffer, read);
+
+    if (response->len >= GSTD_REPLAY_MAX_RESPONSE) {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+          "Response exceeded %d bytes limit", GSTD_REPLAY_MAX_RESPONSE);
+      goto out;
+    }
+  } while (buffer[read - 1] != '\0');
+
+  code = strstr (response->str, "\"code\" : ");
+  ret = code ? atoi (code + strlen ("\"code\" : ")) : -1;
+  if (ret < 0) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Malformed response: %s", response->str);
+  }
+
+out:
+  g_string_free (response, TRUE);
+  return ret;
+}
+
+static gpointer
+gstd_replay_connection_run (gpointer user_data)
+{
+  GstdReplayConnection *connection = user_data;
+  GstdReplay *replay = connection->replay;
+  GstdReplayCommand *command;
+  GstdReplayStats *stats;
+  gint64 target;
+  gint64 now;
+  gint64 start;
+  guint64 latency;
+  gchar *kind;
+  guint i;
+  gint code;
+
+  if (!gstd_replay_connect (connection, &connection->error)) {
+    return NULL;
+  }
+
+  for (i = 0; i < connection->commands->len; i++) {
+    command = &g_array_index (connection->commands, GstdReplayCommand, i);
+
+    if (!replay->fast) {
+      target = replay->start + command->time / replay->speed;
+      now = g_get_monotonic_time ();
+      if (target > now) {
+        g_usleep (target - now);
+      } else {
+        connection->lag = MAX (connection->lag, now - target);
+      }
+    }
+
+    start = g_get_monotonic_time ();
+    code = gstd_replay_send (connection, command->command, &connection->error);
+    latency = (g_get_monotonic_time () - start) * 1000;
+
+    kind = gstd_replay_normalize (command->command);
+    stats = g_hash_table_lookup (connection->stats, kind);
+    if (!stats) {
+      stats = gstd_replay_stats_new ();
+      g_hash_table_insert (connection->stats, kind, stats);
+    } else {
+      g_free (kind);
+    }
+
+    if (code < 0) {
+      stats->errors++;
+      break;
+    }
+
+    g_array_append_val (stats->latencies, latency);
+    if (code) {
+      stats->errors++;
+    }
+  }
+
+  return NULL;
+}
+
+static gint
+gstd_replay_compare (gconstpointer a, gconstpointer b)
+{
+  guint64 x = *(const guint64 *) a;
+  guint64 y = *(const guint64 *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+static gint
+gstd_replay_compare_kind (gconstpointer a, gconstpointer b)
+{
+  return g_strcmp0 (*(const gchar **) a, *(const gchar **) b);
+}
+
+/* Nearest rank percentile over a sorted array, in microseconds */
+static gdouble
+gstd_replay_percentile (GArray * sorted, gdouble percentile)
+{
+  guint rank;
+
+  if (0 == sorted->len) {
+    return 0;
+  }
+
+  rank = (guint) (percentile * sorted->len + 0.999999);
+  rank = CLAMP (rank, 1, sorted->len);
+
+  return g_array_index (sorted, guint64, rank - 1) / 1000.0;
+}
+
+static void
+gstd_replay_report (GstdReplay * replay, GList * connections,
+    guint count, gint64 elapsed)
+{
+  GstdReplayConnection *connection;
+  GstdReplayStats *stats;
+  GstdReplayStats *total;
+  GHashTable *merged;
+  GHashTableIter iter;
+  GPtrArray *kinds;
+  GList *l;
+  gpointer key;
+  gpointer value;
+  gint64 lag = 0;
+  gdouble p50;
+  gdouble p99;
+  gdouble max;
+  guint i;
+
+  merged = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+      gstd_replay_stats_free);
+
+  for (l = connections; l; l = l->next) {
+    connection = l->data;
+    lag = MAX (lag, connection->lag);
+
+    g_hash_table_iter_init (&iter, connection->stats);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+      stats = value;
+      total = g_hash_table_lookup (merged, key);
+      if (!total) {
+        total = gstd_replay_stats_new ();
+        g_hash_table_insert (merged, key, total);
+      }
+      g_array_append_vals (total->latencies, stats->latencies->data,
+          stats->latencies->len);
+      total->errors += stats->errors;
+    }
+  }
+
+  kinds = g_ptr_array_new ();
+  g_hash_table_iter_init (&iter, merged);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    g_ptr_array_add (kinds, key);
+  }
+  g_ptr_array_sort (kinds, gstd_replay_compare_kind);
+
+  if (replay->json) {
+    g_print ("{\n  \"commands\" : %u,\n  \"connections\" : %u,\n"
+        "  \"elapsed_s\" : %.3f,\n  \"max_lag_us\" : %" G_GINT64_FORMAT
+        ",\n  \"results\" : {\n", count, g_list_length (connections),
+        elapsed / (gdouble) G_USEC_PER_SEC, lag);
+  } else {
+    g_print ("Replayed %u commands over %u connections in %.3f s, "
+        "fell behind by up to %.1f ms\n\n", count,
+        g_list_length (connections), elapsed / (gdouble) G_USEC_PER_SEC,
+        lag / 1000.0);
+    g_print ("  %-48s %8s %8s %10s %10s %10s\n", "command", "count",
+        "errors", "p50 us", "p99 us", "max us");
+  }
+
+  for (i = 0; i < kinds->len; i++) {
+    total = g_hash_table_lookup (merged, g_ptr_array_index (kinds, i));
+    g_array_sort (total->latencies, gstd_replay_compare);
+    p50 = gstd_replay_percentile (total->latencies, 0.50);
+    p99 = gstd_replay_percentile (total->latencies, 0.99);
+    max = gstd_replay_percentile (total->latencies, 1.0);
+
+    if (replay->json) {
+      g_print ("    \"%s\" : { \"count\" : %u, \"errors\" : %"
+          G_GUINT64_FORMAT ", \"p50_us\" : %.1f, \"p99_us\" : %.1f, "
+          "\"max_us\" : %.1f }%s\n", (gchar *) g_ptr_array_index (kinds, i),
+          total->latencies->len, total->errors, p50, p99, max,
+          i + 1 < kinds->len ? "," : "");
+    } else {
+      g_print ("  %-48s %8u %8" G_GUINT64_FORMAT " %10.1f %10.1f %10.1f\n",
+          (gchar *) g_ptr_array_index (kinds, i), total->latencies->len,
+          total->errors, p50, p99, max);
+    }
+  }
+
+  if (replay->json) {
+    g_print ("  }\n}\n");
+  }
+
+  g_ptr_array_free (kinds, TRUE);
+  g_hash_table_unref (merged);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstdReplay replay;
+  GstdReplayConnection *connection;
+  GError *error = NULL;
+  GOptionContext *context;
+  GList *connections = NULL;
+  GList *l;
+  gint ret = EXIT_SUCCESS;
+  guint count = 0;
+  gint64 elapsed;
+  gchar *thread_name;
+
+  /* Cmdline options */
+  gchar *protocol = NULL;
+  gchar **files = NULL;
+
+  GOptionEntry entries[] = {
+    {"protocol", 'P', 0, G_OPTION_ARG_STRING, &protocol,
+          "Protocol to replay through: tcp or unix, commands received over "
+          "http are replayed as the commands they were translated to "
+          "(defaults to " GSTD_REPLAY_DEFAULT_PROTOCOL ")", "protocol"}
+    ,
+    {"fast", 'f', 0, G_OPTION_ARG_NONE, &replay.fast,
+          "Send each command as soon as the previous one on its connection "
+          "is answered, instead of keeping the recorded pacing", NULL}
+    ,
+    {"speed", 's', 0, G_OPTION_ARG_DOUBLE, &replay.speed,
+          "Pacing factor, 2 replays twice as fast as recorded (default 1)",
+        "factor"}
+    ,
+    {"tcp-address", 'a', 0, G_OPTION_ARG_STRING, &replay.address,
+          "The IP address of the daemon (defaults to "
+          GSTD_REPLAY_DEFAULT_ADDRESS ")", "address"}
+    ,
+    {"tcp-port", 'p', 0, G_OPTION_ARG_INT, &replay.tcp_port,
+        "The tcp port of the daemon (default 5000)", "tcp-port"}
+    ,
+    {"unix-base-path", 'b', 0, G_OPTION_ARG_STRING, &replay.unix_path,
+          "The daemon unix path (defaults to "
+          GSTD_REPLAY_DEFAULT_UNIX_BASE_NAME " in the run state directory)",
+        "path"}
+    ,
+    {"unix-port", 'e', 0, G_OPTION_ARG_INT, &replay.unix_port,
+        "The daemon unix port (default 0)", "unix-port"}
+    ,
+    {"json", 'j', 0, G_OPTION_ARG_NONE, &replay.json,
+        "Print the results as JSON", NULL}
+    ,
+    {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &files,
+        NULL, "journal"}
+    ,
+    {NULL}
+  };
+
+  /* Internationalization */
+  setlocale (LC_ALL, "");
+
+  memset (&replay, 0, sizeof (replay));
+  replay.speed = 1;
+  replay.tcp_port = GSTD_REPLAY_DEFAULT_TCP_PORT;
+  replay.unix_port = GSTD_REPLAY_DEFAULT_UNIX_PORT;
+
+  context = g_option_context_new ("JOURNAL - replay a gstd journal");
+  g_option_context_set_summary (context,
+      "Plays back the commands a daemon started with --journal-path "
+      "received, against a running daemon, and reports their latencies.");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_option_context_free (context);
+    goto error;
+  }
+  g_option_context_free (context);
+
+  if (!files || !files[0] || files[1]) {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Expected a single journal file");
+    goto error;
+  }
+
+  if (replay.speed <= 0) {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "speed must be positive");
+    goto error;
+  }
+
+  if (!protocol || !g_strcmp0 (protocol, "tcp")) {
+    replay.unix_socket = FALSE;
+  } else if (!g_strcmp0 (protocol, "unix")) {
+    replay.unix_socket = TRUE;
+  } else {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Unknown protocol \"%s\"", protocol);
+    goto error;
+  }
+
+  if (!replay.address) {
+    replay.address = g_strdup (GSTD_REPLAY_DEFAULT_ADDRESS);
+  }
+
+  if (!replay.unix_path) {
+    replay.unix_path = g_strdup_printf ("%s/%s", GSTD_RUN_STATE_DIR,
+        GSTD_REPLAY_DEFAULT_UNIX_BASE_NAME);
+  }
+
+  connections = gstd_replay_load (&replay, files[0], &count, &error);
+  if (!connections) {
+    if (!error) {
+      g_set_error (&error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+          "The journal \"%s\" is empty", files[0]);
+    }
+    goto error;
+  }
+
+  replay.start = g_get_monotonic_time ();
+  for (l = connections; l; l = l->next) {
+    connection = l->data;
+    thread_name = g_strdup_printf ("replay-%u", connection->id);
+    connection->thread = g_thread_new (thread_name,
+        gstd_replay_connection_run, connection);
+    g_free (thread_name);
+  }
+
+  for (l = connections; l; l = l->next) {
+    connection = l->data;
+    g_thread_join (connection->thread);
+    if (connection->error) {
+      g_printerr ("Connection %u stopped early: %s\n", connection->id,
+          connection->error->message);
+      ret = EXIT_FAILURE;
+    }
+  }
+  elapsed = g_get_monotonic_time () - replay.start;
+
+  gstd_replay_report (&replay, connections, count, elapsed);
+
+  goto out;
+
+error:
+  g_printerr ("%s\n", error->message);
+  g_error_free (error);
+  ret = EXIT_FAILURE;
+
+out:
+  g_list_free_full (connections, gstd_replay_connection_free);
+  g_strfreev (files);
+  g_free (protocol);
+  g_free (replay.address);
+  g_free (replay.unix_path);
+
+  return ret;
+}
@@ -0,0 +1,312 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <stdlib.h>
+
+#include "gstd_benchmark.h"
+#include "gstd_bus_msg.h"
+#include "gstd_iformatter.h"
+#include "gstd_json_builder.h"
+#include "gstd_list.h"
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+#define GSTD_REQUEST_PATH_DEFAULT_PIPELINES 100
+#define GSTD_REQUEST_PATH_PIPELINE \
+  "fakesrc name=src ! queue ! identity ! fakesink name=sink"
+
+typedef struct _GstdRequestPathData GstdRequestPathData;
+
+struct _GstdRequestPathData
+{
+  GstdSession *session;
+  GstdObject *node;
+  GstdBusMsg *msg;
+  gchar *cmd;
+  const gchar *name;
+  GstMessage *(*message) (void);
+};
+
+static gint pipelines = GSTD_REQUEST_PATH_DEFAULT_PIPELINES;
+
+static void
+bench_parse_cmd (gpointer user_data)
+{
+  GstdRequestPathData *data = user_data;
+  gchar *response = NULL;
+
+  gstd_parser_parse_cmd (data->session, data->cmd, &response);
+  g_free (response);
+}
+
+static void
+bench_get_by_uri (gpointer user_data)
+{
+  GstdRequestPathData *data = user_data;
+  GstdObject *node = NULL;
+
+  gstd_get_by_uri (data->session, data->cmd, &node);
+  if (node) {
+    gst_object_unref (node);
+  }
+}
+
+static void
+bench_find_child (gpointer user_data)
+{
+  GstdRequestPathData *data = user_data;
+
+  gstd_list_find_child (GSTD_LIST (data->node), data->name);
+}
+
+static void
+bench_object_to_string (gpointer user_data)
+{
+  GstdRequestPathData *data = user_data;
+  gchar *outstring = NULL;
+
+  gstd_object_to_string (data->node, &outstring);
+  g_free (outstring);
+}
+
+static void
+bench_json_builder (gpointer user_data)
+{
+  GstdIFormatter *formatter;
+  GValue value = G_VALUE_INIT;
+  gchar *outstring = NULL;
+
+  /* The shape of a typical property read */
+  formatter = g_object_new (GSTD_TYPE_JSON_BUILDER, NULL);
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, "silent");
+  gstd_iformatter_set_member_name (formatter, "value");
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, TRUE);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+  gstd_iformatter_set_member_name (formatter, "param");
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "description");
+  gstd_iformatter_set_string_value (formatter,
+      "Don't produce last_message events");
+  gstd_iformatter_set_member_name (formatter, "type");
+  gstd_iformatter_set_string_value (formatter, "gboolean");
+  gstd_iformatter_set_member_name (formatter, "access");
+  gstd_iformatter_set_string_value (formatter,
+      "((GstdParamFlags) READ | UPDATE)");
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, &outstring);
+  g_object_unref (formatter);
+  g_free (outstring);
+}
+
+static void
+bench_bus_msg (gpointer user_data)
+{
+  GstdRequestPathData *data = user_data;
+  GstdBusMsg *msg;
+  gchar *outstring = NULL;
+
+  msg = gstd_bus_msg_factory_make (data->message ());
+  gstd_object_to_string (GSTD_OBJECT (msg), &outstring);
+  g_free (outstring);
+  g_object_unref (msg);
+}
+
+static GstMessage *
+eos_message (void)
+{
+  return gst_message_new_eos (NULL);
+}
+
+static GstMessage *
+state_changed_message (void)
+{
+  return gst_message_new_state_changed (NULL, GST_STATE_PAUSED,
+      GST_STATE_PLAYING, GST_STATE_VOID_PENDING);
+}
+
+static GstMessage *
+element_message (void)
+{
+  return gst_message_new_element (NULL, gst_structure_new ("level",
+          "rms", G_TYPE_DOUBLE, -20.0, "peak", G_TYPE_DOUBLE, -6.0,
+          "endtime", G_TYPE_UINT64, GST_SECOND, NULL));
+}
+
+static void
+run_parser (GstdRequestPathData * data, const gchar * last)
+{
+  data->cmd = g_strdup ("no_such_command");
+  gstd_benchmark_run ("parser/dispatch/unknown", bench_parse_cmd, data);
+  g_free (data->cmd);
+
+  data->cmd = g_strdup_printf ("element_get %s sink silent", last);
+  gstd_benchmark_run ("parser/dispatch/element_get", bench_parse_cmd, data);
+  g_free (data->cmd);
+
+  data->cmd = g_strdup_printf ("read /pipelines/%s/state", last);
+  gstd_benchmark_run ("parser/dispatch/read_state", bench_parse_cmd, data);
+  g_free (data->cmd);
+}
+
+static void
+run_uri (GstdRequestPathData * data, const gchar * last)
+{
+  data->cmd = g_strdup ("/pipelines");
+  gstd_benchmark_run ("uri/pipelines", bench_get_by_uri, data);
+  g_free (data->cmd);
+
+  data->cmd = g_strdup_printf ("/pipelines/%s/elements/sink", last);
+  gstd_benchmark_run ("uri/element", bench_get_by_uri, data);
+  g_free (data->cmd);
+
+  data->cmd = g_strdup_printf ("/pipelines/%s/elements/sink/properties/silent",
+      last);
+  gstd_benchmark_run ("uri/property", bench_get_by_uri, data);
+  g_free (data->cmd);
+}
+
+static void
+run_list (GstdRequestPathData * data)
+{
+  GstdObject *child;
+  gchar *name = NULL;
+  gchar *label;
+  gint children;
+  gint i;
+
+  for (children = 1; children <= 10000; children *= 10) {
+    data->node = g_object_new (GSTD_TYPE_LIST, "name", "list",
+        "node-type", GSTD_TYPE_OBJECT, NULL);
+    gst_object_ref_sink (data->node);
+
+    for (i = 0; i < children; i++) {
+      g_free (name);
+      name = g_strdup_printf ("node%d", i);
+      child = g_object_new (GSTD_TYPE_OBJECT, "name", name, NULL);
+      gst_object_ref_sink (child);
+      gstd_list_append_child (GSTD_LIST (data->node), child);
+    }
+
+    /* The last child is the worst case of the linear lookup */
+    data->name = name;
+    label = g_strdup_printf ("list/find_child/%d", children);
+    gstd_benchmark_run (label, bench_find_child, data);
+    g_free (label);
+
+    gst_object_unref (data->node);
+  }
+  g_free (name);
+  data->name = NULL;
+}
+
+static void
+run_formatters (GstdRequestPathData * data, const gchar * last)
+{
+  gchar *uri;
+
+  uri = g_strdup_printf ("/pipelines/%s/elements/sink/properties/silent",
+      last);
+  gstd_get_by_uri (data->session, uri, &data->node);
+  g_free (uri);
+  gstd_benchmark_run ("property/to_string/boolean", bench_object_to_string,
+      data);
+  gst_object_unref (data->node);
+
+  uri = g_strdup_printf ("/pipelines/%s/elements/src/properties/sizetype",
+      last);
+  gstd_get_by_uri (data->session, uri, &data->node);
+  g_free (uri);
+  gstd_benchmark_run ("property/to_string/enum", bench_object_to_string,
+      data);
+  gst_object_unref (data->node);
+
+  gstd_benchmark_run ("json_builder/generate", bench_json_builder, data);
+
+  data->message = eos_message;
+  gstd_benchmark_run ("bus_msg/to_string/eos", bench_bus_msg, data);
+  data->message = state_changed_message;
+  gstd_benchmark_run ("bus_msg/to_string/state_changed", bench_bus_msg, data);
+  data->message = element_message;
+  gstd_benchmark_run ("bus_msg/to_string/element", bench_bus_msg, data);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstdRequestPathData data = { 0 };
+  GstdObject *node;
+  GstdReturnCode ret;
+  gchar *last = NULL;
+  gint i;
+
+  GOptionEntry entries[] = {
+    {"pipelines", 'n', 0, G_OPTION_ARG_INT, &pipelines,
+          "Number of pipelines in the synthetic session (default 100)",
+        "pipelines"}
+    ,
+    {NULL}
+  };
+
+  if (!gstd_benchmark_init (&argc, &argv, entries)) {
+    return EXIT_FAILURE;
+  }
+
+  if (pipelines < 1) {
+    g_printerr ("At least one pipeline is needed\n");
+    return EXIT_FAILURE;
+  }
+
+  data.session = gstd_session_new ("Benchmark Session");
+
+  ret = gstd_get_by_uri (data.session, "/pipelines", &node);
+  for (i = 0; i < pipelines && GSTD_EOK == ret; i++) {
+    g_free (last);
+    last = g_strdup_printf ("p%d", i);
+    ret = gstd_object_create (node, last, GSTD_REQUEST_PATH_PIPELINE);
+  }
+
+  if (GSTD_EOK != ret) {
+    g_printerr ("Unable to create the synthetic session: %s\n",
+        gstd_return_code_to_string (ret));
+    return EXIT_FAILURE;
+  }
+  gst_object_unref (node);
+
+  /* Lookups go to the most recently created pipeline, the last one of
+   * every list in the path */
+  run_parser (&data, last);
+  run_uri (&data, last);
+  run_list (&data);
+  run_formatters (&data, last);
+
+  g_free (last);
+  gst_object_unref (data.session);
+
+  return EXIT_SUCCESS;
+}
@@ -135,6 +135,24 @@ static GstdClientCmd cmds[] = {
       "pipeline_get_graph <name>"},
   {"pipeline_verbose", gstd_client_cmd_socket, "Updates pipeline verbose",
       "pipeline_verbose <name> <value>"},
+  {"pipeline_stats", gstd_client_cmd_socket,
+        "Reads the throughput statistics of the pipeline elements",
+      "pipeline_stats <name>"},
+  {"pipeline_cpu", gstd_client_cmd_socket,
+        "Reads the CPU usage of the pipeline streaming threads",
+      "pipeline_cpu <name>"},
+  {"pipeline_memory", gstd_client_cmd_socket,
+        "Reads the memory allocated by the pipeline elements",
+      "pipeline_memory <name>"},
+  {"pipeline_queues", gstd_client_cmd_socket,
+        "Reads the fill levels of the pipeline queues",
+      "pipeline_queues <name>"},
+  {"pipeline_queues_watermarks", gstd_client_cmd_socket,
+        "Sets the fill percentages that post a bus message when crossed",
+      "pipeline_queues_watermarks <name> <high> <low>"},
+  {"pipeline_qos", gstd_client_cmd_socket,
+        "Reads the QoS reported by the pipeline elements, aggregated",
+      "pipeline_qos <name>"},
 
   {"element_set", gstd_client_cmd_socket,
         "Sets a property in an element of a given pipeline",
@@ -142,6 +160,19 @@ static GstdClientCmd cmds[] = {
   {"element_get", gstd_client_cmd_socket,
         "Queries a property in an element of a given pipeline",
       "element_get <pipe> <element> <property>"},
+  {"element_latency", gstd_client_cmd_socket,
+        "Reads the processing latency of an element of a given pipeline",
+      "element_latency <pipe> <element>"},
+  {"property_subscribe", gstd_client_cmd_socket,
+        "Watch a property for changes. Optionally set the minimum time in "
+        "microseconds between two deliveries",
+      "property_subscribe <pipe> <element> <property> <name> [min-interval]"},
+  {"property_read", gstd_client_cmd_socket,
+        "Wait for a watched property to change and read its latest value",
+      "property_read <pipe> <element> <property> <name>"},
+  {"property_unsubscribe", gstd_client_cmd_socket,
+        "Stop watching a property",
+      "property_unsubscribe <pipe> <element> <property> <name>"},
 
   {"list_pipelines", gstd_client_cmd_socket, "List the existing pipelines",
       "list_pipelines"},
@@ -165,6 +196,14 @@ static GstdClientCmd cmds[] = {
         "Apply a timeout for the bus polling. -1: forever, 0: return immediately, "
         "n: wait n nanoseconds",
       "bus_timeout <pipe> <timeout>"},
+  {"bus_decimate", gstd_client_cmd_socket,
+        "Keep only one out of every N element messages with a given structure "
+        "name, i.e.: level=5,spectrum=10",
+      "bus_decimate <pipe> <decimation>"},
+  {"bus_qos_forward", gstd_client_cmd_socket,
+        "Enable/Disable delivering QoS messages to the bus readers, they "
+        "are still aggregated in pipeline_qos",
+      "bus_qos_forward <pipe> <enable>"},
 
   {"event_eos", gstd_client_cmd_socket, "Send an end-of-stream event",
       "event_eos <pipe>"},
@@ -186,6 +225,16 @@ static GstdClientCmd cmds[] = {
       "signal_timeout <pipe> <element> <signal> <timeout>"},
   {"signal_disconnect", gstd_client_cmd_socket, "Disconnect from signal",
       "signal_disconnect <pipe> <element> <signal>"},
+  {"signal_subscribe", gstd_client_cmd_socket,
+        "Create a persistent subscription that queues every emission of the "
+        "signal. Optionally set the queue size and count-only aggregation",
+      "signal_subscribe <pipe> <element> <signal> <name> [size] [count-only]"},
+  {"signal_read", gstd_client_cmd_socket,
+        "Read the next queued callback from a signal subscription",
+      "signal_read <pipe> <element> <signal> <name>"},
+  {"signal_unsubscribe", gstd_client_cmd_socket,
+        "Delete a signal subscription",
+      "signal_unsubscribe <pipe> <element> <signal> <name>"},
 
   {"action_emit", gstd_client_cmd_socket, "Emit action",
       "action_emit <pipe> <element> <action>"},
@@ -202,6 +251,17 @@ static GstdClientCmd cmds[] = {
   {"debug_reset", gstd_client_cmd_socket,
         "Enable/Disable debug threshold reset",
       "debug_reset <reset>"},
+  {"debug_locks", gstd_client_cmd_socket,
+        "Enable/Disable lock contention statistics, read them with "
+        "\"read /debug/locks\"",
+      "debug_locks <enable>"},
+  {"debug_pipeline", gstd_client_cmd_socket,
+        "Sets a debug threshold for the elements of a single pipeline",
+      "debug_pipeline <name> <threshold>"},
+
+  {"trace", gstd_client_cmd_socket,
+        "Records a timeline of the daemon activity to a Chrome trace file",
+      "trace <start|stop> [file]"},
 
   {NULL}
 };
@@ -28,6 +28,8 @@
 #include "gstd_daemon.h"
 #include "gstd_log.h"
 
+#define GSTD_LOG_ROTATE_COUNT 5
+
 #define HEADER \
       "\nGstD version " PACKAGE_VERSION "\n" \
       "Copyright (C) 2015-2021 RidgeRun (https://www.ridgerun.com)\n\n"
@@ -77,6 +79,8 @@ main (gint argc, gchar * argv[])
   gchar *filename = NULL;
   gboolean nolog = FALSE;
   gboolean parent = FALSE;
+  gint log_rotate_size = 0;
+  gint log_rotate_count = GSTD_LOG_ROTATE_COUNT;
 
   GstD *gstd = NULL;
 
@@ -106,6 +110,13 @@ main (gint argc, gchar * argv[])
           "Disable file logging when gstd is running in daemon mode. Takes precedence over -l and -d.",
         NULL}
     ,
+    {"log-rotate-size", 0, 0, G_OPTION_ARG_INT, &log_rotate_size,
+          "Rotate the log files once they reach this size in MiB (default 0, "
+          "never rotate)", "MiB"}
+    ,
+    {"log-rotate-count", 0, 0, G_OPTION_ARG_INT, &log_rotate_count,
+          "Number of rotated log files to keep (default 5)", "count"}
+    ,
     {NULL}
   };
 
@@ -143,7 +154,14 @@ main (gint argc, gchar * argv[])
      * - the user didn't invoke gstd to kill the daemon
      */
     if (!nolog && !kill) {
-      if (!gstd_log_init (gstdlogfile, gstlogfile)) {
+      if (log_rotate_size < 0 || log_rotate_count < 0) {
+        g_printerr ("The log rotation size and count must not be negative\n");
+        ret = EXIT_FAILURE;
+        goto out;
+      }
+
+      if (!gstd_log_init (gstdlogfile, gstlogfile,
+              (guint64) log_rotate_size * 1024 * 1024, log_rotate_count)) {
         ret = EXIT_FAILURE;
         goto out;
       }
@@ -185,6 +203,9 @@ main (gint argc, gchar * argv[])
     }
   }
 
+  /* The log writer must run in the detached process */
+  gstd_log_start ();
+
   /* Start IPC subsystem */
   if (!gstd_start (gstd)) {
     goto error;
@@ -210,8 +231,6 @@ main (gint argc, gchar * argv[])
   /* Stop any IPC array */
   gstd_stop (gstd);
 
-  gstd_log_deinit ();
-
   goto out;
 
 error:
@@ -225,6 +244,10 @@ error:
   }
 out:
   {
+    /* The parent left the pending log records to the daemon */
+    if (!parent) {
+      gstd_log_deinit ();
+    }
     gst_deinit ();
     gstd_free (gstd);
     return ret;
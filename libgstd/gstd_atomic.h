@@ -0,0 +1,51 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_ATOMIC_H__
+#define __GSTD_ATOMIC_H__
+
+#include <glib.h>
+
+/*
+ * Relaxed 64 bit counters. GLib only offers atomic operations on ints
+ * and pointers, so these map to the compiler builtins, which take care
+ * of the 64 bit accesses not tearing on 32 bit targets. No ordering is
+ * implied, they are meant for statistics read by other threads.
+ */
+#define gstd_atomic_uint64_get(ptr) \
+  (__atomic_load_n ((ptr), __ATOMIC_RELAXED))
+#define gstd_atomic_uint64_set(ptr, val) \
+  (__atomic_store_n ((ptr), (val), __ATOMIC_RELAXED))
+#define gstd_atomic_uint64_add(ptr, val) \
+  ((void) __atomic_fetch_add ((ptr), (val), __ATOMIC_RELAXED))
+#define gstd_atomic_uint64_inc(ptr) \
+  gstd_atomic_uint64_add ((ptr), 1)
+
+/*
+ * Counters written by a single thread, i.e.: per thread shards, need no
+ * read-modify-write. A relaxed load and store keep readers from seeing
+ * torn values without the cost of a locked instruction.
+ */
+#define gstd_atomic_uint64_owner_add(ptr, val) \
+  gstd_atomic_uint64_set ((ptr), gstd_atomic_uint64_get (ptr) + (val))
+#define gstd_atomic_uint64_owner_inc(ptr) \
+  gstd_atomic_uint64_owner_add ((ptr), 1)
+
+#endif //__GSTD_ATOMIC_H__
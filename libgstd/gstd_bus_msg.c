@@ -87,6 +87,12 @@ gstd_bus_msg_dispose (GObject * object)
 
 GstdBusMsg *
 gstd_bus_msg_factory_make (GstMessage * target)
+{
+  return gstd_bus_msg_factory_make_full (target, GSTD_BUS_MSG_FLAG_NONE);
+}
+
+GstdBusMsg *
+gstd_bus_msg_factory_make_full (GstMessage * target, GstdBusMsgFlags flags)
 {
   GstdBusMsg *msg = NULL;
   GstMessageType type;
@@ -125,6 +131,7 @@ gstd_bus_msg_factory_make (GstMessage * target)
 
   if (msg) {
     msg->target = target;
+    msg->flags = flags;
   }
 
   return msg;
@@ -43,6 +43,18 @@ G_BEGIN_DECLS
 #define GSTD_BUS_MSG_GET_CLASS(obj) \
   (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_BUS_MSG, GstdBusMsgClass))
 
+/**
+ * GstdBusMsgFlags:
+ * @GSTD_BUS_MSG_FLAG_NONE: Serialize every field as text
+ * @GSTD_BUS_MSG_FLAG_PACKED_ARRAYS: Serialize numeric array fields as
+ * base64 encoded, little endian binary
+ */
+typedef enum
+{
+  GSTD_BUS_MSG_FLAG_NONE = 0,
+  GSTD_BUS_MSG_FLAG_PACKED_ARRAYS = (1 << 0),
+} GstdBusMsgFlags;
+
 typedef struct _GstdBusMsg GstdBusMsg;
 typedef struct _GstdBusMsgClass GstdBusMsgClass;
 GType gstd_bus_msg_get_type (void);
@@ -52,6 +64,7 @@ struct _GstdBusMsg
   GstdObject parent;
 
   GstMessage *target;
+  GstdBusMsgFlags flags;
 };
 
 struct _GstdBusMsgClass
@@ -64,6 +77,19 @@ struct _GstdBusMsgClass
 
 GstdBusMsg *gstd_bus_msg_factory_make (GstMessage * target);
 
+/**
+ * gstd_bus_msg_factory_make_full:
+ * @target: (transfer full): The message to wrap
+ * @flags: How the message should be serialized
+ *
+ * Same as gstd_bus_msg_factory_make() but with control over the
+ * serialization of the message.
+ *
+ * Returns: (transfer full): A new #GstdBusMsg
+ */
+GstdBusMsg *gstd_bus_msg_factory_make_full (GstMessage * target,
+    GstdBusMsgFlags flags);
+
 G_END_DECLS
 
 #endif // __GSTD_BUS_MSG_H__
@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gstd_bus_msg.h"
 #include "gstd_bus_msg_element.h"
 
@@ -34,6 +36,8 @@ GST_DEBUG_CATEGORY_STATIC (gstd_bus_msg_element_debug);
 static GstdReturnCode
 gstd_bus_msg_element_to_string (GstdBusMsg * msg, GstdIFormatter * formatter,
     GstMessage * target);
+static gboolean gstd_bus_msg_element_pack_array (GstdIFormatter * formatter,
+    const GValue * array);
 
 struct _GstdBusMsgElement
 {
@@ -100,6 +104,12 @@ gstd_bus_msg_element_to_string (GstdBusMsg * msg, GstdIFormatter * formatter,
     field_value = gst_structure_get_value (st, field_name);
 
     gstd_iformatter_set_member_name (formatter, field_name);
+
+    if ((msg->flags & GSTD_BUS_MSG_FLAG_PACKED_ARRAYS)
+        && gstd_bus_msg_element_pack_array (formatter, field_value)) {
+      continue;
+    }
+
     gstd_iformatter_set_value (formatter, field_value);
   }
 
@@ -108,3 +118,120 @@ gstd_bus_msg_element_to_string (GstdBusMsg * msg, GstdIFormatter * formatter,
 out:
   return GSTD_EOK;
 }
+
+static guint
+gstd_bus_msg_element_array_size (const GValue * array)
+{
+  guint size = 0;
+
+  if (GST_VALUE_HOLDS_LIST (array)) {
+    size = gst_value_list_get_size (array);
+  } else if (GST_VALUE_HOLDS_ARRAY (array)) {
+    size = gst_value_array_get_size (array);
+  } else if (G_VALUE_HOLDS (array, G_TYPE_VALUE_ARRAY)) {
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    GValueArray *values = g_value_get_boxed (array);
+    size = values ? values->n_values : 0;
+    G_GNUC_END_IGNORE_DEPRECATIONS
+  }
+
+  return size;
+}
+
+static const GValue *
+gstd_bus_msg_element_array_get (const GValue * array, guint index)
+{
+  const GValue *value = NULL;
+
+  if (GST_VALUE_HOLDS_LIST (array)) {
+    value = gst_value_list_get_value (array, index);
+  } else if (GST_VALUE_HOLDS_ARRAY (array)) {
+    value = gst_value_array_get_value (array, index);
+  } else {
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    value = g_value_array_get_nth (g_value_get_boxed (array), index);
+    G_GNUC_END_IGNORE_DEPRECATIONS
+  }
+
+  return value;
+}
+
+static gboolean
+gstd_bus_msg_element_pack_array (GstdIFormatter * formatter,
+    const GValue * array)
+{
+  const GValue *value;
+  GValue count = G_VALUE_INIT;
+  GType type;
+  guint size;
+  guint width;
+  guint i;
+  guint8 *data;
+  gchar *encoded;
+  gdouble d;
+  gfloat f;
+  guint64 bits64;
+  guint32 bits32;
+
+  size = gstd_bus_msg_element_array_size (array);
+  if (0 == size) {
+    return FALSE;
+  }
+
+  /* Only homogeneous arrays of floating point numbers are packed, the
+   * element type decides the width of the samples */
+  type = G_VALUE_TYPE (gstd_bus_msg_element_array_get (array, 0));
+  if (G_TYPE_DOUBLE == type) {
+    width = sizeof (guint64);
+  } else if (G_TYPE_FLOAT == type) {
+    width = sizeof (guint32);
+  } else {
+    return FALSE;
+  }
+
+  data = g_malloc (size * width);
+
+  for (i = 0; i < size; i++) {
+    value = gstd_bus_msg_element_array_get (array, i);
+    if (G_VALUE_TYPE (value) != type) {
+      g_free (data);
+      return FALSE;
+    }
+
+    if (G_TYPE_DOUBLE == type) {
+      d = g_value_get_double (value);
+      memcpy (&bits64, &d, width);
+      bits64 = GUINT64_TO_LE (bits64);
+      memcpy (data + i * width, &bits64, width);
+    } else {
+      f = g_value_get_float (value);
+      memcpy (&bits32, &f, width);
+      bits32 = GUINT32_TO_LE (bits32);
+      memcpy (data + i * width, &bits32, width);
+    }
+  }
+
+  encoded = g_base64_encode (data, size * width);
+  g_free (data);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "dtype");
+  gstd_iformatter_set_string_value (formatter,
+      G_TYPE_DOUBLE == type ? "f64le" : "f32le");
+
+  g_value_init (&count, G_TYPE_UINT);
+  g_value_set_uint (&count, size);
+  gstd_iformatter_set_member_name (formatter, "count");
+  gstd_iformatter_set_value (formatter, &count);
+  g_value_unset (&count);
+
+  gstd_iformatter_set_member_name (formatter, "data");
+  gstd_iformatter_set_string_value (formatter, encoded);
+
+  gstd_iformatter_end_object (formatter);
+
+  g_free (encoded);
+
+  return TRUE;
+}
@@ -107,6 +107,16 @@ gstd_callback_to_string (GstdObject * object, gchar ** outstring)
   gstd_iformatter_set_member_name (formatter, "name");
   gstd_iformatter_set_string_value (formatter, self->signal_name);
 
+  if (self->count) {
+    GValue count = G_VALUE_INIT;
+
+    g_value_init (&count, G_TYPE_UINT64);
+    g_value_set_uint64 (&count, self->count);
+    gstd_iformatter_set_member_name (formatter, "count");
+    gstd_iformatter_set_value (formatter, &count);
+    g_value_unset (&count);
+  }
+
   gstd_iformatter_set_member_name (formatter, "arguments");
   gstd_iformatter_begin_array (formatter);
 
@@ -160,3 +170,20 @@ gstd_callback_new (const gchar * signal_name, GValue * return_value,
 
   return cb;
 }
+
+GstdCallback *
+gstd_callback_new_aggregate (const gchar * signal_name, guint64 count)
+{
+  GstdCallback *cb;
+
+  cb = g_object_new (GSTD_TYPE_CALLBACK, NULL);
+
+  /* Aggregated callbacks only report how many times the signal was
+   * emitted, the arguments of each emission are not kept */
+  cb->param_values = NULL;
+  cb->n_params = 0;
+  cb->count = count;
+  cb->signal_name = g_strdup (signal_name);
+
+  return cb;
+}
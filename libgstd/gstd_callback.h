@@ -52,6 +52,10 @@ struct _GstdCallback
   gchar *signal_name;
   GValue *param_values;
   guint n_params;
+
+  /* Amount of emissions aggregated in this callback, 0 if it holds the
+   * arguments of a single emission */
+  guint64 count;
 };
 
 struct _GstdCallbackClass
@@ -63,5 +67,8 @@ struct _GstdCallbackClass
 GstdCallback *gstd_callback_new (const gchar * signal_name,
     GValue * return_value, guint n_param_values, const GValue * param_values);
 
+GstdCallback *gstd_callback_new_aggregate (const gchar * signal_name,
+    guint64 count);
+
 G_END_DECLS
 #endif // __GSTD_CALLBACK_H__
@@ -25,7 +25,10 @@
 #include <glib/gprintf.h>
 
 #include "gstd_debug.h"
+#include "gstd_instances.h"
+#include "gstd_lock_stats.h"
 #include "gstd_object.h"
+#include "gstd_pipeline_debug.h"
 #include "gstd_property_reader.h"
 
 GST_DEBUG_CATEGORY_STATIC (gstd_debug_cat);
@@ -37,6 +40,8 @@ enum
   PROP_THRESHOLD,
   PROP_FLAGS,
   PROP_RESET,
+  PROP_LOCKS,
+  PROP_INSTANCES,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -66,6 +71,16 @@ struct _GstdDebug
    */
   gboolean reset;
 
+  /*
+   * Lock contention statistics
+   */
+  GstdLockStats *locks;
+
+  /*
+   * Live instance census
+   */
+  GstdInstances *instances;
+
   GParamFlags flags;
 };
 
@@ -133,6 +148,18 @@ gstd_debug_class_init (GstdDebugClass * klass)
       "Clear previously set debug thresholds ",
       PROP_RESET_DEFAULT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_LOCKS] =
+      g_param_spec_object ("locks",
+      "Locks",
+      "The lock contention statistics",
+      GSTD_TYPE_LOCK_STATS, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_INSTANCES] =
+      g_param_spec_object ("instances",
+      "Instances",
+      "The live instances of every gstd type",
+      GSTD_TYPE_INSTANCES, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -152,6 +179,8 @@ gstd_debug_init (GstdDebug * self)
   self->color = gst_debug_is_colored ();
   self->threshold = debug_obtain_default_level ();
   self->reset = PROP_RESET_DEFAULT;
+  self->locks = gstd_lock_stats_new ();
+  self->instances = gstd_instances_new ();
 
   gstd_object_set_reader (GSTD_OBJECT (self),
       g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
@@ -188,6 +217,14 @@ gstd_debug_get_property (GObject * object,
       GST_WARNING_OBJECT (self, "Returning debug reset %d", self->reset);
       g_value_set_boolean (value, self->reset);
       break;
+    case PROP_LOCKS:
+      GST_DEBUG_OBJECT (self, "Returning lock statistics %p", self->locks);
+      g_value_set_object (value, self->locks);
+      break;
+    case PROP_INSTANCES:
+      GST_DEBUG_OBJECT (self, "Returning instances %p", self->instances);
+      g_value_set_object (value, self->instances);
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -207,6 +244,9 @@ gstd_debug_set_threshold (GstdDebug * self)
     gst_debug_set_threshold_from_string ("*:0", TRUE);
 
   gst_debug_set_threshold_from_string (self->threshold, FALSE);
+
+  /* Pipelines with their own debug keep it over the new thresholds */
+  gstd_pipeline_debug_refresh ();
 }
 
 static void
@@ -268,6 +308,9 @@ gstd_debug_dispose (GObject * object)
     g_free (self->threshold);
     self->threshold = NULL;
   }
+
+  g_clear_object (&self->locks);
+  g_clear_object (&self->instances);
 }
 
 
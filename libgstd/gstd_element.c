@@ -29,6 +29,7 @@
 
 #include "gstd_action.h"
 #include "gstd_element.h"
+#include "gstd_element_latency.h"
 #include "gstd_event_handler.h"
 #include "gstd_iformatter.h"
 #include "gstd_json_builder.h"
@@ -51,6 +52,7 @@ enum
   PROP_PROPERTIES,
   PROP_SIGNALS,
   PROP_ACTIONS,
+  PROP_LATENCY,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -94,6 +96,11 @@ struct _GstdElement
    * The actions held by the element
    */
   GstdList *element_actions;
+
+  /*
+   * The processing latency of the element
+   */
+  GstdElementLatency *latency;
 };
 
 struct _GstdElementClass
@@ -168,6 +175,13 @@ gstd_element_class_init (GstdElementClass * klass)
       GSTD_TYPE_LIST,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
 
+  properties[PROP_LATENCY] =
+      g_param_spec_object ("latency",
+      "Latency",
+      "The processing latency of the element",
+      GSTD_TYPE_ELEMENT_LATENCY,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   gstd_object_class->to_string = gstd_element_to_string;
@@ -185,6 +199,7 @@ gstd_element_init (GstdElement * self)
   GST_INFO_OBJECT (self, "Initializing element");
   self->element = GSTD_ELEMENT_DEFAULT_GSTELEMENT;
   self->event_handler = NULL;
+  self->latency = NULL;
 
   gstd_object_set_reader (GSTD_OBJECT (self),
       g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
@@ -229,6 +244,11 @@ gstd_element_dispose (GObject * object)
     self->event_handler = NULL;
   }
 
+  if (self->latency) {
+    g_object_unref (self->latency);
+    self->latency = NULL;
+  }
+
   g_object_unref (self->element_properties);
   g_object_unref (self->element_signals);
   g_object_unref (self->element_actions);
@@ -266,6 +286,10 @@ gstd_element_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning actions %p", self->element_actions);
       g_value_set_object (value, self->element_actions);
       break;
+    case PROP_LATENCY:
+      GST_DEBUG_OBJECT (self, "Returning latency %p", self->latency);
+      g_value_set_object (value, self->latency);
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -287,6 +311,10 @@ gstd_element_set_property (GObject * object,
       }
       self->event_handler = g_object_new (GSTD_TYPE_EVENT_HANDLER, "receiver",
           G_OBJECT (self->element), NULL);
+      if (self->latency) {
+        g_object_unref (self->latency);
+      }
+      self->latency = gstd_element_latency_new (self->element);
 
       GST_DEBUG_OBJECT (self, "Setting element %p (%s)", self->element,
           GST_OBJECT_NAME (self->element));
@@ -0,0 +1,224 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_tracer.h"
+
+#include "gstd_element_latency.h"
+
+/* Gstd Element Latency debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_element_latency_debug);
+#define GST_CAT_DEFAULT gstd_element_latency_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/**
+ * GstdElementLatency:
+ * Processing latency of an element and of the pipeline it belongs to
+ */
+struct _GstdElementLatency
+{
+  GstdObject parent;
+
+  GstElement *target;
+};
+
+struct _GstdElementLatencyClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdElementLatency, gstd_element_latency, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_element_latency_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_element_latency_dispose (GObject * obj);
+static void gstd_element_latency_describe_pipeline (GstdElementLatency *
+    self, GstdIFormatter * formatter);
+static void gstd_element_latency_set_time (GstdIFormatter * formatter,
+    const gchar * name, GstClockTime value);
+
+static void
+gstd_element_latency_class_init (GstdElementLatencyClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->dispose = gstd_element_latency_dispose;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_element_latency_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_element_latency_debug, "gstdelementlatency",
+      debug_color, "Gstd Element Latency category");
+}
+
+static void
+gstd_element_latency_init (GstdElementLatency * self)
+{
+  GST_INFO_OBJECT (self, "Initializing element latency");
+  self->target = NULL;
+}
+
+/* Times are reported in nanoseconds, -1 stands for unknown or
+   unbounded */
+static void
+gstd_element_latency_set_time (GstdIFormatter * formatter,
+    const gchar * name, GstClockTime value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_INT64);
+  g_value_set_int64 (&gvalue,
+      GST_CLOCK_TIME_IS_VALID (value) ? (gint64) value : -1);
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &gvalue);
+  g_value_unset (&gvalue);
+}
+
+static void
+gstd_element_latency_describe_pipeline (GstdElementLatency * self,
+    GstdIFormatter * formatter)
+{
+  GstObject *top;
+  GstObject *parent;
+  GstQuery *query;
+  gboolean live = FALSE;
+  GstClockTime min = GST_CLOCK_TIME_NONE;
+  GstClockTime max = GST_CLOCK_TIME_NONE;
+  GValue value = G_VALUE_INIT;
+
+  top = gst_object_ref (GST_OBJECT (self->target));
+  while ((parent = gst_object_get_parent (top))) {
+    gst_object_unref (top);
+    top = parent;
+  }
+
+  /* The pipeline only answers once it is prerolled */
+  query = gst_query_new_latency ();
+  if (GST_IS_ELEMENT (top) && gst_element_query (GST_ELEMENT (top), query)) {
+    gst_query_parse_latency (query, &live, &min, &max);
+  } else {
+    GST_DEBUG_OBJECT (self, "Latency query on %s failed",
+        GST_OBJECT_NAME (top));
+  }
+  gst_query_unref (query);
+  gst_object_unref (top);
+
+  gstd_iformatter_set_member_name (formatter, "pipeline");
+  gstd_iformatter_begin_object (formatter);
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, live);
+  gstd_iformatter_set_member_name (formatter, "live");
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  gstd_element_latency_set_time (formatter, "min", min);
+  gstd_element_latency_set_time (formatter, "max", max);
+
+  gstd_iformatter_end_object (formatter);
+}
+
+static GstdReturnCode
+gstd_element_latency_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdElementLatency *self;
+  GstdIFormatter *formatter;
+  GstdLatencyStats stats;
+  GValue value = G_VALUE_INIT;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_ELEMENT_LATENCY (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  /* Measuring costs on every push, so it only starts once someone
+     is interested */
+  gstd_tracer_watch_latency (self->target);
+  if (!gstd_tracer_get_latency (self->target, &stats)) {
+    stats.min = stats.avg = stats.p99 = stats.max = GST_CLOCK_TIME_NONE;
+  }
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  gstd_iformatter_set_member_name (formatter, "count");
+  gstd_iformatter_set_uint64_value (formatter, stats.count);
+
+  g_value_init (&value, G_TYPE_UINT);
+  g_value_set_uint (&value, stats.samples);
+  gstd_iformatter_set_member_name (formatter, "samples");
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  gstd_element_latency_set_time (formatter, "min", stats.min);
+  gstd_element_latency_set_time (formatter, "avg", stats.avg);
+  gstd_element_latency_set_time (formatter, "p99", stats.p99);
+  gstd_element_latency_set_time (formatter, "max", stats.max);
+
+  gstd_element_latency_describe_pipeline (self, formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdElementLatency *
+gstd_element_latency_new (GstElement * target)
+{
+  GstdElementLatency *self;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (target), NULL);
+
+  gstd_tracer_acquire ();
+
+  self = g_object_new (GSTD_TYPE_ELEMENT_LATENCY, "name", "latency", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
+
+static void
+gstd_element_latency_dispose (GObject * object)
+{
+  GstdElementLatency *self = GSTD_ELEMENT_LATENCY (object);
+
+  if (self->target) {
+    gst_object_unref (self->target);
+    self->target = NULL;
+    gstd_tracer_release ();
+  }
+
+  G_OBJECT_CLASS (gstd_element_latency_parent_class)->dispose (object);
+}
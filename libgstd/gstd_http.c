@@ -28,7 +28,11 @@
 #include <libsoup/soup.h>
 
 #include "gstd_http.h"
+#include "gstd_journal.h"
+#include "gstd_lock_stats.h"
+#include "gstd_metrics.h"
 #include "gstd_parser.h"
+#include "gstd_trace.h"
 
 /* Gstd HTTP debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_http_debug);
@@ -36,6 +40,9 @@ GST_DEBUG_CATEGORY_STATIC (gstd_http_debug);
 
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
+#define GSTD_HTTP_METRICS_PATH "/metrics"
+#define GSTD_HTTP_METRICS_CONTENT_TYPE "text/plain; version=0.0.4"
+
 typedef struct _GstdHttpRequest
 {
   SoupServer *server;
@@ -44,6 +51,8 @@ typedef struct _GstdHttpRequest
   const char *path;
   GHashTable *query;
   GMutex *mutex;
+  GstdMetricsGauge *active_requests;
+  guint connection;
 } GstdHttpRequest;
 
 struct _GstdHttp
@@ -56,6 +65,7 @@ struct _GstdHttp
   GstdSession *session;
   GThreadPool *pool;
   GMutex mutex;
+  GstdMetricsGauge *active_requests;
 };
 
 struct _GstdHttpClass
@@ -83,9 +93,11 @@ static GstdReturnCode do_put (SoupServer * server, SoupMessage * msg,
 static GstdReturnCode do_delete (SoupServer * server, SoupMessage * msg,
     char *name, char **output, const char *path, GstdSession * session);
 static void do_request (gpointer data_request, gpointer eval);
+static void do_metrics (SoupMessage * msg, GstdSession * session);
 static void server_callback (SoupServer * server, SoupMessage * msg,
     const char *path, GHashTable * query, SoupClientContext * context,
     gpointer data);
+static guint get_connection (SoupClientContext * context);
 
 static void
 gstd_http_class_init (GstdHttpClass * klass)
@@ -117,6 +129,7 @@ gstd_http_init (GstdHttp * self)
   self->server = NULL;
   self->session = NULL;
   self->pool = NULL;
+  self->active_requests = NULL;
 
 }
 
@@ -299,18 +312,30 @@ do_request (gpointer data_request, gpointer eval)
   const char *path = NULL;
   GHashTable *query = NULL;
   GstdHttpRequest *data_request_local = NULL;
+  gint64 start;
+  gint64 reply_start;
+  gint64 lock;
 
   g_return_if_fail (data_request);
 
+  start = gstd_trace_now ();
+
   data_request_local = (GstdHttpRequest *) data_request;
-  g_mutex_lock (data_request_local->mutex);
+  lock = gstd_lock_stats_lock (data_request_local->mutex,
+      GSTD_LOCK_SITE_HTTP_REQUEST);
   server = data_request_local->server;
-  g_mutex_unlock (data_request_local->mutex);
+  gstd_lock_stats_unlock (data_request_local->mutex,
+      GSTD_LOCK_SITE_HTTP_REQUEST, lock);
   msg = data_request_local->msg;
   session = data_request_local->session;
   path = data_request_local->path;
   query = data_request_local->query;
 
+  gstd_metrics_gauge_inc (data_request_local->active_requests);
+  gstd_trace_instant ("receive", path);
+  gstd_journal_set_connection (GSTD_JOURNAL_PROTOCOL_HTTP,
+      data_request_local->connection);
+
   if (query != NULL) {
     name = g_hash_table_lookup (query, "name");
     description_pipe = g_hash_table_lookup (query, "description");
@@ -336,6 +361,7 @@ do_request (gpointer data_request, gpointer eval)
   g_free (output);
   output = NULL;
 
+  reply_start = gstd_trace_now ();
   soup_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
       response, strlen (response));
   g_free (response);
@@ -343,9 +369,16 @@ do_request (gpointer data_request, gpointer eval)
 
   status = get_status_code (ret);
   soup_message_set_status (msg, status);
-  g_mutex_lock (data_request_local->mutex);
+  lock = gstd_lock_stats_lock (data_request_local->mutex,
+      GSTD_LOCK_SITE_HTTP_REPLY);
   soup_server_unpause_message (server, msg);
-  g_mutex_unlock (data_request_local->mutex);
+  gstd_lock_stats_unlock (data_request_local->mutex,
+      GSTD_LOCK_SITE_HTTP_REPLY, lock);
+  gstd_trace_span ("reply", NULL, reply_start);
+  gstd_trace_span ("request", path, start);
+
+  gstd_metrics_gauge_dec (data_request_local->active_requests);
+  gstd_journal_set_connection (GSTD_JOURNAL_PROTOCOL_NONE, 0);
 
   if (query != NULL) {
     g_hash_table_unref (query);
@@ -356,6 +389,53 @@ do_request (gpointer data_request, gpointer eval)
   return;
 }
 
+static void
+do_metrics (SoupMessage * msg, GstdSession * session)
+{
+  gchar *metrics;
+
+  g_return_if_fail (msg);
+  g_return_if_fail (session);
+
+  /* Rendering is cheap and lock-free for the dispatch path, so answer
+   * right away instead of going through the request pool */
+  metrics = gstd_metrics_render (session);
+  soup_message_set_response (msg, GSTD_HTTP_METRICS_CONTENT_TYPE,
+      SOUP_MEMORY_TAKE, metrics, strlen (metrics));
+  soup_message_set_status (msg, SOUP_STATUS_OK);
+}
+
+static guint
+get_connection (SoupClientContext * context)
+{
+#ifdef SOUP_CHECK_VERSION
+#if SOUP_CHECK_VERSION(2, 48, 0)
+  static GQuark quark = 0;
+  GSocket *socket;
+  guint connection;
+
+  if (G_UNLIKELY (!quark)) {
+    quark = g_quark_from_static_string ("gstd-journal-connection");
+  }
+
+  /* Keep-alive requests share the socket, so tag it with its id */
+  socket = soup_client_context_get_gsocket (context);
+  if (socket) {
+    connection = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (socket),
+            quark));
+    if (!connection) {
+      connection = gstd_journal_new_connection ();
+      g_object_set_qdata (G_OBJECT (socket), quark,
+          GUINT_TO_POINTER (connection));
+    }
+    return connection;
+  }
+#endif
+#endif
+
+  return gstd_journal_new_connection ();
+}
+
 static void
 server_callback (SoupServer * server, SoupMessage * msg,
     const char *path, GHashTable * query,
@@ -364,6 +444,7 @@ server_callback (SoupServer * server, SoupMessage * msg,
   GstdSession *session = NULL;
   GstdHttp *self = NULL;
   GstdHttpRequest *data_request = NULL;
+  gint64 lock;
 
   g_return_if_fail (server);
   g_return_if_fail (msg);
@@ -372,6 +453,12 @@ server_callback (SoupServer * server, SoupMessage * msg,
   self = GSTD_HTTP (data);
   session = self->session;
 
+  if (msg->method == SOUP_METHOD_GET
+      && !g_strcmp0 (path, GSTD_HTTP_METRICS_PATH)) {
+    do_metrics (msg, session);
+    return;
+  }
+
   data_request = (GstdHttpRequest *) malloc (sizeof (GstdHttpRequest));
 
   data_request->msg = msg;
@@ -384,6 +471,8 @@ server_callback (SoupServer * server, SoupMessage * msg,
     data_request->query = query;
   }
   data_request->mutex = &self->mutex;
+  data_request->active_requests = self->active_requests;
+  data_request->connection = get_connection (context);
 
   soup_message_headers_append (msg->response_headers,
       "Access-Control-Allow-Origin", "*");
@@ -391,9 +480,9 @@ server_callback (SoupServer * server, SoupMessage * msg,
       "Access-Control-Allow-Headers", "origin,range,content-type");
   soup_message_headers_append (msg->response_headers,
       "Access-Control-Allow-Methods", "PUT, GET, POST, DELETE");
-  g_mutex_lock (&self->mutex);
+  lock = gstd_lock_stats_lock (&self->mutex, GSTD_LOCK_SITE_HTTP_PAUSE);
   soup_server_pause_message (server, msg);
-  g_mutex_unlock (&self->mutex);
+  gstd_lock_stats_unlock (&self->mutex, GSTD_LOCK_SITE_HTTP_PAUSE, lock);
   if (!g_thread_pool_push (self->pool, (gpointer) data_request, NULL)) {
     GST_ERROR_OBJECT (self->pool, "Thread pool push failed");
   }
@@ -419,6 +508,9 @@ gstd_http_start (GstdIpc * base, GstdSession * session)
   self->session = session;
   gstd_http_stop (base);
 
+  self->active_requests = gstd_metrics_gauge_get ("gstd_ipc_active_requests",
+      "Requests currently being processed", "ipc=\"GstdHttp\"");
+
   GST_DEBUG_OBJECT (self, "Initializing HTTP server");
   self->server = soup_server_new (SOUP_SERVER_SERVER_HEADER, "Gstd-1.0", NULL);
   if (!self->server) {
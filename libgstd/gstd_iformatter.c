@@ -72,6 +72,19 @@ gstd_iformatter_set_value (GstdIFormatter * self, const GValue * value)
   GSTD_IFORMATTER_GET_INTERFACE (self)->set_value (self, value);
 }
 
+void
+gstd_iformatter_set_uint64_value (GstdIFormatter * self, guint64 value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_return_if_fail (self);
+
+  g_value_init (&gvalue, G_TYPE_UINT64);
+  g_value_set_uint64 (&gvalue, value);
+  gstd_iformatter_set_value (self, &gvalue);
+  g_value_unset (&gvalue);
+}
+
 void
 gstd_iformatter_generate (GstdIFormatter * self, gchar ** outstring)
 {
@@ -73,6 +73,9 @@ void gstd_iformatter_set_string_value (GstdIFormatter * self,
 
 void gstd_iformatter_set_value (GstdIFormatter * self, const GValue * value);
 
+/* Convenience wrapper over gstd_iformatter_set_value() */
+void gstd_iformatter_set_uint64_value (GstdIFormatter * self, guint64 value);
+
 void gstd_iformatter_generate (GstdIFormatter * self, gchar ** outstring);
 
 G_END_DECLS
@@ -0,0 +1,232 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_instances.h"
+#include "gstd_property_reader.h"
+
+/* Gstd Instances debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_instances_debug);
+#define GST_CAT_DEFAULT gstd_instances_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Counters are never freed, types are not unloaded */
+struct _GstdInstanceCount
+{
+  GType type;
+  gsize size;
+  gint live;
+  gsize created;
+};
+
+/**
+ * GstdInstances:
+ * Reports the live instances of the counted types
+ */
+struct _GstdInstances
+{
+  GstdObject parent;
+};
+
+struct _GstdInstancesClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdInstances, gstd_instances, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_instances_to_string (GstdObject * obj, gchar ** outstring);
+static gint gstd_instances_compare (gconstpointer a, gconstpointer b);
+
+static GMutex instances_lock;
+static GList *counts = NULL;
+
+static void
+gstd_instances_class_init (GstdInstancesClass * klass)
+{
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_instances_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_instances_debug, "gstdinstances",
+      debug_color, "Gstd Instances category");
+}
+
+static void
+gstd_instances_init (GstdInstances * self)
+{
+  GST_INFO_OBJECT (self, "Initializing instances");
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static gint
+gstd_instances_compare (gconstpointer a, gconstpointer b)
+{
+  const GstdInstanceCount *x = a;
+  const GstdInstanceCount *y = b;
+
+  return g_strcmp0 (g_type_name (x->type), g_type_name (y->type));
+}
+
+GstdInstanceCount *
+gstd_instances_get (GType type, GstdInstanceCount ** cache)
+{
+  GstdInstanceCount *count;
+  GTypeQuery query;
+  GList *iter;
+
+  g_return_val_if_fail (cache, NULL);
+
+  count = g_atomic_pointer_get (cache);
+  if (G_LIKELY (count && count->type == type)) {
+    return count;
+  }
+
+  g_mutex_lock (&instances_lock);
+
+  count = NULL;
+  for (iter = counts; iter; iter = iter->next) {
+    if (((GstdInstanceCount *) iter->data)->type == type) {
+      count = iter->data;
+      break;
+    }
+  }
+
+  if (!count) {
+    g_type_query (type, &query);
+
+    count = g_new0 (GstdInstanceCount, 1);
+    count->type = type;
+    count->size = query.instance_size;
+    counts = g_list_insert_sorted (counts, count, gstd_instances_compare);
+  }
+
+  g_mutex_unlock (&instances_lock);
+
+  g_atomic_pointer_set (cache, count);
+
+  return count;
+}
+
+void
+gstd_instances_add (GstdInstanceCount * count)
+{
+  g_return_if_fail (count);
+
+  g_atomic_int_inc (&count->live);
+  g_atomic_pointer_add (&count->created, 1);
+}
+
+void
+gstd_instances_remove (GstdInstanceCount * count)
+{
+  g_return_if_fail (count);
+
+  g_atomic_int_add (&count->live, -1);
+}
+
+static GstdReturnCode
+gstd_instances_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdIFormatter *formatter;
+  GstdInstanceCount *count;
+  GList *iter;
+  guint64 total_live = 0;
+  guint64 total_bytes = 0;
+  guint64 live;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  /* Created before taking the lock, formatters are counted too */
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (obj));
+
+  g_mutex_lock (&instances_lock);
+
+  for (iter = counts; iter; iter = iter->next) {
+    count = iter->data;
+    live = MAX (g_atomic_int_get (&count->live), 0);
+    total_live += live;
+    total_bytes += live * count->size;
+  }
+
+  /* Only the instance structures, memory owned by them is not seen */
+  gstd_iformatter_set_member_name (formatter, "live");
+  gstd_iformatter_set_uint64_value (formatter, total_live);
+  gstd_iformatter_set_member_name (formatter, "bytes");
+  gstd_iformatter_set_uint64_value (formatter, total_bytes);
+
+  gstd_iformatter_set_member_name (formatter, "types");
+  gstd_iformatter_begin_array (formatter);
+
+  for (iter = counts; iter; iter = iter->next) {
+    count = iter->data;
+    live = MAX (g_atomic_int_get (&count->live), 0);
+
+    gstd_iformatter_begin_object (formatter);
+
+    gstd_iformatter_set_member_name (formatter, "name");
+    gstd_iformatter_set_string_value (formatter, g_type_name (count->type));
+
+    gstd_iformatter_set_member_name (formatter, "live");
+    gstd_iformatter_set_uint64_value (formatter, live);
+    gstd_iformatter_set_member_name (formatter, "created");
+    gstd_iformatter_set_uint64_value (formatter,
+        (gsize) g_atomic_pointer_get (&count->created));
+    gstd_iformatter_set_member_name (formatter, "bytes");
+    gstd_iformatter_set_uint64_value (formatter, live * count->size);
+
+    gstd_iformatter_end_object (formatter);
+  }
+
+  g_mutex_unlock (&instances_lock);
+
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdInstances *
+gstd_instances_new (void)
+{
+  return g_object_new (GSTD_TYPE_INSTANCES, "name", "instances", NULL);
+}
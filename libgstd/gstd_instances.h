@@ -0,0 +1,88 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_INSTANCES_H__
+#define __GSTD_INSTANCES_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_INSTANCES \
+  (gstd_instances_get_type())
+#define GSTD_INSTANCES(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_INSTANCES,GstdInstances))
+#define GSTD_INSTANCES_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_INSTANCES,GstdInstancesClass))
+#define GSTD_IS_INSTANCES(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_INSTANCES))
+#define GSTD_IS_INSTANCES_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_INSTANCES))
+#define GSTD_INSTANCES_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_INSTANCES, GstdInstancesClass))
+typedef struct _GstdInstances GstdInstances;
+typedef struct _GstdInstancesClass GstdInstancesClass;
+
+GType gstd_instances_get_type (void);
+
+/**
+ * Creates the node that reports the live instances of every counted
+ * type
+ *
+ * \return A new GstdInstances
+ **/
+GstdInstances *gstd_instances_new (void);
+
+/**
+ * Looks up the instance counter of a type, registering it the first
+ * time the type is seen.
+ *
+ * \param type The type whose instances are counted
+ * \param cache Where the counter of the type is remembered, so the
+ * lookup is a single pointer read afterwards. A cache shared by a type
+ * and its subtypes is replaced by the counter of the last type looked
+ * up.
+ *
+ * \return The counter of the type, valid for the process lifetime
+ **/
+GstdInstanceCount *gstd_instances_get (GType type,
+    GstdInstanceCount ** cache);
+
+/**
+ * Accounts a new instance, call it once the instance is initialized
+ *
+ * \param count The counter of the instance type
+ **/
+void gstd_instances_add (GstdInstanceCount * count);
+
+/**
+ * Accounts a finalized instance
+ *
+ * \param count The counter of the instance type
+ **/
+void gstd_instances_remove (GstdInstanceCount * count);
+
+G_END_DECLS
+#endif // __GSTD_INSTANCES_H__
@@ -39,6 +39,17 @@ GST_DEBUG_CATEGORY_STATIC (gstd_ipc_debug);
 
 G_DEFINE_TYPE (GstdIpc, gstd_ipc, GSTD_TYPE_OBJECT);
 
+typedef struct _GstdIpcWaiter GstdIpcWaiter;
+
+/* The wait function of the IPC serving a thread */
+struct _GstdIpcWaiter
+{
+  GstdIpcWaitFunc func;
+  gpointer user_data;
+};
+
+static GPrivate ipc_waiter = G_PRIVATE_INIT (g_free);
+
 enum
 {
   N_PROPERTIES,                 // NOT A PROPERTY
@@ -184,3 +195,39 @@ gstd_ipc_stop (GstdIpc * ipc)
 
   return ret;
 }
+
+void
+gstd_ipc_set_wait_func (GstdIpcWaitFunc func, gpointer user_data)
+{
+  GstdIpcWaiter *waiter = g_private_get (&ipc_waiter);
+
+  if (!waiter) {
+    waiter = g_new0 (GstdIpcWaiter, 1);
+    g_private_set (&ipc_waiter, waiter);
+  }
+
+  waiter->func = func;
+  waiter->user_data = user_data;
+}
+
+GCancellable *
+gstd_ipc_wait_begin (void)
+{
+  GstdIpcWaiter *waiter = g_private_get (&ipc_waiter);
+
+  if (waiter && waiter->func) {
+    waiter->func (TRUE, waiter->user_data);
+  }
+
+  return g_cancellable_get_current ();
+}
+
+void
+gstd_ipc_wait_end (void)
+{
+  GstdIpcWaiter *waiter = g_private_get (&ipc_waiter);
+
+  if (waiter && waiter->func) {
+    waiter->func (FALSE, waiter->user_data);
+  }
+}
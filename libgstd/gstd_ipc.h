@@ -53,6 +53,7 @@
 #define __GSTD_IPC___
 
 #include <glib.h>
+#include <gio/gio.h>
 
 #include "gstd_return_codes.h"
 #include "gstd_object.h"
@@ -106,5 +107,37 @@ GType gstd_ipc_get_type (void);
 gboolean gstd_ipc_get_option_group (GstdIpc *, GOptionGroup **);
 GstdReturnCode gstd_ipc_start (GstdIpc *, GstdSession *);
 GstdReturnCode gstd_ipc_stop (GstdIpc *);
+
+/**
+ * GstdIpcWaitFunc:
+ * Notifies an IPC that the request it is serving on the current
+ * thread starts (waiting is TRUE) or stops blocking on the daemon
+ */
+typedef void (*GstdIpcWaitFunc) (gboolean waiting, gpointer user_data);
+
+/**
+ * gstd_ipc_set_wait_func:
+ * Installs the wait function of the IPC serving the current thread
+ *
+ * \param func The function to call around blocking waits, or NULL
+ * \param user_data The data to pass to func
+ **/
+void gstd_ipc_set_wait_func (GstdIpcWaitFunc func, gpointer user_data);
+
+/**
+ * gstd_ipc_wait_begin:
+ * Called by requests about to block until something happens in the
+ * daemon, so the IPC can cancel them if their client goes away
+ *
+ * \return The cancellable of the current request, if any
+ **/
+GCancellable *gstd_ipc_wait_begin (void);
+
+/**
+ * gstd_ipc_wait_end:
+ * Called once a request stops blocking, see gstd_ipc_wait_begin()
+ **/
+void gstd_ipc_wait_end (void);
+
 G_END_DECLS
 #endif //__GSTD_IPC___
@@ -0,0 +1,463 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "gstd_journal.h"
+
+/* Gstd Journal debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_journal_debug);
+#define GST_CAT_DEFAULT gstd_journal_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Size of the stdio buffer in front of the journal file */
+#define GSTD_JOURNAL_BUFFER_SIZE (64 * 1024)
+/* Microseconds between flushes of the stdio buffer */
+#define GSTD_JOURNAL_FLUSH_INTERVAL G_USEC_PER_SEC
+/* Length of the file header */
+#define GSTD_JOURNAL_HEADER_SIZE 24
+/* Bytes needed by a 64 bit varint */
+#define GSTD_JOURNAL_VARINT_SIZE 10
+/* Upper bound on a single command, to detect corrupt journals */
+#define GSTD_JOURNAL_MAX_COMMAND (16 * 1024 * 1024)
+
+typedef struct _GstdJournalConnection GstdJournalConnection;
+
+struct _GstdJournalConnection
+{
+  GstdJournalProtocol protocol;
+  guint id;
+};
+
+struct _GstdJournalReader
+{
+  FILE *file;
+  gchar *filename;
+  gint64 start;
+  gint64 time;
+};
+
+static void gstd_journal_init_debug (void);
+static guint gstd_journal_put_varint (guint8 * buffer, guint64 value);
+static gboolean gstd_journal_get_varint (FILE * file, guint64 * value,
+    gboolean * eof);
+static void gstd_journal_set_corrupt (GError ** error,
+    GstdJournalReader * reader, const gchar * what);
+static gpointer gstd_journal_flusher (gpointer data);
+
+static GMutex journal_lock;
+static GCond journal_cond;
+static FILE *journal_file = NULL;
+static gint journal_enabled = FALSE;
+/* Monotonic time of the last record, protected by journal_lock */
+static gint64 journal_last = 0;
+/* Whether records wait in the stdio buffer, protected by journal_lock */
+static gboolean journal_dirty = FALSE;
+/* Flushes the buffer even if no more commands come */
+static GThread *journal_thread = NULL;
+static gint journal_connections = 0;
+static GPrivate current_connection = G_PRIVATE_INIT (g_free);
+
+static void
+gstd_journal_init_debug (void)
+{
+  static gsize init = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&init)) {
+    /* Initialize debug category with nice colors */
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_journal_debug, "gstdjournal", debug_color,
+        "Gstd Journal category");
+    g_once_init_leave (&init, 1);
+  }
+}
+
+static guint
+gstd_journal_put_varint (guint8 * buffer, guint64 value)
+{
+  guint len = 0;
+
+  while (value >= 0x80) {
+    buffer[len++] = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  buffer[len++] = value;
+
+  return len;
+}
+
+static gboolean
+gstd_journal_get_varint (FILE * file, guint64 * value, gboolean * eof)
+{
+  guint shift;
+  gint c;
+
+  *value = 0;
+  for (shift = 0; shift < 64; shift += 7) {
+    c = getc (file);
+    if (EOF == c) {
+      /* Running out right at a record boundary is a clean end */
+      if (eof) {
+        *eof = 0 == shift;
+      }
+      return FALSE;
+    }
+
+    *value |= (guint64) (c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      return TRUE;
+    }
+  }
+
+  if (eof) {
+    *eof = FALSE;
+  }
+  return FALSE;
+}
+
+gboolean
+gstd_journal_open (const gchar * filename, GError ** error)
+{
+  guint8 header[GSTD_JOURNAL_HEADER_SIZE] = { 0 };
+  gint64 start;
+  FILE *file;
+  gint saved_errno;
+  guint i;
+
+  g_return_val_if_fail (filename, FALSE);
+  g_return_val_if_fail (!error || !*error, FALSE);
+
+  gstd_journal_init_debug ();
+
+  file = fopen (filename, "wb");
+  if (!file) {
+    saved_errno = errno;
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+        "Unable to open journal \"%s\": %s", filename,
+        g_strerror (saved_errno));
+    return FALSE;
+  }
+  setvbuf (file, NULL, _IOFBF, GSTD_JOURNAL_BUFFER_SIZE);
+
+  start = g_get_real_time ();
+  memcpy (header, GSTD_JOURNAL_MAGIC, 8);
+  for (i = 0; i < 4; i++) {
+    header[8 + i] = (GSTD_JOURNAL_VERSION >> (8 * i)) & 0xff;
+  }
+  for (i = 0; i < 8; i++) {
+    header[16 + i] = ((guint64) start >> (8 * i)) & 0xff;
+  }
+
+  if (fwrite (header, sizeof (header), 1, file) != 1 || fflush (file)) {
+    saved_errno = errno;
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+        "Unable to write journal \"%s\": %s", filename,
+        g_strerror (saved_errno));
+    fclose (file);
+    return FALSE;
+  }
+
+  /* Reopening replaces the journal being written, if any */
+  gstd_journal_close ();
+
+  g_mutex_lock (&journal_lock);
+  journal_file = file;
+  journal_last = g_get_monotonic_time ();
+  journal_dirty = FALSE;
+  journal_thread = g_thread_new ("gstd-journal", gstd_journal_flusher, NULL);
+  g_atomic_int_set (&journal_enabled, TRUE);
+  g_mutex_unlock (&journal_lock);
+
+  GST_INFO ("Journaling commands to \"%s\"", filename);
+
+  return TRUE;
+}
+
+static gpointer
+gstd_journal_flusher (gpointer data)
+{
+  gint64 deadline;
+
+  g_mutex_lock (&journal_lock);
+  while (journal_file) {
+    if (journal_dirty) {
+      fflush (journal_file);
+      journal_dirty = FALSE;
+    }
+
+    deadline = g_get_monotonic_time () + GSTD_JOURNAL_FLUSH_INTERVAL;
+    g_cond_wait_until (&journal_cond, &journal_lock, deadline);
+  }
+  g_mutex_unlock (&journal_lock);
+
+  return NULL;
+}
+
+void
+gstd_journal_close (void)
+{
+  GThread *thread;
+  FILE *file;
+
+  gstd_journal_init_debug ();
+
+  g_mutex_lock (&journal_lock);
+  g_atomic_int_set (&journal_enabled, FALSE);
+  file = journal_file;
+  journal_file = NULL;
+  thread = journal_thread;
+  journal_thread = NULL;
+  g_cond_signal (&journal_cond);
+  g_mutex_unlock (&journal_lock);
+
+  if (thread) {
+    g_thread_join (thread);
+  }
+
+  if (file) {
+    if (fclose (file)) {
+      GST_ERROR ("Unable to close the journal: %s", g_strerror (errno));
+    } else {
+      GST_INFO ("Closed the journal");
+    }
+  }
+}
+
+guint
+gstd_journal_new_connection (void)
+{
+  guint id;
+
+  /* Zero is reserved for commands not tied to a connection */
+  do {
+    id = g_atomic_int_add (&journal_connections, 1) + 1;
+  } while (0 == id);
+
+  return id;
+}
+
+void
+gstd_journal_set_connection (GstdJournalProtocol protocol, guint connection)
+{
+  GstdJournalConnection *current = g_private_get (&current_connection);
+
+  if (G_UNLIKELY (!current)) {
+    current = g_new0 (GstdJournalConnection, 1);
+    g_private_set (&current_connection, current);
+  }
+
+  current->protocol = connection ? protocol : GSTD_JOURNAL_PROTOCOL_NONE;
+  current->id = connection;
+}
+
+void
+gstd_journal_record (const gchar * command)
+{
+  GstdJournalConnection *current;
+  guint8 prefix[3 * GSTD_JOURNAL_VARINT_SIZE + 1];
+  guint len = 0;
+  gsize size;
+  gint64 now;
+  guint id = 0;
+  guint8 protocol = GSTD_JOURNAL_PROTOCOL_NONE;
+
+  g_return_if_fail (command);
+
+  if (G_LIKELY (!g_atomic_int_get (&journal_enabled))) {
+    return;
+  }
+
+  current = g_private_get (&current_connection);
+  if (current) {
+    id = current->id;
+    protocol = current->protocol;
+  }
+  size = strlen (command);
+
+  g_mutex_lock (&journal_lock);
+  if (!journal_file) {
+    g_mutex_unlock (&journal_lock);
+    return;
+  }
+
+  /* Taking the time under the lock keeps deltas from going negative */
+  now = g_get_monotonic_time ();
+  len += gstd_journal_put_varint (prefix + len, now - journal_last);
+  len += gstd_journal_put_varint (prefix + len, id);
+  prefix[len++] = protocol;
+  len += gstd_journal_put_varint (prefix + len, size);
+  journal_last = now;
+
+  if (fwrite (prefix, len, 1, journal_file) != 1 ||
+      (size && fwrite (command, size, 1, journal_file) != 1)) {
+    GST_ERROR ("Unable to write to the journal, stopping: %s",
+        g_strerror (errno));
+    g_atomic_int_set (&journal_enabled, FALSE);
+  } else {
+    journal_dirty = TRUE;
+  }
+  g_mutex_unlock (&journal_lock);
+}
+
+static void
+gstd_journal_set_corrupt (GError ** error, GstdJournalReader * reader,
+    const gchar * what)
+{
+  g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+      "Journal \"%s\" is corrupt: %s at offset %ld", reader->filename, what,
+      ftell (reader->file));
+}
+
+GstdJournalReader *
+gstd_journal_reader_new (const gchar * filename, GError ** error)
+{
+  guint8 header[GSTD_JOURNAL_HEADER_SIZE];
+  GstdJournalReader *reader;
+  guint32 version = 0;
+  guint64 start = 0;
+  gint saved_errno;
+  gint i;
+
+  g_return_val_if_fail (filename, NULL);
+  g_return_val_if_fail (!error || !*error, NULL);
+
+  reader = g_new0 (GstdJournalReader, 1);
+  reader->filename = g_strdup (filename);
+  reader->file = fopen (filename, "rb");
+  if (!reader->file) {
+    saved_errno = errno;
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+        "Unable to open journal \"%s\": %s", filename,
+        g_strerror (saved_errno));
+    goto error;
+  }
+
+  if (fread (header, sizeof (header), 1, reader->file) != 1 ||
+      memcmp (header, GSTD_JOURNAL_MAGIC, 8)) {
+    gstd_journal_set_corrupt (error, reader, "bad header");
+    goto error;
+  }
+
+  for (i = 3; i >= 0; i--) {
+    version = (version << 8) | header[8 + i];
+  }
+  if (version != GSTD_JOURNAL_VERSION) {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+        "Journal \"%s\" has unsupported version %u", filename, version);
+    goto error;
+  }
+
+  for (i = 7; i >= 0; i--) {
+    start = (start << 8) | header[16 + i];
+  }
+  reader->start = start;
+
+  return reader;
+
+error:
+  gstd_journal_reader_free (reader);
+  return NULL;
+}
+
+gint64
+gstd_journal_reader_get_start (GstdJournalReader * reader)
+{
+  g_return_val_if_fail (reader, 0);
+
+  return reader->start;
+}
+
+gboolean
+gstd_journal_reader_next (GstdJournalReader * reader,
+    GstdJournalRecord * record, GError ** error)
+{
+  guint64 delta;
+  guint64 connection;
+  guint64 size;
+  gboolean eof = FALSE;
+  gint protocol;
+
+  g_return_val_if_fail (reader, FALSE);
+  g_return_val_if_fail (record, FALSE);
+  g_return_val_if_fail (!error || !*error, FALSE);
+
+  memset (record, 0, sizeof (*record));
+
+  /* A journal cut short by a crash ends at the last whole record */
+  if (!gstd_journal_get_varint (reader->file, &delta, &eof)) {
+    if (!eof) {
+      gstd_journal_set_corrupt (error, reader, "truncated record");
+    }
+    return FALSE;
+  }
+
+  if (!gstd_journal_get_varint (reader->file, &connection, NULL)
+      || connection > G_MAXUINT) {
+    gstd_journal_set_corrupt (error, reader, "bad connection");
+    return FALSE;
+  }
+
+  protocol = getc (reader->file);
+  if (EOF == protocol || protocol > GSTD_JOURNAL_PROTOCOL_HTTP) {
+    gstd_journal_set_corrupt (error, reader, "bad protocol");
+    return FALSE;
+  }
+
+  if (!gstd_journal_get_varint (reader->file, &size, NULL)
+      || size > GSTD_JOURNAL_MAX_COMMAND) {
+    gstd_journal_set_corrupt (error, reader, "bad command length");
+    return FALSE;
+  }
+
+  record->command = g_malloc (size + 1);
+  if (size && fread (record->command, size, 1, reader->file) != 1) {
+    g_clear_pointer (&record->command, g_free);
+    gstd_journal_set_corrupt (error, reader, "truncated command");
+    return FALSE;
+  }
+  record->command[size] = '\0';
+
+  reader->time += delta;
+  record->time = reader->time;
+  record->connection = connection;
+  record->protocol = protocol;
+
+  return TRUE;
+}
+
+void
+gstd_journal_reader_free (GstdJournalReader * reader)
+{
+  g_return_if_fail (reader);
+
+  if (reader->file) {
+    fclose (reader->file);
+  }
+  g_free (reader->filename);
+  g_free (reader);
+}
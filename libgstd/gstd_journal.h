@@ -0,0 +1,166 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_JOURNAL_H__
+#define __GSTD_JOURNAL_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Journal file layout, integers are little endian:
+ *
+ *   header:  "GSTDJRNL" | u32 version | u32 reserved | i64 start
+ *   record:  varint delta | varint connection | u8 protocol |
+ *            varint length | command bytes, no terminator
+ *
+ * start is the wall clock time the journal was opened, in microseconds
+ * since the epoch. delta is the monotonic time in microseconds since
+ * the previous record, or since start for the first one. Varints are
+ * unsigned LEB128.
+ */
+#define GSTD_JOURNAL_MAGIC "GSTDJRNL"
+#define GSTD_JOURNAL_VERSION 1
+
+/**
+ * GstdJournalProtocol:
+ * @GSTD_JOURNAL_PROTOCOL_NONE: Not received through an IPC
+ * @GSTD_JOURNAL_PROTOCOL_TCP: Received over TCP
+ * @GSTD_JOURNAL_PROTOCOL_UNIX: Received over a unix socket
+ * @GSTD_JOURNAL_PROTOCOL_HTTP: Received over HTTP, journaled as the
+ * command it was translated to
+ */
+typedef enum _GstdJournalProtocol GstdJournalProtocol;
+
+enum _GstdJournalProtocol
+{
+  GSTD_JOURNAL_PROTOCOL_NONE,
+  GSTD_JOURNAL_PROTOCOL_TCP,
+  GSTD_JOURNAL_PROTOCOL_UNIX,
+  GSTD_JOURNAL_PROTOCOL_HTTP,
+};
+
+typedef struct _GstdJournalRecord GstdJournalRecord;
+typedef struct _GstdJournalReader GstdJournalReader;
+
+/**
+ * GstdJournalRecord:
+ * @time: Microseconds since the journal was opened
+ * @connection: The connection the command arrived on, 0 if none
+ * @protocol: The IPC the command arrived on
+ * @command: The command as given to the parser
+ */
+struct _GstdJournalRecord
+{
+  gint64 time;
+  guint connection;
+  GstdJournalProtocol protocol;
+  gchar *command;
+};
+
+/**
+ * gstd_journal_open:
+ * @filename: Where to write the journal, truncated if it exists
+ * @error: Return location for a #GError
+ *
+ * Starts journaling every command given to the parser. Records are
+ * buffered and flushed to the file by a background thread at least
+ * once per second.
+ *
+ * Returns: TRUE if the journal was opened
+ */
+gboolean gstd_journal_open (const gchar * filename, GError ** error);
+
+/**
+ * gstd_journal_close:
+ *
+ * Flushes and closes the journal, if open.
+ */
+void gstd_journal_close (void);
+
+/**
+ * gstd_journal_new_connection:
+ *
+ * Returns: A new process wide connection id, never 0
+ */
+guint gstd_journal_new_connection (void);
+
+/**
+ * gstd_journal_set_connection:
+ * @protocol: The IPC serving the calling thread
+ * @connection: The connection served by the calling thread, 0 once done
+ *
+ * Tags the commands parsed from now on by the calling thread.
+ */
+void gstd_journal_set_connection (GstdJournalProtocol protocol,
+    guint connection);
+
+/**
+ * gstd_journal_record:
+ * @command: The command about to be parsed
+ *
+ * Appends @command to the journal, tagged with the calling thread
+ * connection. This is a single atomic read when not journaling.
+ */
+void gstd_journal_record (const gchar * command);
+
+/**
+ * gstd_journal_reader_new:
+ * @filename: A journal written by gstd_journal_open()
+ * @error: Return location for a #GError
+ *
+ * Returns: (transfer full) (nullable): A reader positioned at the first
+ * record, free it with gstd_journal_reader_free()
+ */
+GstdJournalReader *gstd_journal_reader_new (const gchar * filename,
+    GError ** error);
+
+/**
+ * gstd_journal_reader_get_start:
+ * @reader: A #GstdJournalReader
+ *
+ * Returns: The wall clock time the journal was opened, in microseconds
+ * since the epoch
+ */
+gint64 gstd_journal_reader_get_start (GstdJournalReader * reader);
+
+/**
+ * gstd_journal_reader_next:
+ * @reader: A #GstdJournalReader
+ * @record: (out caller-allocates): The next record, free its command
+ * with g_free()
+ * @error: Return location for a #GError
+ *
+ * Returns: TRUE if a record was read, FALSE at the end of the journal
+ * or if it is truncated or corrupt, in which case @error is set
+ */
+gboolean gstd_journal_reader_next (GstdJournalReader * reader,
+    GstdJournalRecord * record, GError ** error);
+
+/**
+ * gstd_journal_reader_free:
+ * @reader: (transfer full): A #GstdJournalReader
+ */
+void gstd_journal_reader_free (GstdJournalReader * reader);
+
+G_END_DECLS
+
+#endif // __GSTD_JOURNAL_H__
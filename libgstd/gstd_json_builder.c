@@ -20,6 +20,7 @@
 
 #include "gstd_json_builder.h"
 #include "gstd_iformatter.h"
+#include "gstd_instances.h"
 #include <json-glib/json-glib.h>
 
 
@@ -57,6 +58,9 @@ static void gstd_iformatter_interface_init (GstdIFormatterInterface * iface);
 
 static void gstd_json_builder_finalize (GObject * object);
 
+/* Formatters are not GstdObjects, they are counted here */
+static GstdInstanceCount *json_builder_instances = NULL;
+
 G_DEFINE_TYPE_WITH_CODE (GstdJsonBuilder, gstd_json_builder, G_TYPE_OBJECT,
     G_IMPLEMENT_INTERFACE (GSTD_TYPE_IFORMATTER,
         gstd_iformatter_interface_init));
@@ -81,6 +85,9 @@ gstd_json_builder_init (GstdJsonBuilder * self)
   GST_INFO_OBJECT (self, "Initializing Json builder");
 
   self->json_builder = json_builder_new ();
+
+  gstd_instances_add (gstd_instances_get (GSTD_TYPE_JSON_BUILDER,
+          &json_builder_instances));
 }
 
 static void
@@ -254,6 +261,7 @@ gstd_json_builder_finalize (GObject * object)
   GST_DEBUG_OBJECT (self, "finalize");
 
   g_object_unref (self->json_builder);
+  gstd_instances_remove (json_builder_instances);
   G_OBJECT_CLASS (gstd_json_builder_parent_class)->finalize (object);
 }
 
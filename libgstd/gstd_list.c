@@ -27,6 +27,7 @@
 #include <string.h>
 
 #include "gstd_list.h"
+#include "gstd_lock_stats.h"
 #include "gstd_object.h"
 
 enum
@@ -246,6 +247,7 @@ gstd_list_delete (GstdObject * object, const gchar * node)
   GstdObject *todelete;
   GList *found;
   GstdReturnCode ret;
+  gint64 lock;
 
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (node, GSTD_NULL_ARGUMENT);
@@ -255,11 +257,11 @@ gstd_list_delete (GstdObject * object, const gchar * node)
   g_return_val_if_fail (object->deleter, GSTD_MISSING_INITIALIZATION);
 
   /* Test if the resource to delete exists */
-  GST_OBJECT_LOCK (self);
+  lock = GSTD_OBJECT_LOCK_SITE (self, GSTD_LOCK_SITE_LIST_DELETE);
   found = g_list_find_custom (self->list, node, gstd_list_find_node);
 
   if (!found) {
-    GST_OBJECT_UNLOCK (self);
+    GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_DELETE, lock);
     goto unexisting;
   }
 
@@ -270,14 +272,14 @@ gstd_list_delete (GstdObject * object, const gchar * node)
 
   ret = gstd_ideleter_delete (object->deleter, todelete);
   if (ret) {
-    GST_OBJECT_UNLOCK (self);
+    GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_DELETE, lock);
     return ret;
   }
 
   self->count--;
 
   self->list = g_list_delete_link (self->list, found);
-  GST_OBJECT_UNLOCK (self);
+  GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_DELETE, lock);
 
   return ret;
 
@@ -332,11 +334,12 @@ gstd_list_find_child (GstdList * self, const gchar * name)
 {
   GList *result;
   GstdObject *child;
+  gint64 lock;
 
   g_return_val_if_fail (self, NULL);
   g_return_val_if_fail (name, NULL);
 
-  GST_OBJECT_LOCK (self);
+  lock = GSTD_OBJECT_LOCK_SITE (self, GSTD_LOCK_SITE_LIST_FIND);
   result = g_list_find_custom (self->list, name, gstd_list_find_node);
 
 
@@ -345,7 +348,7 @@ gstd_list_find_child (GstdList * self, const gchar * name)
   } else {
     child = NULL;
   }
-  GST_OBJECT_UNLOCK (self);
+  GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_FIND, lock);
 
   return child;
 }
@@ -354,23 +357,24 @@ gboolean
 gstd_list_append_child (GstdList * self, GstdObject * child)
 {
   GList *found;
+  gint64 lock;
 
   g_return_val_if_fail (self, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (child, GSTD_NULL_ARGUMENT);
 
   /* Test if the resource to create already exists */
-  GST_OBJECT_LOCK (self);
+  lock = GSTD_OBJECT_LOCK_SITE (self, GSTD_LOCK_SITE_LIST_APPEND);
   found =
       g_list_find_custom (self->list, GSTD_OBJECT_NAME (child),
       gstd_list_find_node);
   if (found) {
-    GST_OBJECT_UNLOCK (self);
+    GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_APPEND, lock);
     goto exists;
   }
 
   self->list = g_list_append (self->list, child);
   self->count = g_list_length (self->list);
-  GST_OBJECT_UNLOCK (self);
+  GSTD_OBJECT_UNLOCK_SITE (self, GSTD_LOCK_SITE_LIST_APPEND, lock);
   GST_INFO_OBJECT (self, "Appended %s to %s list", GSTD_OBJECT_NAME (child),
       GSTD_OBJECT_NAME (self));
 
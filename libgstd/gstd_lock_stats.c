@@ -0,0 +1,365 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstd_lock_stats.h"
+#include "gstd_atomic.h"
+#include "gstd_property_reader.h"
+#include "gstd_shards.h"
+
+/* Gstd Lock Stats debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_lock_stats_debug);
+#define GST_CAT_DEFAULT gstd_lock_stats_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+enum
+{
+  PROP_ENABLED = 1,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+typedef struct _GstdLockSiteStats GstdLockSiteStats;
+typedef struct _GstdLockShard GstdLockShard;
+
+/* Times are in nanoseconds */
+struct _GstdLockSiteStats
+{
+  guint64 acquisitions;
+  guint64 contended;
+  guint64 wait;
+  guint64 wait_max;
+  guint64 hold;
+  guint64 hold_max;
+};
+
+/* Statistics of the locks taken by a single thread, so accounting a
+ * lock adds no contention of its own. A shard found with an old
+ * generation holds a previous measurement and is cleared by its owner.
+ */
+struct _GstdLockShard
+{
+  GstdShard shard;
+  GstdLockSiteStats sites[GSTD_LOCK_N_SITES];
+};
+
+/**
+ * GstdLockStats:
+ * Reports how long requests wait for and hold the daemon locks
+ */
+struct _GstdLockStats
+{
+  GstdObject parent;
+};
+
+struct _GstdLockStatsClass
+{
+  GstdObjectClass parent_class;
+};
+
+static const gchar *site_names[GSTD_LOCK_N_SITES] = {
+  [GSTD_LOCK_SITE_LIST_APPEND] = "list-append",
+  [GSTD_LOCK_SITE_LIST_FIND] = "list-find",
+  [GSTD_LOCK_SITE_LIST_DELETE] = "list-delete",
+  [GSTD_LOCK_SITE_LIST_SNAPSHOT] = "list-snapshot",
+  [GSTD_LOCK_SITE_SESSION_CREATE_REF] = "session-create-ref",
+  [GSTD_LOCK_SITE_SESSION_DELETE_REF] = "session-delete-ref",
+  [GSTD_LOCK_SITE_PIPELINE_PLAY_REF] = "pipeline-play-ref",
+  [GSTD_LOCK_SITE_PIPELINE_STOP_REF] = "pipeline-stop-ref",
+  [GSTD_LOCK_SITE_HTTP_REQUEST] = "http-request",
+  [GSTD_LOCK_SITE_HTTP_REPLY] = "http-reply",
+  [GSTD_LOCK_SITE_HTTP_PAUSE] = "http-pause",
+};
+
+G_DEFINE_TYPE (GstdLockStats, gstd_lock_stats, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static void gstd_lock_stats_set_property (GObject *, guint, const GValue *,
+    GParamSpec *);
+static void gstd_lock_stats_get_property (GObject *, guint, GValue *,
+    GParamSpec *);
+static GstdReturnCode
+gstd_lock_stats_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_lock_shard_clear (gpointer data, gpointer user_data);
+static void gstd_lock_shard_merge (gpointer data, gpointer user_data);
+
+static GstdShards lock_shards = GSTD_SHARDS_INIT (GstdLockShard,
+    gstd_lock_shard_clear, gstd_lock_shard_merge);
+static gint lock_stats_enabled = FALSE;
+
+static void
+gstd_lock_stats_class_init (GstdLockStatsClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  oclass->set_property = gstd_lock_stats_set_property;
+  oclass->get_property = gstd_lock_stats_get_property;
+
+  properties[PROP_ENABLED] =
+      g_param_spec_boolean ("enabled",
+      "Enabled",
+      "Account lock waits and holds, enabling clears previous statistics",
+      FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (oclass, N_PROPERTIES, properties);
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_lock_stats_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_lock_stats_debug, "gstdlockstats",
+      debug_color, "Gstd Lock Stats category");
+}
+
+static void
+gstd_lock_stats_init (GstdLockStats * self)
+{
+  GST_INFO_OBJECT (self, "Initializing lock stats");
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static void
+gstd_lock_stats_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdLockStats *self = GSTD_LOCK_STATS (object);
+  gboolean enabled;
+
+  switch (property_id) {
+    case PROP_ENABLED:
+      enabled = g_atomic_int_get (&lock_stats_enabled);
+      GST_DEBUG_OBJECT (self, "Returning lock stats enabled %d", enabled);
+      g_value_set_boolean (value, enabled);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_lock_stats_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdLockStats *self = GSTD_LOCK_STATS (object);
+  gboolean enabled;
+
+  switch (property_id) {
+    case PROP_ENABLED:
+      enabled = g_value_get_boolean (value);
+      GST_INFO_OBJECT (self, "Changing lock stats enabled to %d", enabled);
+      gstd_lock_stats_set_enabled (enabled);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_lock_shard_clear (gpointer data, gpointer user_data)
+{
+  GstdLockShard *shard = data;
+
+  /* Readers skip the shard until its generation is updated */
+  memset (shard->sites, 0, sizeof (shard->sites));
+}
+
+static void
+gstd_lock_shard_merge (gpointer data, gpointer user_data)
+{
+  const GstdLockShard *src = data;
+  GstdLockShard *dest = user_data;
+  const GstdLockSiteStats *from;
+  GstdLockSiteStats *to;
+  guint i;
+
+  for (i = 0; i < GSTD_LOCK_N_SITES; i++) {
+    from = &src->sites[i];
+    to = &dest->sites[i];
+
+    to->acquisitions += gstd_atomic_uint64_get (&from->acquisitions);
+    to->contended += gstd_atomic_uint64_get (&from->contended);
+    to->wait += gstd_atomic_uint64_get (&from->wait);
+    to->wait_max = MAX (to->wait_max,
+        gstd_atomic_uint64_get (&from->wait_max));
+    to->hold += gstd_atomic_uint64_get (&from->hold);
+    to->hold_max = MAX (to->hold_max,
+        gstd_atomic_uint64_get (&from->hold_max));
+  }
+}
+
+void
+gstd_lock_stats_set_enabled (gboolean enabled)
+{
+  if (enabled) {
+    /* Every shard clears itself on its next lock */
+    gstd_shards_reset (&lock_shards);
+  }
+  g_atomic_int_set (&lock_stats_enabled, enabled);
+}
+
+gint64
+gstd_lock_stats_lock (GMutex * mutex, GstdLockSite site)
+{
+  GstdLockShard *shard;
+  GstdLockSiteStats *stats;
+  GstClockTime start;
+  GstClockTime now;
+  guint64 wait;
+
+  if (G_LIKELY (!g_atomic_int_get (&lock_stats_enabled))
+      || G_UNLIKELY (site >= GSTD_LOCK_N_SITES)) {
+    g_mutex_lock (mutex);
+    return 0;
+  }
+
+  shard = gstd_shards_get (&lock_shards);
+  stats = &shard->sites[site];
+
+  /* Only waits that actually blocked count as contention */
+  if (g_mutex_trylock (mutex)) {
+    now = gst_util_get_timestamp ();
+  } else {
+    start = gst_util_get_timestamp ();
+    g_mutex_lock (mutex);
+    now = gst_util_get_timestamp ();
+
+    /* Only the owning thread writes the shard, but readers load it
+     * concurrently, so the updates must not tear */
+    wait = now - start;
+    gstd_atomic_uint64_owner_inc (&stats->contended);
+    gstd_atomic_uint64_owner_add (&stats->wait, wait);
+    if (wait > stats->wait_max) {
+      gstd_atomic_uint64_set (&stats->wait_max, wait);
+    }
+  }
+  gstd_atomic_uint64_owner_inc (&stats->acquisitions);
+
+  return now;
+}
+
+void
+gstd_lock_stats_unlock (GMutex * mutex, GstdLockSite site, gint64 token)
+{
+  GstdLockShard *shard;
+  GstdLockSiteStats *stats;
+  guint64 hold;
+
+  /* Locks taken while disabled are not accounted */
+  if (G_LIKELY (0 == token) || site >= GSTD_LOCK_N_SITES) {
+    g_mutex_unlock (mutex);
+    return;
+  }
+
+  hold = gst_util_get_timestamp () - token;
+  g_mutex_unlock (mutex);
+
+  shard = gstd_shards_get (&lock_shards);
+  stats = &shard->sites[site];
+  gstd_atomic_uint64_owner_add (&stats->hold, hold);
+  if (hold > stats->hold_max) {
+    gstd_atomic_uint64_set (&stats->hold_max, hold);
+  }
+}
+
+static GstdReturnCode
+gstd_lock_stats_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdIFormatter *formatter;
+  GstdLockShard total;
+  GstdLockSiteStats *totals = total.sites;
+  GValue enabled = G_VALUE_INIT;
+  guint i;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  /* Shards being written may be a few locks behind, which is fine for
+     statistics */
+  memset (&total, 0, sizeof (total));
+  gstd_shards_foreach (&lock_shards, gstd_lock_shard_merge, &total);
+
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (obj));
+
+  g_value_init (&enabled, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&enabled, g_atomic_int_get (&lock_stats_enabled));
+  gstd_iformatter_set_member_name (formatter, "enabled");
+  gstd_iformatter_set_value (formatter, &enabled);
+  g_value_unset (&enabled);
+
+  gstd_iformatter_set_member_name (formatter, "sites");
+  gstd_iformatter_begin_array (formatter);
+
+  for (i = 0; i < GSTD_LOCK_N_SITES; i++) {
+    gstd_iformatter_begin_object (formatter);
+
+    gstd_iformatter_set_member_name (formatter, "name");
+    gstd_iformatter_set_string_value (formatter, site_names[i]);
+
+    gstd_iformatter_set_member_name (formatter, "acquisitions");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].acquisitions);
+    gstd_iformatter_set_member_name (formatter, "contended");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].contended);
+    gstd_iformatter_set_member_name (formatter, "wait-ns");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].wait);
+    gstd_iformatter_set_member_name (formatter, "wait-max-ns");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].wait_max);
+    gstd_iformatter_set_member_name (formatter, "hold-ns");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].hold);
+    gstd_iformatter_set_member_name (formatter, "hold-max-ns");
+    gstd_iformatter_set_uint64_value (formatter, totals[i].hold_max);
+
+    gstd_iformatter_end_object (formatter);
+  }
+
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdLockStats *
+gstd_lock_stats_new (void)
+{
+  return g_object_new (GSTD_TYPE_LOCK_STATS, "name", "locks", NULL);
+}
@@ -0,0 +1,115 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_LOCK_STATS_H__
+#define __GSTD_LOCK_STATS_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstdLockSite:
+ * The places where requests serialize on a lock. Sites are accounted
+ * separately even when they share a lock, so the report tells which
+ * code path holds it the longest.
+ */
+typedef enum _GstdLockSite GstdLockSite;
+
+enum _GstdLockSite
+{
+  GSTD_LOCK_SITE_LIST_APPEND,
+  GSTD_LOCK_SITE_LIST_FIND,
+  GSTD_LOCK_SITE_LIST_DELETE,
+  GSTD_LOCK_SITE_LIST_SNAPSHOT,
+  GSTD_LOCK_SITE_SESSION_CREATE_REF,
+  GSTD_LOCK_SITE_SESSION_DELETE_REF,
+  GSTD_LOCK_SITE_PIPELINE_PLAY_REF,
+  GSTD_LOCK_SITE_PIPELINE_STOP_REF,
+  GSTD_LOCK_SITE_HTTP_REQUEST,
+  GSTD_LOCK_SITE_HTTP_REPLY,
+  GSTD_LOCK_SITE_HTTP_PAUSE,
+  GSTD_LOCK_N_SITES
+};
+
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_LOCK_STATS \
+  (gstd_lock_stats_get_type())
+#define GSTD_LOCK_STATS(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_LOCK_STATS,GstdLockStats))
+#define GSTD_LOCK_STATS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_LOCK_STATS,GstdLockStatsClass))
+#define GSTD_IS_LOCK_STATS(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_LOCK_STATS))
+#define GSTD_IS_LOCK_STATS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_LOCK_STATS))
+#define GSTD_LOCK_STATS_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_LOCK_STATS, GstdLockStatsClass))
+typedef struct _GstdLockStats GstdLockStats;
+typedef struct _GstdLockStatsClass GstdLockStatsClass;
+
+GType gstd_lock_stats_get_type (void);
+
+/**
+ * Creates the node that reports the lock statistics
+ *
+ * \return A new GstdLockStats
+ **/
+GstdLockStats *gstd_lock_stats_new (void);
+
+/**
+ * Starts or stops accounting the lock sites. Starting clears the
+ * previous statistics.
+ *
+ * \param enabled Whether to account the lock sites
+ **/
+void gstd_lock_stats_set_enabled (gboolean enabled);
+
+/**
+ * Locks a mutex, accounting the wait at a site while enabled.
+ *
+ * \param mutex The mutex to lock
+ * \param site Where the mutex is being locked
+ *
+ * \return A token to hand to gstd_lock_stats_unlock()
+ **/
+gint64 gstd_lock_stats_lock (GMutex * mutex, GstdLockSite site);
+
+/**
+ * Unlocks a mutex, accounting the hold time at a site while enabled.
+ *
+ * \param mutex The mutex to unlock
+ * \param site Where the mutex was locked
+ * \param token What gstd_lock_stats_lock() returned
+ **/
+void gstd_lock_stats_unlock (GMutex * mutex, GstdLockSite site,
+    gint64 token);
+
+#define GSTD_OBJECT_LOCK_SITE(obj, site) \
+  gstd_lock_stats_lock (GST_OBJECT_GET_LOCK (obj), site)
+#define GSTD_OBJECT_UNLOCK_SITE(obj, site, token) \
+  gstd_lock_stats_unlock (GST_OBJECT_GET_LOCK (obj), site, token)
+
+G_END_DECLS
+#endif // __GSTD_LOCK_STATS_H__
@@ -27,6 +27,10 @@
 #include <gst/gst.h>
 #include <glib/gstdio.h>
 #include <string.h>
+#include <unistd.h>
+
+#include "gstd_metrics.h"
+#include "gstd_pipeline_debug.h"
 
 GST_DEBUG_CATEGORY (gstd_debug);
 
@@ -35,10 +39,79 @@ GST_DEBUG_CATEGORY (gstd_debug);
 #define GSTD_DEBUG_PREFIX "gstd"
 #define GSTD_DEBUG_LEVEL "WARNING"
 
+/* Per thread ring capacity, must be a power of two */
+#define GSTD_LOG_RING_SIZE (64 * 1024)
+/* Largest record, longer lines are dropped */
+#define GSTD_LOG_MAX_RECORD (GSTD_LOG_RING_SIZE / 4)
+/* How often the writer drains the rings */
+#define GSTD_LOG_FLUSH_INTERVAL (20 * G_TIME_SPAN_MILLISECOND)
+/* Records are aligned so their headers never straddle the ring end */
+#define GSTD_LOG_ALIGN(size) (((size) + 7) & ~7)
+#define GSTD_LOG_PADDING G_MAXUINT32
+
+typedef enum _GstdLogTarget GstdLogTarget;
+typedef struct _GstdLogFile GstdLogFile;
+typedef struct _GstdLogRecord GstdLogRecord;
+typedef struct _GstdLogRing GstdLogRing;
+
+enum _GstdLogTarget
+{
+  GSTD_LOG_TARGET_GSTD,
+  GSTD_LOG_TARGET_GST,
+  GSTD_LOG_N_TARGETS
+};
+
+struct _GstdLogFile
+{
+  gchar *filename;
+  FILE *file;
+  /* Bytes in the current file, to know when to rotate it */
+  guint64 size;
+  /* Records lost because a ring was full */
+  GstdMetricsGauge *dropped_gauge;
+  gint dropped;
+  gint reported;
+};
+
+/* Precedes every record in a ring. Padding records fill the space
+ * left at the end of the ring when the next record does not fit. */
+struct _GstdLogRecord
+{
+  guint32 length;
+  guint32 target;
+};
+
+/* A single producer, single consumer ring. Only the logging thread
+ * moves the head and only the writer moves the tail, so neither side
+ * takes a lock. Indexes grow freely and wrap on their own, since the
+ * size divides 2^32.
+ */
+struct _GstdLogRing
+{
+  gint head;
+  gint tail;
+  gint retired;
+  gchar data[GSTD_LOG_RING_SIZE];
+};
+
 static const gchar *gstd_log_get_gstd_default (void);
 static const gchar *gstd_log_get_gst_default (void);
 static gchar *gstd_log_get_filename (const gchar * filename,
     const gchar * default_filename);
+static gboolean gstd_log_file_open (GstdLogFile * log, const gchar * name,
+    const gchar * filename, const gchar * default_filename);
+static void gstd_log_file_rotate (GstdLogFile * log);
+static void gstd_log_file_close (GstdLogFile * log);
+static GstdLogRing *gstd_log_ring_get (void);
+static void gstd_log_ring_retire (gpointer data);
+static void gstd_log_ring_push (GstdLogRing * ring, GstdLogTarget target,
+    const gchar * line, gsize length);
+static gboolean gstd_log_ring_drain (GstdLogRing * ring);
+static void gstd_log_drain (void);
+static gpointer gstd_log_writer (gpointer data);
+static gchar *gstd_log_format (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message);
 
 static void
 gstd_log_proxy (GstDebugCategory * category, GstDebugLevel level,
@@ -46,36 +119,35 @@ gstd_log_proxy (GstDebugCategory * category, GstDebugLevel level,
     GstDebugMessage * message, gpointer user_data)
     G_GNUC_NO_INSTRUMENT;
 
-     static FILE *_gstdlog = NULL;
-     static FILE *_gstlog = NULL;
-     static gchar *gstd_filename = NULL;
-     static gchar *gst_filename = NULL;
+     static GstdLogFile logs[GSTD_LOG_N_TARGETS];
+     static guint64 rotate_size = 0;
+     static gint rotate_count = 0;
+
+     static GMutex rings_lock;
+     static GCond writer_cond;
+     static GList *rings = NULL;
+     static GThread *writer = NULL;
+     static gboolean writer_stop = FALSE;
+     static GPrivate current_ring = G_PRIVATE_INIT (gstd_log_ring_retire);
 
 gboolean
-gstd_log_init (const gchar * gstdfilename, const gchar * gstfilename)
+gstd_log_init (const gchar * gstdfilename, const gchar * gstfilename,
+    guint64 max_size, gint max_files)
 {
-  if (_gstdlog) {
+  if (logs[GSTD_LOG_TARGET_GSTD].file) {
     return TRUE;
   }
 
-  gstd_filename =
-      gstd_log_get_filename (gstdfilename, gstd_log_get_gstd_default ());
+  rotate_size = max_size;
+  rotate_count = max_files;
 
-  _gstdlog = g_fopen (gstd_filename, "a+");
-
-  if (!_gstdlog) {
-    g_printerr ("Unable to open Gstd log file %s: %s\n", gstd_filename,
-        g_strerror (errno));
+  if (!gstd_log_file_open (&logs[GSTD_LOG_TARGET_GSTD], "gstd", gstdfilename,
+          gstd_log_get_gstd_default ())) {
     return FALSE;
   }
 
-  gst_filename =
-      gstd_log_get_filename (gstfilename, gstd_log_get_gst_default ());
-  _gstlog = g_fopen (gst_filename, "a+");
-
-  if (!_gstlog) {
-    g_printerr ("Unable to open Gst log file %s: %s\n", gst_filename,
-        g_strerror (errno));
+  if (!gstd_log_file_open (&logs[GSTD_LOG_TARGET_GST], "gst", gstfilename,
+          gstd_log_get_gst_default ())) {
     return FALSE;
   }
 
@@ -85,6 +157,18 @@ gstd_log_init (const gchar * gstdfilename, const gchar * gstfilename)
   return TRUE;
 }
 
+void
+gstd_log_start (void)
+{
+  if (!logs[GSTD_LOG_TARGET_GSTD].file || writer) {
+    return;
+  }
+
+  /* Records logged until now wait in the rings */
+  writer_stop = FALSE;
+  writer = g_thread_new ("gstd-log", gstd_log_writer, NULL);
+}
+
 void
 gstd_debug_init (void)
 {
@@ -101,15 +185,320 @@ gstd_debug_init (void)
 void
 gstd_log_deinit (void)
 {
-  g_free (gstd_filename);
-  g_free (gst_filename);
+  gint target;
 
-  if (!_gstdlog) {
+  if (!logs[GSTD_LOG_TARGET_GSTD].file) {
+    for (target = 0; target < GSTD_LOG_N_TARGETS; target++) {
+      g_clear_pointer (&logs[target].filename, g_free);
+    }
     return;
   }
 
-  fclose (_gstdlog);
-  fclose (_gstlog);
+  gst_debug_remove_log_function (gstd_log_proxy);
+
+  if (writer) {
+    g_mutex_lock (&rings_lock);
+    writer_stop = TRUE;
+    g_cond_signal (&writer_cond);
+    g_mutex_unlock (&rings_lock);
+
+    g_thread_join (writer);
+    writer = NULL;
+  }
+
+  /* Whatever the writer did not get to */
+  gstd_log_drain ();
+
+  for (target = 0; target < GSTD_LOG_N_TARGETS; target++) {
+    gstd_log_file_close (&logs[target]);
+  }
+}
+
+static gboolean
+gstd_log_file_open (GstdLogFile * log, const gchar * name,
+    const gchar * filename, const gchar * default_filename)
+{
+  GStatBuf status;
+  gchar *labels;
+
+  log->filename = gstd_log_get_filename (filename, default_filename);
+  log->file = g_fopen (log->filename, "a+");
+
+  if (!log->file) {
+    g_printerr ("Unable to open %s log file %s: %s\n",
+        0 == g_strcmp0 (name, "gstd") ? "Gstd" : "Gst", log->filename,
+        g_strerror (errno));
+    return FALSE;
+  }
+
+  log->size = 0;
+  if (0 == g_stat (log->filename, &status)) {
+    log->size = status.st_size;
+  }
+
+  labels = g_strdup_printf ("log=\"%s\"", name);
+  log->dropped_gauge = gstd_metrics_gauge_get ("gstd_log_dropped_records",
+      "Log records dropped because the logging thread outpaced the writer",
+      labels);
+  g_free (labels);
+
+  return TRUE;
+}
+
+static void
+gstd_log_file_close (GstdLogFile * log)
+{
+  if (log->file) {
+    fclose (log->file);
+    log->file = NULL;
+  }
+
+  g_clear_pointer (&log->filename, g_free);
+}
+
+/* Shifts log.1 to log.2 and so on, dropping the oldest file */
+static void
+gstd_log_file_rotate (GstdLogFile * log)
+{
+  gchar *older;
+  gchar *newer;
+  gint i;
+
+  fclose (log->file);
+
+  for (i = rotate_count; i > 0; i--) {
+    older = g_strdup_printf ("%s.%d", log->filename, i);
+    if (i > 1) {
+      newer = g_strdup_printf ("%s.%d", log->filename, i - 1);
+    } else {
+      newer = g_strdup (log->filename);
+    }
+
+    g_rename (newer, older);
+
+    g_free (older);
+    g_free (newer);
+  }
+
+  /* Without backups the log simply starts over */
+  log->file = g_fopen (log->filename, rotate_count > 0 ? "a+" : "w+");
+  log->size = 0;
+
+  if (!log->file) {
+    g_printerr ("Unable to reopen log file %s: %s\n", log->filename,
+        g_strerror (errno));
+  }
+}
+
+static GstdLogRing *
+gstd_log_ring_get (void)
+{
+  GstdLogRing *ring = g_private_get (&current_ring);
+
+  /* Threads only get a ring once they log */
+  if (G_UNLIKELY (!ring)) {
+    ring = g_new0 (GstdLogRing, 1);
+
+    g_mutex_lock (&rings_lock);
+    rings = g_list_prepend (rings, ring);
+    g_mutex_unlock (&rings_lock);
+
+    g_private_set (&current_ring, ring);
+  }
+
+  return ring;
+}
+
+static void
+gstd_log_ring_retire (gpointer data)
+{
+  GstdLogRing *ring = data;
+
+  /* The writer frees the ring once it is drained */
+  g_atomic_int_set (&ring->retired, TRUE);
+}
+
+static void
+gstd_log_ring_push (GstdLogRing * ring, GstdLogTarget target,
+    const gchar * line, gsize length)
+{
+  GstdLogRecord *record;
+  guint32 head;
+  guint32 tail;
+  guint32 offset;
+  guint32 padding = 0;
+  guint32 size;
+
+  head = (guint32) ring->head;
+  tail = (guint32) g_atomic_int_get (&ring->tail);
+  size = GSTD_LOG_ALIGN (sizeof (GstdLogRecord) + length);
+  offset = head & (GSTD_LOG_RING_SIZE - 1);
+
+  if (offset + size > GSTD_LOG_RING_SIZE) {
+    padding = GSTD_LOG_RING_SIZE - offset;
+  }
+
+  if (length > GSTD_LOG_MAX_RECORD
+      || head - tail + padding + size > GSTD_LOG_RING_SIZE) {
+    g_atomic_int_inc (&logs[target].dropped);
+    gstd_metrics_gauge_inc (logs[target].dropped_gauge);
+    return;
+  }
+
+  if (padding) {
+    record = (GstdLogRecord *) (ring->data + offset);
+    record->length = padding;
+    record->target = GSTD_LOG_PADDING;
+    head += padding;
+    offset = 0;
+  }
+
+  record = (GstdLogRecord *) (ring->data + offset);
+  record->length = length;
+  record->target = target;
+  memcpy (record + 1, line, length);
+
+  /* Publishes the record to the writer */
+  g_atomic_int_set (&ring->head, (gint) (head + size));
+}
+
+/* Writes the pending records of a ring, returns whether it had any */
+static gboolean
+gstd_log_ring_drain (GstdLogRing * ring)
+{
+  GstdLogRecord *record;
+  GstdLogFile *log;
+  guint32 head;
+  guint32 tail;
+
+  head = (guint32) g_atomic_int_get (&ring->head);
+  tail = (guint32) ring->tail;
+
+  if (head == tail) {
+    return FALSE;
+  }
+
+  while (tail != head) {
+    record = (GstdLogRecord *) (ring->data + (tail & (GSTD_LOG_RING_SIZE -
+                1)));
+
+    if (GSTD_LOG_PADDING == record->target) {
+      tail += record->length;
+      continue;
+    }
+
+    log = &logs[record->target];
+    if (log->file) {
+      fwrite (record + 1, 1, record->length, log->file);
+      log->size += record->length;
+    }
+    tail += GSTD_LOG_ALIGN (sizeof (GstdLogRecord) + record->length);
+  }
+
+  /* Hands the space back to the logging thread */
+  g_atomic_int_set (&ring->tail, (gint) tail);
+
+  return TRUE;
+}
+
+/* Only one thread drains at a time: the writer, or the thread stopping
+ * the logs once the writer is gone */
+static void
+gstd_log_drain (void)
+{
+  GstdLogRing *ring;
+  GstdLogFile *log;
+  GList *pending;
+  GList *retired = NULL;
+  GList *iter;
+  gint dropped;
+  gint target;
+
+  /* Threads logging for the first time must not wait for the files */
+  g_mutex_lock (&rings_lock);
+  pending = g_list_copy (rings);
+  g_mutex_unlock (&rings_lock);
+
+  for (iter = pending; iter; iter = iter->next) {
+    ring = iter->data;
+
+    /* Read before draining, so nothing logged before retiring is lost */
+    if (g_atomic_int_get (&ring->retired)) {
+      retired = g_list_prepend (retired, ring);
+    }
+    gstd_log_ring_drain (ring);
+  }
+  g_list_free (pending);
+
+  if (retired) {
+    g_mutex_lock (&rings_lock);
+    for (iter = retired; iter; iter = iter->next) {
+      rings = g_list_remove (rings, iter->data);
+    }
+    g_mutex_unlock (&rings_lock);
+    g_list_free_full (retired, g_free);
+  }
+
+  for (target = 0; target < GSTD_LOG_N_TARGETS; target++) {
+    log = &logs[target];
+    if (!log->file) {
+      continue;
+    }
+
+    dropped = g_atomic_int_get (&log->dropped);
+    if (dropped != log->reported) {
+      log->size += fprintf (log->file, "gstd: dropped %d log records, "
+          "the logging threads outpaced the log writer\n",
+          dropped - log->reported);
+      log->reported = dropped;
+    }
+
+    /* One write per batch instead of one per line */
+    fflush (log->file);
+
+    if (rotate_size && log->size >= rotate_size) {
+      gstd_log_file_rotate (log);
+    }
+  }
+}
+
+static gpointer
+gstd_log_writer (gpointer data)
+{
+  gint64 deadline;
+
+  g_mutex_lock (&rings_lock);
+  while (!writer_stop) {
+    deadline = g_get_monotonic_time () + GSTD_LOG_FLUSH_INTERVAL;
+    g_cond_wait_until (&writer_cond, &rings_lock, deadline);
+    if (writer_stop) {
+      break;
+    }
+
+    g_mutex_unlock (&rings_lock);
+    gstd_log_drain ();
+    g_mutex_lock (&rings_lock);
+  }
+  g_mutex_unlock (&rings_lock);
+
+  return NULL;
+}
+
+static gchar *
+gstd_log_format (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message)
+{
+#if GST_CHECK_VERSION(1,18,0)
+  return gst_debug_log_get_line (category, level, file, function, line,
+      object, message);
+#else
+  /* Same layout as the default log function, without colors */
+  return g_strdup_printf ("%" GST_TIME_FORMAT " %5d %p %s %20s %s:%d:%s: %s\n",
+      GST_TIME_ARGS (gst_util_get_timestamp ()), getpid (), g_thread_self (),
+      gst_debug_level_get_name (level), gst_debug_category_get_name (category),
+      file, line, function, gst_debug_message_get (message));
+#endif
 }
 
 static void
@@ -118,19 +507,31 @@ gstd_log_proxy (GstDebugCategory * category, GstDebugLevel level,
     GstDebugMessage * message, gpointer user_data)
 {
   const gchar *cat_name;
+  GstdLogTarget target;
+  gchar *formatted;
+
+  /* Messages only some pipeline asked for are none of the others' */
+  if (!gstd_pipeline_debug_filter (category, level, object)) {
+    return;
+  }
 
   cat_name = gst_debug_category_get_name (category);
 
-  /* Log every gstd trace into the gstd log file */
+  /* Log every gstd trace into the gstd log file, everything else goes
+   * to the gst file */
   if (!strncmp (cat_name, GSTD_DEBUG_PREFIX, sizeof (GSTD_DEBUG_PREFIX) - 1)) {
-    /* Redirect gstd debug to its respective file */
-    gst_debug_log_default (category, level, file, function, line, object,
-        message, _gstdlog);
+    target = GSTD_LOG_TARGET_GSTD;
   } else {
-    /* Everything else goes to the gst file */
-    gst_debug_log_default (category, level, file, function, line, object,
-        message, _gstlog);
+    target = GSTD_LOG_TARGET_GST;
   }
+
+  /* The line is written by the log writer, this thread never blocks
+   * on the log files */
+  formatted = gstd_log_format (category, level, file, function, line, object,
+      message);
+  gstd_log_ring_push (gstd_log_ring_get (), target, formatted,
+      strlen (formatted));
+  g_free (formatted);
 }
 
 static const gchar *
@@ -164,11 +565,11 @@ gstd_log_get_filename (const gchar * filename, const gchar * default_filename)
 gchar *
 gstd_log_get_current_gstd (void)
 {
-  return g_strdup (gstd_filename);
+  return g_strdup (logs[GSTD_LOG_TARGET_GSTD].filename);
 }
 
 gchar *
 gstd_log_get_current_gst (void)
 {
-  return g_strdup (gst_filename);
+  return g_strdup (logs[GSTD_LOG_TARGET_GST].filename);
 }
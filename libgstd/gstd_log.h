@@ -23,7 +23,15 @@
 
 #include <gst/gst.h>
 
-gboolean gstd_log_init (const gchar * gstdfilename, const gchar * gstfilename);
+/* Opens the log files and starts queuing the log records. Files are
+ * rotated once they reach max_size bytes, keeping max_files older
+ * files. A max_size of 0 disables rotation. */
+gboolean gstd_log_init (const gchar * gstdfilename, const gchar * gstfilename,
+    guint64 max_size, gint max_files);
+/* Starts the thread that writes the queued records, call it from the
+ * process that keeps running, after detaching */
+void gstd_log_start (void);
+/* Writes the pending records and closes the log files */
 void gstd_log_deinit (void);
 void gstd_debug_init (void);
 
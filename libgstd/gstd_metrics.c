@@ -0,0 +1,485 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstd_metrics.h"
+#include "gstd_atomic.h"
+#include "gstd_list.h"
+#include "gstd_lock_stats.h"
+#include "gstd_pipeline.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_shards.h"
+
+/* Gstd Metrics debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_metrics_debug);
+#define GST_CAT_DEFAULT gstd_metrics_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Latency histogram buckets, the bounds are in microseconds */
+static const gint64 bucket_bounds[] = {
+  100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000, 5000000,
+  10000000
+};
+
+static const gchar *bucket_labels[] = {
+  "0.0001", "0.0005", "0.001", "0.005", "0.01", "0.05", "0.1", "0.5", "1",
+  "5", "10"
+};
+
+#define GSTD_METRICS_N_BUCKETS G_N_ELEMENTS (bucket_bounds)
+
+typedef struct _GstdMetricsCommand GstdMetricsCommand;
+typedef struct _GstdMetricsShard GstdMetricsShard;
+
+struct _GstdMetricsCommand
+{
+  guint64 count;
+  guint64 errors;
+  guint64 sum;
+  guint64 buckets[GSTD_METRICS_N_BUCKETS];
+};
+
+/* Counters owned by a single thread. A scrape may observe slightly
+ * stale values, which is harmless for monotonic counters.
+ */
+struct _GstdMetricsShard
+{
+  GstdShard shard;
+  GstdMetricsCommand commands[GSTD_METRICS_MAX_COMMANDS];
+};
+
+struct _GstdMetricsGauge
+{
+  gchar *name;
+  gchar *help;
+  gchar *labels;
+  gint value;
+};
+
+static void gstd_metrics_shard_merge (gpointer data, gpointer user_data);
+static void gstd_metrics_shard_count (gpointer data, gpointer user_data);
+
+static GMutex metrics_lock;
+static GstdShards metrics_shards = GSTD_SHARDS_INIT (GstdMetricsShard, NULL,
+    gstd_metrics_shard_merge);
+static GPtrArray *gauges = NULL;
+static const gchar *command_names[GSTD_METRICS_MAX_COMMANDS];
+
+static void
+gstd_metrics_init_debug (void)
+{
+  static gsize init = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&init)) {
+    /* Initialize debug category with nice colors */
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_metrics_debug, "gstdmetrics", debug_color,
+        "Gstd Metrics category");
+    g_once_init_leave (&init, 1);
+  }
+}
+
+static void
+gstd_metrics_shard_merge (gpointer data, gpointer user_data)
+{
+  const GstdMetricsShard *src = data;
+  GstdMetricsShard *dest = user_data;
+  const GstdMetricsCommand *from;
+  GstdMetricsCommand *to;
+  guint i;
+  guint b;
+
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    from = &src->commands[i];
+    to = &dest->commands[i];
+
+    to->count += gstd_atomic_uint64_get (&from->count);
+    to->errors += gstd_atomic_uint64_get (&from->errors);
+    to->sum += gstd_atomic_uint64_get (&from->sum);
+    for (b = 0; b < GSTD_METRICS_N_BUCKETS; b++) {
+      to->buckets[b] += gstd_atomic_uint64_get (&from->buckets[b]);
+    }
+  }
+}
+
+void
+gstd_metrics_command_done (guint index, const gchar * name, gint64 elapsed,
+    GstdReturnCode ret)
+{
+  GstdMetricsShard *shard;
+  GstdMetricsCommand *command;
+  guint b;
+
+  g_return_if_fail (name);
+
+  if (G_UNLIKELY (index >= GSTD_METRICS_MAX_COMMANDS)) {
+    return;
+  }
+
+  if (G_UNLIKELY (!g_atomic_pointer_get (&command_names[index]))) {
+    g_atomic_pointer_set (&command_names[index], name);
+  }
+
+  shard = gstd_shards_get (&metrics_shards);
+  command = &shard->commands[index];
+
+  /* Only the owning thread writes the shard, but the exporter reads it
+   * concurrently, so the updates must not tear */
+  gstd_atomic_uint64_owner_inc (&command->count);
+  gstd_atomic_uint64_owner_add (&command->sum, MAX (elapsed, 0));
+  if (GSTD_EOK != ret) {
+    gstd_atomic_uint64_owner_inc (&command->errors);
+  }
+
+  for (b = 0; b < GSTD_METRICS_N_BUCKETS; b++) {
+    if (elapsed <= bucket_bounds[b]) {
+      gstd_atomic_uint64_owner_inc (&command->buckets[b]);
+      break;
+    }
+  }
+}
+
+/* Accumulates the requests and errors of a shard into a pair of
+   totals */
+static void
+gstd_metrics_shard_count (gpointer data, gpointer user_data)
+{
+  const GstdMetricsShard *shard = data;
+  guint64 *totals = user_data;
+  guint i;
+
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    totals[0] += gstd_atomic_uint64_get (&shard->commands[i].count);
+    totals[1] += gstd_atomic_uint64_get (&shard->commands[i].errors);
+  }
+}
+
+void
+gstd_metrics_get_totals (guint64 * requests, guint64 * errors)
+{
+  guint64 totals[2] = { 0, 0 };
+
+  g_return_if_fail (requests);
+  g_return_if_fail (errors);
+
+  gstd_shards_foreach (&metrics_shards, gstd_metrics_shard_count, totals);
+
+  *requests = totals[0];
+  *errors = totals[1];
+}
+
+GstdMetricsGauge *
+gstd_metrics_gauge_get (const gchar * name, const gchar * help,
+    const gchar * labels)
+{
+  GstdMetricsGauge *gauge = NULL;
+  guint i;
+
+  g_return_val_if_fail (name, NULL);
+  g_return_val_if_fail (help, NULL);
+
+  gstd_metrics_init_debug ();
+
+  g_mutex_lock (&metrics_lock);
+
+  if (!gauges) {
+    gauges = g_ptr_array_new ();
+  }
+
+  for (i = 0; i < gauges->len; i++) {
+    GstdMetricsGauge *candidate = g_ptr_array_index (gauges, i);
+
+    if (!g_strcmp0 (candidate->name, name)
+        && !g_strcmp0 (candidate->labels, labels)) {
+      gauge = candidate;
+      break;
+    }
+  }
+
+  if (!gauge) {
+    gauge = g_new0 (GstdMetricsGauge, 1);
+    gauge->name = g_strdup (name);
+    gauge->help = g_strdup (help);
+    gauge->labels = g_strdup (labels);
+    g_ptr_array_add (gauges, gauge);
+    GST_DEBUG ("Registered gauge %s{%s}", name, GST_STR_NULL (labels));
+  }
+
+  g_mutex_unlock (&metrics_lock);
+
+  return gauge;
+}
+
+void
+gstd_metrics_gauge_inc (GstdMetricsGauge * gauge)
+{
+  g_return_if_fail (gauge);
+
+  g_atomic_int_inc (&gauge->value);
+}
+
+void
+gstd_metrics_gauge_dec (GstdMetricsGauge * gauge)
+{
+  g_return_if_fail (gauge);
+
+  g_atomic_int_add (&gauge->value, -1);
+}
+
+static void
+gstd_metrics_append_header (GString * out, const gchar * name,
+    const gchar * help, const gchar * type)
+{
+  g_string_append_printf (out, "# HELP %s %s\n# TYPE %s %s\n", name, help,
+      name, type);
+}
+
+static void
+gstd_metrics_append_label (GString * out, const gchar * value)
+{
+  const gchar *c;
+
+  g_string_append_c (out, '"');
+  for (c = value; c && *c; c++) {
+    if ('\\' == *c || '"' == *c) {
+      g_string_append_c (out, '\\');
+      g_string_append_c (out, *c);
+    } else if ('\n' == *c) {
+      g_string_append (out, "\\n");
+    } else {
+      g_string_append_c (out, *c);
+    }
+  }
+  g_string_append_c (out, '"');
+}
+
+static void
+gstd_metrics_render_commands (GString * out)
+{
+  GstdMetricsShard total;
+  const gchar *names[GSTD_METRICS_MAX_COMMANDS];
+  GstdMetricsCommand *command;
+  gchar seconds[G_ASCII_DTOSTR_BUF_SIZE];
+  guint64 cumulative;
+  guint i;
+  guint b;
+
+  memset (&total, 0, sizeof (total));
+  gstd_shards_foreach (&metrics_shards, gstd_metrics_shard_merge, &total);
+
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    names[i] = g_atomic_pointer_get (&command_names[i]);
+  }
+
+  gstd_metrics_append_header (out, "gstd_command_requests_total",
+      "Commands processed", "counter");
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    if (names[i]) {
+      g_string_append_printf (out,
+          "gstd_command_requests_total{command=\"%s\"} %" G_GUINT64_FORMAT
+          "\n", names[i], total.commands[i].count);
+    }
+  }
+
+  gstd_metrics_append_header (out, "gstd_command_errors_total",
+      "Commands that didn't succeed", "counter");
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    if (names[i]) {
+      g_string_append_printf (out,
+          "gstd_command_errors_total{command=\"%s\"} %" G_GUINT64_FORMAT
+          "\n", names[i], total.commands[i].errors);
+    }
+  }
+
+  gstd_metrics_append_header (out, "gstd_command_duration_seconds",
+      "Time spent processing commands", "histogram");
+  for (i = 0; i < GSTD_METRICS_MAX_COMMANDS; i++) {
+    if (!names[i]) {
+      continue;
+    }
+
+    command = &total.commands[i];
+    cumulative = 0;
+    for (b = 0; b < GSTD_METRICS_N_BUCKETS; b++) {
+      cumulative += command->buckets[b];
+      g_string_append_printf (out,
+          "gstd_command_duration_seconds_bucket{command=\"%s\",le=\"%s\"} %"
+          G_GUINT64_FORMAT "\n", names[i], bucket_labels[b], cumulative);
+    }
+    g_string_append_printf (out,
+        "gstd_command_duration_seconds_bucket{command=\"%s\",le=\"+Inf\"} %"
+        G_GUINT64_FORMAT "\n", names[i], command->count);
+
+    g_ascii_dtostr (seconds, sizeof (seconds),
+        (gdouble) command->sum / G_USEC_PER_SEC);
+    g_string_append_printf (out,
+        "gstd_command_duration_seconds_sum{command=\"%s\"} %s\n", names[i],
+        seconds);
+    g_string_append_printf (out,
+        "gstd_command_duration_seconds_count{command=\"%s\"} %"
+        G_GUINT64_FORMAT "\n", names[i], command->count);
+  }
+}
+
+static void
+gstd_metrics_render_gauges (GString * out)
+{
+  GstdMetricsGauge *gauge;
+  GstdMetricsGauge *other;
+  guint i;
+  guint j;
+
+  g_mutex_lock (&metrics_lock);
+
+  for (i = 0; gauges && i < gauges->len; i++) {
+    gauge = g_ptr_array_index (gauges, i);
+
+    /* Every series of a family is rendered along with its first one */
+    for (j = 0; j < i; j++) {
+      other = g_ptr_array_index (gauges, j);
+      if (!g_strcmp0 (other->name, gauge->name)) {
+        break;
+      }
+    }
+    if (j < i) {
+      continue;
+    }
+
+    gstd_metrics_append_header (out, gauge->name, gauge->help, "gauge");
+    for (j = i; j < gauges->len; j++) {
+      other = g_ptr_array_index (gauges, j);
+      if (g_strcmp0 (other->name, gauge->name)) {
+        continue;
+      }
+      g_string_append_printf (out, "%s{%s} %d\n", other->name,
+          other->labels ? other->labels : "", g_atomic_int_get (&other->value));
+    }
+  }
+
+  g_mutex_unlock (&metrics_lock);
+}
+
+static void
+gstd_metrics_render_pipeline (GString * out, const gchar * metric,
+    const gchar * pipeline, guint64 value)
+{
+  g_string_append_printf (out, "%s{pipeline=", metric);
+  gstd_metrics_append_label (out, pipeline);
+  g_string_append_printf (out, "} %" G_GUINT64_FORMAT "\n", value);
+}
+
+static void
+gstd_metrics_render_pipelines (GString * out, GstdSession * session)
+{
+  GstdList *list = session->pipelines;
+  GList *pipelines;
+  GList *iter;
+  GstdObject *pipeline;
+  GstdPipelineBus *bus;
+  GstElement *element;
+  gint queued;
+  guint errors;
+  guint warnings;
+  gint64 lock;
+
+  /* Keep the pipelines alive outside of the list lock */
+  lock = GSTD_OBJECT_LOCK_SITE (list, GSTD_LOCK_SITE_LIST_SNAPSHOT);
+  pipelines = g_list_copy_deep (list->list, (GCopyFunc) g_object_ref, NULL);
+  GSTD_OBJECT_UNLOCK_SITE (list, GSTD_LOCK_SITE_LIST_SNAPSHOT, lock);
+
+  gstd_metrics_append_header (out, "gstd_pipeline_state",
+      "Current pipeline state, 1: NULL, 2: READY, 3: PAUSED, 4: PLAYING",
+      "gauge");
+  for (iter = pipelines; iter; iter = iter->next) {
+    pipeline = GSTD_OBJECT (iter->data);
+    element = gstd_pipeline_get_pipeline (GSTD_PIPELINE (pipeline));
+    gstd_metrics_render_pipeline (out, "gstd_pipeline_state",
+        GSTD_OBJECT_NAME (pipeline), element ? GST_STATE (element) : 0);
+    if (element) {
+      gst_object_unref (element);
+    }
+  }
+
+  gstd_metrics_append_header (out, "gstd_pipeline_bus_queued_messages",
+      "Messages waiting in the pipeline bus", "gauge");
+  for (iter = pipelines; iter; iter = iter->next) {
+    pipeline = GSTD_OBJECT (iter->data);
+    g_object_get (pipeline, "bus", &bus, NULL);
+    if (bus) {
+      g_object_get (bus, "queued", &queued, NULL);
+      gstd_metrics_render_pipeline (out, "gstd_pipeline_bus_queued_messages",
+          GSTD_OBJECT_NAME (pipeline), queued);
+      g_object_unref (bus);
+    }
+  }
+
+  gstd_metrics_append_header (out, "gstd_pipeline_errors_total",
+      "Error messages posted by the pipeline", "counter");
+  for (iter = pipelines; iter; iter = iter->next) {
+    pipeline = GSTD_OBJECT (iter->data);
+    g_object_get (pipeline, "bus", &bus, NULL);
+    if (bus) {
+      g_object_get (bus, "errors", &errors, NULL);
+      gstd_metrics_render_pipeline (out, "gstd_pipeline_errors_total",
+          GSTD_OBJECT_NAME (pipeline), errors);
+      g_object_unref (bus);
+    }
+  }
+
+  gstd_metrics_append_header (out, "gstd_pipeline_warnings_total",
+      "Warning messages posted by the pipeline", "counter");
+  for (iter = pipelines; iter; iter = iter->next) {
+    pipeline = GSTD_OBJECT (iter->data);
+    g_object_get (pipeline, "bus", &bus, NULL);
+    if (bus) {
+      g_object_get (bus, "warnings", &warnings, NULL);
+      gstd_metrics_render_pipeline (out, "gstd_pipeline_warnings_total",
+          GSTD_OBJECT_NAME (pipeline), warnings);
+      g_object_unref (bus);
+    }
+  }
+
+  g_list_free_full (pipelines, g_object_unref);
+}
+
+gchar *
+gstd_metrics_render (GstdSession * session)
+{
+  GString *out;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), NULL);
+
+  gstd_metrics_init_debug ();
+
+  out = g_string_sized_new (4096);
+
+  gstd_metrics_render_commands (out);
+  gstd_metrics_render_gauges (out);
+  gstd_metrics_render_pipelines (out, session);
+
+  return g_string_free (out, FALSE);
+}
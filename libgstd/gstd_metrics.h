@@ -0,0 +1,87 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_METRICS_H__
+#define __GSTD_METRICS_H__
+
+#include <gst/gst.h>
+
+#include "gstd_return_codes.h"
+#include "gstd_session.h"
+
+G_BEGIN_DECLS
+
+/* Upper limit of distinct commands accounted by the metrics */
+#define GSTD_METRICS_MAX_COMMANDS 64
+
+typedef struct _GstdMetricsGauge GstdMetricsGauge;
+
+/**
+ * gstd_metrics_command_done:
+ * @index: Position of the command in the parser command table
+ * @name: (transfer none): The command name, must outlive the process
+ * @elapsed: Time spent executing the command, in microseconds
+ * @ret: The result of the command
+ *
+ * Accounts a processed command. Counters are kept per thread so
+ * concurrent requests never contend on a lock.
+ */
+void gstd_metrics_command_done (guint index, const gchar * name,
+    gint64 elapsed, GstdReturnCode ret);
+
+/**
+ * gstd_metrics_get_totals:
+ * @requests: (out): Commands processed since start
+ * @errors: (out): Commands that didn't succeed since start
+ *
+ * Adds up the command counters of every thread.
+ */
+void gstd_metrics_get_totals (guint64 * requests, guint64 * errors);
+
+/**
+ * gstd_metrics_gauge_get:
+ * @name: The metric name
+ * @help: A one line description of the metric
+ * @labels: (nullable): The labels of this series, i.e.: ipc="GstdTcp"
+ *
+ * Finds the gauge registered with @name and @labels, registering it the
+ * first time. Gauges live until the process exits.
+ *
+ * Returns: (transfer none): The gauge
+ */
+GstdMetricsGauge *gstd_metrics_gauge_get (const gchar * name,
+    const gchar * help, const gchar * labels);
+
+void gstd_metrics_gauge_inc (GstdMetricsGauge * gauge);
+void gstd_metrics_gauge_dec (GstdMetricsGauge * gauge);
+
+/**
+ * gstd_metrics_render:
+ * @session: The session whose pipelines are reported
+ *
+ * Renders every metric in the Prometheus text exposition format.
+ *
+ * Returns: (transfer full): The metrics document, free with g_free()
+ */
+gchar *gstd_metrics_render (GstdSession * session);
+
+G_END_DECLS
+
+#endif // __GSTD_METRICS_H__
@@ -24,6 +24,7 @@
 #include "gstd_property_reader.h"
 #include "gstd_pipeline_bus.h"
 #include "gstd_bus_msg.h"
+#include "gstd_ipc.h"
 
 /* Gstd Core debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_msg_reader_debug);
@@ -31,6 +32,9 @@ GST_DEBUG_CATEGORY_STATIC (gstd_msg_reader_debug);
 
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
+/* How often a blocked read checks whether its request was cancelled */
+#define GSTD_MSG_READER_CANCEL_POLL (100 * GST_MSECOND)
+
 static GstdReturnCode
 gstd_msg_reader_read (GstdIReader * iface,
     GstdObject * object, const gchar * name, GstdObject ** out);
@@ -39,6 +43,9 @@ static GstdReturnCode
 gstd_msg_reader_read_message (GstdIReader * iface,
     GstdObject * object, GstdObject ** out);
 
+static GstMessage *gstd_msg_reader_pop (GstdPipelineBus * gstdbus,
+    gint64 timeout, gint types);
+
 typedef struct _GstdMsgReaderClass GstdMsgReaderClass;
 
 struct _GstdMsgReader
@@ -116,9 +123,9 @@ gstd_msg_reader_read_message (GstdIReader * iface,
 {
   GstdReturnCode ret = GSTD_EOK;
   GstdPipelineBus *gstdbus;
-  GstBus *bus;
   gint64 timeout;
   gint types;
+  gboolean packed_arrays;
   GstMessage *msg;
 
   g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
@@ -127,9 +134,9 @@ gstd_msg_reader_read_message (GstdIReader * iface,
 
   gstdbus = GSTD_PIPELINE_BUS (object);
 
-  bus = gstd_pipeline_bus_get_bus (gstdbus);
   g_object_get (gstdbus, "timeout", &timeout, NULL);
   g_object_get (gstdbus, "types", &types, NULL);
+  g_object_get (gstdbus, "packed-arrays", &packed_arrays, NULL);
 
   /* The unknown or none message type is not a valid polling filter,
    * instead we interpret it as a flushing request. As such we flush
@@ -138,19 +145,71 @@ gstd_msg_reader_read_message (GstdIReader * iface,
   if (GST_MESSAGE_UNKNOWN == types) {
     GST_INFO_OBJECT (gstdbus, "Flushing the bus for %" GST_TIME_FORMAT,
         GST_TIME_ARGS (timeout));
-    gst_bus_set_flushing (bus, TRUE);
+    gstd_pipeline_bus_set_flushing (gstdbus, TRUE);
     g_usleep (GST_TIME_AS_USECONDS (timeout));
-    gst_bus_set_flushing (bus, FALSE);
+    gstd_pipeline_bus_set_flushing (gstdbus, FALSE);
     msg = NULL;
   } else {
-    msg = gst_bus_timed_pop_filtered (bus, timeout, types);
+    msg = gstd_msg_reader_pop (gstdbus, timeout, types);
   }
 
   if (msg) {
-    *out = GSTD_OBJECT (gstd_bus_msg_factory_make (msg));
+    *out = GSTD_OBJECT (gstd_bus_msg_factory_make_full (msg,
+            packed_arrays ? GSTD_BUS_MSG_FLAG_PACKED_ARRAYS :
+            GSTD_BUS_MSG_FLAG_NONE));
   }
 
-  gst_object_unref (bus);
-
   return ret;
 }
+
+static GstMessage *
+gstd_msg_reader_pop (GstdPipelineBus * gstdbus, gint64 timeout, gint types)
+{
+  GCancellable *cancellable;
+  GstMessage *msg = NULL;
+  GstClockTime slice;
+  gint64 end_time = 0;
+  gboolean popped;
+
+  g_return_val_if_fail (gstdbus, NULL);
+
+  /* The bus can't be woken up from the outside, so if the request may
+   * be cancelled (i.e. its client hanging up) wait in short slices
+   * instead of a single, possibly endless, pop
+   */
+  cancellable = gstd_ipc_wait_begin ();
+
+  if (timeout >= 0) {
+    end_time = g_get_monotonic_time () + GST_TIME_AS_USECONDS (timeout);
+  }
+
+  do {
+    slice = GST_CLOCK_TIME_NONE;
+    if (timeout >= 0) {
+      slice = MAX (end_time - g_get_monotonic_time (), 0) * GST_USECOND;
+    }
+    if (cancellable) {
+      slice = MIN (slice, GSTD_MSG_READER_CANCEL_POLL);
+    }
+
+    msg = gstd_pipeline_bus_pop (gstdbus, slice);
+    popped = NULL != msg;
+
+    /* Filtered out and decimated messages are dropped before being
+     * serialized, keep draining the bus in case a matching one follows */
+    if (msg && (!(GST_MESSAGE_TYPE (msg) & types)
+            || gstd_pipeline_bus_decimate (gstdbus, msg))) {
+      gst_message_unref (msg);
+      msg = NULL;
+    }
+  } while (!msg && !g_cancellable_is_cancelled (cancellable)
+      && (popped || timeout < 0 || g_get_monotonic_time () < end_time));
+
+  if (!msg && g_cancellable_is_cancelled (cancellable)) {
+    GST_INFO_OBJECT (gstdbus, "Bus read cancelled");
+  }
+
+  gstd_ipc_wait_end ();
+
+  return msg;
+}
@@ -28,10 +28,12 @@
 #include <json-glib/json-glib.h>
 
 #include "gstd_object.h"
+#include "gstd_instances.h"
 #include "gstd_no_creator.h"
 #include "gstd_no_reader.h"
 #include "gstd_no_updater.h"
 #include "gstd_no_deleter.h"
+#include "gstd_probes.h"
 
 #include "gstd_json_builder.h"
 
@@ -54,6 +56,7 @@ static void
 gstd_object_set_property (GObject *, guint, const GValue *, GParamSpec *);
 static void gstd_object_get_property (GObject *, guint, GValue *, GParamSpec *);
 static void gstd_object_dispose (GObject *);
+static void gstd_object_constructed (GObject *);
 static GstdReturnCode
 gstd_object_create_default (GstdObject * object, const gchar * name,
     const gchar * description);
@@ -94,6 +97,7 @@ gstd_object_class_init (GstdObjectClass * klass)
   object_class->get_property = gstd_object_get_property;
   object_class->dispose = gstd_object_dispose;
   object_class->finalize = gstd_object_finalize;
+  object_class->constructed = gstd_object_constructed;
 
   properties[PROP_NAME] =
       g_param_spec_string ("name",
@@ -130,12 +134,26 @@ gstd_object_init (GstdObject * self)
   self->formatter_factory = GSTD_TYPE_JSON_BUILDER;
 }
 
+static void
+gstd_object_constructed (GObject * object)
+{
+  /* The instance type is only final once constructed, subclasses
+   * replace the counter inherited from their parent class here */
+  gstd_instances_add (gstd_instances_get (G_OBJECT_TYPE (object),
+          &GSTD_OBJECT_GET_CLASS (object)->instances));
+
+  G_OBJECT_CLASS (gstd_object_parent_class)->constructed (object);
+}
+
 void
 gstd_object_finalize (GObject * object)
 {
   GstdObject *self = GSTD_OBJECT (object);
   GST_DEBUG_OBJECT (self, "finalize");
 
+  gstd_instances_remove (gstd_instances_get (G_OBJECT_TYPE (object),
+          &GSTD_OBJECT_GET_CLASS (object)->instances));
+
   G_OBJECT_CLASS (gstd_object_parent_class)->finalize (object);
 }
 
@@ -332,10 +350,14 @@ GstdReturnCode
 gstd_object_create (GstdObject * object, const gchar * name,
     const gchar * description)
 {
+  GstdReturnCode ret;
+
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
 
-  return GSTD_OBJECT_GET_CLASS (object)->create (object, name, description);
+  ret = GSTD_OBJECT_GET_CLASS (object)->create (object, name, description);
+  GSTD_PROBE3 (object__create, object->name, name, ret);
 
+  return ret;
 }
 
 GstdReturnCode
@@ -347,6 +369,7 @@ gstd_object_read (GstdObject * object, const gchar * property,
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
 
   ret = GSTD_OBJECT_GET_CLASS (object)->read (object, property, resource);
+  GSTD_PROBE3 (object__read, object->name, property, ret);
 
   return ret;
 }
@@ -354,19 +377,29 @@ gstd_object_read (GstdObject * object, const gchar * property,
 GstdReturnCode
 gstd_object_update (GstdObject * object, const gchar * value)
 {
+  GstdReturnCode ret;
+
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (value, GSTD_NULL_ARGUMENT);
 
-  return GSTD_OBJECT_GET_CLASS (object)->update (object, value);
+  ret = GSTD_OBJECT_GET_CLASS (object)->update (object, value);
+  GSTD_PROBE3 (object__update, object->name, value, ret);
+
+  return ret;
 }
 
 GstdReturnCode
 gstd_object_delete (GstdObject * object, const gchar * name)
 {
+  GstdReturnCode ret;
+
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (name, GSTD_NULL_ARGUMENT);
 
-  return GSTD_OBJECT_GET_CLASS (object)->delete (object, name);
+  ret = GSTD_OBJECT_GET_CLASS (object)->delete (object, name);
+  GSTD_PROBE3 (object__delete, object->name, name, ret);
+
+  return ret;
 }
 
 GstdReturnCode
@@ -30,6 +30,7 @@
 #include "gstd_iupdater.h"
 
 typedef struct _GstdIFormatter GstdIFormatter;
+typedef struct _GstdInstanceCount GstdInstanceCount;
 
 G_BEGIN_DECLS
 #define GSTD_TYPE_OBJECT \
@@ -90,6 +91,9 @@ struct _GstdObjectClass
     GstdReturnCode (*delete) (GstdObject * object, const gchar * name);
 
     GstdReturnCode (*to_string) (GstdObject * object, gchar ** outstring);
+
+  /* Live instances of the type, see gstd_instances.h */
+  GstdInstanceCount *instances;
 };
 
 GType gstd_object_get_type (void);
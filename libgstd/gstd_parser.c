@@ -23,9 +23,16 @@
 #endif
 
 #include "gstd_event_handler.h"
+#include "gstd_journal.h"
+#include "gstd_lock_stats.h"
+#include "gstd_metrics.h"
 #include "gstd_pipeline.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_pipeline_debug.h"
+#include "gstd_probes.h"
 #include "gstd_session.h"
 #include "gstd_state.h"
+#include "gstd_trace.h"
 
 #include "gstd_parser.h"
 
@@ -59,10 +66,24 @@ static GstdReturnCode gstd_parser_pipeline_graph (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_pipeline_verbose (GstdSession *, gchar *,
     gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_stats (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_cpu (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_memory (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_queues (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_queues_watermarks (GstdSession *,
+    gchar *, gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_qos (GstdSession *, gchar *,
+    gchar *, gchar **);
 static GstdReturnCode gstd_parser_element_set (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_element_get (GstdSession *, gchar *,
     gchar *, gchar **);
+static GstdReturnCode gstd_parser_element_latency (GstdSession *, gchar *,
+    gchar *, gchar **);
 static GstdReturnCode gstd_parser_list_pipelines (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_list_elements (GstdSession *, gchar *,
@@ -75,6 +96,10 @@ static GstdReturnCode gstd_parser_bus_read (GstdSession *, gchar *, gchar *,
     gchar **);
 static GstdReturnCode gstd_parser_bus_filter (GstdSession *, gchar *, gchar *,
     gchar **);
+static GstdReturnCode gstd_parser_bus_qos_forward (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_bus_decimate (GstdSession *, gchar *,
+    gchar *, gchar **);
 static GstdReturnCode gstd_parser_bus_timeout (GstdSession *, gchar *, gchar *,
     gchar **);
 static GstdReturnCode gstd_parser_event_eos (GstdSession *, gchar *, gchar *,
@@ -91,6 +116,18 @@ static GstdReturnCode gstd_parser_signal_timeout (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_signal_disconnect (GstdSession *, gchar *,
     gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_subscribe (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_read (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_unsubscribe (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_property_subscribe (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_property_read (GstdSession *, gchar *,
+    gchar *, gchar **);
+static GstdReturnCode gstd_parser_property_unsubscribe (GstdSession *,
+    gchar *, gchar *, gchar **);
 static GstdReturnCode gstd_parser_action_emit (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_debug_enable (GstdSession *, gchar *, gchar *,
@@ -99,8 +136,14 @@ static GstdReturnCode gstd_parser_debug_threshold (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_debug_color (GstdSession *, gchar *, gchar *,
     gchar **);
+static GstdReturnCode gstd_parser_trace (GstdSession *, gchar *, gchar *,
+    gchar **);
 static GstdReturnCode gstd_parser_debug_reset (GstdSession *, gchar *, gchar *,
     gchar **);
+static GstdReturnCode gstd_parser_debug_locks (GstdSession *, gchar *, gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_debug_pipeline (GstdSession *, gchar *,
+    gchar *, gchar **);
 static GstdReturnCode gstd_parser_pipeline_create_ref (GstdSession *, gchar *,
     gchar *, gchar **);
 static GstdReturnCode gstd_parser_pipeline_delete_ref (GstdSession *, gchar *,
@@ -130,9 +173,19 @@ static GstdCmd cmds[] = {
   {"pipeline_stop", gstd_parser_pipeline_stop},
   {"pipeline_get_graph", gstd_parser_pipeline_graph},
   {"pipeline_verbose", gstd_parser_pipeline_verbose},
+  {"pipeline_stats", gstd_parser_pipeline_stats},
+  {"pipeline_cpu", gstd_parser_pipeline_cpu},
+  {"pipeline_memory", gstd_parser_pipeline_memory},
+  {"pipeline_queues", gstd_parser_pipeline_queues},
+  {"pipeline_queues_watermarks", gstd_parser_pipeline_queues_watermarks},
+  {"pipeline_qos", gstd_parser_pipeline_qos},
 
   {"element_set", gstd_parser_element_set},
   {"element_get", gstd_parser_element_get},
+  {"element_latency", gstd_parser_element_latency},
+  {"property_subscribe", gstd_parser_property_subscribe},
+  {"property_read", gstd_parser_property_read},
+  {"property_unsubscribe", gstd_parser_property_unsubscribe},
 
   {"list_pipelines", gstd_parser_list_pipelines},
   {"list_elements", gstd_parser_list_elements},
@@ -142,6 +195,8 @@ static GstdCmd cmds[] = {
   {"bus_read", gstd_parser_bus_read},
   {"bus_filter", gstd_parser_bus_filter},
   {"bus_timeout", gstd_parser_bus_timeout},
+  {"bus_decimate", gstd_parser_bus_decimate},
+  {"bus_qos_forward", gstd_parser_bus_qos_forward},
 
   {"event_eos", gstd_parser_event_eos},
   {"event_seek", gstd_parser_event_seek},
@@ -151,6 +206,9 @@ static GstdCmd cmds[] = {
   {"signal_connect", gstd_parser_signal_connect},
   {"signal_timeout", gstd_parser_signal_timeout},
   {"signal_disconnect", gstd_parser_signal_disconnect},
+  {"signal_subscribe", gstd_parser_signal_subscribe},
+  {"signal_read", gstd_parser_signal_read},
+  {"signal_unsubscribe", gstd_parser_signal_unsubscribe},
 
   {"action_emit", gstd_parser_action_emit},
 
@@ -158,6 +216,10 @@ static GstdCmd cmds[] = {
   {"debug_threshold", gstd_parser_debug_threshold},
   {"debug_color", gstd_parser_debug_color},
   {"debug_reset", gstd_parser_debug_reset},
+  {"debug_locks", gstd_parser_debug_locks},
+  {"debug_pipeline", gstd_parser_debug_pipeline},
+
+  {"trace", gstd_parser_trace},
 
   {"pipeline_create_ref", gstd_parser_pipeline_create_ref},
   {"pipeline_delete_ref", gstd_parser_pipeline_delete_ref},
@@ -167,6 +229,9 @@ static GstdCmd cmds[] = {
   {NULL}
 };
 
+/* Every command gets its own slot in the metrics */
+G_STATIC_ASSERT (G_N_ELEMENTS (cmds) - 1 <= GSTD_METRICS_MAX_COMMANDS);
+
 static GstdReturnCode
 gstd_parser_parse_raw_cmd (GstdSession * session, gchar * action, gchar * args,
     gchar ** response)
@@ -175,6 +240,7 @@ gstd_parser_parse_raw_cmd (GstdSession * session, gchar * action, gchar * args,
   gchar *uri, *rest;
   GstdObject *node;
   GstdReturnCode ret;
+  gint64 start;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
@@ -190,19 +256,26 @@ gstd_parser_parse_raw_cmd (GstdSession * session, gchar * action, gchar * args,
   if (!uri)
     uri = (gchar *) "/";
 
+  start = gstd_trace_now ();
   ret = gstd_get_by_uri (session, uri, &node);
+  gstd_trace_span ("resolve", uri, start);
   if (ret || NULL == node) {
     goto out;
   }
 
+  start = gstd_trace_now ();
   if (!g_ascii_strcasecmp ("CREATE", action)) {
     ret = gstd_parser_create (session, node, rest, response);
+    gstd_trace_span ("create", uri, start);
   } else if (!g_ascii_strcasecmp ("READ", action)) {
     ret = gstd_parser_read (session, node, rest, response);
+    gstd_trace_span ("read", uri, start);
   } else if (!g_ascii_strcasecmp ("UPDATE", action)) {
     ret = gstd_parser_update (session, node, rest, response);
+    gstd_trace_span ("update", uri, start);
   } else if (!g_ascii_strcasecmp ("DELETE", action)) {
     ret = gstd_parser_delete (session, node, rest, response);
+    gstd_trace_span ("delete", uri, start);
   } else {
     GST_ERROR_OBJECT (session, "Unknown command \"%s\"", action);
     ret = GSTD_BAD_COMMAND;
@@ -225,11 +298,16 @@ gstd_parser_parse_cmd (GstdSession * session, const gchar * cmd,
   gchar *action, *args;
   GstdCmd *cb;
   GstdReturnCode ret = GSTD_BAD_COMMAND;
+  gint64 start;
+  gint64 elapsed;
+  gint64 trace_start;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (cmd, GSTD_NULL_ARGUMENT);
   g_warn_if_fail (!*response);
 
+  gstd_journal_record (cmd);
+
   tokens = g_strsplit (cmd, " ", 2);
   action = tokens[0];
   args = tokens[1];
@@ -237,7 +315,14 @@ gstd_parser_parse_cmd (GstdSession * session, const gchar * cmd,
   cb = cmds;
   while (cb->cmd) {
     if (!g_ascii_strcasecmp (cb->cmd, action)) {
+      GSTD_PROBE2 (command__start, cb->cmd, args);
+      trace_start = gstd_trace_now ();
+      start = g_get_monotonic_time ();
       ret = cb->callback (session, action, args, response);
+      elapsed = g_get_monotonic_time () - start;
+      gstd_metrics_command_done (cb - cmds, cb->cmd, elapsed, ret);
+      GSTD_PROBE3 (command__done, cb->cmd, ret, elapsed);
+      gstd_trace_span (cb->cmd, args, trace_start);
       break;
     }
     cb++;
@@ -305,6 +390,9 @@ static GstdReturnCode
 gstd_parser_read (GstdSession * session, GstdObject * obj, gchar * args,
     gchar ** response)
 {
+  GstdReturnCode ret;
+  gint64 start;
+
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
 
@@ -312,7 +400,11 @@ gstd_parser_read (GstdSession * session, GstdObject * obj, gchar * args,
   g_warn_if_fail (!*response);
 
   // Print the raw object
-  return gstd_object_to_string (obj, response);
+  start = gstd_trace_now ();
+  ret = gstd_object_to_string (obj, response);
+  gstd_trace_span ("serialize", GSTD_OBJECT_NAME (obj), start);
+
+  return ret;
 }
 
 static GstdReturnCode
@@ -320,6 +412,7 @@ gstd_parser_update (GstdSession * session, GstdObject * obj, gchar * args,
     gchar ** response)
 {
   GstdReturnCode ret;
+  gint64 start;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
@@ -337,7 +430,9 @@ gstd_parser_update (GstdSession * session, GstdObject * obj, gchar * args,
   }
 
   /* Serialize the updated object */
+  start = gstd_trace_now ();
   gstd_object_to_string (obj, response);
+  gstd_trace_span ("serialize", GSTD_OBJECT_NAME (obj), start);
 out:
   {
     return ret;
@@ -459,6 +554,117 @@ gstd_parser_pipeline_graph (GstdSession * session, gchar * action, gchar * args,
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_pipeline_stats (GstdSession * session, gchar * action, gchar * args,
+    gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  uri = g_strdup_printf ("/pipelines/%s/stats", args);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_cpu (GstdSession * session, gchar * action, gchar * args,
+    gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  uri = g_strdup_printf ("/pipelines/%s/cpu", args);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_memory (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  uri = g_strdup_printf ("/pipelines/%s/memory", args);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_queues (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  uri = g_strdup_printf ("/pipelines/%s/queues", args);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_qos (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  uri = g_strdup_printf ("/pipelines/%s/qos", args);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_queues_watermarks (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 3);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/pipelines/%s/queues %s %s", tokens[0], tokens[1],
+      tokens[2]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
 static GstdReturnCode
 gstd_parser_pipeline_verbose (GstdSession * session, gchar * action,
     gchar * args, gchar ** response)
@@ -546,6 +752,31 @@ gstd_parser_element_get (GstdSession * session, gchar * action, gchar * args,
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_element_latency (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 2);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/pipelines/%s/elements/%s/latency",
+      tokens[0], tokens[1]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
 static GstdReturnCode
 gstd_parser_list_pipelines (GstdSession * session, gchar * action, gchar * args,
     gchar ** response)
@@ -700,6 +931,64 @@ gstd_parser_bus_timeout (GstdSession * session, gchar * action, gchar * args,
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_bus_decimate (GstdSession * session, gchar * action, gchar * args,
+    gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 2);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+
+  if (!gstd_pipeline_bus_check_decimation (tokens[1])) {
+    GST_ERROR_OBJECT (session, "Invalid decimation \"%s\"", tokens[1]);
+    g_strfreev (tokens);
+    return GSTD_BAD_VALUE;
+  }
+
+  uri = g_strdup_printf ("/pipelines/%s/bus/decimation %s", tokens[0],
+      tokens[1]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_bus_qos_forward (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 2);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/pipelines/%s/bus/qos-forward %s", tokens[0],
+      tokens[1]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
 static GstdReturnCode
 gstd_parser_event_eos (GstdSession * session, gchar * action, gchar * pipeline,
     gchar ** response)
@@ -871,6 +1160,105 @@ gstd_parser_debug_reset (GstdSession * session, gchar * action, gchar * reset,
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_debug_locks (GstdSession * session, gchar * action, gchar * enabled,
+    gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  check_argument (enabled, GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/debug/locks/enabled %s", enabled);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+
+  g_free (uri);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_debug_pipeline (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  check_argument (args, GSTD_BAD_COMMAND);
+
+  // Tokens has the form {<name>, <threshold>}
+  tokens = g_strsplit (args, " ", 2);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+
+  if (!gstd_pipeline_debug_check_threshold (tokens[1])) {
+    GST_ERROR_OBJECT (session, "Invalid debug threshold \"%s\"", tokens[1]);
+    g_strfreev (tokens);
+    return GSTD_BAD_VALUE;
+  }
+
+  uri = g_strdup_printf ("/pipelines/%s/debug/threshold %s", tokens[0],
+      tokens[1]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  g_free (uri);
+
+  if (GSTD_EOK == ret) {
+    g_free (*response);
+    *response = NULL;
+
+    uri = g_strdup_printf ("/pipelines/%s/debug/enable true", tokens[0]);
+    ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri,
+        response);
+    g_free (uri);
+  }
+
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_trace (GstdSession * session, gchar * action, gchar * args,
+    gchar ** response)
+{
+  GstdReturnCode ret = GSTD_EOK;
+  GError *error = NULL;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  check_argument (args, GSTD_BAD_COMMAND);
+
+  // Tokens has the form {<start|stop>, [file]}
+  tokens = g_strsplit (args, " ", 2);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+
+  if (!g_ascii_strcasecmp ("start", tokens[0])) {
+    gstd_trace_start (tokens[1]);
+  } else if (!g_ascii_strcasecmp ("stop", tokens[0])) {
+    ret = gstd_trace_stop (tokens[1], &error);
+    if (error) {
+      GST_ERROR_OBJECT (session, "Unable to write trace: %s", error->message);
+      g_error_free (error);
+    }
+  } else {
+    GST_ERROR_OBJECT (session, "Unknown trace action \"%s\"", tokens[0]);
+    ret = GSTD_BAD_COMMAND;
+  }
+
+  g_strfreev (tokens);
+
+  return ret;
+}
+
 
 static GstdReturnCode
 gstd_parser_signal_connect (GstdSession * session, gchar * action,
@@ -927,6 +1315,180 @@ gstd_parser_signal_disconnect (GstdSession * session, gchar * action,
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_property_subscribe (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 5);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  /* The minimum interval between deliveries is optional */
+  uri = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s/subscriptions"
+      " %s interval=%s", tokens[0], tokens[1], tokens[2], tokens[3],
+      tokens[4] ? tokens[4] : "0");
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_property_read (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 4);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf
+      ("/pipelines/%s/elements/%s/properties/%s/subscriptions/%s/value",
+      tokens[0], tokens[1], tokens[2], tokens[3]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_property_unsubscribe (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 4);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s/subscriptions"
+      " %s", tokens[0], tokens[1], tokens[2], tokens[3]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "delete", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_signal_subscribe (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 5);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  /* The queue size and count-only options are optional */
+  uri = g_strdup_printf ("/pipelines/%s/elements/%s/signals/%s/subscriptions "
+      "%s %s", tokens[0], tokens[1], tokens[2], tokens[3],
+      tokens[4] ? tokens[4] : "");
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_signal_read (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 4);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf
+      ("/pipelines/%s/elements/%s/signals/%s/subscriptions/%s/callback",
+      tokens[0], tokens[1], tokens[2], tokens[3]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_parser_signal_unsubscribe (GstdSession * session, gchar * action,
+    gchar * args, gchar ** response)
+{
+  GstdReturnCode ret;
+  gchar *uri;
+  gchar **tokens = NULL;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  tokens = g_strsplit (args, " ", 4);
+  check_argument (tokens[0], GSTD_BAD_COMMAND);
+  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  check_argument (tokens[3], GSTD_BAD_COMMAND);
+
+  uri = g_strdup_printf ("/pipelines/%s/elements/%s/signals/%s/subscriptions "
+      "%s", tokens[0], tokens[1], tokens[2], tokens[3]);
+  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "delete", uri, response);
+
+  g_free (uri);
+  g_strfreev (tokens);
+
+  return ret;
+}
+
 static GstdReturnCode
 gstd_parser_action_emit (GstdSession * session, gchar * action,
     gchar * args, gchar ** response)
@@ -991,6 +1553,7 @@ gstd_parser_pipeline_create_ref (GstdSession * session, gchar * action,
   GstdObject *pipeline_list_node = NULL;
   GstdObject *pipeline_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
+  gint64 lock = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
@@ -1005,7 +1568,7 @@ gstd_parser_pipeline_create_ref (GstdSession * session, gchar * action,
     goto pipeline_list_node_error;
   }
 
-  GST_OBJECT_LOCK (session);
+  lock = GSTD_OBJECT_LOCK_SITE (session, GSTD_LOCK_SITE_SESSION_CREATE_REF);
 
   /* Look for the pipeline node */
   pipeline_node =
@@ -1032,7 +1595,7 @@ gstd_parser_pipeline_create_ref (GstdSession * session, gchar * action,
   ret = gstd_pipeline_increment_refcount (GSTD_PIPELINE (pipeline_node));
 
 create_error:
-  GST_OBJECT_UNLOCK (session);
+  GSTD_OBJECT_UNLOCK_SITE (session, GSTD_LOCK_SITE_SESSION_CREATE_REF, lock);
   gst_object_unref (pipeline_list_node);
 pipeline_list_node_error:
   g_strfreev (tokens);
@@ -1046,6 +1609,7 @@ gstd_parser_pipeline_delete_ref (GstdSession * session, gchar * action,
   GstdObject *pipeline_list_node = NULL;
   GstdObject *pipeline_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
+  gint64 lock = 0;
   guint refcount = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
@@ -1059,7 +1623,7 @@ gstd_parser_pipeline_delete_ref (GstdSession * session, gchar * action,
     goto pipeline_list_node_error;
   }
 
-  GST_OBJECT_LOCK (session);
+  lock = GSTD_OBJECT_LOCK_SITE (session, GSTD_LOCK_SITE_SESSION_DELETE_REF);
 
   /* Look for the pipeline node */
   pipeline_node = gstd_list_find_child (GSTD_LIST (pipeline_list_node), args);
@@ -1076,7 +1640,7 @@ gstd_parser_pipeline_delete_ref (GstdSession * session, gchar * action,
   }
 
 pipeline_node_error:
-  GST_OBJECT_UNLOCK (session);
+  GSTD_OBJECT_UNLOCK_SITE (session, GSTD_LOCK_SITE_SESSION_DELETE_REF, lock);
   gst_object_unref (pipeline_list_node);
 pipeline_list_node_error:
   return ret;
@@ -1090,6 +1654,7 @@ gstd_parser_pipeline_play_ref (GstdSession * session, gchar * action,
   GstdObject *pipeline_node = NULL;
   GstdObject *state_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
+  gint64 lock = 0;
   guint refcount = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
@@ -1113,7 +1678,8 @@ gstd_parser_pipeline_play_ref (GstdSession * session, gchar * action,
     goto state_node_error;
   }
 
-  GST_OBJECT_LOCK (pipeline_node);
+  lock =
+      GSTD_OBJECT_LOCK_SITE (pipeline_node, GSTD_LOCK_SITE_PIPELINE_PLAY_REF);
 
   g_object_get (state_node, "refcount", &refcount, NULL);
   if (0 == refcount) {
@@ -1127,7 +1693,8 @@ gstd_parser_pipeline_play_ref (GstdSession * session, gchar * action,
   ret = gstd_state_increment_refcount (GSTD_STATE (state_node));
 
 play_error:
-  GST_OBJECT_UNLOCK (pipeline_node);
+  GSTD_OBJECT_UNLOCK_SITE (pipeline_node, GSTD_LOCK_SITE_PIPELINE_PLAY_REF,
+      lock);
   gst_object_unref (state_node);
 state_node_error:
   gst_object_unref (pipeline_node);
@@ -1143,6 +1710,7 @@ gstd_parser_pipeline_stop_ref (GstdSession * session, gchar * action,
   GstdObject *pipeline_node = NULL;
   GstdObject *state_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
+  gint64 lock = 0;
   guint refcount = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
@@ -1166,7 +1734,8 @@ gstd_parser_pipeline_stop_ref (GstdSession * session, gchar * action,
     goto state_node_error;
   }
 
-  GST_OBJECT_LOCK (pipeline_node);
+  lock =
+      GSTD_OBJECT_LOCK_SITE (pipeline_node, GSTD_LOCK_SITE_PIPELINE_STOP_REF);
 
   g_object_get (state_node, "refcount", &refcount, NULL);
   if (1 == refcount) {
@@ -1180,7 +1749,8 @@ gstd_parser_pipeline_stop_ref (GstdSession * session, gchar * action,
   ret = gstd_state_decrement_refcount (GSTD_STATE (state_node));
 
 stop_error:
-  GST_OBJECT_UNLOCK (pipeline_node);
+  GSTD_OBJECT_UNLOCK_SITE (pipeline_node, GSTD_LOCK_SITE_PIPELINE_STOP_REF,
+      lock);
   gst_object_unref (state_node);
 state_node_error:
   gst_object_unref (pipeline_node);
@@ -31,6 +31,13 @@
 #include "gstd_list_reader.h"
 #include "gstd_object.h"
 #include "gstd_pipeline_bus.h"
+#include "gstd_pipeline_cpu.h"
+#include "gstd_pipeline_debug.h"
+#include "gstd_pipeline_memory.h"
+#include "gstd_pipeline_qos.h"
+#include "gstd_pipeline_queues.h"
+#include "gstd_pipeline_stats.h"
+#include "gstd_probes.h"
 #include "gstd_property_reader.h"
 #include "gstd_state.h"
 
@@ -48,6 +55,12 @@ enum
   PROP_GRAPH,
   PROP_VERBOSE,
   PROP_REFCOUNT,
+  PROP_STATS,
+  PROP_CPU,
+  PROP_MEMORY,
+  PROP_QUEUES,
+  PROP_QOS,
+  PROP_DEBUG,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -104,6 +117,36 @@ struct _GstdPipeline
    */
   GstdState *state;
 
+  /**
+   * The dataflow statistics of the GstPipeline
+   */
+  GstdPipelineStats *stats;
+
+  /**
+   * The CPU time spent by the streaming threads of the GstPipeline
+   */
+  GstdPipelineCpu *cpu;
+
+  /**
+   * The memory allocated by the elements of the GstPipeline
+   */
+  GstdPipelineMemory *memory;
+
+  /**
+   * The fill levels of the queues in the GstPipeline
+   */
+  GstdPipelineQueues *queues;
+
+  /**
+   * The QoS reported by the elements of the GstPipeline
+   */
+  GstdPipelineQos *qos;
+
+  /**
+   * The debug thresholds scoped to the GstPipeline
+   */
+  GstdPipelineDebug *debug;
+
   /**
    * Position of the media progress pipeline
    */
@@ -218,6 +261,43 @@ gstd_pipeline_class_init (GstdPipelineClass * klass)
       "Reference count of pipeline creation",
       0, G_MAXINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_STATS] =
+      g_param_spec_object ("stats", "Stats",
+      "The throughput statistics of the pipeline elements",
+      GSTD_TYPE_PIPELINE_STATS,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_CPU] =
+      g_param_spec_object ("cpu", "CPU",
+      "The CPU usage of the pipeline streaming threads",
+      GSTD_TYPE_PIPELINE_CPU,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_MEMORY] =
+      g_param_spec_object ("memory", "Memory",
+      "The memory allocated by the pipeline elements",
+      GSTD_TYPE_PIPELINE_MEMORY,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_QUEUES] =
+      g_param_spec_object ("queues", "Queues",
+      "The fill levels and water marks of the pipeline queues",
+      GSTD_TYPE_PIPELINE_QUEUES,
+      G_PARAM_READABLE |
+      G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ | GSTD_PARAM_UPDATE);
+
+  properties[PROP_QOS] =
+      g_param_spec_object ("qos", "QoS",
+      "The QoS messages of the pipeline elements, aggregated",
+      GSTD_TYPE_PIPELINE_QOS,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_DEBUG] =
+      g_param_spec_object ("debug", "Debug",
+      "The debug thresholds applied only to the pipeline elements",
+      GSTD_TYPE_PIPELINE_DEBUG,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -235,6 +315,12 @@ gstd_pipeline_init (GstdPipeline * self)
   self->event_handler = NULL;
   self->pipeline_bus = NULL;
   self->state = NULL;
+  self->stats = NULL;
+  self->cpu = NULL;
+  self->memory = NULL;
+  self->queues = NULL;
+  self->qos = NULL;
+  self->debug = NULL;
   self->graph = NULL;
   self->deep_notify_id = 0;
   self->refcount = 0;
@@ -275,6 +361,24 @@ gstd_pipeline_build (GstdPipeline * object)
     goto out2;
   }
 
+  /* The pipeline bus flushes from READY->NULL until the pipeline leaves
+   * NULL on its own, so that pending messages are accounted for */
+  gst_pipeline_set_auto_flush_bus (GST_PIPELINE (self->pipeline), FALSE);
+
+  self->stats = gstd_pipeline_stats_new (self->pipeline);
+
+  self->cpu = gstd_pipeline_cpu_new ();
+  gstd_pipeline_bus_set_cpu (self->pipeline_bus, self->cpu);
+
+  self->qos = gstd_pipeline_qos_new ();
+  gstd_pipeline_bus_set_qos (self->pipeline_bus, self->qos);
+
+  self->memory = gstd_pipeline_memory_new (self->pipeline);
+
+  self->queues = gstd_pipeline_queues_new (self->pipeline);
+
+  self->debug = gstd_pipeline_debug_new (self->pipeline);
+
   goto out;
 
 out2:
@@ -288,6 +392,7 @@ out1:
   self->pipeline = NULL;
 
 out:
+  GSTD_PROBE3 (pipeline__create, self->parent.name, self->description, ret);
   return ret;
 }
 
@@ -297,6 +402,7 @@ gstd_pipeline_dispose (GObject * object)
   GstdPipeline *self = GSTD_PIPELINE (object);
 
   GST_INFO_OBJECT (self, "Disposing %s pipeline", GSTD_OBJECT_NAME (self));
+  GSTD_PROBE1 (pipeline__delete, self->parent.name);
 
   /* Stop the pipe if playing */
   if (self->state) {
@@ -315,6 +421,36 @@ gstd_pipeline_dispose (GObject * object)
     self->pipeline_bus = NULL;
   }
 
+  if (self->stats) {
+    g_object_unref (self->stats);
+    self->stats = NULL;
+  }
+
+  if (self->cpu) {
+    g_object_unref (self->cpu);
+    self->cpu = NULL;
+  }
+
+  if (self->memory) {
+    g_object_unref (self->memory);
+    self->memory = NULL;
+  }
+
+  if (self->queues) {
+    g_object_unref (self->queues);
+    self->queues = NULL;
+  }
+
+  if (self->qos) {
+    g_object_unref (self->qos);
+    self->qos = NULL;
+  }
+
+  if (self->debug) {
+    g_object_unref (self->debug);
+    self->debug = NULL;
+  }
+
   if (self->event_handler) {
     g_object_unref (self->event_handler);
     self->event_handler = NULL;
@@ -362,6 +498,30 @@ gstd_pipeline_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning pipeline state %p", self->state);
       g_value_set_object (value, self->state);
       break;
+    case PROP_STATS:
+      GST_DEBUG_OBJECT (self, "Returning pipeline stats %p", self->stats);
+      g_value_set_object (value, self->stats);
+      break;
+    case PROP_CPU:
+      GST_DEBUG_OBJECT (self, "Returning pipeline cpu %p", self->cpu);
+      g_value_set_object (value, self->cpu);
+      break;
+    case PROP_MEMORY:
+      GST_DEBUG_OBJECT (self, "Returning pipeline memory %p", self->memory);
+      g_value_set_object (value, self->memory);
+      break;
+    case PROP_QUEUES:
+      GST_DEBUG_OBJECT (self, "Returning pipeline queues %p", self->queues);
+      g_value_set_object (value, self->queues);
+      break;
+    case PROP_QOS:
+      GST_DEBUG_OBJECT (self, "Returning pipeline qos %p", self->qos);
+      g_value_set_object (value, self->qos);
+      break;
+    case PROP_DEBUG:
+      GST_DEBUG_OBJECT (self, "Returning pipeline debug %p", self->debug);
+      g_value_set_object (value, self->debug);
+      break;
     case PROP_EVENT:
       GST_DEBUG_OBJECT (self, "Returning event handler %p",
           self->event_handler);
@@ -632,3 +792,19 @@ gstd_pipeline_decrement_refcount (GstdPipeline * self)
   GST_OBJECT_UNLOCK (self);
   return GSTD_EOK;
 }
+
+GstElement *
+gstd_pipeline_get_pipeline (GstdPipeline * self)
+{
+  GstElement *pipeline = NULL;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE (self), NULL);
+
+  GST_OBJECT_LOCK (self);
+  if (self->pipeline) {
+    pipeline = gst_object_ref (self->pipeline);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return pipeline;
+}
@@ -22,6 +22,7 @@
 #define __GSTD_PIPELINE_H__
 
 #include <glib-object.h>
+#include <gst/gst.h>
 
 #include "gstd_object.h"
 
@@ -65,5 +66,14 @@ GstdReturnCode gstd_pipeline_increment_refcount (GstdPipeline * self);
  **/
 GstdReturnCode gstd_pipeline_decrement_refcount (GstdPipeline * self);
 
+/**
+ * Get the GStreamer pipeline wrapped by this object
+ *
+ * \param self GstdPipeline object
+ *
+ * \return A new reference to the pipeline, NULL if not built yet
+ **/
+GstElement *gstd_pipeline_get_pipeline (GstdPipeline * self);
+
 G_END_DECLS
 #endif // __GSTD_PIPELINE_H__
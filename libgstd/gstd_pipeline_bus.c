@@ -24,15 +24,33 @@
 #include "gstd_pipeline_bus.h"
 #include "gstd_msg_reader.h"
 #include "gstd_msg_type.h"
+#include "gstd_pipeline_cpu.h"
+#include "gstd_probes.h"
+#include "gstd_trace.h"
 
 enum
 {
   PROP_MESSAGE = 1,
   PROP_TIMEOUT,
   PROP_TYPES,
+  PROP_DECIMATION,
+  PROP_PACKED_ARRAYS,
+  PROP_QUEUED,
+  PROP_ERRORS,
+  PROP_WARNINGS,
+  PROP_QOS_FORWARD,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
+typedef struct _GstdBusDecimator GstdBusDecimator;
+
+/* Keeps one out of every @factor element messages of a structure name */
+struct _GstdBusDecimator
+{
+  guint factor;
+  guint count;
+};
+
 
 struct _GstdPipelineBus
 {
@@ -42,6 +60,25 @@ struct _GstdPipelineBus
   gint64 timeout;
   gint types;
 
+  gchar *decimation;
+  GHashTable *decimators;
+  gboolean packed_arrays;
+
+  /* Notified of the streaming threads entering and leaving */
+  GstdPipelineCpu *cpu;
+
+  /* Accumulates the QoS messages */
+  GstdPipelineQos *qos;
+  gint qos_forward;
+
+  /* The pipeline while it sits in NULL after being stopped, its
+     messages are dropped as with the pipeline auto-flush */
+  GstElement *stopped;
+
+  /* Updated from the streaming threads posting to the bus */
+  gint queued;
+  guint errors;
+  guint warnings;
 };
 
 struct _GstdPipelineBusClass
@@ -55,6 +92,11 @@ static void
 gstd_pipeline_bus_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec);
 static void gstd_pipeline_bus_dispose (GObject *);
+static void gstd_pipeline_bus_finalize (GObject *);
+static void gstd_pipeline_bus_set_decimation (GstdPipelineBus * self,
+    const gchar * decimation);
+static GstBusSyncReply gstd_pipeline_bus_sync_handler (GstBus * bus,
+    GstMessage * message, gpointer data);
 
 G_DEFINE_TYPE (GstdPipelineBus, gstd_pipeline_bus, GSTD_TYPE_OBJECT);
 
@@ -66,6 +108,9 @@ GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_bus_debug);
 #define GSTD_PIPELINE_BUS_TIMEOUT_MIN -1
 #define GSTD_PIPELINE_BUS_TIMEOUT_MAX G_MAXINT64
 #define GSTD_PIPELINE_BUS_TYPES_DEFAULT (GST_MESSAGE_ERROR | GST_MESSAGE_WARNING | GST_MESSAGE_INFO)
+#define GSTD_PIPELINE_BUS_DECIMATION_DEFAULT NULL
+#define GSTD_PIPELINE_BUS_PACKED_ARRAYS_DEFAULT FALSE
+#define GSTD_PIPELINE_BUS_QOS_FORWARD_DEFAULT TRUE
 
 static void
 gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
@@ -77,6 +122,7 @@ gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
   object_class->set_property = gstd_pipeline_bus_set_property;
   object_class->get_property = gstd_pipeline_bus_get_property;
   object_class->dispose = gstd_pipeline_bus_dispose;
+  object_class->finalize = gstd_pipeline_bus_finalize;
 
   properties[PROP_MESSAGE] =
       g_param_spec_object ("message",
@@ -101,6 +147,48 @@ gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
       GSTD_PIPELINE_BUS_TYPES_DEFAULT,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_DECIMATION] =
+      g_param_spec_string ("decimation",
+      "Decimation",
+      "Keep only one out of every N element messages with a given structure "
+      "name, i.e.: level=5,spectrum=10. Empty to deliver every message",
+      GSTD_PIPELINE_BUS_DECIMATION_DEFAULT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_PACKED_ARRAYS] =
+      g_param_spec_boolean ("packed-arrays",
+      "Packed Arrays",
+      "Deliver numeric array fields of element messages as base64 encoded "
+      "little endian binary instead of text",
+      GSTD_PIPELINE_BUS_PACKED_ARRAYS_DEFAULT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_QUEUED] =
+      g_param_spec_int ("queued",
+      "Queued",
+      "The amount of messages waiting to be read from the bus",
+      0, G_MAXINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_ERRORS] =
+      g_param_spec_uint ("errors",
+      "Errors",
+      "The amount of error messages posted to the bus",
+      0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_WARNINGS] =
+      g_param_spec_uint ("warnings",
+      "Warnings",
+      "The amount of warning messages posted to the bus",
+      0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_QOS_FORWARD] =
+      g_param_spec_boolean ("qos-forward",
+      "QoS Forward",
+      "Deliver the QoS messages to the bus readers. They are accumulated "
+      "in the pipeline qos node either way",
+      GSTD_PIPELINE_BUS_QOS_FORWARD_DEFAULT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -116,6 +204,14 @@ gstd_pipeline_bus_init (GstdPipelineBus * self)
 
   self->timeout = GSTD_PIPELINE_BUS_TIMEOUT_DEFAULT;
   self->types = GSTD_PIPELINE_BUS_TYPES_DEFAULT;
+  self->decimation = GSTD_PIPELINE_BUS_DECIMATION_DEFAULT;
+  self->decimators = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_free);
+  self->packed_arrays = GSTD_PIPELINE_BUS_PACKED_ARRAYS_DEFAULT;
+  self->cpu = NULL;
+  self->qos = NULL;
+  self->qos_forward = GSTD_PIPELINE_BUS_QOS_FORWARD_DEFAULT;
+  self->stopped = NULL;
 
   gstd_object_set_reader (GSTD_OBJECT (self),
       g_object_new (GSTD_TYPE_MSG_READER, NULL));
@@ -132,6 +228,8 @@ gstd_pipeline_bus_new (GstBus * bus)
   self = GSTD_PIPELINE_BUS (g_object_new (GSTD_TYPE_PIPELINE_BUS, NULL));
   self->bus = G_OBJECT (bus);
 
+  gst_bus_set_sync_handler (bus, gstd_pipeline_bus_sync_handler, self, NULL);
+
   return self;
 }
 
@@ -151,6 +249,21 @@ gstd_pipeline_bus_set_property (GObject * object,
       self->types = g_value_get_flags (value);
       GST_INFO_OBJECT (self, "Types changed to: 0x%x", self->types);
       break;
+    case PROP_DECIMATION:
+      gstd_pipeline_bus_set_decimation (self, g_value_get_string (value));
+      GST_INFO_OBJECT (self, "Decimation changed to: %s",
+          GST_STR_NULL (self->decimation));
+      break;
+    case PROP_PACKED_ARRAYS:
+      self->packed_arrays = g_value_get_boolean (value);
+      GST_INFO_OBJECT (self, "Packed arrays changed to: %d",
+          self->packed_arrays);
+      break;
+    case PROP_QOS_FORWARD:
+      g_atomic_int_set (&self->qos_forward, g_value_get_boolean (value));
+      GST_INFO_OBJECT (self, "QoS forward changed to: %d",
+          g_value_get_boolean (value));
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -179,6 +292,30 @@ gstd_pipeline_bus_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning types 0x%x", self->types);
       g_value_set_flags (value, self->types);
       break;
+    case PROP_DECIMATION:
+      GST_OBJECT_LOCK (self);
+      GST_DEBUG_OBJECT (self, "Returning decimation %s",
+          GST_STR_NULL (self->decimation));
+      g_value_set_string (value, self->decimation);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_PACKED_ARRAYS:
+      GST_DEBUG_OBJECT (self, "Returning packed arrays %d",
+          self->packed_arrays);
+      g_value_set_boolean (value, self->packed_arrays);
+      break;
+    case PROP_QUEUED:
+      g_value_set_int (value, MAX (g_atomic_int_get (&self->queued), 0));
+      break;
+    case PROP_ERRORS:
+      g_value_set_uint (value, g_atomic_int_get (&self->errors));
+      break;
+    case PROP_WARNINGS:
+      g_value_set_uint (value, g_atomic_int_get (&self->warnings));
+      break;
+    case PROP_QOS_FORWARD:
+      g_value_set_boolean (value, g_atomic_int_get (&self->qos_forward));
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -193,11 +330,288 @@ gstd_pipeline_bus_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s pipeline bus", GSTD_OBJECT_NAME (self));
 
+  if (self->bus) {
+    gst_bus_set_sync_handler (GST_BUS (self->bus), NULL, NULL, NULL);
+  }
   g_clear_object (&self->bus);
+  g_clear_object (&self->cpu);
+  g_clear_object (&self->qos);
 
   G_OBJECT_CLASS (gstd_pipeline_bus_parent_class)->dispose (object);
 }
 
+static void
+gstd_pipeline_bus_finalize (GObject * object)
+{
+  GstdPipelineBus *self = GSTD_PIPELINE_BUS (object);
+
+  g_free (self->decimation);
+  g_hash_table_unref (self->decimators);
+
+  G_OBJECT_CLASS (gstd_pipeline_bus_parent_class)->finalize (object);
+}
+
+/* Returns the decimators described by decimation, or NULL if any of
+ * its entries is invalid */
+static GHashTable *
+gstd_pipeline_bus_parse_decimation (const gchar * decimation)
+{
+  GHashTable *decimators;
+  GstdBusDecimator *decimator;
+  gchar **entries = NULL;
+  gchar **pair;
+  gchar *end;
+  guint64 factor;
+  gboolean valid = TRUE;
+  gint i;
+
+  decimators = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_free);
+
+  if (decimation) {
+    entries = g_strsplit (decimation, ",", -1);
+  }
+
+  for (i = 0; valid && entries && entries[i]; i++) {
+    g_strstrip (entries[i]);
+    if ('\0' == entries[i][0]) {
+      continue;
+    }
+
+    pair = g_strsplit (entries[i], "=", 2);
+    valid = pair[0] && pair[1];
+
+    if (valid) {
+      g_strstrip (pair[0]);
+      factor = g_ascii_strtoull (pair[1], &end, 10);
+      valid = '\0' != pair[0][0] && end != pair[1] && '\0' == *end
+          && factor >= 1 && factor <= G_MAXUINT;
+    }
+
+    if (valid) {
+      decimator = g_new0 (GstdBusDecimator, 1);
+      decimator->factor = factor;
+      g_hash_table_insert (decimators, g_strdup (pair[0]), decimator);
+    }
+
+    g_strfreev (pair);
+  }
+
+  g_strfreev (entries);
+
+  if (!valid) {
+    g_hash_table_unref (decimators);
+    decimators = NULL;
+  }
+
+  return decimators;
+}
+
+gboolean
+gstd_pipeline_bus_check_decimation (const gchar * decimation)
+{
+  GHashTable *decimators;
+
+  decimators = gstd_pipeline_bus_parse_decimation (decimation);
+  if (!decimators) {
+    return FALSE;
+  }
+
+  g_hash_table_unref (decimators);
+
+  return TRUE;
+}
+
+static void
+gstd_pipeline_bus_set_decimation (GstdPipelineBus * self,
+    const gchar * decimation)
+{
+  GHashTable *decimators;
+
+  /* An invalid decimation leaves the current one untouched */
+  decimators = gstd_pipeline_bus_parse_decimation (decimation);
+  if (!decimators) {
+    GST_WARNING_OBJECT (self, "Ignoring invalid decimation \"%s\"",
+        decimation);
+    return;
+  }
+
+  GST_OBJECT_LOCK (self);
+
+  g_hash_table_unref (self->decimators);
+  self->decimators = decimators;
+  g_free (self->decimation);
+  self->decimation = g_strdup (decimation);
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstBusSyncReply
+gstd_pipeline_bus_sync_handler (GstBus * bus, GstMessage * message,
+    gpointer data)
+{
+  GstdPipelineBus *self = GSTD_PIPELINE_BUS (data);
+  GstElement *stopped;
+  GstState old_state;
+  GstState new_state;
+  gchar *detail;
+
+  /* The bus flushes until the pipeline is asked to leave NULL. The
+     target state is read without locking, the pipeline may be posting
+     while holding its own lock */
+  stopped = g_atomic_pointer_get (&self->stopped);
+  if (stopped) {
+    if (GST_STATE_NULL == GST_STATE_TARGET (stopped)) {
+      return GST_BUS_DROP;
+    }
+    g_atomic_pointer_set (&self->stopped, NULL);
+  }
+
+  if (GST_MESSAGE_QOS == GST_MESSAGE_TYPE (message)) {
+    if (self->qos) {
+      gstd_pipeline_qos_message (self->qos, message);
+    }
+
+    /* Overloaded sinks post QoS for every late buffer, readers may
+       rely on the aggregates instead of being flooded */
+    if (!g_atomic_int_get (&self->qos_forward)) {
+      return GST_BUS_DROP;
+    }
+  }
+
+  /* Emulate the pipeline auto-flush, which would otherwise drop the
+     pending messages behind our back and leave them counted. The
+     pipeline stays flushing until it leaves NULL */
+  if (GST_MESSAGE_STATE_CHANGED == GST_MESSAGE_TYPE (message)
+      && GST_IS_PIPELINE (GST_MESSAGE_SRC (message))
+      && !GST_OBJECT_PARENT (GST_MESSAGE_SRC (message))) {
+    gst_message_parse_state_changed (message, &old_state, &new_state, NULL);
+    if (GST_STATE_READY == old_state && GST_STATE_NULL == new_state) {
+      gstd_pipeline_bus_set_flushing (self, TRUE);
+      gstd_pipeline_bus_set_flushing (self, FALSE);
+      g_atomic_pointer_set (&self->stopped,
+          GST_ELEMENT (GST_MESSAGE_SRC (message)));
+      return GST_BUS_DROP;
+    }
+  }
+
+  g_atomic_int_inc (&self->queued);
+  GSTD_PROBE2 (bus__message, GST_MESSAGE_SRC_NAME (message),
+      GST_MESSAGE_TYPE (message));
+
+  /* Interleave the pipeline activity with the requests in the trace */
+  if (gstd_trace_now ()) {
+    if (GST_MESSAGE_STATE_CHANGED == GST_MESSAGE_TYPE (message)) {
+      gst_message_parse_state_changed (message, &old_state, &new_state, NULL);
+      detail = g_strdup_printf ("%s %s->%s", GST_MESSAGE_SRC_NAME (message),
+          gst_element_state_get_name (old_state),
+          gst_element_state_get_name (new_state));
+      gstd_trace_instant ("state-changed", detail);
+    } else {
+      detail = g_strdup_printf ("%s %s", GST_MESSAGE_TYPE_NAME (message),
+          GST_MESSAGE_SRC_NAME (message));
+      gstd_trace_instant ("bus", detail);
+    }
+    g_free (detail);
+  }
+
+  if (GST_MESSAGE_ERROR == GST_MESSAGE_TYPE (message)) {
+    g_atomic_int_inc (&self->errors);
+  } else if (GST_MESSAGE_WARNING == GST_MESSAGE_TYPE (message)) {
+    g_atomic_int_inc (&self->warnings);
+  } else if (GST_MESSAGE_STREAM_STATUS == GST_MESSAGE_TYPE (message)
+      && self->cpu) {
+    gstd_pipeline_cpu_stream_status (self->cpu, message);
+  }
+
+  return GST_BUS_PASS;
+}
+
+GstMessage *
+gstd_pipeline_bus_pop (GstdPipelineBus * self, GstClockTime timeout)
+{
+  GstMessage *message;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), NULL);
+
+  message = gst_bus_timed_pop (GST_BUS (self->bus), timeout);
+  if (message) {
+    g_atomic_int_add (&self->queued, -1);
+    GSTD_PROBE2 (bus__deliver, GST_MESSAGE_SRC_NAME (message),
+        GST_MESSAGE_TYPE (message));
+  }
+
+  return message;
+}
+
+void
+gstd_pipeline_bus_set_cpu (GstdPipelineBus * self, GstdPipelineCpu * cpu)
+{
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+  g_return_if_fail (GSTD_IS_PIPELINE_CPU (cpu));
+
+  g_clear_object (&self->cpu);
+  self->cpu = g_object_ref (cpu);
+}
+
+void
+gstd_pipeline_bus_set_qos (GstdPipelineBus * self, GstdPipelineQos * qos)
+{
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+  g_return_if_fail (GSTD_IS_PIPELINE_QOS (qos));
+
+  g_clear_object (&self->qos);
+  self->qos = g_object_ref (qos);
+}
+
+void
+gstd_pipeline_bus_set_flushing (GstdPipelineBus * self, gboolean flushing)
+{
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+
+  gst_bus_set_flushing (GST_BUS (self->bus), flushing);
+
+  /* Every pending message was dropped */
+  if (flushing) {
+    g_atomic_int_set (&self->queued, 0);
+  }
+}
+
+gboolean
+gstd_pipeline_bus_decimate (GstdPipelineBus * self, GstMessage * message)
+{
+  const GstStructure *st;
+  GstdBusDecimator *decimator;
+  gboolean drop = FALSE;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), FALSE);
+  g_return_val_if_fail (message, FALSE);
+
+  if (GST_MESSAGE_ELEMENT != GST_MESSAGE_TYPE (message)) {
+    return FALSE;
+  }
+
+  st = gst_message_get_structure (message);
+  if (!st) {
+    return FALSE;
+  }
+
+  GST_OBJECT_LOCK (self);
+
+  decimator = g_hash_table_lookup (self->decimators,
+      gst_structure_get_name (st));
+  if (decimator) {
+    /* Keep the first message of every group so a single reading is
+     * delivered right away */
+    drop = 0 != decimator->count;
+    decimator->count = (decimator->count + 1) % decimator->factor;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+
+  return drop;
+}
+
 GstBus *
 gstd_pipeline_bus_get_bus (GstdPipelineBus * self)
 {
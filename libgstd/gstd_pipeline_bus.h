@@ -23,6 +23,8 @@
 
 #include <gst/gst.h>
 #include <gstd_object.h>
+#include <gstd_pipeline_cpu.h>
+#include <gstd_pipeline_qos.h>
 
 G_BEGIN_DECLS
 #define GSTD_TYPE_PIPELINE_BUS \
@@ -56,6 +58,76 @@ GstdPipelineBus *gstd_pipeline_bus_new (GstBus * bus);
 
 GstBus *gstd_pipeline_bus_get_bus (GstdPipelineBus * self);
 
+/**
+ * gstd_pipeline_bus_pop:
+ * @self: The pipeline bus to read from
+ * @timeout: Maximum time to wait for a message, GST_CLOCK_TIME_NONE to
+ * wait forever
+ *
+ * Pops the next message of any type, keeping the queued message count
+ * up to date.
+ *
+ * Returns: (transfer full) (nullable): The message or NULL on timeout
+ */
+GstMessage *gstd_pipeline_bus_pop (GstdPipelineBus * self,
+    GstClockTime timeout);
+
+/**
+ * gstd_pipeline_bus_set_flushing:
+ * @self: The pipeline bus to flush
+ * @flushing: Whether to drop pending and new messages
+ *
+ * Same as gst_bus_set_flushing() but keeping the queued message count
+ * up to date.
+ */
+void gstd_pipeline_bus_set_flushing (GstdPipelineBus * self,
+    gboolean flushing);
+
+/**
+ * gstd_pipeline_bus_set_cpu:
+ * @self: The pipeline bus to observe
+ * @cpu: The CPU node to notify
+ *
+ * Forwards the stream status messages posted to the bus to @cpu, from
+ * the streaming threads posting them. Must be set before the pipeline
+ * starts streaming.
+ */
+void gstd_pipeline_bus_set_cpu (GstdPipelineBus * self, GstdPipelineCpu * cpu);
+
+/**
+ * gstd_pipeline_bus_set_qos:
+ * @self: The pipeline bus to observe
+ * @qos: The QoS node to notify
+ *
+ * Accumulates the QoS messages posted to the bus into @qos, whether or
+ * not they are forwarded to the bus readers.
+ */
+void gstd_pipeline_bus_set_qos (GstdPipelineBus * self, GstdPipelineQos * qos);
+
+/**
+ * gstd_pipeline_bus_decimate:
+ * @self: The pipeline bus the message was popped from
+ * @message: The message to account
+ *
+ * Accounts an element message against the configured decimation. Only
+ * one out of every N messages with a given structure name is kept.
+ *
+ * Returns: TRUE if the message should be dropped, FALSE otherwise
+ */
+gboolean gstd_pipeline_bus_decimate (GstdPipelineBus * self,
+    GstMessage * message);
+
+/**
+ * gstd_pipeline_bus_check_decimation:
+ * @decimation: A decimation, as in the "decimation" property
+ *
+ * Checks every entry of a decimation before it is applied. Setting an
+ * invalid decimation keeps the current one.
+ *
+ * Returns: TRUE if the decimation is valid, FALSE otherwise
+ */
+gboolean gstd_pipeline_bus_check_decimation (const gchar * decimation);
+
 
 G_END_DECLS
 
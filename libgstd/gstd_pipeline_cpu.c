@@ -0,0 +1,403 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gstd_pipeline_cpu.h"
+
+/* Gstd Pipeline Cpu debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_cpu_debug);
+#define GST_CAT_DEFAULT gstd_pipeline_cpu_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* A streaming thread that is currently running */
+typedef struct _GstdCpuThread GstdCpuThread;
+struct _GstdCpuThread
+{
+  gint tid;
+  gchar *owner;
+  /* Pooled threads are reused across tasks, only the time after the
+     task entered is accounted */
+  guint64 start;
+};
+
+/* CPU time of the threads an element owns */
+typedef struct _GstdCpuElement GstdCpuElement;
+struct _GstdCpuElement
+{
+  /* Time spent by threads that already left */
+  guint64 retired;
+  /* Total time at the previous read */
+  guint64 previous;
+  /* Scratch total for the read in progress */
+  guint64 current;
+};
+
+/**
+ * GstdPipelineCpu:
+ * CPU time spent by the streaming threads of a pipeline
+ */
+struct _GstdPipelineCpu
+{
+  GstdObject parent;
+
+  /* The fields below are protected by the object lock */
+
+  /* Thread id to GstdCpuThread */
+  GHashTable *threads;
+
+  /* Owner element name to GstdCpuElement */
+  GHashTable *elements;
+
+  GstClockTime previous_time;
+  guint64 previous_total;
+};
+
+struct _GstdPipelineCpuClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineCpu, gstd_pipeline_cpu, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_pipeline_cpu_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_pipeline_cpu_finalize (GObject * obj);
+static void gstd_pipeline_cpu_thread_free (GstdCpuThread * thread);
+static GstdCpuElement *gstd_pipeline_cpu_get_element (GstdPipelineCpu * self,
+    const gchar * name);
+static gboolean gstd_pipeline_cpu_read_thread (gint tid, guint64 * time);
+static gint gstd_pipeline_cpu_get_tid (void);
+static void gstd_pipeline_cpu_set_usage (GstdIFormatter * formatter,
+    guint64 time, GstClockTime elapsed);
+
+static void
+gstd_pipeline_cpu_class_init (GstdPipelineCpuClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->finalize = gstd_pipeline_cpu_finalize;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_pipeline_cpu_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_cpu_debug, "gstdpipelinecpu",
+      debug_color, "Gstd Pipeline Cpu category");
+}
+
+static void
+gstd_pipeline_cpu_init (GstdPipelineCpu * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline cpu");
+  self->threads = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) gstd_pipeline_cpu_thread_free);
+  self->elements = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_free);
+  self->previous_time = gst_util_get_timestamp ();
+  self->previous_total = 0;
+}
+
+static void
+gstd_pipeline_cpu_thread_free (GstdCpuThread * thread)
+{
+  g_free (thread->owner);
+  g_free (thread);
+}
+
+static gint
+gstd_pipeline_cpu_get_tid (void)
+{
+#ifdef __linux__
+  return (gint) syscall (SYS_gettid);
+#else
+  return -1;
+#endif
+}
+
+/* Reads the user plus system time of a thread of this process */
+static gboolean
+gstd_pipeline_cpu_read_thread (gint tid, guint64 * time)
+{
+#ifdef __linux__
+  gchar *path;
+  gchar *contents = NULL;
+  gchar *fields;
+  guint64 utime;
+  guint64 stime;
+  glong ticks;
+  gboolean ret = FALSE;
+
+  path = g_strdup_printf ("/proc/self/task/%d/stat", tid);
+  if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+    goto out;
+  }
+
+  /* The thread name may contain spaces and parentheses, the fields
+     start after the last closing one */
+  fields = strrchr (contents, ')');
+  if (!fields) {
+    goto out;
+  }
+
+  /* state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt
+     cmajflt utime stime */
+  if (2 != sscanf (fields + 1,
+          " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %" G_GUINT64_FORMAT
+          " %" G_GUINT64_FORMAT, &utime, &stime)) {
+    goto out;
+  }
+
+  ticks = sysconf (_SC_CLK_TCK);
+  if (ticks <= 0) {
+    goto out;
+  }
+
+  *time = gst_util_uint64_scale (utime + stime, GST_SECOND, ticks);
+  ret = TRUE;
+
+out:
+  g_free (contents);
+  g_free (path);
+  return ret;
+#else
+  return FALSE;
+#endif
+}
+
+static GstdCpuElement *
+gstd_pipeline_cpu_get_element (GstdPipelineCpu * self, const gchar * name)
+{
+  GstdCpuElement *element;
+
+  element = g_hash_table_lookup (self->elements, name);
+  if (!element) {
+    element = g_new0 (GstdCpuElement, 1);
+    g_hash_table_insert (self->elements, g_strdup (name), element);
+  }
+
+  return element;
+}
+
+void
+gstd_pipeline_cpu_stream_status (GstdPipelineCpu * self, GstMessage * message)
+{
+  GstStreamStatusType type;
+  GstElement *owner;
+  GstdCpuThread *thread;
+  GstdCpuElement *element;
+  guint64 time;
+  gint tid;
+
+  g_return_if_fail (GSTD_IS_PIPELINE_CPU (self));
+  g_return_if_fail (GST_IS_MESSAGE (message));
+
+  gst_message_parse_stream_status (message, &type, &owner);
+
+  /* Enter and leave are posted from the streaming thread itself */
+  if (GST_STREAM_STATUS_TYPE_ENTER != type
+      && GST_STREAM_STATUS_TYPE_LEAVE != type) {
+    return;
+  }
+
+  tid = gstd_pipeline_cpu_get_tid ();
+  if (tid < 0) {
+    return;
+  }
+
+  GST_OBJECT_LOCK (self);
+  if (GST_STREAM_STATUS_TYPE_ENTER == type) {
+    thread = g_new0 (GstdCpuThread, 1);
+    thread->tid = tid;
+    thread->owner = g_strdup (GST_OBJECT_NAME (owner));
+    if (!gstd_pipeline_cpu_read_thread (tid, &thread->start)) {
+      thread->start = 0;
+    }
+    gstd_pipeline_cpu_get_element (self, thread->owner);
+    g_hash_table_replace (self->threads, GINT_TO_POINTER (tid), thread);
+    GST_DEBUG_OBJECT (self, "Thread %d of %s entered", tid, thread->owner);
+  } else {
+    thread = g_hash_table_lookup (self->threads, GINT_TO_POINTER (tid));
+    /* Keep what the thread spent once it is gone */
+    if (thread && gstd_pipeline_cpu_read_thread (tid, &time)) {
+      element = gstd_pipeline_cpu_get_element (self, thread->owner);
+      element->retired += time - MIN (thread->start, time);
+    }
+    GST_DEBUG_OBJECT (self, "Thread %d left", tid);
+    g_hash_table_remove (self->threads, GINT_TO_POINTER (tid));
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* Percentage of a core used over the elapsed time, may exceed 100 on
+   multicore systems */
+static void
+gstd_pipeline_cpu_set_usage (GstdIFormatter * formatter, guint64 time,
+    GstClockTime elapsed)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_DOUBLE);
+  g_value_set_double (&gvalue, elapsed ? 100.0 * time / elapsed : 0);
+  gstd_iformatter_set_member_name (formatter, "usage");
+  gstd_iformatter_set_value (formatter, &gvalue);
+  g_value_unset (&gvalue);
+}
+
+static GstdReturnCode
+gstd_pipeline_cpu_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdPipelineCpu *self;
+  GstdIFormatter *formatter;
+  GHashTableIter iter;
+  GstdCpuThread *thread;
+  GstdCpuElement *element;
+  const gchar *name;
+  GstClockTime now;
+  GstClockTime elapsed;
+  guint64 time;
+  guint64 total = 0;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_CPU (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  GST_OBJECT_LOCK (self);
+
+  now = gst_util_get_timestamp ();
+  elapsed = now - self->previous_time;
+
+  g_hash_table_iter_init (&iter, self->elements);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & element)) {
+    element->current = element->retired;
+  }
+
+  gstd_iformatter_set_member_name (formatter, "threads");
+  gstd_iformatter_begin_array (formatter);
+
+  g_hash_table_iter_init (&iter, self->threads);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & thread)) {
+    if (!gstd_pipeline_cpu_read_thread (thread->tid, &time)) {
+      continue;
+    }
+
+    time -= MIN (thread->start, time);
+    element = gstd_pipeline_cpu_get_element (self, thread->owner);
+    element->current += time;
+
+    gstd_iformatter_begin_object (formatter);
+
+    gstd_iformatter_set_member_name (formatter, "tid");
+    gstd_iformatter_set_uint64_value (formatter, thread->tid);
+
+    gstd_iformatter_set_member_name (formatter, "owner");
+    gstd_iformatter_set_string_value (formatter, thread->owner);
+
+    gstd_iformatter_set_member_name (formatter, "time");
+    gstd_iformatter_set_uint64_value (formatter, time);
+
+    gstd_iformatter_end_object (formatter);
+  }
+
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "elements");
+  gstd_iformatter_begin_array (formatter);
+
+  g_hash_table_iter_init (&iter, self->elements);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & name,
+          (gpointer *) & element)) {
+    gstd_iformatter_begin_object (formatter);
+
+    gstd_iformatter_set_member_name (formatter, "name");
+    gstd_iformatter_set_string_value (formatter, name);
+
+    gstd_iformatter_set_member_name (formatter, "time");
+    gstd_iformatter_set_uint64_value (formatter, element->current);
+    gstd_pipeline_cpu_set_usage (formatter,
+        element->current - MIN (element->previous, element->current),
+        elapsed);
+
+    gstd_iformatter_end_object (formatter);
+
+    element->previous = element->current;
+    total += element->current;
+  }
+
+  gstd_iformatter_end_array (formatter);
+
+  /* Time is in nanoseconds, usage is averaged since the previous
+     read */
+  gstd_iformatter_set_member_name (formatter, "time");
+  gstd_iformatter_set_uint64_value (formatter, total);
+  gstd_pipeline_cpu_set_usage (formatter,
+      total - MIN (self->previous_total, total), elapsed);
+
+  self->previous_total = total;
+  self->previous_time = now;
+
+  GST_OBJECT_UNLOCK (self);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdPipelineCpu *
+gstd_pipeline_cpu_new (void)
+{
+  return g_object_new (GSTD_TYPE_PIPELINE_CPU, "name", "cpu", NULL);
+}
+
+static void
+gstd_pipeline_cpu_finalize (GObject * object)
+{
+  GstdPipelineCpu *self = GSTD_PIPELINE_CPU (object);
+
+  g_hash_table_unref (self->threads);
+  g_hash_table_unref (self->elements);
+
+  G_OBJECT_CLASS (gstd_pipeline_cpu_parent_class)->finalize (object);
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PIPELINE_CPU_H__
+#define __GSTD_PIPELINE_CPU_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_PIPELINE_CPU \
+  (gstd_pipeline_cpu_get_type())
+#define GSTD_PIPELINE_CPU(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_PIPELINE_CPU,GstdPipelineCpu))
+#define GSTD_PIPELINE_CPU_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_PIPELINE_CPU,GstdPipelineCpuClass))
+#define GSTD_IS_PIPELINE_CPU(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_PIPELINE_CPU))
+#define GSTD_IS_PIPELINE_CPU_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_PIPELINE_CPU))
+#define GSTD_PIPELINE_CPU_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_PIPELINE_CPU, GstdPipelineCpuClass))
+typedef struct _GstdPipelineCpu GstdPipelineCpu;
+typedef struct _GstdPipelineCpuClass GstdPipelineCpuClass;
+
+GType gstd_pipeline_cpu_get_type (void);
+
+/**
+ * Creates the CPU usage node of a pipeline
+ *
+ * \return A new GstdPipelineCpu
+ **/
+GstdPipelineCpu *gstd_pipeline_cpu_new (void);
+
+/**
+ * Tracks the streaming thread that posted a stream status message.
+ * Must be called synchronously, from the thread posting the message.
+ *
+ * \param self The CPU node of the pipeline the message belongs to
+ * \param message A GST_MESSAGE_STREAM_STATUS message
+ **/
+void gstd_pipeline_cpu_stream_status (GstdPipelineCpu * self,
+    GstMessage * message);
+
+G_END_DECLS
+#endif // __GSTD_PIPELINE_CPU_H__
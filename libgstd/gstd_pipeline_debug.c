@@ -0,0 +1,666 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstd_pipeline_debug.h"
+#include "gstd_property_reader.h"
+
+/* Gstd Pipeline Debug debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_debug_cat);
+#define GST_CAT_DEFAULT gstd_pipeline_debug_cat
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+#define PROP_ENABLE_DEFAULT FALSE
+#define PROP_THRESHOLD_DEFAULT "*:4"
+
+enum
+{
+  PROP_ENABLE = 1,
+  PROP_THRESHOLD,
+  PROP_FILE,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+typedef struct _GstdDebugScope GstdDebugScope;
+typedef struct _GstdDebugRaise GstdDebugRaise;
+
+/* The thresholds of an enabled pipeline, resolved per category */
+struct _GstdDebugScope
+{
+  /* Only compared against, never dereferenced */
+  GstObject *pipeline;
+  /* GstDebugCategory to GstDebugLevel */
+  GHashTable *levels;
+  /* Where the messages of the pipeline go, NULL for the usual logs */
+  FILE *file;
+};
+
+/* A category threshold raised so the messages of a pipeline reach the
+ * log functions, and what it was before */
+struct _GstdDebugRaise
+{
+  GstDebugLevel original;
+  GstDebugLevel level;
+};
+
+/**
+ * GstdPipelineDebug:
+ * Debug thresholds scoped to the objects of a pipeline
+ */
+struct _GstdPipelineDebug
+{
+  GstdObject parent;
+
+  GstElement *target;
+
+  /* Protected by the object lock */
+  gboolean enable;
+  gchar *threshold;
+  gchar *filename;
+  GstdDebugScope *scope;
+};
+
+struct _GstdPipelineDebugClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineDebug, gstd_pipeline_debug, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static void gstd_pipeline_debug_set_property (GObject *, guint,
+    const GValue *, GParamSpec *);
+static void gstd_pipeline_debug_get_property (GObject *, guint, GValue *,
+    GParamSpec *);
+static void gstd_pipeline_debug_dispose (GObject *);
+static void gstd_pipeline_debug_update (GstdPipelineDebug * self);
+static void gstd_pipeline_debug_apply (void);
+static void gstd_pipeline_debug_install (void);
+static GHashTable *gstd_pipeline_debug_resolve (const gchar * threshold);
+static gboolean gstd_pipeline_debug_parse_level (const gchar * name,
+    GstDebugLevel * level);
+static GstdDebugScope *gstd_debug_scope_find (GObject * object);
+static gboolean gstd_debug_scope_accepts (GstdDebugScope * scope,
+    GstDebugCategory * category, GstDebugLevel level);
+static void gstd_debug_scope_free (GstdDebugScope * scope);
+static void gstd_pipeline_debug_log_default (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message,
+    gpointer user_data) G_GNUC_NO_INSTRUMENT;
+static void gstd_pipeline_debug_log_file (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message,
+    gpointer user_data) G_GNUC_NO_INSTRUMENT;
+
+/* Read by every log function call, nothing here may log while holding
+ * the lock for writing */
+static GRWLock scopes_lock;
+static GList *scopes = NULL;
+static GHashTable *raised = NULL;
+static gint n_scopes = 0;
+static gint n_files = 0;
+
+static void
+gstd_pipeline_debug_class_init (GstdPipelineDebugClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  oclass->set_property = gstd_pipeline_debug_set_property;
+  oclass->get_property = gstd_pipeline_debug_get_property;
+  oclass->dispose = gstd_pipeline_debug_dispose;
+
+  properties[PROP_ENABLE] =
+      g_param_spec_boolean ("enable",
+      "Enable",
+      "Apply the threshold to the messages of the pipeline",
+      PROP_ENABLE_DEFAULT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_THRESHOLD] =
+      g_param_spec_string ("threshold",
+      "Threshold",
+      "The debug level threshold for the pipeline, as in GST_DEBUG",
+      PROP_THRESHOLD_DEFAULT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_FILE] =
+      g_param_spec_string ("file",
+      "File",
+      "Where to write the messages of the pipeline instead of the usual "
+      "logs, empty to use the usual logs",
+      NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (oclass, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_debug_cat, "gstdpipelinedebug",
+      debug_color, "Gstd Pipeline Debug category");
+}
+
+static void
+gstd_pipeline_debug_init (GstdPipelineDebug * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline debug");
+
+  self->target = NULL;
+  self->enable = PROP_ENABLE_DEFAULT;
+  self->threshold = g_strdup (PROP_THRESHOLD_DEFAULT);
+  self->filename = NULL;
+  self->scope = NULL;
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static void
+gstd_pipeline_debug_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdPipelineDebug *self = GSTD_PIPELINE_DEBUG (object);
+
+  GST_OBJECT_LOCK (self);
+
+  switch (property_id) {
+    case PROP_ENABLE:
+      GST_DEBUG_OBJECT (self, "Returning debug enabled %d", self->enable);
+      g_value_set_boolean (value, self->enable);
+      break;
+    case PROP_THRESHOLD:
+      GST_DEBUG_OBJECT (self, "Returning debug threshold %s",
+          self->threshold);
+      g_value_set_string (value, self->threshold);
+      break;
+    case PROP_FILE:
+      GST_DEBUG_OBJECT (self, "Returning debug file %s",
+          GST_STR_NULL (self->filename));
+      g_value_set_string (value, self->filename);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gstd_pipeline_debug_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdPipelineDebug *self = GSTD_PIPELINE_DEBUG (object);
+  const gchar *threshold;
+
+  GST_OBJECT_LOCK (self);
+
+  switch (property_id) {
+    case PROP_ENABLE:
+      self->enable = g_value_get_boolean (value);
+      GST_INFO_OBJECT (self, "Changing debug enabled to %d", self->enable);
+      break;
+    case PROP_THRESHOLD:
+      threshold = g_value_get_string (value);
+      /* An invalid threshold would silently disable the scope */
+      if (!gstd_pipeline_debug_check_threshold (threshold)) {
+        GST_ERROR_OBJECT (self, "Ignoring invalid debug threshold \"%s\"",
+            GST_STR_NULL (threshold));
+        GST_OBJECT_UNLOCK (self);
+        return;
+      }
+      g_free (self->threshold);
+      self->threshold = g_value_dup_string (value);
+      GST_INFO_OBJECT (self, "Changing debug threshold to %s",
+          GST_STR_NULL (self->threshold));
+      break;
+    case PROP_FILE:
+      g_free (self->filename);
+      self->filename = g_value_dup_string (value);
+      /* An empty file goes back to the usual logs */
+      if (self->filename && '\0' == self->filename[0]) {
+        g_clear_pointer (&self->filename, g_free);
+      }
+      GST_INFO_OBJECT (self, "Changing debug file to %s",
+          GST_STR_NULL (self->filename));
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      GST_OBJECT_UNLOCK (self);
+      return;
+  }
+
+  /* Nothing changes until the pipeline is attached */
+  if (self->target) {
+    gstd_pipeline_debug_update (self);
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gstd_pipeline_debug_dispose (GObject * object)
+{
+  GstdPipelineDebug *self = GSTD_PIPELINE_DEBUG (object);
+
+  GST_INFO_OBJECT (self, "Disposing pipeline debug");
+
+  GST_OBJECT_LOCK (self);
+  if (self->target) {
+    self->enable = FALSE;
+    gstd_pipeline_debug_update (self);
+    gst_object_unref (self->target);
+    self->target = NULL;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  g_clear_pointer (&self->threshold, g_free);
+  g_clear_pointer (&self->filename, g_free);
+
+  G_OBJECT_CLASS (gstd_pipeline_debug_parent_class)->dispose (object);
+}
+
+/* Called with the object lock */
+static void
+gstd_pipeline_debug_update (GstdPipelineDebug * self)
+{
+  GstdDebugScope *scope = NULL;
+  GstdDebugScope *old;
+  GHashTable *levels = NULL;
+  FILE *file = NULL;
+  GList *iter;
+  gint files = 0;
+
+  if (self->enable) {
+    levels = gstd_pipeline_debug_resolve (self->threshold);
+    if (!levels) {
+      GST_ERROR_OBJECT (self, "Invalid debug threshold \"%s\"",
+          GST_STR_NULL (self->threshold));
+    }
+  }
+
+  if (levels && self->filename) {
+    file = g_fopen (self->filename, "a");
+    if (!file) {
+      GST_ERROR_OBJECT (self, "Unable to open %s, using the usual logs: %s",
+          self->filename, g_strerror (errno));
+    }
+  }
+
+  if (levels) {
+    gstd_pipeline_debug_install ();
+
+    scope = g_new0 (GstdDebugScope, 1);
+    scope->pipeline = GST_OBJECT (self->target);
+    scope->levels = levels;
+    scope->file = file;
+  }
+
+  g_rw_lock_writer_lock (&scopes_lock);
+
+  old = self->scope;
+  if (old) {
+    scopes = g_list_remove (scopes, old);
+  }
+  if (scope) {
+    scopes = g_list_prepend (scopes, scope);
+  }
+  self->scope = scope;
+
+  gstd_pipeline_debug_apply ();
+
+  for (iter = scopes; iter; iter = iter->next) {
+    if (((GstdDebugScope *) iter->data)->file) {
+      files++;
+    }
+  }
+  g_atomic_int_set (&n_scopes, g_list_length (scopes));
+  g_atomic_int_set (&n_files, files);
+
+  g_rw_lock_writer_unlock (&scopes_lock);
+
+  if (old) {
+    gstd_debug_scope_free (old);
+  }
+
+  GST_INFO_OBJECT (self, "Pipeline debug %s", scope ? "enabled" : "disabled");
+}
+
+/* Called with the scopes lock held for writing. Categories are raised
+ * to the highest level any pipeline wants, so their messages reach the
+ * log functions, which then filter them by pipeline */
+static void
+gstd_pipeline_debug_apply (void)
+{
+  GstdDebugScope *scope;
+  GstdDebugRaise *raise;
+  GstDebugCategory *category;
+  GstDebugLevel current;
+  GstDebugLevel level;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  GList *walk;
+
+  if (!raised) {
+    raised = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+  }
+
+  /* Give back the thresholds still raised, the others were changed
+   * by the global threshold since */
+  g_hash_table_iter_init (&iter, raised);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    category = key;
+    raise = value;
+    if (gst_debug_category_get_threshold (category) == raise->level) {
+      gst_debug_category_set_threshold (category, raise->original);
+    }
+  }
+  g_hash_table_remove_all (raised);
+
+  for (walk = scopes; walk; walk = walk->next) {
+    scope = walk->data;
+
+    g_hash_table_iter_init (&iter, scope->levels);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+      category = key;
+      level = GPOINTER_TO_INT (value);
+      current = gst_debug_category_get_threshold (category);
+      if (level <= current) {
+        continue;
+      }
+
+      raise = g_hash_table_lookup (raised, category);
+      if (!raise) {
+        raise = g_new (GstdDebugRaise, 1);
+        raise->original = current;
+        g_hash_table_insert (raised, category, raise);
+      }
+      raise->level = level;
+      gst_debug_category_set_threshold (category, level);
+    }
+  }
+}
+
+void
+gstd_pipeline_debug_refresh (void)
+{
+  if (!g_atomic_int_get (&n_scopes)) {
+    return;
+  }
+
+  g_rw_lock_writer_lock (&scopes_lock);
+  gstd_pipeline_debug_apply ();
+  g_rw_lock_writer_unlock (&scopes_lock);
+}
+
+/* Log functions are only added once, and never while holding the
+ * scopes lock, since adding them logs */
+static void
+gstd_pipeline_debug_install (void)
+{
+  static gsize installed = 0;
+
+  if (!g_once_init_enter (&installed)) {
+    return;
+  }
+
+  /* The default log function writes to stderr unless GST_DEBUG_FILE
+   * redirects it, which it can't be told apart from */
+  if (g_getenv ("GST_DEBUG_FILE")) {
+    GST_WARNING ("GST_DEBUG_FILE is set, it will get the messages of "
+        "every pipeline whose debug is enabled");
+  } else if (gst_debug_remove_log_function (gst_debug_log_default) > 0) {
+    gst_debug_add_log_function (gstd_pipeline_debug_log_default, NULL, NULL);
+  }
+
+  gst_debug_add_log_function (gstd_pipeline_debug_log_file, NULL, NULL);
+
+  g_once_init_leave (&installed, 1);
+}
+
+static gboolean
+gstd_pipeline_debug_parse_level (const gchar * name, GstDebugLevel * level)
+{
+  gchar *end;
+  gint i;
+
+  if (g_ascii_isdigit (name[0])) {
+    i = strtol (name, &end, 10);
+    if ('\0' != *end || i >= GST_LEVEL_COUNT) {
+      return FALSE;
+    }
+    *level = i;
+    return TRUE;
+  }
+
+  for (i = 0; i < GST_LEVEL_COUNT; i++) {
+    if (!g_ascii_strcasecmp (name, gst_debug_level_get_name (i))) {
+      *level = i;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Resolves a GST_DEBUG like threshold against the existing categories.
+ * Later entries override earlier ones, a bare level applies to every
+ * category. Returns NULL if the threshold is invalid. */
+static GHashTable *
+gstd_pipeline_debug_resolve (const gchar * threshold)
+{
+  GHashTable *levels;
+  GSList *categories;
+  GSList *walk;
+  gchar **entries;
+  gchar **entry;
+  gchar *pattern;
+  gchar *separator;
+  GstDebugLevel level;
+  gboolean ret = TRUE;
+
+  if (!threshold) {
+    return NULL;
+  }
+
+  levels = g_hash_table_new (NULL, NULL);
+  categories = gst_debug_get_all_categories ();
+
+  entries = g_strsplit (threshold, ",", -1);
+  for (entry = entries; *entry && ret; entry++) {
+    g_strstrip (*entry);
+    if ('\0' == (*entry)[0]) {
+      continue;
+    }
+
+    separator = strrchr (*entry, ':');
+    if (separator) {
+      pattern = g_strndup (*entry, separator - *entry);
+    } else {
+      pattern = g_strdup ("*");
+    }
+
+    ret = gstd_pipeline_debug_parse_level (separator ? separator + 1 : *entry,
+        &level);
+
+    for (walk = categories; walk && ret; walk = walk->next) {
+      if (g_pattern_match_simple (pattern,
+              gst_debug_category_get_name (walk->data))) {
+        g_hash_table_insert (levels, walk->data, GINT_TO_POINTER (level));
+      }
+    }
+
+    g_free (pattern);
+  }
+  g_strfreev (entries);
+  g_slist_free (categories);
+
+  if (!ret) {
+    g_hash_table_unref (levels);
+    levels = NULL;
+  }
+
+  return levels;
+}
+
+gboolean
+gstd_pipeline_debug_check_threshold (const gchar * threshold)
+{
+  GHashTable *levels;
+
+  levels = gstd_pipeline_debug_resolve (threshold);
+  if (!levels) {
+    return FALSE;
+  }
+
+  g_hash_table_unref (levels);
+
+  return TRUE;
+}
+
+/* Called with the scopes lock. The parents are read without locking,
+ * like GStreamer does when it logs, since messages are often logged
+ * while holding the object lock */
+static GstdDebugScope *
+gstd_debug_scope_find (GObject * object)
+{
+  GstObject *ancestor;
+  GList *walk;
+
+  if (!object || !GST_IS_OBJECT (object)) {
+    return NULL;
+  }
+
+  for (ancestor = GST_OBJECT (object); ancestor;
+      ancestor = GST_OBJECT_PARENT (ancestor)) {
+    for (walk = scopes; walk; walk = walk->next) {
+      if (((GstdDebugScope *) walk->data)->pipeline == ancestor) {
+        return walk->data;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static gboolean
+gstd_debug_scope_accepts (GstdDebugScope * scope, GstDebugCategory * category,
+    GstDebugLevel level)
+{
+  return level <= GPOINTER_TO_INT (g_hash_table_lookup (scope->levels,
+          category));
+}
+
+static void
+gstd_debug_scope_free (GstdDebugScope * scope)
+{
+  if (scope->file) {
+    fclose (scope->file);
+  }
+  g_hash_table_unref (scope->levels);
+  g_free (scope);
+}
+
+gboolean
+gstd_pipeline_debug_filter (GstDebugCategory * category, GstDebugLevel level,
+    GObject * object)
+{
+  GstdDebugRaise *raise;
+  GstdDebugScope *scope;
+  gboolean ret = TRUE;
+
+  /* Nothing is raised while no pipeline debug is enabled */
+  if (G_LIKELY (!g_atomic_int_get (&n_scopes))) {
+    return TRUE;
+  }
+
+  g_rw_lock_reader_lock (&scopes_lock);
+
+  /* Only messages below the global threshold need to be looked at */
+  raise = raised ? g_hash_table_lookup (raised, category) : NULL;
+  if (raise && level > raise->original) {
+    scope = gstd_debug_scope_find (object);
+    ret = scope && !scope->file
+        && gstd_debug_scope_accepts (scope, category, level);
+  }
+
+  g_rw_lock_reader_unlock (&scopes_lock);
+
+  return ret;
+}
+
+static void
+gstd_pipeline_debug_log_default (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message,
+    gpointer user_data)
+{
+  if (gstd_pipeline_debug_filter (category, level, object)) {
+    gst_debug_log_default (category, level, file, function, line, object,
+        message, user_data);
+  }
+}
+
+static void
+gstd_pipeline_debug_log_file (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message,
+    gpointer user_data)
+{
+  GstdDebugScope *scope;
+
+  if (G_LIKELY (!g_atomic_int_get (&n_files))) {
+    return;
+  }
+
+  g_rw_lock_reader_lock (&scopes_lock);
+
+  scope = gstd_debug_scope_find (object);
+  if (scope && scope->file
+      && gstd_debug_scope_accepts (scope, category, level)) {
+    gst_debug_log_default (category, level, file, function, line, object,
+        message, scope->file);
+  }
+
+  g_rw_lock_reader_unlock (&scopes_lock);
+}
+
+GstdPipelineDebug *
+gstd_pipeline_debug_new (GstElement * target)
+{
+  GstdPipelineDebug *self;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (target), NULL);
+
+  self = g_object_new (GSTD_TYPE_PIPELINE_DEBUG, "name", "debug", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PIPELINE_DEBUG_H__
+#define __GSTD_PIPELINE_DEBUG_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_PIPELINE_DEBUG \
+  (gstd_pipeline_debug_get_type())
+#define GSTD_PIPELINE_DEBUG(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_PIPELINE_DEBUG,GstdPipelineDebug))
+#define GSTD_PIPELINE_DEBUG_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_PIPELINE_DEBUG,GstdPipelineDebugClass))
+#define GSTD_IS_PIPELINE_DEBUG(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_PIPELINE_DEBUG))
+#define GSTD_IS_PIPELINE_DEBUG_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_PIPELINE_DEBUG))
+#define GSTD_PIPELINE_DEBUG_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_PIPELINE_DEBUG, GstdPipelineDebugClass))
+typedef struct _GstdPipelineDebug GstdPipelineDebug;
+typedef struct _GstdPipelineDebugClass GstdPipelineDebugClass;
+
+GType gstd_pipeline_debug_get_type (void);
+
+/**
+ * Creates the debug node of a pipeline. Once enabled, its threshold
+ * applies only to the messages of the pipeline and its children.
+ *
+ * \param target The pipeline whose messages are scoped
+ *
+ * \return A new GstdPipelineDebug
+ **/
+GstdPipelineDebug *gstd_pipeline_debug_new (GstElement * target);
+
+/**
+ * Checks a threshold before it is given to a pipeline debug node,
+ * which keeps its previous threshold when given an invalid one.
+ *
+ * \param threshold A threshold as in GST_DEBUG, i.e.: "*:2,queue:5"
+ *
+ * \return TRUE if the threshold is valid
+ **/
+gboolean gstd_pipeline_debug_check_threshold (const gchar * threshold);
+
+/**
+ * Tells a log function whether to output a message. Messages enabled
+ * only by a pipeline threshold pass for that pipeline alone, and not
+ * at all when the pipeline logs to its own file.
+ *
+ * \param category The category of the message
+ * \param level The level of the message
+ * \param object The object the message is about, may be NULL
+ *
+ * \return TRUE if the message should be output
+ **/
+gboolean gstd_pipeline_debug_filter (GstDebugCategory * category,
+    GstDebugLevel level, GObject * object);
+
+/**
+ * Applies the pipeline thresholds again after the global ones changed
+ **/
+void gstd_pipeline_debug_refresh (void);
+
+G_END_DECLS
+#endif // __GSTD_PIPELINE_DEBUG_H__
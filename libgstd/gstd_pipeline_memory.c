@@ -0,0 +1,146 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_tracer.h"
+
+#include "gstd_pipeline_memory.h"
+
+/* Gstd Pipeline Memory debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_memory_debug);
+#define GST_CAT_DEFAULT gstd_pipeline_memory_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/**
+ * GstdPipelineMemory:
+ * Memory allocated by the elements of a pipeline
+ */
+struct _GstdPipelineMemory
+{
+  GstdObject parent;
+
+  GstElement *target;
+};
+
+struct _GstdPipelineMemoryClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineMemory, gstd_pipeline_memory, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_pipeline_memory_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_pipeline_memory_dispose (GObject * obj);
+
+static void
+gstd_pipeline_memory_class_init (GstdPipelineMemoryClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->dispose = gstd_pipeline_memory_dispose;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_pipeline_memory_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_memory_debug, "gstdpipelinememory",
+      debug_color, "Gstd Pipeline Memory category");
+}
+
+static void
+gstd_pipeline_memory_init (GstdPipelineMemory * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline memory");
+  self->target = NULL;
+}
+
+static GstdReturnCode
+gstd_pipeline_memory_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdPipelineMemory *self;
+  GstdIFormatter *formatter;
+  gsize current;
+  gsize peak;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_MEMORY (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_tracer_get_memory (self->target, &current, &peak);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  /* Sizes are in bytes */
+  gstd_iformatter_set_member_name (formatter, "current");
+  gstd_iformatter_set_uint64_value (formatter, current);
+  gstd_iformatter_set_member_name (formatter, "peak");
+  gstd_iformatter_set_uint64_value (formatter, peak);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdPipelineMemory *
+gstd_pipeline_memory_new (GstElement * target)
+{
+  GstdPipelineMemory *self;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (target), NULL);
+
+  gstd_tracer_acquire ();
+  gstd_tracer_track_memory (target);
+
+  self = g_object_new (GSTD_TYPE_PIPELINE_MEMORY, "name", "memory", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
+
+static void
+gstd_pipeline_memory_dispose (GObject * object)
+{
+  GstdPipelineMemory *self = GSTD_PIPELINE_MEMORY (object);
+
+  if (self->target) {
+    gst_object_unref (self->target);
+    self->target = NULL;
+    gstd_tracer_release ();
+  }
+
+  G_OBJECT_CLASS (gstd_pipeline_memory_parent_class)->dispose (object);
+}
@@ -0,0 +1,284 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_pipeline_qos.h"
+
+/* Gstd Pipeline QoS debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_qos_debug);
+#define GST_CAT_DEFAULT gstd_pipeline_qos_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* QoS reported by a single element */
+typedef struct _GstdQosElement GstdQosElement;
+struct _GstdQosElement
+{
+  guint64 messages;
+  gboolean live;
+  /* Cumulative counts as reported by the element, -1 if unknown */
+  gint64 processed;
+  gint64 dropped;
+  GstFormat format;
+  /* Nanoseconds, negative when the data arrived early */
+  gint64 jitter;
+  gint64 jitter_min;
+  gint64 jitter_max;
+  gint64 jitter_sum;
+  gdouble proportion;
+  gdouble proportion_min;
+  gdouble proportion_max;
+  gint quality;
+};
+
+/**
+ * GstdPipelineQos:
+ * Aggregates of the QoS messages posted in a pipeline
+ */
+struct _GstdPipelineQos
+{
+  GstdObject parent;
+
+  /* Element name to GstdQosElement, protected by the object lock */
+  GHashTable *elements;
+};
+
+struct _GstdPipelineQosClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineQos, gstd_pipeline_qos, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_pipeline_qos_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_pipeline_qos_finalize (GObject * obj);
+static void gstd_pipeline_qos_set_int64 (GstdIFormatter * formatter,
+    const gchar * name, gint64 value);
+static void gstd_pipeline_qos_set_double (GstdIFormatter * formatter,
+    const gchar * name, gdouble value);
+static void gstd_pipeline_qos_describe (const gchar * name,
+    const GstdQosElement * element, GstdIFormatter * formatter);
+
+static void
+gstd_pipeline_qos_class_init (GstdPipelineQosClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->finalize = gstd_pipeline_qos_finalize;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_pipeline_qos_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_qos_debug, "gstdpipelineqos",
+      debug_color, "Gstd Pipeline QoS category");
+}
+
+static void
+gstd_pipeline_qos_init (GstdPipelineQos * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline qos");
+  self->elements = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_free);
+}
+
+void
+gstd_pipeline_qos_message (GstdPipelineQos * self, GstMessage * message)
+{
+  GstdQosElement *element;
+  const gchar *name;
+  gboolean live;
+  gint64 jitter;
+  gdouble proportion;
+  gint quality;
+  GstFormat format;
+  guint64 processed;
+  guint64 dropped;
+
+  g_return_if_fail (GSTD_IS_PIPELINE_QOS (self));
+  g_return_if_fail (GST_MESSAGE_QOS == GST_MESSAGE_TYPE (message));
+
+  gst_message_parse_qos (message, &live, NULL, NULL, NULL, NULL);
+  gst_message_parse_qos_values (message, &jitter, &proportion, &quality);
+  gst_message_parse_qos_stats (message, &format, &processed, &dropped);
+
+  name = GST_MESSAGE_SRC_NAME (message);
+
+  GST_OBJECT_LOCK (self);
+
+  element = g_hash_table_lookup (self->elements, name);
+  if (!element) {
+    element = g_new0 (GstdQosElement, 1);
+    element->jitter_min = G_MAXINT64;
+    element->jitter_max = G_MININT64;
+    element->proportion_min = G_MAXDOUBLE;
+    element->proportion_max = -G_MAXDOUBLE;
+    g_hash_table_insert (self->elements, g_strdup (name), element);
+  }
+
+  element->messages++;
+  element->live = live;
+  element->format = format;
+  /* The stats are running totals, the latest ones are kept */
+  element->processed = GST_FORMAT_UNDEFINED == format ? -1 : (gint64) processed;
+  element->dropped = GST_FORMAT_UNDEFINED == format ? -1 : (gint64) dropped;
+  element->jitter = jitter;
+  element->jitter_min = MIN (element->jitter_min, jitter);
+  element->jitter_max = MAX (element->jitter_max, jitter);
+  element->jitter_sum += jitter;
+  element->proportion = proportion;
+  element->proportion_min = MIN (element->proportion_min, proportion);
+  element->proportion_max = MAX (element->proportion_max, proportion);
+  element->quality = quality;
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gstd_pipeline_qos_set_int64 (GstdIFormatter * formatter, const gchar * name,
+    gint64 value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_INT64);
+  g_value_set_int64 (&gvalue, value);
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &gvalue);
+  g_value_unset (&gvalue);
+}
+
+static void
+gstd_pipeline_qos_set_double (GstdIFormatter * formatter, const gchar * name,
+    gdouble value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_DOUBLE);
+  g_value_set_double (&gvalue, value);
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &gvalue);
+  g_value_unset (&gvalue);
+}
+
+static void
+gstd_pipeline_qos_describe (const gchar * name, const GstdQosElement * element,
+    GstdIFormatter * formatter)
+{
+  GValue live = G_VALUE_INIT;
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, name);
+
+  gstd_pipeline_qos_set_int64 (formatter, "messages", element->messages);
+
+  g_value_init (&live, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&live, element->live);
+  gstd_iformatter_set_member_name (formatter, "live");
+  gstd_iformatter_set_value (formatter, &live);
+  g_value_unset (&live);
+
+  gstd_iformatter_set_member_name (formatter, "format");
+  gstd_iformatter_set_string_value (formatter,
+      gst_format_get_name (element->format));
+  gstd_pipeline_qos_set_int64 (formatter, "processed", element->processed);
+  gstd_pipeline_qos_set_int64 (formatter, "dropped", element->dropped);
+
+  gstd_pipeline_qos_set_int64 (formatter, "jitter", element->jitter);
+  gstd_pipeline_qos_set_int64 (formatter, "jitter-min", element->jitter_min);
+  gstd_pipeline_qos_set_int64 (formatter, "jitter-max", element->jitter_max);
+  gstd_pipeline_qos_set_int64 (formatter, "jitter-avg",
+      element->jitter_sum / (gint64) element->messages);
+
+  gstd_pipeline_qos_set_double (formatter, "proportion", element->proportion);
+  gstd_pipeline_qos_set_double (formatter, "proportion-min",
+      element->proportion_min);
+  gstd_pipeline_qos_set_double (formatter, "proportion-max",
+      element->proportion_max);
+
+  gstd_pipeline_qos_set_int64 (formatter, "quality", element->quality);
+
+  gstd_iformatter_end_object (formatter);
+}
+
+static GstdReturnCode
+gstd_pipeline_qos_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdPipelineQos *self;
+  GstdIFormatter *formatter;
+  GHashTableIter iter;
+  gpointer name;
+  gpointer element;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_QOS (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  gstd_iformatter_set_member_name (formatter, "elements");
+  gstd_iformatter_begin_array (formatter);
+
+  GST_OBJECT_LOCK (self);
+  g_hash_table_iter_init (&iter, self->elements);
+  while (g_hash_table_iter_next (&iter, &name, &element)) {
+    gstd_pipeline_qos_describe (name, element, formatter);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdPipelineQos *
+gstd_pipeline_qos_new (void)
+{
+  return g_object_new (GSTD_TYPE_PIPELINE_QOS, "name", "qos", NULL);
+}
+
+static void
+gstd_pipeline_qos_finalize (GObject * object)
+{
+  GstdPipelineQos *self = GSTD_PIPELINE_QOS (object);
+
+  g_hash_table_unref (self->elements);
+
+  G_OBJECT_CLASS (gstd_pipeline_qos_parent_class)->finalize (object);
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PIPELINE_QOS_H__
+#define __GSTD_PIPELINE_QOS_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_PIPELINE_QOS \
+  (gstd_pipeline_qos_get_type())
+#define GSTD_PIPELINE_QOS(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_PIPELINE_QOS,GstdPipelineQos))
+#define GSTD_PIPELINE_QOS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_PIPELINE_QOS,GstdPipelineQosClass))
+#define GSTD_IS_PIPELINE_QOS(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_PIPELINE_QOS))
+#define GSTD_IS_PIPELINE_QOS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_PIPELINE_QOS))
+#define GSTD_PIPELINE_QOS_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_PIPELINE_QOS, GstdPipelineQosClass))
+typedef struct _GstdPipelineQos GstdPipelineQos;
+typedef struct _GstdPipelineQosClass GstdPipelineQosClass;
+
+GType gstd_pipeline_qos_get_type (void);
+
+/**
+ * Creates the QoS node of a pipeline
+ *
+ * \return A new GstdPipelineQos
+ **/
+GstdPipelineQos *gstd_pipeline_qos_new (void);
+
+/**
+ * Accumulates a QoS message into the aggregates of the element that
+ * posted it.
+ *
+ * \param self The QoS node of the pipeline the message belongs to
+ * \param message A GST_MESSAGE_QOS message
+ **/
+void gstd_pipeline_qos_message (GstdPipelineQos * self, GstMessage * message);
+
+G_END_DECLS
+#endif // __GSTD_PIPELINE_QOS_H__
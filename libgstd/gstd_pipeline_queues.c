@@ -0,0 +1,628 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstd_pipeline_queues.h"
+
+/* Gstd Pipeline Queues debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_queues_debug);
+#define GST_CAT_DEFAULT gstd_pipeline_queues_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+#define GSTD_QUEUE_DIMENSIONS 3
+
+/* Watched levels are sampled every few buffers instead of on every
+   one. Queues limited in buffers are sampled often enough to resolve a
+   1/GSTD_QUEUE_SAMPLE_STEPS of the limit, the rest every
+   GSTD_QUEUE_SAMPLE_INTERVAL buffers */
+#define GSTD_QUEUE_SAMPLE_STEPS 20
+#define GSTD_QUEUE_SAMPLE_INTERVAL 8
+
+/* Fill levels and their limits, in buffers, bytes and time. Every
+   queue-like element in GStreamer names them the same */
+static const gchar *level_names[GSTD_QUEUE_DIMENSIONS] = {
+  "current-level-buffers", "current-level-bytes", "current-level-time"
+};
+
+static const gchar *limit_names[GSTD_QUEUE_DIMENSIONS] = {
+  "max-size-buffers", "max-size-bytes", "max-size-time"
+};
+
+typedef struct _GstdQueueWatch GstdQueueWatch;
+typedef struct _GstdQueueProbe GstdQueueProbe;
+
+/* A queue being watched for water mark crossings. It is shared by
+ * the probes in both ends of the queue, the last one removed frees
+ * it. The thresholds are copied so the probes never reach back into
+ * the node.
+ */
+struct _GstdQueueWatch
+{
+  gint refcount;
+  /* The element, or the multiqueue pad, holding the current levels */
+  GObject *levels;
+  /* The element holding the limits */
+  GstElement *limits;
+  /* Looked up once, the probes run on every buffer */
+  GParamSpec *level_specs[GSTD_QUEUE_DIMENSIONS];
+  GParamSpec *limit_specs[GSTD_QUEUE_DIMENSIONS];
+  gchar *name;
+  guint high;
+  guint low;
+  /* Whether the queue went above high and didn't drain below low */
+  gint above;
+  /* Buffers between samples, and buffers seen through both ends */
+  guint interval;
+  gint seen;
+};
+
+struct _GstdQueueProbe
+{
+  GstPad *pad;
+  gulong id;
+};
+
+typedef void (*GstdQueueFunc) (GstdPipelineQueues * self, GObject * levels,
+    GstElement * limits, const gchar * name, gpointer data);
+
+/**
+ * GstdPipelineQueues:
+ * Fill levels of the queues in a pipeline
+ */
+struct _GstdPipelineQueues
+{
+  GstdObject parent;
+
+  GstElement *target;
+
+  /* Water marks in percent, protected by the object lock */
+  guint high;
+  guint low;
+
+  /* Installed GstdQueueProbe, protected by the object lock */
+  GArray *probes;
+};
+
+struct _GstdPipelineQueuesClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineQueues, gstd_pipeline_queues, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_pipeline_queues_to_string (GstdObject * obj, gchar ** outstring);
+static GstdReturnCode
+gstd_pipeline_queues_update (GstdObject * obj, const gchar * value);
+static void gstd_pipeline_queues_dispose (GObject * obj);
+static void gstd_pipeline_queues_finalize (GObject * obj);
+static void gstd_pipeline_queues_foreach (GstdPipelineQueues * self,
+    GstdQueueFunc func, gpointer data);
+static void gstd_pipeline_queues_find_specs (GObject * object,
+    const gchar ** names, GParamSpec ** specs);
+static guint64 gstd_pipeline_queues_get_uint64 (GObject * object,
+    GParamSpec * spec);
+static guint gstd_pipeline_queues_level (GObject * levels,
+    GParamSpec ** level_specs, GstElement * limits, GParamSpec ** limit_specs,
+    guint64 * current, guint64 * max);
+static void gstd_pipeline_queues_describe (GstdPipelineQueues * self,
+    GObject * levels, GstElement * limits, const gchar * name, gpointer data);
+static void gstd_pipeline_queues_watch (GstdPipelineQueues * self,
+    GObject * levels, GstElement * limits, const gchar * name, gpointer data);
+static void gstd_pipeline_queues_add_probe (GstdPipelineQueues * self,
+    GstPad * pad, GstdQueueWatch * watch);
+static void gstd_pipeline_queues_clear_probes (GstdPipelineQueues * self);
+static GstPadProbeReturn gstd_pipeline_queues_probe (GstPad * pad,
+    GstPadProbeInfo * info, gpointer data);
+static GstdQueueWatch *gstd_queue_watch_ref (GstdQueueWatch * watch);
+static void gstd_queue_watch_unref (GstdQueueWatch * watch);
+static gboolean gstd_pipeline_queues_parse_percent (const gchar * token,
+    guint * percent);
+
+static void
+gstd_pipeline_queues_class_init (GstdPipelineQueuesClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->dispose = gstd_pipeline_queues_dispose;
+  oclass->finalize = gstd_pipeline_queues_finalize;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_pipeline_queues_to_string);
+  gstdc->update = GST_DEBUG_FUNCPTR (gstd_pipeline_queues_update);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_queues_debug, "gstdpipelinequeues",
+      debug_color, "Gstd Pipeline Queues category");
+}
+
+static void
+gstd_pipeline_queues_init (GstdPipelineQueues * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline queues");
+  self->target = NULL;
+  self->high = 0;
+  self->low = 0;
+  self->probes = g_array_new (FALSE, FALSE, sizeof (GstdQueueProbe));
+}
+
+static GstdQueueWatch *
+gstd_queue_watch_ref (GstdQueueWatch * watch)
+{
+  g_atomic_int_inc (&watch->refcount);
+
+  return watch;
+}
+
+static void
+gstd_queue_watch_unref (GstdQueueWatch * watch)
+{
+  if (!g_atomic_int_dec_and_test (&watch->refcount)) {
+    return;
+  }
+
+  g_object_unref (watch->levels);
+  gst_object_unref (watch->limits);
+  g_free (watch->name);
+  g_free (watch);
+}
+
+static void
+gstd_pipeline_queues_find_specs (GObject * object, const gchar ** names,
+    GParamSpec ** specs)
+{
+  guint i;
+
+  for (i = 0; i < GSTD_QUEUE_DIMENSIONS; i++) {
+    specs[i] = g_object_class_find_property (G_OBJECT_GET_CLASS (object),
+        names[i]);
+  }
+}
+
+static guint64
+gstd_pipeline_queues_get_uint64 (GObject * object, GParamSpec * spec)
+{
+  GValue value = G_VALUE_INIT;
+  guint64 ret;
+
+  if (!spec) {
+    return 0;
+  }
+
+  /* Buffers and bytes are guint, time is guint64. Reading them with
+     their own type spares a transformation */
+  g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (spec));
+  g_object_get_property (object, spec->name, &value);
+  ret = G_VALUE_HOLDS_UINT (&value) ? g_value_get_uint (&value) :
+      g_value_get_uint64 (&value);
+  g_value_unset (&value);
+
+  return ret;
+}
+
+static guint
+gstd_pipeline_queues_level (GObject * levels, GParamSpec ** level_specs,
+    GstElement * limits, GParamSpec ** limit_specs, guint64 * current,
+    guint64 * max)
+{
+  guint percent = 0;
+  guint i;
+
+  /* A queue is as full as its fullest limited dimension */
+  for (i = 0; i < GSTD_QUEUE_DIMENSIONS; i++) {
+    current[i] = gstd_pipeline_queues_get_uint64 (levels, level_specs[i]);
+    max[i] = gstd_pipeline_queues_get_uint64 (G_OBJECT (limits),
+        limit_specs[i]);
+    if (max[i]) {
+      percent = MAX (percent, MIN (100, current[i] * 100 / max[i]));
+    }
+  }
+
+  return percent;
+}
+
+static void
+gstd_pipeline_queues_foreach (GstdPipelineQueues * self, GstdQueueFunc func,
+    gpointer data)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstElement *element;
+  GObjectClass *klass;
+  GList *pads;
+  GList *iter;
+  gchar *name;
+  gboolean done = FALSE;
+
+  it = gst_bin_iterate_recurse (GST_BIN (self->target));
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+        element = GST_ELEMENT (g_value_get_object (&item));
+        klass = G_OBJECT_GET_CLASS (element);
+
+        if (g_object_class_find_property (klass, level_names[0])) {
+          func (self, G_OBJECT (element), element, GST_OBJECT_NAME (element),
+              data);
+        } else if (g_object_class_find_property (klass, limit_names[0])) {
+          /* Multiqueue keeps a level per stream in its source pads */
+          GST_OBJECT_LOCK (element);
+          pads = g_list_copy_deep (element->srcpads, (GCopyFunc)
+              gst_object_ref, NULL);
+          GST_OBJECT_UNLOCK (element);
+
+          for (iter = pads; iter; iter = iter->next) {
+            if (!g_object_class_find_property (G_OBJECT_GET_CLASS (iter->data),
+                    level_names[0])) {
+              continue;
+            }
+            name = g_strdup_printf ("%s:%s", GST_OBJECT_NAME (element),
+                GST_OBJECT_NAME (iter->data));
+            func (self, G_OBJECT (iter->data), element, name, data);
+            g_free (name);
+          }
+          g_list_free_full (pads, gst_object_unref);
+        }
+        g_value_reset (&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        GST_WARNING_OBJECT (self, "Pipeline changed while reading queues");
+        done = TRUE;
+        break;
+      case GST_ITERATOR_ERROR:
+      case GST_ITERATOR_DONE:
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+static void
+gstd_pipeline_queues_describe (GstdPipelineQueues * self, GObject * levels,
+    GstElement * limits, const gchar * name, gpointer data)
+{
+  GstdIFormatter *formatter = data;
+  GstElementFactory *factory;
+  GParamSpec *level_specs[GSTD_QUEUE_DIMENSIONS];
+  GParamSpec *limit_specs[GSTD_QUEUE_DIMENSIONS];
+  guint64 current[GSTD_QUEUE_DIMENSIONS];
+  guint64 max[GSTD_QUEUE_DIMENSIONS];
+  guint percent;
+  guint i;
+
+  gstd_pipeline_queues_find_specs (levels, level_names, level_specs);
+  gstd_pipeline_queues_find_specs (G_OBJECT (limits), limit_names,
+      limit_specs);
+  percent = gstd_pipeline_queues_level (levels, level_specs, limits,
+      limit_specs, current, max);
+  factory = gst_element_get_factory (limits);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, name);
+
+  gstd_iformatter_set_member_name (formatter, "factory");
+  gstd_iformatter_set_string_value (formatter,
+      factory ? GST_OBJECT_NAME (factory) : "");
+
+  for (i = 0; i < GSTD_QUEUE_DIMENSIONS; i++) {
+    gstd_iformatter_set_member_name (formatter, level_names[i]);
+    gstd_iformatter_set_uint64_value (formatter, current[i]);
+  }
+  for (i = 0; i < GSTD_QUEUE_DIMENSIONS; i++) {
+    gstd_iformatter_set_member_name (formatter, limit_names[i]);
+    gstd_iformatter_set_uint64_value (formatter, max[i]);
+  }
+  gstd_iformatter_set_member_name (formatter, "percent");
+  gstd_iformatter_set_uint64_value (formatter, percent);
+
+  gstd_iformatter_end_object (formatter);
+}
+
+static GstdReturnCode
+gstd_pipeline_queues_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdPipelineQueues *self;
+  GstdIFormatter *formatter;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_QUEUES (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  GST_OBJECT_LOCK (self);
+
+  gstd_iformatter_set_member_name (formatter, "high-water");
+  gstd_iformatter_set_uint64_value (formatter, self->high);
+  gstd_iformatter_set_member_name (formatter, "low-water");
+  gstd_iformatter_set_uint64_value (formatter, self->low);
+
+  gstd_iformatter_set_member_name (formatter, "queues");
+  gstd_iformatter_begin_array (formatter);
+  gstd_pipeline_queues_foreach (self, gstd_pipeline_queues_describe,
+      formatter);
+  gstd_iformatter_end_array (formatter);
+
+  GST_OBJECT_UNLOCK (self);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+static GstPadProbeReturn
+gstd_pipeline_queues_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer data)
+{
+  GstdQueueWatch *watch = data;
+  guint64 current[GSTD_QUEUE_DIMENSIONS];
+  guint64 max[GSTD_QUEUE_DIMENSIONS];
+  const gchar *level = NULL;
+  guint threshold = 0;
+  guint percent;
+  GstStructure *structure;
+
+  if ((guint) g_atomic_int_add (&watch->seen, 1) % watch->interval) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  percent = gstd_pipeline_queues_level (watch->levels, watch->level_specs,
+      watch->limits, watch->limit_specs, current, max);
+
+  /* Only the crossings are notified, the queue has to drain below low
+     before high is notified again */
+  if (percent >= watch->high) {
+    if (g_atomic_int_compare_and_exchange (&watch->above, FALSE, TRUE)) {
+      level = "high";
+      threshold = watch->high;
+    }
+  } else if (percent <= watch->low) {
+    if (g_atomic_int_compare_and_exchange (&watch->above, TRUE, FALSE)) {
+      level = "low";
+      threshold = watch->low;
+    }
+  }
+
+  if (level) {
+    GST_DEBUG ("Queue %s crossed its %s water mark at %u%%", watch->name,
+        level, percent);
+    structure = gst_structure_new (GSTD_PIPELINE_QUEUES_MESSAGE,
+        "queue", G_TYPE_STRING, watch->name,
+        "level", G_TYPE_STRING, level,
+        "percent", G_TYPE_UINT, percent,
+        "threshold", G_TYPE_UINT, threshold, NULL);
+    gst_element_post_message (watch->limits,
+        gst_message_new_element (GST_OBJECT (watch->limits), structure));
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+gstd_pipeline_queues_add_probe (GstdPipelineQueues * self, GstPad * pad,
+    GstdQueueWatch * watch)
+{
+  GstdQueueProbe probe;
+
+  if (!pad) {
+    return;
+  }
+
+  probe.pad = pad;
+  probe.id = gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      gstd_pipeline_queues_probe, gstd_queue_watch_ref (watch),
+      (GDestroyNotify) gstd_queue_watch_unref);
+  g_array_append_val (self->probes, probe);
+}
+
+static void
+gstd_pipeline_queues_watch (GstdPipelineQueues * self, GObject * levels,
+    GstElement * limits, const gchar * name, gpointer data)
+{
+  GstdQueueWatch *watch;
+  GstPad *srcpad;
+  GstPad *sinkpad;
+  gchar *sinkname;
+  guint64 buffers;
+
+  watch = g_new0 (GstdQueueWatch, 1);
+  watch->refcount = 1;
+  watch->levels = g_object_ref (levels);
+  watch->limits = gst_object_ref (limits);
+  watch->name = g_strdup (name);
+  watch->high = self->high;
+  watch->low = self->low;
+  gstd_pipeline_queues_find_specs (levels, level_names, watch->level_specs);
+  gstd_pipeline_queues_find_specs (G_OBJECT (limits), limit_names,
+      watch->limit_specs);
+
+  /* A later change of the limit is picked up on the next update */
+  buffers = gstd_pipeline_queues_get_uint64 (G_OBJECT (limits),
+      watch->limit_specs[0]);
+  watch->interval = buffers ? MAX (1, buffers / GSTD_QUEUE_SAMPLE_STEPS) :
+      GSTD_QUEUE_SAMPLE_INTERVAL;
+
+  /* The level changes when data enters and leaves the queue */
+  if (GST_IS_PAD (levels)) {
+    /* Multiqueue pairs sink_%u with src_%u */
+    srcpad = gst_object_ref (GST_PAD (levels));
+    sinkpad = NULL;
+    if (g_str_has_prefix (GST_OBJECT_NAME (levels), "src")) {
+      sinkname = g_strconcat ("sink", GST_OBJECT_NAME (levels) + strlen ("src"),
+          NULL);
+      sinkpad = gst_element_get_static_pad (limits, sinkname);
+      g_free (sinkname);
+    }
+  } else {
+    srcpad = gst_element_get_static_pad (limits, "src");
+    sinkpad = gst_element_get_static_pad (limits, "sink");
+  }
+
+  gstd_pipeline_queues_add_probe (self, sinkpad, watch);
+  gstd_pipeline_queues_add_probe (self, srcpad, watch);
+
+  gstd_queue_watch_unref (watch);
+}
+
+/* Must be called with the object lock held */
+static void
+gstd_pipeline_queues_clear_probes (GstdPipelineQueues * self)
+{
+  GstdQueueProbe *probe;
+  guint i;
+
+  for (i = 0; i < self->probes->len; i++) {
+    probe = &g_array_index (self->probes, GstdQueueProbe, i);
+    gst_pad_remove_probe (probe->pad, probe->id);
+    gst_object_unref (probe->pad);
+  }
+  g_array_set_size (self->probes, 0);
+}
+
+static gboolean
+gstd_pipeline_queues_parse_percent (const gchar * token, guint * percent)
+{
+  gchar *end = NULL;
+  guint64 value;
+
+  if (!token || !*token) {
+    return FALSE;
+  }
+
+  value = g_ascii_strtoull (token, &end, 10);
+  if (*end || value > 100) {
+    return FALSE;
+  }
+
+  *percent = value;
+
+  return TRUE;
+}
+
+static GstdReturnCode
+gstd_pipeline_queues_update (GstdObject * obj, const gchar * value)
+{
+  GstdPipelineQueues *self;
+  gchar **tokens;
+  guint high = 0;
+  guint low = 0;
+  gboolean valid;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (value, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_QUEUES (obj);
+
+  // Tokens has the form {<high>, <low>}
+  tokens = g_strsplit (value, " ", -1);
+  valid = g_strv_length (tokens) == 2
+      && gstd_pipeline_queues_parse_percent (tokens[0], &high)
+      && gstd_pipeline_queues_parse_percent (tokens[1], &low)
+      && (low < high || (0 == high && 0 == low));
+  g_strfreev (tokens);
+
+  if (!valid) {
+    GST_ERROR_OBJECT (self, "Invalid water marks \"%s\", expected "
+        "\"<high> <low>\" percentages with low below high", value);
+    return GSTD_BAD_VALUE;
+  }
+
+  GST_OBJECT_LOCK (self);
+
+  gstd_pipeline_queues_clear_probes (self);
+  self->high = high;
+  self->low = low;
+
+  /* Queues added to the pipeline afterwards need a new update */
+  if (high) {
+    gstd_pipeline_queues_foreach (self, gstd_pipeline_queues_watch, NULL);
+  }
+
+  GST_OBJECT_UNLOCK (self);
+
+  GST_INFO_OBJECT (self, "Water marks set to high %u%% and low %u%%", high,
+      low);
+
+  return GSTD_EOK;
+}
+
+GstdPipelineQueues *
+gstd_pipeline_queues_new (GstElement * target)
+{
+  GstdPipelineQueues *self;
+
+  g_return_val_if_fail (GST_IS_BIN (target), NULL);
+
+  self = g_object_new (GSTD_TYPE_PIPELINE_QUEUES, "name", "queues", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
+
+static void
+gstd_pipeline_queues_dispose (GObject * object)
+{
+  GstdPipelineQueues *self = GSTD_PIPELINE_QUEUES (object);
+
+  GST_OBJECT_LOCK (self);
+  gstd_pipeline_queues_clear_probes (self);
+  GST_OBJECT_UNLOCK (self);
+
+  if (self->target) {
+    gst_object_unref (self->target);
+    self->target = NULL;
+  }
+
+  G_OBJECT_CLASS (gstd_pipeline_queues_parent_class)->dispose (object);
+}
+
+static void
+gstd_pipeline_queues_finalize (GObject * object)
+{
+  GstdPipelineQueues *self = GSTD_PIPELINE_QUEUES (object);
+
+  g_array_free (self->probes, TRUE);
+
+  G_OBJECT_CLASS (gstd_pipeline_queues_parent_class)->finalize (object);
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PIPELINE_QUEUES_H__
+#define __GSTD_PIPELINE_QUEUES_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_PIPELINE_QUEUES \
+  (gstd_pipeline_queues_get_type())
+#define GSTD_PIPELINE_QUEUES(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_PIPELINE_QUEUES,GstdPipelineQueues))
+#define GSTD_PIPELINE_QUEUES_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_PIPELINE_QUEUES,GstdPipelineQueuesClass))
+#define GSTD_IS_PIPELINE_QUEUES(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_PIPELINE_QUEUES))
+#define GSTD_IS_PIPELINE_QUEUES_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_PIPELINE_QUEUES))
+#define GSTD_PIPELINE_QUEUES_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_PIPELINE_QUEUES, GstdPipelineQueuesClass))
+typedef struct _GstdPipelineQueues GstdPipelineQueues;
+typedef struct _GstdPipelineQueuesClass GstdPipelineQueuesClass;
+
+/* Name of the element messages posted when a water mark is crossed */
+#define GSTD_PIPELINE_QUEUES_MESSAGE "gstd-queue-level"
+
+GType gstd_pipeline_queues_get_type (void);
+
+/**
+ * Creates the queues node of a pipeline. It reports the fill level of
+ * every queue, queue2 and multiqueue in the pipeline. Updating it with
+ * "<high> <low>" percentages posts a GSTD_PIPELINE_QUEUES_MESSAGE
+ * element message whenever a queue fills above high or drains below
+ * low. "0 0" disables the notifications. Levels are sampled every few
+ * buffers, so a crossing may be notified slightly late.
+ *
+ * \param target The pipeline to report the queues of
+ *
+ * \return A new GstdPipelineQueues
+ **/
+GstdPipelineQueues *gstd_pipeline_queues_new (GstElement * target);
+
+G_END_DECLS
+#endif // __GSTD_PIPELINE_QUEUES_H__
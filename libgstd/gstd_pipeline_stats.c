@@ -0,0 +1,299 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_tracer.h"
+
+#include "gstd_pipeline_stats.h"
+
+/* Gstd Pipeline Stats debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_stats_debug);
+#define GST_CAT_DEFAULT gstd_pipeline_stats_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Counters of an element as seen in the previous read, used to
+   compute the rates */
+typedef struct _GstdStatsSample GstdStatsSample;
+struct _GstdStatsSample
+{
+  guint64 buffers;
+  guint64 bytes;
+  GstClockTime time;
+};
+
+/**
+ * GstdPipelineStats:
+ * Throughput statistics of the elements in a pipeline
+ */
+struct _GstdPipelineStats
+{
+  GstdObject parent;
+
+  GstElement *target;
+
+  /* Element path to GstdStatsSample, protected by the object lock */
+  GHashTable *samples;
+};
+
+struct _GstdPipelineStatsClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdPipelineStats, gstd_pipeline_stats, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static GstdReturnCode
+gstd_pipeline_stats_to_string (GstdObject * obj, gchar ** outstring);
+static void gstd_pipeline_stats_dispose (GObject * obj);
+static void gstd_pipeline_stats_finalize (GObject * obj);
+static void gstd_pipeline_stats_describe (GstdPipelineStats * self,
+    GstElement * element, GstClockTime now, GstdIFormatter * formatter);
+static void gstd_pipeline_stats_set_double (GstdIFormatter * formatter,
+    const gchar * name, gdouble value);
+
+static void
+gstd_pipeline_stats_class_init (GstdPipelineStatsClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->dispose = gstd_pipeline_stats_dispose;
+  oclass->finalize = gstd_pipeline_stats_finalize;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_pipeline_stats_to_string);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_pipeline_stats_debug, "gstdpipelinestats",
+      debug_color, "Gstd Pipeline Stats category");
+}
+
+static void
+gstd_pipeline_stats_init (GstdPipelineStats * self)
+{
+  GST_INFO_OBJECT (self, "Initializing pipeline stats");
+  self->target = NULL;
+  self->samples = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_free);
+}
+
+static void
+gstd_pipeline_stats_set_double (GstdIFormatter * formatter,
+    const gchar * name, gdouble value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_DOUBLE);
+  g_value_set_double (&gvalue, value);
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &gvalue);
+  g_value_unset (&gvalue);
+}
+
+static void
+gstd_pipeline_stats_describe (GstdPipelineStats * self, GstElement * element,
+    GstClockTime now, GstdIFormatter * formatter)
+{
+  GstdPadStats total = { 0, 0, 0, GST_CLOCK_TIME_NONE };
+  GstdPadStats stats;
+  GstdStatsSample *sample;
+  GstClockTime since;
+  gdouble elapsed;
+  gdouble buffer_rate = 0;
+  gdouble byte_rate = 0;
+  gchar *path;
+  GList *pads;
+
+  /* Data is accounted on the pad that produced it, so the source
+     pads describe what the element output */
+  GST_OBJECT_LOCK (element);
+  for (pads = element->srcpads; pads; pads = pads->next) {
+    if (!gstd_tracer_get_pad_stats (GST_PAD (pads->data), &stats)) {
+      continue;
+    }
+
+    total.buffers += stats.buffers;
+    total.bytes += stats.bytes;
+    total.dropped += stats.dropped;
+    if (!GST_CLOCK_TIME_IS_VALID (total.first) || stats.first < total.first) {
+      total.first = stats.first;
+    }
+  }
+  GST_OBJECT_UNLOCK (element);
+
+  path = gst_object_get_path_string (GST_OBJECT (element));
+  sample = g_hash_table_lookup (self->samples, path);
+
+  /* Rates are averaged since the previous read, or since the first
+     buffer if this is the first time the element is read */
+  if (sample) {
+    since = sample->time;
+    elapsed = GST_CLOCK_DIFF (since, now) / (gdouble) GST_SECOND;
+    if (elapsed > 0) {
+      buffer_rate = (total.buffers - sample->buffers) / elapsed;
+      byte_rate = (total.bytes - sample->bytes) / elapsed;
+    }
+  } else if (GST_CLOCK_TIME_IS_VALID (total.first)) {
+    elapsed = GST_CLOCK_DIFF (total.first, now) / (gdouble) GST_SECOND;
+    if (elapsed > 0) {
+      buffer_rate = total.buffers / elapsed;
+      byte_rate = total.bytes / elapsed;
+    }
+  }
+
+  if (!sample) {
+    sample = g_new0 (GstdStatsSample, 1);
+    g_hash_table_insert (self->samples, path, sample);
+  } else {
+    g_free (path);
+  }
+  sample->buffers = total.buffers;
+  sample->bytes = total.bytes;
+  sample->time = now;
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GST_OBJECT_NAME (element));
+
+  gstd_iformatter_set_member_name (formatter, "buffers");
+  gstd_iformatter_set_uint64_value (formatter, total.buffers);
+  gstd_iformatter_set_member_name (formatter, "bytes");
+  gstd_iformatter_set_uint64_value (formatter, total.bytes);
+  gstd_iformatter_set_member_name (formatter, "dropped");
+  gstd_iformatter_set_uint64_value (formatter, total.dropped);
+  gstd_pipeline_stats_set_double (formatter, "buffers-per-second",
+      buffer_rate);
+  gstd_pipeline_stats_set_double (formatter, "bytes-per-second", byte_rate);
+
+  gstd_iformatter_end_object (formatter);
+}
+
+static GstdReturnCode
+gstd_pipeline_stats_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdPipelineStats *self;
+  GstdIFormatter *formatter;
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstClockTime now;
+  gboolean done = FALSE;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_STATS (obj);
+  formatter = g_object_new (obj->formatter_factory, NULL);
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
+
+  gstd_iformatter_set_member_name (formatter, "elements");
+  gstd_iformatter_begin_array (formatter);
+
+  now = gst_util_get_timestamp ();
+
+  GST_OBJECT_LOCK (self);
+  it = gst_bin_iterate_recurse (GST_BIN (self->target));
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+        /* Bins only forward data through ghost pads, their children
+           are reported instead */
+        if (!GST_IS_BIN (g_value_get_object (&item))) {
+          gstd_pipeline_stats_describe (self,
+              GST_ELEMENT (g_value_get_object (&item)), now, formatter);
+        }
+        g_value_reset (&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        /* The partial output can't be taken back, report what was
+           read so far */
+        GST_WARNING_OBJECT (self, "Pipeline changed while reading stats");
+        done = TRUE;
+        break;
+      case GST_ITERATOR_ERROR:
+      case GST_ITERATOR_DONE:
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+  GST_OBJECT_UNLOCK (self);
+
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+GstdPipelineStats *
+gstd_pipeline_stats_new (GstElement * target)
+{
+  GstdPipelineStats *self;
+
+  g_return_val_if_fail (GST_IS_BIN (target), NULL);
+
+  gstd_tracer_acquire ();
+
+  self = g_object_new (GSTD_TYPE_PIPELINE_STATS, "name", "stats", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
+
+static void
+gstd_pipeline_stats_dispose (GObject * object)
+{
+  GstdPipelineStats *self = GSTD_PIPELINE_STATS (object);
+
+  if (self->target) {
+    gst_object_unref (self->target);
+    self->target = NULL;
+    gstd_tracer_release ();
+  }
+
+  G_OBJECT_CLASS (gstd_pipeline_stats_parent_class)->dispose (object);
+}
+
+static void
+gstd_pipeline_stats_finalize (GObject * object)
+{
+  GstdPipelineStats *self = GSTD_PIPELINE_STATS (object);
+
+  g_hash_table_unref (self->samples);
+
+  G_OBJECT_CLASS (gstd_pipeline_stats_parent_class)->finalize (object);
+}
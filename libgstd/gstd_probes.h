@@ -0,0 +1,66 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PROBES_H__
+#define __GSTD_PROBES_H__
+
+#include <glib.h>
+
+/*
+ * Statically defined tracepoints for the request and pipeline paths.
+ * When sys/sdt.h is available each probe compiles to a single nop
+ * plus an ELF note, so they cost nothing until a tracer such as
+ * bpftrace, perf or systemtap attaches to them, e.g.:
+ *
+ *   bpftrace -e 'usdt:/usr/lib/libgstd-1.0.so:gstd:command__done
+ *     { printf("%s %d %dus\n", str(arg0), arg1, arg2); }'
+ *
+ * Arguments are only read by the attached tracer, so they must be
+ * plain values or fields, never function calls. Strings are passed
+ * as pointers.
+ *
+ * Provider: gstd
+ *   command__start (const gchar *cmd, const gchar *args)
+ *   command__done (const gchar *cmd, gint ret, gint64 usecs)
+ *   uri__resolve (const gchar *uri, gint ret)
+ *   object__create (const gchar *object, const gchar *name, gint ret)
+ *   object__read (const gchar *object, const gchar *property, gint ret)
+ *   object__update (const gchar *object, const gchar *value, gint ret)
+ *   object__delete (const gchar *object, const gchar *name, gint ret)
+ *   bus__message (const gchar *src, gint type)
+ *   bus__deliver (const gchar *src, gint type)
+ *   pipeline__create (const gchar *name, const gchar *description, gint ret)
+ *   pipeline__delete (const gchar *name)
+ *   pipeline__state (const gchar *name, gint state, gint ret)
+ */
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+
+#define GSTD_PROBE1(name, a) DTRACE_PROBE1 (gstd, name, a)
+#define GSTD_PROBE2(name, a, b) DTRACE_PROBE2 (gstd, name, a, b)
+#define GSTD_PROBE3(name, a, b, c) DTRACE_PROBE3 (gstd, name, a, b, c)
+#else
+#define GSTD_PROBE1(name, a) G_STMT_START { } G_STMT_END
+#define GSTD_PROBE2(name, a, b) G_STMT_START { } G_STMT_END
+#define GSTD_PROBE3(name, a, b, c) G_STMT_START { } G_STMT_END
+#endif
+
+#endif // __GSTD_PROBES_H__
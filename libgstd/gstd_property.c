@@ -22,12 +22,19 @@
 #include "config.h"
 #endif
 
+#include "gstd_list_reader.h"
+#include "gstd_no_reader.h"
 #include "gstd_property.h"
+#include "gstd_property_reader.h"
+#include "gstd_signal_subscription.h"
+#include "gstd_signal_subscription_creator.h"
+#include "gstd_signal_subscription_deleter.h"
 
 enum
 {
   PROP_TARGET = 1,
   PROP_PSPEC,
+  PROP_SUBSCRIPTIONS,
   N_PROPERTIES
 };
 
@@ -60,6 +67,9 @@ gstd_property_add_value_default (GstdProperty * self,
     GstdIFormatter * formatter, GValue * value);
 static GstdReturnCode gstd_property_update_default (GstdObject * object,
     const gchar * arg);
+static GstdReturnCode gstd_property_read (GstdObject * object,
+    const gchar * name, GstdObject ** resource);
+static GstdList *gstd_property_get_subscriptions (GstdProperty * self);
 
 static void
 gstd_property_class_init (GstdPropertyClass * klass)
@@ -88,8 +98,16 @@ gstd_property_class_init (GstdPropertyClass * klass)
       G_PARAM_READWRITE |
       G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
 
+  properties[PROP_SUBSCRIPTIONS] =
+      g_param_spec_object ("subscriptions",
+      "Subscriptions",
+      "The subscriptions to changes of the property",
+      GSTD_TYPE_LIST,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
+  gstdc->read = GST_DEBUG_FUNCPTR (gstd_property_read);
   gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_property_to_string);
   gstdc->update = GST_DEBUG_FUNCPTR (gstd_property_update_default);
 
@@ -108,6 +126,7 @@ gstd_property_init (GstdProperty * self)
   GST_INFO_OBJECT (self, "Initializing property");
   self->target = DEFAULT_PROP_TARGET;
   self->pspec = DEFAULT_PROP_PSPEC;
+  self->subscriptions = NULL;
 }
 
 static void
@@ -117,6 +136,21 @@ gstd_property_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s property", GSTD_OBJECT_NAME (self));
 
+  if (self->subscriptions) {
+    GList *elem;
+
+    /* Subscriptions are kept alive by their signal handlers, break
+     * the connection so they can be released along with the list */
+    GST_OBJECT_LOCK (self->subscriptions);
+    for (elem = self->subscriptions->list; elem; elem = g_list_next (elem)) {
+      gstd_signal_subscription_cancel (elem->data);
+    }
+    GST_OBJECT_UNLOCK (self->subscriptions);
+
+    g_object_unref (self->subscriptions);
+    self->subscriptions = NULL;
+  }
+
   if (self->target) {
     g_object_unref (self->target);
     self->target = NULL;
@@ -142,6 +176,9 @@ gstd_property_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning property spec %p", self->pspec);
       g_value_set_pointer (value, self->pspec);
       break;
+    case PROP_SUBSCRIPTIONS:
+      g_value_set_object (value, gstd_property_get_subscriptions (self));
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -303,3 +340,63 @@ gstd_property_update_default (GstdObject * object, const gchar * svalue)
 
   return ret;
 }
+
+static GstdReturnCode
+gstd_property_read (GstdObject * object, const gchar * name,
+    GstdObject ** resource)
+{
+  GstdIReader *reader;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_PROPERTY (object), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (resource, GSTD_NULL_ARGUMENT);
+
+  /* A property is built for every read of it, but only a few are ever
+   * read into, install the reader for their children on the first one */
+  GST_OBJECT_LOCK (object);
+  if (GSTD_IS_NO_READER (object->reader)) {
+    gstd_object_set_reader (object, g_object_new (GSTD_TYPE_PROPERTY_READER,
+            NULL));
+  }
+  reader = g_object_ref (object->reader);
+  GST_OBJECT_UNLOCK (object);
+
+  ret = gstd_ireader_read (reader, object, name, resource);
+  g_object_unref (reader);
+
+  return ret;
+}
+
+static GstdList *
+gstd_property_get_subscriptions (GstdProperty * self)
+{
+  GstdList *subscriptions;
+
+  g_return_val_if_fail (GSTD_IS_PROPERTY (self), NULL);
+
+  /* Properties are plenty and rarely watched, don't pay for the list
+   * until somebody asks for it */
+  GST_OBJECT_LOCK (self);
+  if (!self->subscriptions) {
+    subscriptions =
+        GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "subscriptions",
+            "node-type", GSTD_TYPE_SIGNAL_SUBSCRIPTION, "flags",
+            GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE, NULL));
+
+    gstd_object_set_creator (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION_CREATOR, "property", self,
+            NULL));
+
+    gstd_object_set_reader (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_LIST_READER, NULL));
+
+    gstd_object_set_deleter (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION_DELETER, NULL));
+
+    self->subscriptions = subscriptions;
+  }
+  subscriptions = self->subscriptions;
+  GST_OBJECT_UNLOCK (self);
+
+  return subscriptions;
+}
@@ -24,6 +24,7 @@
 #include <glib-object.h>
 
 #include "gstd_object.h"
+#include "gstd_list.h"
 
 G_BEGIN_DECLS
 
@@ -53,6 +54,9 @@ struct _GstdProperty
 
   GParamSpec *pspec;
   GObject *target;
+
+  /* change subscriptions, created on first use */
+  GstdList *subscriptions;
 };
 
 struct _GstdPropertyClass
@@ -29,6 +29,7 @@
 #include "gstd_property_reader.h"
 #include "gstd_list_reader.h"
 #include "gstd_pipeline_deleter.h"
+#include "gstd_probes.h"
 
 /* Gstd Session debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_session_debug);
@@ -281,17 +282,20 @@ gstd_get_by_uri (GstdSession * gstd, const gchar * uri, GstdObject ** node)
 
   g_strfreev (nodes);
   *node = parent;
+  GSTD_PROBE2 (uri__resolve, uri, GSTD_EOK);
   return GSTD_EOK;
 
 badcommand:
   {
     GST_ERROR_OBJECT (gstd, "Invalid command");
+    GSTD_PROBE2 (uri__resolve, uri, GSTD_BAD_COMMAND);
     return GSTD_BAD_COMMAND;
   }
 nonode:
   {
     GST_ERROR_OBJECT (gstd, "Invalid node %s", *it);
     g_strfreev (nodes);
+    GSTD_PROBE2 (uri__resolve, uri, GSTD_BAD_COMMAND);
     return GSTD_BAD_COMMAND;
   }
 }
@@ -0,0 +1,174 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <string.h>
+
+#include "gstd_shards.h"
+
+/* Gstd Shards debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_shards_debug);
+#define GST_CAT_DEFAULT gstd_shards_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static void gstd_shards_init_debug (void);
+
+static void
+gstd_shards_init_debug (void)
+{
+  static gsize init = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&init)) {
+    /* Initialize debug category with nice colors */
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_shards_debug, "gstdshards", debug_color,
+        "Gstd Shards category");
+    g_once_init_leave (&init, 1);
+  }
+}
+
+gpointer
+gstd_shards_get (GstdShards * shards)
+{
+  GstdShard *shard;
+  gint generation;
+
+  g_return_val_if_fail (shards, NULL);
+
+  shard = g_private_get (&shards->current);
+
+  /* Threads only get a shard once they account something */
+  if (G_UNLIKELY (!shard)) {
+    gstd_shards_init_debug ();
+
+    shard = g_malloc0 (shards->size);
+    shard->shards = shards;
+
+    g_mutex_lock (&shards->lock);
+    shard->id = ++shards->next_id;
+    shard->generation = shards->generation;
+    shards->list = g_list_prepend (shards->list, shard);
+    g_mutex_unlock (&shards->lock);
+
+    g_private_set (&shards->current, shard);
+    GST_DEBUG ("Created shard %u at %p", shard->id, shard);
+  }
+
+  generation = g_atomic_int_get (&shards->generation);
+  if (G_UNLIKELY (shard->generation != generation)) {
+    if (shards->clear) {
+      shards->clear (shard, NULL);
+    }
+    g_atomic_int_set (&shard->generation, generation);
+  }
+
+  return shard;
+}
+
+void
+gstd_shard_retire (gpointer data)
+{
+  GstdShard *shard = data;
+  GstdShards *shards = shard->shards;
+
+  g_mutex_lock (&shards->lock);
+
+  /* Without a way to fold it, the shard is still needed by the next
+     read and is freed once the generation changes */
+  if (!shards->merge) {
+    shard->retired = TRUE;
+    g_mutex_unlock (&shards->lock);
+    return;
+  }
+
+  /* Fold the statistics of exiting threads so they are not lost */
+  if (shard->generation == shards->generation) {
+    if (!shards->retired) {
+      shards->retired = g_malloc0 (shards->size);
+    }
+    shards->merge (shard, shards->retired);
+  }
+  shards->list = g_list_remove (shards->list, shard);
+
+  g_mutex_unlock (&shards->lock);
+
+  g_free (shard);
+}
+
+void
+gstd_shards_foreach (GstdShards * shards, GstdShardFunc func,
+    gpointer user_data)
+{
+  GstdShard *shard;
+  GList *iter;
+  gint generation;
+
+  g_return_if_fail (shards);
+  g_return_if_fail (func);
+
+  g_mutex_lock (&shards->lock);
+
+  if (shards->retired) {
+    func (shards->retired, user_data);
+  }
+
+  generation = g_atomic_int_get (&shards->generation);
+  for (iter = shards->list; iter; iter = iter->next) {
+    shard = iter->data;
+    if (g_atomic_int_get (&shard->generation) == generation) {
+      func (shard, user_data);
+    }
+  }
+
+  g_mutex_unlock (&shards->lock);
+}
+
+void
+gstd_shards_reset (GstdShards * shards)
+{
+  GList *iter;
+  GList *next;
+
+  g_return_if_fail (shards);
+
+  g_mutex_lock (&shards->lock);
+
+  for (iter = shards->list; iter; iter = next) {
+    next = iter->next;
+    if (((GstdShard *) iter->data)->retired) {
+      g_free (iter->data);
+      shards->list = g_list_delete_link (shards->list, iter);
+    }
+  }
+
+  if (shards->retired) {
+    memset (shards->retired, 0, shards->size);
+  }
+
+  g_atomic_int_inc (&shards->generation);
+
+  g_mutex_unlock (&shards->lock);
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_SHARDS_H__
+#define __GSTD_SHARDS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstdShard GstdShard;
+typedef struct _GstdShards GstdShards;
+
+typedef void (*GstdShardFunc) (gpointer shard, gpointer user_data);
+
+/**
+ * GstdShard:
+ * Header every shard type starts with
+ */
+struct _GstdShard
+{
+  GstdShards *shards;
+  /* Unique per registry, starting at 1 */
+  guint id;
+  gint generation;
+  /* The owner thread exited, protected by the registry lock */
+  gboolean retired;
+};
+
+/**
+ * GstdShards:
+ * Registry of per thread shards. Only the owner thread writes its
+ * shard, so accounting into it takes no lock. Readers walk the shards
+ * under the registry lock and may observe slightly stale values.
+ *
+ * Must be declared static and initialized with GSTD_SHARDS_INIT().
+ */
+struct _GstdShards
+{
+  GMutex lock;
+  GList *list;
+  GPrivate current;
+  gsize size;
+  guint next_id;
+  gint generation;
+  /* Clears a shard of a previous generation, called by its owner */
+  GstdShardFunc clear;
+  /* Folds a shard into user_data. The shards of exiting threads are
+     folded into a retired shard, or kept until the next reset if NULL */
+  GstdShardFunc merge;
+  GstdShard *retired;
+};
+
+void gstd_shard_retire (gpointer data);
+
+/**
+ * GSTD_SHARDS_INIT:
+ * @type: The shard type, which must start with a #GstdShard
+ * @clear: (nullable): A #GstdShardFunc to clear stale shards
+ * @merge: (nullable): A #GstdShardFunc to fold a shard into another
+ */
+#define GSTD_SHARDS_INIT(type, clear, merge) {                        \
+    .current = G_PRIVATE_INIT (gstd_shard_retire),                      \
+    .size = sizeof (type),                                              \
+    .clear = (clear),                                                   \
+    .merge = (merge),                                                   \
+  }
+
+/**
+ * gstd_shards_get:
+ * @shards: The registry
+ *
+ * Returns the calling thread shard, creating it the first time and
+ * clearing it if it belongs to a previous generation.
+ *
+ * Returns: (transfer none): The shard of the calling thread
+ */
+gpointer gstd_shards_get (GstdShards * shards);
+
+/**
+ * gstd_shards_foreach:
+ * @shards: The registry
+ * @func: Called with the registry lock held
+ * @user_data: Passed to @func
+ *
+ * Calls @func on the retired shard, if any, and then on every shard of
+ * the current generation.
+ */
+void gstd_shards_foreach (GstdShards * shards, GstdShardFunc func,
+    gpointer user_data);
+
+/**
+ * gstd_shards_reset:
+ * @shards: The registry
+ *
+ * Starts a new generation. The retired shard is cleared right away
+ * and every other shard clears itself on its next use.
+ */
+void gstd_shards_reset (GstdShards * shards);
+
+G_END_DECLS
+
+#endif //__GSTD_SHARDS_H__
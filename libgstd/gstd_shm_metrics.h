@@ -0,0 +1,103 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_SHM_METRICS_H__
+#define __GSTD_SHM_METRICS_H__
+
+/*
+ * Layout of the metrics page gstd publishes when started with
+ * --metrics-shm-path. Monitoring agents map the file read-only and
+ * read it without talking to the daemon. This header only depends on
+ * the C library so agents don't need GLib nor GStreamer.
+ *
+ * The page is protected by a sequence lock with a single writer. A
+ * consistent snapshot is read as:
+ *
+ *   do {
+ *     seq = __atomic_load_n (&page->sequence, __ATOMIC_ACQUIRE);
+ *     if (seq & 1)
+ *       continue;
+ *     memcpy (&copy, page, sizeof (copy));
+ *     __atomic_thread_fence (__ATOMIC_ACQUIRE);
+ *   } while (seq & 1
+ *       || seq != __atomic_load_n (&page->sequence, __ATOMIC_RELAXED));
+ *
+ * Readers must check magic and version before trusting the rest.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* "GSTD" in ASCII */
+#define GSTD_SHM_METRICS_MAGIC 0x44545347u
+#define GSTD_SHM_METRICS_VERSION 1u
+
+#define GSTD_SHM_METRICS_MAX_PIPELINES 512
+#define GSTD_SHM_METRICS_NAME_SIZE 64
+
+typedef struct _GstdShmPipeline GstdShmPipeline;
+typedef struct _GstdShmMetrics GstdShmMetrics;
+
+struct _GstdShmPipeline
+{
+  /* NUL terminated, truncated if longer */
+  char name[GSTD_SHM_METRICS_NAME_SIZE];
+  /* GstState: 1 NULL, 2 READY, 3 PAUSED, 4 PLAYING, 0 unknown */
+  int32_t state;
+  /* Messages waiting in the pipeline bus */
+  int32_t bus_queued;
+  /* Nanoseconds, -1 when unknown */
+  int64_t position;
+  int64_t duration;
+  uint64_t bus_errors;
+  uint64_t bus_warnings;
+};
+
+struct _GstdShmMetrics
+{
+  uint32_t magic;
+  uint32_t version;
+  /* Odd while the page is being updated */
+  uint32_t sequence;
+  uint32_t n_pipelines;
+  /* Process id of the publisher */
+  int64_t pid;
+  /* Monotonic time of the last update, in microseconds */
+  int64_t timestamp;
+  /* Commands processed over every IPC since start */
+  uint64_t requests;
+  uint64_t request_errors;
+  /* Commands per second since the previous update */
+  double request_rate;
+  /* Pipelines that didn't fit in the page */
+  uint32_t dropped_pipelines;
+  uint32_t reserved;
+  GstdShmPipeline pipelines[GSTD_SHM_METRICS_MAX_PIPELINES];
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GSTD_SHM_METRICS_H__
@@ -0,0 +1,303 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "gstd_shm_publisher.h"
+#include "gstd_list.h"
+#include "gstd_lock_stats.h"
+#include "gstd_metrics.h"
+#include "gstd_pipeline.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_shm_metrics.h"
+
+/* Gstd Shared Memory Publisher debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_shm_publisher_debug);
+#define GST_CAT_DEFAULT gstd_shm_publisher_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+struct _GstdShmPublisher
+{
+  GstdSession *session;
+  gchar *path;
+  guint interval;
+
+  /* The mapped page, only written by the publisher thread */
+  GstdShmMetrics *page;
+  /* The pipelines are collected here before entering the write side
+     of the sequence lock, so readers never retry on a slow query */
+  GstdShmPipeline pipelines[GSTD_SHM_METRICS_MAX_PIPELINES];
+
+  guint64 last_requests;
+  gint64 last_timestamp;
+
+  GThread *thread;
+  GMutex lock;
+  GCond cond;
+  gboolean stop;
+};
+
+static void gstd_shm_publisher_init_debug (void);
+static guint gstd_shm_publisher_collect (GstdShmPublisher * self,
+    guint * dropped);
+static void gstd_shm_publisher_update (GstdShmPublisher * self);
+static gpointer gstd_shm_publisher_loop (gpointer data);
+
+static void
+gstd_shm_publisher_init_debug (void)
+{
+  static gsize init = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&init)) {
+    /* Initialize debug category with nice colors */
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_shm_publisher_debug, "gstdshmpublisher",
+        debug_color, "Gstd Shared Memory Publisher category");
+    g_once_init_leave (&init, 1);
+  }
+}
+
+static guint
+gstd_shm_publisher_collect (GstdShmPublisher * self, guint * dropped)
+{
+  GstdList *list = self->session->pipelines;
+  GList *pipelines;
+  GList *iter;
+  GstdObject *pipeline;
+  GstdPipelineBus *bus;
+  GstElement *element;
+  GstdShmPipeline *entry;
+  gint64 position;
+  gint64 duration;
+  gint queued;
+  guint errors;
+  guint warnings;
+  guint count = 0;
+  gint64 lock;
+
+  *dropped = 0;
+
+  /* Keep the pipelines alive outside of the list lock */
+  lock = GSTD_OBJECT_LOCK_SITE (list, GSTD_LOCK_SITE_LIST_SNAPSHOT);
+  pipelines = g_list_copy_deep (list->list, (GCopyFunc) g_object_ref, NULL);
+  GSTD_OBJECT_UNLOCK_SITE (list, GSTD_LOCK_SITE_LIST_SNAPSHOT, lock);
+
+  for (iter = pipelines; iter; iter = iter->next) {
+    if (count == GSTD_SHM_METRICS_MAX_PIPELINES) {
+      (*dropped)++;
+      continue;
+    }
+
+    pipeline = GSTD_OBJECT (iter->data);
+    entry = &self->pipelines[count++];
+    memset (entry, 0, sizeof (*entry));
+    g_strlcpy (entry->name, GSTD_OBJECT_NAME (pipeline), sizeof (entry->name));
+    entry->position = -1;
+    entry->duration = -1;
+
+    element = gstd_pipeline_get_pipeline (GSTD_PIPELINE (pipeline));
+    if (element) {
+      entry->state = GST_STATE (element);
+      if (gst_element_query_position (element, GST_FORMAT_TIME, &position)) {
+        entry->position = position;
+      }
+      if (gst_element_query_duration (element, GST_FORMAT_TIME, &duration)) {
+        entry->duration = duration;
+      }
+      gst_object_unref (element);
+    }
+
+    g_object_get (pipeline, "bus", &bus, NULL);
+    if (bus) {
+      g_object_get (bus, "queued", &queued, "errors", &errors, "warnings",
+          &warnings, NULL);
+      entry->bus_queued = queued;
+      entry->bus_errors = errors;
+      entry->bus_warnings = warnings;
+      g_object_unref (bus);
+    }
+  }
+
+  g_list_free_full (pipelines, g_object_unref);
+
+  return count;
+}
+
+static void
+gstd_shm_publisher_update (GstdShmPublisher * self)
+{
+  GstdShmMetrics *page = self->page;
+  guint64 requests;
+  guint64 errors;
+  gint64 now;
+  guint count;
+  guint dropped;
+  guint32 sequence;
+
+  count = gstd_shm_publisher_collect (self, &dropped);
+  gstd_metrics_get_totals (&requests, &errors);
+  now = g_get_monotonic_time ();
+
+  sequence = page->sequence;
+  __atomic_store_n (&page->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+
+  page->n_pipelines = count;
+  page->dropped_pipelines = dropped;
+  page->timestamp = now;
+  page->requests = requests;
+  page->request_errors = errors;
+  if (self->last_timestamp && now > self->last_timestamp) {
+    page->request_rate = (gdouble) (requests - self->last_requests) *
+        G_USEC_PER_SEC / (now - self->last_timestamp);
+  }
+  memcpy (page->pipelines, self->pipelines, count * sizeof (*self->pipelines));
+
+  __atomic_store_n (&page->sequence, sequence + 2, __ATOMIC_RELEASE);
+
+  self->last_requests = requests;
+  self->last_timestamp = now;
+}
+
+static gpointer
+gstd_shm_publisher_loop (gpointer data)
+{
+  GstdShmPublisher *self = data;
+  gint64 deadline;
+
+  g_mutex_lock (&self->lock);
+  while (!self->stop) {
+    g_mutex_unlock (&self->lock);
+    gstd_shm_publisher_update (self);
+    g_mutex_lock (&self->lock);
+
+    deadline = g_get_monotonic_time () +
+        (gint64) self->interval * G_TIME_SPAN_MILLISECOND;
+    /* Wait out the interval unless asked to stop */
+    while (!self->stop) {
+      if (!g_cond_wait_until (&self->cond, &self->lock, deadline)) {
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  return NULL;
+}
+
+GstdShmPublisher *
+gstd_shm_publisher_new (GstdSession * session, const gchar * path,
+    guint interval, GError ** error)
+{
+  GstdShmPublisher *self;
+  GstdShmMetrics *page;
+  gint fd;
+  gint saved_errno;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), NULL);
+  g_return_val_if_fail (path, NULL);
+  g_return_val_if_fail (interval > 0, NULL);
+
+  gstd_shm_publisher_init_debug ();
+
+  fd = g_open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    goto error;
+  }
+
+  if (ftruncate (fd, sizeof (GstdShmMetrics)) < 0) {
+    goto close;
+  }
+
+  page = mmap (NULL, sizeof (GstdShmMetrics), PROT_READ | PROT_WRITE,
+      MAP_SHARED, fd, 0);
+  if (MAP_FAILED == page) {
+    goto close;
+  }
+  close (fd);
+
+  /* The file is zero filled by ftruncate, agents see an empty page
+     until the first update */
+  page->version = GSTD_SHM_METRICS_VERSION;
+  page->pid = getpid ();
+  __atomic_store_n (&page->magic, GSTD_SHM_METRICS_MAGIC, __ATOMIC_RELEASE);
+
+  self = g_new0 (GstdShmPublisher, 1);
+  self->session = g_object_ref (session);
+  self->path = g_strdup (path);
+  self->interval = interval;
+  self->page = page;
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+
+  self->thread = g_thread_new ("gstd-shm", gstd_shm_publisher_loop, self);
+
+  GST_INFO ("Publishing metrics to \"%s\" every %u ms", path, interval);
+
+  return self;
+
+close:
+  saved_errno = errno;
+  close (fd);
+  g_unlink (path);
+  goto out;
+error:
+  saved_errno = errno;
+out:
+  GST_ERROR ("Unable to create metrics page \"%s\": %s", path,
+      g_strerror (saved_errno));
+  g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+      "Unable to create metrics page \"%s\": %s", path,
+      g_strerror (saved_errno));
+  return NULL;
+}
+
+void
+gstd_shm_publisher_free (GstdShmPublisher * self)
+{
+  g_return_if_fail (self);
+
+  g_mutex_lock (&self->lock);
+  self->stop = TRUE;
+  g_cond_signal (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  g_thread_join (self->thread);
+
+  munmap (self->page, sizeof (GstdShmMetrics));
+  g_unlink (self->path);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+  g_object_unref (self->session);
+  g_free (self->path);
+  g_free (self);
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_SHM_PUBLISHER_H__
+#define __GSTD_SHM_PUBLISHER_H__
+
+#include <gst/gst.h>
+
+#include "gstd_session.h"
+
+G_BEGIN_DECLS
+
+/* Milliseconds between updates of the metrics page */
+#define GSTD_SHM_PUBLISHER_DEFAULT_INTERVAL 1000
+
+typedef struct _GstdShmPublisher GstdShmPublisher;
+
+/**
+ * gstd_shm_publisher_new:
+ * @session: The session whose pipelines are published
+ * @path: The file to map, typically under /dev/shm
+ * @interval: Milliseconds between updates
+ * @error: (out) (optional): Where to report a failure to create the file
+ *
+ * Creates @path with the layout in gstd_shm_metrics.h and starts a
+ * thread that refreshes it every @interval milliseconds.
+ *
+ * Returns: (transfer full) (nullable): The publisher or NULL on error
+ */
+GstdShmPublisher *gstd_shm_publisher_new (GstdSession * session,
+    const gchar * path, guint interval, GError ** error);
+
+/**
+ * gstd_shm_publisher_free:
+ * @self: The publisher
+ *
+ * Stops updating the page and removes its file.
+ */
+void gstd_shm_publisher_free (GstdShmPublisher * self);
+
+G_END_DECLS
+
+#endif // __GSTD_SHM_PUBLISHER_H__
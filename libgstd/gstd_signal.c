@@ -22,8 +22,13 @@
 #include "config.h"
 #endif
 
+#include "gstd_list.h"
+#include "gstd_list_reader.h"
 #include "gstd_signal_reader.h"
 #include "gstd_signal.h"
+#include "gstd_signal_subscription.h"
+#include "gstd_signal_subscription_creator.h"
+#include "gstd_signal_subscription_deleter.h"
 
 enum
 {
@@ -31,6 +36,7 @@ enum
   PROP_TIMEOUT,
   PROP_CALLBACK,
   PROP_DISCONNECT,
+  PROP_SUBSCRIPTIONS,
   N_PROPERTIES
 };
 
@@ -57,6 +63,7 @@ static void gstd_signal_get_property (GObject *, guint, GValue *, GParamSpec *);
 static void gstd_signal_set_property (GObject *, guint, const GValue *,
     GParamSpec *);
 static void gstd_signal_dispose (GObject *);
+static GstdList *gstd_signal_get_subscriptions (GstdSignal * self);
 
 static void
 gstd_signal_class_init (GstdSignalClass * klass)
@@ -94,6 +101,11 @@ gstd_signal_class_init (GstdSignalClass * klass)
       "Stop waiting for signal", FALSE,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_SUBSCRIPTIONS] =
+      g_param_spec_object ("subscriptions", "Subscriptions",
+      "The persistent subscriptions to the signal", GSTD_TYPE_LIST,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -111,6 +123,8 @@ gstd_signal_init (GstdSignal * self)
 
   gstd_object_set_reader (GSTD_OBJECT (self),
       g_object_new (GSTD_TYPE_SIGNAL_READER, NULL));
+
+  self->subscriptions = NULL;
 }
 
 static void
@@ -120,6 +134,21 @@ gstd_signal_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s signal", GSTD_OBJECT_NAME (self));
 
+  if (self->subscriptions) {
+    GList *elem;
+
+    /* Subscriptions are kept alive by their signal handlers, break
+     * the connection so they can be released along with the list */
+    GST_OBJECT_LOCK (self->subscriptions);
+    for (elem = self->subscriptions->list; elem; elem = g_list_next (elem)) {
+      gstd_signal_subscription_cancel (elem->data);
+    }
+    GST_OBJECT_UNLOCK (self->subscriptions);
+
+    g_object_unref (self->subscriptions);
+    self->subscriptions = NULL;
+  }
+
   if (self->target) {
     g_object_unref (self->target);
     self->target = NULL;
@@ -150,6 +179,11 @@ gstd_signal_get_property (GObject * object,
     case PROP_CALLBACK:
       GST_DEBUG_OBJECT (self, "Connecting callback");
       break;
+    case PROP_SUBSCRIPTIONS:
+      g_value_set_object (value, gstd_signal_get_subscriptions (self));
+      GST_DEBUG_OBJECT (self, "Returning subscriptions %p",
+          self->subscriptions);
+      break;
     default:
       /* We don't have any other signal... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -183,6 +217,40 @@ gstd_signal_set_property (GObject * object,
   }
 }
 
+static GstdList *
+gstd_signal_get_subscriptions (GstdSignal * self)
+{
+  GstdList *subscriptions;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL (self), NULL);
+
+  /* Every signal of every element gets a node, don't pay for the list
+   * until somebody asks for it */
+  GST_OBJECT_LOCK (self);
+  if (!self->subscriptions) {
+    subscriptions =
+        GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "subscriptions",
+            "node-type", GSTD_TYPE_SIGNAL_SUBSCRIPTION, "flags",
+            GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE, NULL));
+
+    gstd_object_set_creator (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION_CREATOR, "signal", self,
+            NULL));
+
+    gstd_object_set_reader (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_LIST_READER, NULL));
+
+    gstd_object_set_deleter (GSTD_OBJECT (subscriptions),
+        g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION_DELETER, NULL));
+
+    self->subscriptions = subscriptions;
+  }
+  subscriptions = self->subscriptions;
+  GST_OBJECT_UNLOCK (self);
+
+  return subscriptions;
+}
+
 void
 gstd_signal_disconnect (GstdSignal * self)
 {
@@ -24,6 +24,7 @@
 #include <glib-object.h>
 
 #include "gstd_object.h"
+#include "gstd_list.h"
 
 G_BEGIN_DECLS
 
@@ -54,6 +55,9 @@ struct _GstdSignal
   /* properties */
   GObject *target;
   gint64 timeout;
+
+  /* persistent subscriptions */
+  GstdList *subscriptions;
 };
 
 struct _GstdSignalClass
@@ -23,7 +23,9 @@
 #include "gstd_signal_reader.h"
 #include "gstd_property_reader.h"
 #include "gstd_callback.h"
+#include "gstd_ipc.h"
 #include "gstd_signal.h"
+#include "gstd_signal_subscription.h"
 
 /* Gstd Core debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_signal_reader_debug);
@@ -43,6 +45,9 @@ void gstd_signal_marshal (GClosure * closure, GValue * return_value,
 
 static void gstd_signal_reader_dispose (GObject * object);
 
+static void gstd_signal_reader_cancelled (GCancellable * cancellable,
+    gpointer user_data);
+
 typedef struct _GstdSignalReaderClass GstdSignalReaderClass;
 
 struct _GstdSignalReader
@@ -125,9 +130,21 @@ gstd_signal_reader_read (GstdIReader * iface, GstdObject * object,
   g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
 
   /* If the user requested to read a signal, connect to the signal,
-   * else, default to the property reading implementation
+   * else, default to the property reading implementation. Persistent
+   * subscriptions are already connected, so just take the next
+   * queued callback (or the latest "value" of a watched property)
+   * from them.
    */
-  if (!g_ascii_strcasecmp ("callback", name)) {
+  if (GSTD_IS_SIGNAL_SUBSCRIPTION (object)
+      && (!g_ascii_strcasecmp ("callback", name)
+          || !g_ascii_strcasecmp ("value", name))) {
+    ret = gstd_signal_subscription_pop (GSTD_SIGNAL_SUBSCRIPTION (object),
+        &resource);
+  } else if (GSTD_IS_SIGNAL_SUBSCRIPTION (object)
+      && !g_ascii_strcasecmp ("disconnect", name)) {
+    gstd_signal_subscription_wakeup (GSTD_SIGNAL_SUBSCRIPTION (object));
+    ret = GSTD_EOK;
+  } else if (!g_ascii_strcasecmp ("callback", name)) {
     ret = gstd_signal_reader_read_signal (iface, object, &resource);
   } else if (!g_ascii_strcasecmp ("disconnect", name)) {
     ret = gstd_signal_reader_disconnect (iface);
@@ -153,6 +170,8 @@ gstd_signal_reader_read_signal (GstdIReader * iface,
   gulong handler_id;
   guint64 timeout;
   guint64 end_time;
+  GCancellable *cancellable;
+  gulong cancel_id = 0;
 
   g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (GSTD_IS_SIGNAL (object), GSTD_BAD_VALUE);
@@ -161,6 +180,15 @@ gstd_signal_reader_read_signal (GstdIReader * iface,
   GST_INFO_OBJECT (self, "connecting callback of %s",
       GSTD_OBJECT_NAME (object));
 
+  /* Stop waiting if the request gets cancelled, for example because
+   * the client hung up
+   */
+  cancellable = gstd_ipc_wait_begin ();
+  if (cancellable) {
+    cancel_id = g_cancellable_connect (cancellable,
+        G_CALLBACK (gstd_signal_reader_cancelled), self, NULL);
+  }
+
   g_mutex_lock (&self->signal_lock);
 
   self->waiting_signal = TRUE;
@@ -181,13 +209,13 @@ gstd_signal_reader_read_signal (GstdIReader * iface,
   g_object_get (object, "timeout", &timeout, NULL);
   if (timeout != -1) {
     end_time = g_get_monotonic_time () + timeout;
-    while (self->waiting_signal) {
+    while (self->waiting_signal && !g_cancellable_is_cancelled (cancellable)) {
       if (!g_cond_wait_until (&self->signal_call, &self->signal_lock, end_time)) {
         goto out;
       }
     }
   } else {
-    while (self->waiting_signal)
+    while (self->waiting_signal && !g_cancellable_is_cancelled (cancellable))
       g_cond_wait (&self->signal_call, &self->signal_lock);
   }
 
@@ -202,9 +230,25 @@ out:
   g_signal_handler_disconnect (target, handler_id);
   g_mutex_unlock (&self->signal_lock);
 
+  /* Must be done unlocked, it waits for a running cancel handler */
+  g_cancellable_disconnect (cancellable, cancel_id);
+  gstd_ipc_wait_end ();
+
   return ret;
 }
 
+static void
+gstd_signal_reader_cancelled (GCancellable * cancellable, gpointer user_data)
+{
+  GstdSignalReader *self = GSTD_SIGNAL_READER (user_data);
+
+  GST_INFO_OBJECT (self, "Signal wait cancelled");
+
+  g_mutex_lock (&self->signal_lock);
+  g_cond_broadcast (&self->signal_call);
+  g_mutex_unlock (&self->signal_lock);
+}
+
 void
 gstd_signal_marshal (GClosure * closure, GValue * return_value,
     guint n_param_values, const GValue * param_values, gpointer invocation_hint,
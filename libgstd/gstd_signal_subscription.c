@@ -0,0 +1,594 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_callback.h"
+#include "gstd_ipc.h"
+#include "gstd_property.h"
+#include "gstd_signal_reader.h"
+#include "gstd_signal_subscription.h"
+
+enum
+{
+  PROP_TARGET = 1,
+  PROP_SIGNAL_NAME,
+  PROP_MAX_SIZE,
+  PROP_COUNT_ONLY,
+  PROP_TIMEOUT,
+  PROP_MIN_INTERVAL,
+  PROP_PSPEC,
+  PROP_QUEUED,
+  PROP_EMITTED,
+  PROP_DROPPED,
+  N_PROPERTIES
+};
+
+#define DEFAULT_PROP_TARGET NULL
+#define DEFAULT_PROP_SIGNAL_NAME NULL
+#define DEFAULT_PROP_MAX_SIZE GSTD_SIGNAL_SUBSCRIPTION_DEFAULT_MAX_SIZE
+#define DEFAULT_PROP_MAX_SIZE_MIN 1
+#define DEFAULT_PROP_MAX_SIZE_MAX G_MAXINT
+#define DEFAULT_PROP_COUNT_ONLY FALSE
+#define DEFAULT_PROP_TIMEOUT -1
+#define DEFAULT_PROP_TIMEOUT_MIN -1
+#define DEFAULT_PROP_TIMEOUT_MAX G_MAXINT64
+#define DEFAULT_PROP_MIN_INTERVAL 0
+#define DEFAULT_PROP_MIN_INTERVAL_MIN 0
+#define DEFAULT_PROP_MIN_INTERVAL_MAX G_MAXINT64
+#define DEFAULT_PROP_PSPEC NULL
+
+/* Gstd Signal Subscription debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_signal_subscription_debug);
+#define GST_CAT_DEFAULT gstd_signal_subscription_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+G_DEFINE_TYPE (GstdSignalSubscription, gstd_signal_subscription,
+    GSTD_TYPE_OBJECT);
+
+/* VTable */
+static void gstd_signal_subscription_get_property (GObject *, guint, GValue *,
+    GParamSpec *);
+static void gstd_signal_subscription_set_property (GObject *, guint,
+    const GValue *, GParamSpec *);
+static void gstd_signal_subscription_dispose (GObject *);
+static void gstd_signal_subscription_finalize (GObject *);
+
+static void gstd_signal_subscription_marshal (GClosure * closure,
+    GValue * return_value, guint n_param_values, const GValue * param_values,
+    gpointer invocation_hint, gpointer marshal_data);
+static void gstd_signal_subscription_closure_notify (gpointer data,
+    GClosure * closure);
+static void gstd_signal_subscription_cancelled (GCancellable * cancellable,
+    gpointer user_data);
+static gboolean gstd_signal_subscription_is_empty (GstdSignalSubscription *
+    self);
+
+static void
+gstd_signal_subscription_class_init (GstdSignalSubscriptionClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  object_class->set_property = gstd_signal_subscription_set_property;
+  object_class->get_property = gstd_signal_subscription_get_property;
+  object_class->dispose = gstd_signal_subscription_dispose;
+  object_class->finalize = gstd_signal_subscription_finalize;
+
+  properties[PROP_TARGET] =
+      g_param_spec_object ("target",
+      "Target",
+      "The target object owning the signal",
+      G_TYPE_OBJECT,
+      G_PARAM_READWRITE |
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_SIGNAL_NAME] =
+      g_param_spec_string ("signal-name",
+      "Signal Name",
+      "The name of the subscribed signal",
+      DEFAULT_PROP_SIGNAL_NAME,
+      G_PARAM_READWRITE |
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_MAX_SIZE] =
+      g_param_spec_uint ("max-size",
+      "Max Size",
+      "The maximum amount of callbacks to queue before dropping the oldest",
+      DEFAULT_PROP_MAX_SIZE_MIN, DEFAULT_PROP_MAX_SIZE_MAX,
+      DEFAULT_PROP_MAX_SIZE,
+      G_PARAM_READWRITE |
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_COUNT_ONLY] =
+      g_param_spec_boolean ("count-only",
+      "Count Only",
+      "Aggregate emissions into a single counter instead of queueing "
+      "their arguments",
+      DEFAULT_PROP_COUNT_ONLY,
+      G_PARAM_READWRITE |
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_TIMEOUT] =
+      g_param_spec_int64 ("timeout", "Timeout",
+      "The quantity of time that callbacks should be waited for, -1: infinity, "
+      "0: no time, n: micro seconds to wait",
+      DEFAULT_PROP_TIMEOUT_MIN, DEFAULT_PROP_TIMEOUT_MAX, DEFAULT_PROP_TIMEOUT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ |
+      GSTD_PARAM_UPDATE);
+
+  properties[PROP_MIN_INTERVAL] =
+      g_param_spec_int64 ("min-interval", "Minimum Interval",
+      "The minimum time between two deliveries in micro seconds, emissions "
+      "in between are held until the interval expires",
+      DEFAULT_PROP_MIN_INTERVAL_MIN, DEFAULT_PROP_MIN_INTERVAL_MAX,
+      DEFAULT_PROP_MIN_INTERVAL,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ |
+      GSTD_PARAM_UPDATE);
+
+  properties[PROP_PSPEC] =
+      g_param_spec_pointer ("pspec",
+      "Property Specification",
+      "The watched property, if this is a property subscription",
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_QUEUED] =
+      g_param_spec_uint64 ("queued",
+      "Queued",
+      "The amount of emissions waiting to be read",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
+      GSTD_PARAM_READ);
+
+  properties[PROP_EMITTED] =
+      g_param_spec_uint64 ("emitted",
+      "Emitted",
+      "The amount of emissions received since the subscription was created",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
+      GSTD_PARAM_READ);
+
+  properties[PROP_DROPPED] =
+      g_param_spec_uint64 ("dropped",
+      "Dropped",
+      "The amount of callbacks discarded because the queue was full",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
+      GSTD_PARAM_READ);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_signal_subscription_debug,
+      "gstdsignalsubscription", debug_color,
+      "Gstd Signal Subscription category");
+}
+
+static void
+gstd_signal_subscription_init (GstdSignalSubscription * self)
+{
+  GST_INFO_OBJECT (self, "Initializing signal subscription");
+
+  self->target = DEFAULT_PROP_TARGET;
+  self->signal_name = DEFAULT_PROP_SIGNAL_NAME;
+  self->max_size = DEFAULT_PROP_MAX_SIZE;
+  self->count_only = DEFAULT_PROP_COUNT_ONLY;
+  self->timeout = DEFAULT_PROP_TIMEOUT;
+  self->min_interval = DEFAULT_PROP_MIN_INTERVAL;
+  self->pspec = DEFAULT_PROP_PSPEC;
+  self->emitted = 0;
+  self->dropped = 0;
+  self->handler_id = 0;
+  self->pending = 0;
+  self->last_delivery = 0;
+  self->wakeup = 0;
+  self->cancelled = FALSE;
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  g_queue_init (&self->callbacks);
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_SIGNAL_READER, NULL));
+}
+
+static void
+gstd_signal_subscription_dispose (GObject * object)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (object);
+
+  GST_INFO_OBJECT (self, "Disposing %s subscription", GSTD_OBJECT_NAME (self));
+
+  gstd_signal_subscription_cancel (self);
+
+  if (self->target) {
+    g_object_unref (self->target);
+    self->target = NULL;
+  }
+
+  G_OBJECT_CLASS (gstd_signal_subscription_parent_class)->dispose (object);
+}
+
+static void
+gstd_signal_subscription_finalize (GObject * object)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (object);
+
+  g_free (self->signal_name);
+  self->signal_name = NULL;
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (gstd_signal_subscription_parent_class)->finalize (object);
+}
+
+static void
+gstd_signal_subscription_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (object);
+
+  switch (property_id) {
+    case PROP_TARGET:
+      GST_DEBUG_OBJECT (self, "Returning signal owner %p", self->target);
+      g_value_set_object (value, self->target);
+      break;
+    case PROP_SIGNAL_NAME:
+      GST_DEBUG_OBJECT (self, "Returning signal name %s", self->signal_name);
+      g_value_set_string (value, self->signal_name);
+      break;
+    case PROP_MAX_SIZE:
+      GST_DEBUG_OBJECT (self, "Returning max size %u", self->max_size);
+      g_value_set_uint (value, self->max_size);
+      break;
+    case PROP_COUNT_ONLY:
+      GST_DEBUG_OBJECT (self, "Returning count only %d", self->count_only);
+      g_value_set_boolean (value, self->count_only);
+      break;
+    case PROP_TIMEOUT:
+      GST_DEBUG_OBJECT (self, "Returning subscription timeout %"
+          G_GINT64_FORMAT, self->timeout);
+      g_value_set_int64 (value, self->timeout);
+      break;
+    case PROP_MIN_INTERVAL:
+      GST_DEBUG_OBJECT (self, "Returning minimum interval %" G_GINT64_FORMAT,
+          self->min_interval);
+      g_value_set_int64 (value, self->min_interval);
+      break;
+    case PROP_PSPEC:
+      GST_DEBUG_OBJECT (self, "Returning property spec %p", self->pspec);
+      g_value_set_pointer (value, self->pspec);
+      break;
+    case PROP_QUEUED:
+      g_mutex_lock (&self->lock);
+      if (self->count_only) {
+        g_value_set_uint64 (value, self->pending);
+      } else {
+        g_value_set_uint64 (value, g_queue_get_length (&self->callbacks));
+      }
+      g_mutex_unlock (&self->lock);
+      break;
+    case PROP_EMITTED:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->emitted);
+      g_mutex_unlock (&self->lock);
+      break;
+    case PROP_DROPPED:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->dropped);
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_signal_subscription_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (object);
+
+  switch (property_id) {
+    case PROP_TARGET:
+      if (self->target)
+        g_object_unref (self->target);
+      self->target = g_value_dup_object (value);
+      GST_DEBUG_OBJECT (self, "Setting signal owner %p", self->target);
+      break;
+    case PROP_SIGNAL_NAME:
+      g_free (self->signal_name);
+      self->signal_name = g_value_dup_string (value);
+      GST_DEBUG_OBJECT (self, "Setting signal name %s", self->signal_name);
+      break;
+    case PROP_MAX_SIZE:
+      self->max_size = g_value_get_uint (value);
+      GST_DEBUG_OBJECT (self, "Setting max size %u", self->max_size);
+      break;
+    case PROP_COUNT_ONLY:
+      self->count_only = g_value_get_boolean (value);
+      GST_DEBUG_OBJECT (self, "Setting count only %d", self->count_only);
+      break;
+    case PROP_TIMEOUT:
+      self->timeout = g_value_get_int64 (value);
+      GST_DEBUG_OBJECT (self, "Timeout changed to %" G_GINT64_FORMAT,
+          self->timeout);
+      break;
+    case PROP_MIN_INTERVAL:
+      g_mutex_lock (&self->lock);
+      self->min_interval = g_value_get_int64 (value);
+      /* Let throttled readers recompute their deadline */
+      g_cond_broadcast (&self->cond);
+      g_mutex_unlock (&self->lock);
+      GST_DEBUG_OBJECT (self, "Minimum interval changed to %" G_GINT64_FORMAT,
+          self->min_interval);
+      break;
+    case PROP_PSPEC:
+      self->pspec = g_value_get_pointer (value);
+      GST_DEBUG_OBJECT (self, "Setting property spec %p", self->pspec);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_signal_subscription_closure_notify (gpointer data, GClosure * closure)
+{
+  g_object_unref (data);
+}
+
+static void
+gstd_signal_subscription_marshal (GClosure * closure, GValue * return_value,
+    guint n_param_values, const GValue * param_values,
+    gpointer invocation_hint, gpointer marshal_data)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (closure->data);
+  GstdCallback *callback = NULL;
+  GstdCallback *oldest = NULL;
+
+  /* Aggregated subscriptions don't pay for copying the arguments */
+  if (!self->count_only) {
+    callback = gstd_callback_new (self->signal_name, return_value,
+        n_param_values, param_values);
+  }
+
+  g_mutex_lock (&self->lock);
+
+  if (self->cancelled) {
+    g_mutex_unlock (&self->lock);
+    goto out;
+  }
+
+  self->emitted++;
+
+  if (self->count_only) {
+    /* Readers only care about the first pending emission, don't wake
+     * them up again for every coalesced one */
+    if (self->pending++) {
+      g_mutex_unlock (&self->lock);
+      goto out;
+    }
+  } else {
+    if (g_queue_get_length (&self->callbacks) >= self->max_size) {
+      GST_LOG_OBJECT (self, "Queue full, dropping oldest callback");
+      oldest = g_queue_pop_head (&self->callbacks);
+      self->dropped++;
+    }
+    g_queue_push_tail (&self->callbacks, callback);
+    callback = NULL;
+  }
+
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+out:
+  if (oldest)
+    g_object_unref (oldest);
+  if (callback)
+    g_object_unref (callback);
+}
+
+static gboolean
+gstd_signal_subscription_is_empty (GstdSignalSubscription * self)
+{
+  if (self->count_only) {
+    return 0 == self->pending;
+  } else {
+    return g_queue_is_empty (&self->callbacks);
+  }
+}
+
+GstdReturnCode
+gstd_signal_subscription_connect (GstdSignalSubscription * self)
+{
+  GClosure *closure;
+  guint signal_id;
+  GQuark detail;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_SUBSCRIPTION (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (self->target, GSTD_MISSING_INITIALIZATION);
+  g_return_val_if_fail (self->signal_name, GSTD_MISSING_INITIALIZATION);
+
+  if (!g_signal_parse_name (self->signal_name, G_OBJECT_TYPE (self->target),
+          &signal_id, &detail, TRUE)) {
+    GST_ERROR_OBJECT (self, "No \"%s\" signal in target", self->signal_name);
+    return GSTD_NO_RESOURCE;
+  }
+
+  /* The closure keeps the subscription alive while an emission is in
+   * progress, the reference is released once the handler is disconnected */
+  closure = g_closure_new_simple (sizeof (GClosure), self);
+  g_closure_set_marshal (closure, gstd_signal_subscription_marshal);
+  g_closure_add_finalize_notifier (closure, g_object_ref (self),
+      gstd_signal_subscription_closure_notify);
+
+  self->handler_id = g_signal_connect_closure_by_id (self->target, signal_id,
+      detail, closure, FALSE);
+
+  GST_INFO_OBJECT (self, "Subscribed to \"%s\" with %s queue of %u",
+      self->signal_name, self->count_only ? "a counting" : "a",
+      self->max_size);
+
+  return GSTD_EOK;
+}
+
+GstdReturnCode
+gstd_signal_subscription_pop (GstdSignalSubscription * self, GstdObject ** out)
+{
+  gint64 end_time = 0;
+  gint64 deadline;
+  gint64 now = 0;
+  gboolean ready = FALSE;
+  guint wakeup;
+  GCancellable *cancellable;
+  gulong cancel_id = 0;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_SUBSCRIPTION (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+
+  *out = NULL;
+
+  /* A cancelled request (i.e. its client hung up) stops waiting */
+  cancellable = gstd_ipc_wait_begin ();
+  if (cancellable) {
+    cancel_id = g_cancellable_connect (cancellable,
+        G_CALLBACK (gstd_signal_subscription_cancelled), self, NULL);
+  }
+
+  g_mutex_lock (&self->lock);
+
+  wakeup = self->wakeup;
+  if (self->timeout != -1) {
+    end_time = g_get_monotonic_time () + self->timeout;
+  }
+
+  while (!self->cancelled && wakeup == self->wakeup
+      && !g_cancellable_is_cancelled (cancellable)) {
+    now = g_get_monotonic_time ();
+    deadline = G_MAXINT64;
+
+    if (!gstd_signal_subscription_is_empty (self)) {
+      /* The first delivery is never throttled */
+      deadline = self->last_delivery ?
+          self->last_delivery + self->min_interval : now;
+      if (now >= deadline) {
+        ready = TRUE;
+        break;
+      }
+    }
+
+    if (self->timeout != -1) {
+      if (now >= end_time) {
+        break;
+      }
+      deadline = MIN (deadline, end_time);
+    }
+
+    if (G_MAXINT64 == deadline) {
+      g_cond_wait (&self->cond, &self->lock);
+    } else {
+      g_cond_wait_until (&self->cond, &self->lock, deadline);
+    }
+  }
+
+  if (!ready) {
+    goto out;
+  }
+
+  self->last_delivery = now;
+
+  if (self->pspec) {
+    /* Property watches only deliver the value at the time of reading,
+     * the notifications in between are coalesced */
+    *out = GSTD_OBJECT (g_object_new (GSTD_TYPE_PROPERTY, "name",
+            self->pspec->name, "target", self->target, "pspec", self->pspec,
+            NULL));
+    self->pending = 0;
+  } else if (self->count_only) {
+    *out = GSTD_OBJECT (gstd_callback_new_aggregate (self->signal_name,
+            self->pending));
+    self->pending = 0;
+  } else {
+    *out = g_queue_pop_head (&self->callbacks);
+  }
+
+out:
+  g_mutex_unlock (&self->lock);
+
+  g_cancellable_disconnect (cancellable, cancel_id);
+  gstd_ipc_wait_end ();
+
+  return GSTD_EOK;
+}
+
+static void
+gstd_signal_subscription_cancelled (GCancellable * cancellable,
+    gpointer user_data)
+{
+  GstdSignalSubscription *self = GSTD_SIGNAL_SUBSCRIPTION (user_data);
+
+  g_mutex_lock (&self->lock);
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+}
+
+void
+gstd_signal_subscription_wakeup (GstdSignalSubscription * self)
+{
+  g_return_if_fail (GSTD_IS_SIGNAL_SUBSCRIPTION (self));
+
+  g_mutex_lock (&self->lock);
+  self->wakeup++;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+}
+
+void
+gstd_signal_subscription_cancel (GstdSignalSubscription * self)
+{
+  GstdCallback *callback;
+  gulong handler_id;
+
+  g_return_if_fail (GSTD_IS_SIGNAL_SUBSCRIPTION (self));
+
+  g_mutex_lock (&self->lock);
+  self->cancelled = TRUE;
+  handler_id = self->handler_id;
+  self->handler_id = 0;
+  self->pending = 0;
+  while ((callback = g_queue_pop_head (&self->callbacks))) {
+    g_object_unref (callback);
+  }
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (handler_id) {
+    GST_INFO_OBJECT (self, "Unsubscribing from \"%s\"", self->signal_name);
+    g_signal_handler_disconnect (self->target, handler_id);
+  }
+}
@@ -0,0 +1,142 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_SIGNAL_SUBSCRIPTION_H__
+#define __GSTD_SIGNAL_SUBSCRIPTION_H__
+
+#include <glib-object.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_SIGNAL_SUBSCRIPTION \
+  (gstd_signal_subscription_get_type())
+#define GSTD_SIGNAL_SUBSCRIPTION(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_SIGNAL_SUBSCRIPTION,GstdSignalSubscription))
+#define GSTD_SIGNAL_SUBSCRIPTION_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_SIGNAL_SUBSCRIPTION,GstdSignalSubscriptionClass))
+#define GSTD_IS_SIGNAL_SUBSCRIPTION(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_SIGNAL_SUBSCRIPTION))
+#define GSTD_IS_SIGNAL_SUBSCRIPTION_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_SIGNAL_SUBSCRIPTION))
+#define GSTD_SIGNAL_SUBSCRIPTION_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_SIGNAL_SUBSCRIPTION, GstdSignalSubscriptionClass))
+
+#define GSTD_SIGNAL_SUBSCRIPTION_DEFAULT_MAX_SIZE 32
+
+typedef struct _GstdSignalSubscription GstdSignalSubscription;
+typedef struct _GstdSignalSubscriptionClass GstdSignalSubscriptionClass;
+GType gstd_signal_subscription_get_type (void);
+
+/**
+ * GstdSignalSubscription:
+ * A persistent connection to a signal that queues every emission
+ * until the subscriber reads it. When a pspec is given the subscription
+ * watches the "notify" signal of that property and only delivers its
+ * latest value.
+ */
+struct _GstdSignalSubscription
+{
+  GstdObject parent;
+
+  /* properties */
+  GObject *target;
+  gchar *signal_name;
+  guint max_size;
+  gboolean count_only;
+  gint64 timeout;
+  gint64 min_interval;
+  GParamSpec *pspec;
+
+  /* statistics */
+  guint64 emitted;
+  guint64 dropped;
+
+  gulong handler_id;
+
+  /* Pending callbacks, or number of pending emissions in count-only
+   * mode. All of them protected by the lock */
+  GMutex lock;
+  GCond cond;
+  GQueue callbacks;
+  guint64 pending;
+  gint64 last_delivery;
+  guint wakeup;
+  gboolean cancelled;
+};
+
+struct _GstdSignalSubscriptionClass
+{
+  GstdObjectClass parent_class;
+};
+
+/**
+ * gstd_signal_subscription_connect:
+ * @self: The subscription to connect
+ *
+ * Starts queueing the emissions of the signal in the target object.
+ *
+ * Returns: GSTD_EOK if the signal was connected, GSTD_NO_RESOURCE if
+ * the target doesn't have such signal.
+ */
+GstdReturnCode gstd_signal_subscription_connect (GstdSignalSubscription *
+    self);
+
+/**
+ * gstd_signal_subscription_pop:
+ * @self: The subscription to read from
+ * @out: (out) (transfer full): The oldest pending callback, the
+ * watched property for property subscriptions, or NULL if the timeout
+ * expired before any emission arrived.
+ *
+ * Blocks according to the subscription timeout until a callback is
+ * available and at least min-interval has passed since the previous
+ * delivery.
+ *
+ * Returns: GSTD_EOK unless the arguments are invalid.
+ */
+GstdReturnCode gstd_signal_subscription_pop (GstdSignalSubscription * self,
+    GstdObject ** out);
+
+/**
+ * gstd_signal_subscription_wakeup:
+ * @self: The subscription whose readers will be released
+ *
+ * Releases the readers currently blocked in the subscription without
+ * disconnecting from the signal.
+ */
+void gstd_signal_subscription_wakeup (GstdSignalSubscription * self);
+
+/**
+ * gstd_signal_subscription_cancel:
+ * @self: The subscription to cancel
+ *
+ * Disconnects from the signal, drops every pending callback and
+ * releases any blocked reader.
+ */
+void gstd_signal_subscription_cancel (GstdSignalSubscription * self);
+
+G_END_DECLS
+
+#endif // __GSTD_SIGNAL_SUBSCRIPTION_H__
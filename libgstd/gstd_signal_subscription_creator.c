@@ -0,0 +1,282 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstd_property.h"
+#include "gstd_signal.h"
+#include "gstd_signal_subscription.h"
+#include "gstd_signal_subscription_creator.h"
+
+enum
+{
+  PROP_SIGNAL = 1,
+  PROP_PROPERTY,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_signal_subscription_creator_debug);
+#define GST_CAT_DEFAULT gstd_signal_subscription_creator_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+#define GSTD_SIGNAL_SUBSCRIPTION_COUNT_ONLY "count-only"
+#define GSTD_SIGNAL_SUBSCRIPTION_INTERVAL "interval="
+
+static void gstd_signal_subscription_creator_set_property (GObject *,
+    guint, const GValue *, GParamSpec *);
+static GstdReturnCode gstd_signal_subscription_creator_create (GstdICreator *
+    iface, const gchar * name, const gchar * description, GstdObject ** out);
+static GstdReturnCode
+gstd_signal_subscription_creator_parse (GstdSignalSubscriptionCreator * self,
+    const gchar * description, guint * max_size, gboolean * count_only,
+    gint64 * min_interval);
+
+typedef struct _GstdSignalSubscriptionCreatorClass
+    GstdSignalSubscriptionCreatorClass;
+
+/**
+ * GstdSignalSubscriptionCreator:
+ * Creates persistent subscriptions to a signal or to the changes of a
+ * property. The description has the form
+ * "[max-size] [count-only] [interval=<micro seconds>]".
+ */
+struct _GstdSignalSubscriptionCreator
+{
+  GObject parent;
+
+  /* The signal or property owns this creator through its subscription
+   * list, so no reference is held to avoid a cycle */
+  GstdSignal *signal;
+  GstdProperty *property;
+};
+
+struct _GstdSignalSubscriptionCreatorClass
+{
+  GObjectClass parent_class;
+};
+
+static void
+gstd_icreator_interface_init (GstdICreatorInterface * iface)
+{
+  iface->create = gstd_signal_subscription_creator_create;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdSignalSubscriptionCreator,
+    gstd_signal_subscription_creator, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE (GSTD_TYPE_ICREATOR, gstd_icreator_interface_init));
+
+static void
+gstd_signal_subscription_creator_class_init (GstdSignalSubscriptionCreatorClass
+    * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  object_class->set_property = gstd_signal_subscription_creator_set_property;
+
+  properties[PROP_SIGNAL] =
+      g_param_spec_object ("signal",
+      "Signal",
+      "The signal to subscribe to",
+      GSTD_TYPE_SIGNAL,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_PROPERTY] =
+      g_param_spec_object ("property",
+      "Property",
+      "The property to watch for changes",
+      GSTD_TYPE_PROPERTY,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_signal_subscription_creator_debug,
+      "gstdsignalsubscriptioncreator", debug_color,
+      "Gstd Signal Subscription Creator category");
+}
+
+static void
+gstd_signal_subscription_creator_init (GstdSignalSubscriptionCreator * self)
+{
+  GST_INFO_OBJECT (self, "Initializing signal subscription creator");
+  self->signal = NULL;
+  self->property = NULL;
+}
+
+static void
+gstd_signal_subscription_creator_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdSignalSubscriptionCreator *self =
+      GSTD_SIGNAL_SUBSCRIPTION_CREATOR (object);
+
+  switch (property_id) {
+    case PROP_SIGNAL:
+      self->signal = g_value_get_object (value);
+      GST_INFO_OBJECT (self, "Changed signal to %p", self->signal);
+      break;
+    case PROP_PROPERTY:
+      self->property = g_value_get_object (value);
+      GST_INFO_OBJECT (self, "Changed property to %p", self->property);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static GstdReturnCode
+gstd_signal_subscription_creator_parse (GstdSignalSubscriptionCreator * self,
+    const gchar * description, guint * max_size, gboolean * count_only,
+    gint64 * min_interval)
+{
+  gchar **tokens;
+  gchar **token;
+  gchar *end;
+  guint64 size;
+  gint64 interval;
+  GstdReturnCode ret = GSTD_EOK;
+
+  if (NULL == description) {
+    return GSTD_EOK;
+  }
+
+  tokens = g_strsplit (description, " ", -1);
+
+  for (token = tokens; *token; token++) {
+    if ('\0' == **token) {
+      continue;
+    }
+
+    if (!g_ascii_strcasecmp (GSTD_SIGNAL_SUBSCRIPTION_COUNT_ONLY, *token)) {
+      *count_only = TRUE;
+      continue;
+    }
+
+    if (g_str_has_prefix (*token, GSTD_SIGNAL_SUBSCRIPTION_INTERVAL)) {
+      interval = g_ascii_strtoll (*token +
+          strlen (GSTD_SIGNAL_SUBSCRIPTION_INTERVAL), &end, 10);
+      if ('\0' != *end || interval < 0) {
+        GST_ERROR_OBJECT (self, "Invalid subscription interval \"%s\"",
+            *token);
+        ret = GSTD_BAD_VALUE;
+        break;
+      }
+      *min_interval = interval;
+      continue;
+    }
+
+    size = g_ascii_strtoull (*token, &end, 10);
+    if ('\0' != *end || 0 == size || size > G_MAXINT) {
+      GST_ERROR_OBJECT (self, "Invalid subscription option \"%s\"", *token);
+      ret = GSTD_BAD_VALUE;
+      break;
+    }
+
+    *max_size = size;
+  }
+
+  g_strfreev (tokens);
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_signal_subscription_creator_create (GstdICreator * iface,
+    const gchar * name, const gchar * description, GstdObject ** out)
+{
+  GstdSignalSubscriptionCreator *self;
+  GstdSignalSubscription *subscription;
+  GstdReturnCode ret;
+  guint max_size = GSTD_SIGNAL_SUBSCRIPTION_DEFAULT_MAX_SIZE;
+  gboolean count_only = FALSE;
+  gint64 min_interval = 0;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_SIGNAL_SUBSCRIPTION_CREATOR (iface);
+  *out = NULL;
+
+  g_return_val_if_fail (self->signal || self->property,
+      GSTD_MISSING_INITIALIZATION);
+
+  if (NULL == name) {
+    GST_ERROR_OBJECT (self, "Subscription name not provided");
+    return GSTD_MISSING_NAME;
+  }
+
+  ret = gstd_signal_subscription_creator_parse (self, description, &max_size,
+      &count_only, &min_interval);
+  if (ret) {
+    return ret;
+  }
+
+  if (self->signal) {
+    subscription = g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION, "name", name,
+        "target", self->signal->target, "signal-name",
+        GSTD_OBJECT_NAME (self->signal), "max-size", max_size, "count-only",
+        count_only, "min-interval", min_interval, "timeout",
+        self->signal->timeout, NULL);
+  } else {
+    GParamSpec *pspec = self->property->pspec;
+    gchar *signal_name;
+
+    if (NULL == pspec) {
+      pspec = g_object_class_find_property (G_OBJECT_GET_CLASS
+          (self->property->target), GSTD_OBJECT_NAME (self->property));
+    }
+
+    if (NULL == pspec || !(pspec->flags & G_PARAM_READABLE)) {
+      GST_ERROR_OBJECT (self, "The property %s can't be watched",
+          GSTD_OBJECT_NAME (self->property));
+      return GSTD_NO_READ;
+    }
+
+    /* Only the latest value is of interest, so there is nothing to
+     * queue besides the fact that the property changed */
+    signal_name = g_strdup_printf ("notify::%s", pspec->name);
+    subscription = g_object_new (GSTD_TYPE_SIGNAL_SUBSCRIPTION, "name", name,
+        "target", self->property->target, "signal-name", signal_name,
+        "count-only", TRUE, "min-interval", min_interval, "pspec", pspec,
+        NULL);
+    g_free (signal_name);
+  }
+
+  ret = gstd_signal_subscription_connect (subscription);
+  if (ret) {
+    g_object_unref (subscription);
+    return ret;
+  }
+
+  *out = GSTD_OBJECT (subscription);
+
+  return GSTD_EOK;
+}
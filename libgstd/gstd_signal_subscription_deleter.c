@@ -0,0 +1,97 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_signal_subscription.h"
+#include "gstd_signal_subscription_deleter.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_signal_subscription_deleter_debug);
+#define GST_CAT_DEFAULT gstd_signal_subscription_deleter_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode gstd_signal_subscription_deleter_delete (GstdIDeleter *
+    iface, GstdObject * object);
+
+typedef struct _GstdSignalSubscriptionDeleterClass
+    GstdSignalSubscriptionDeleterClass;
+
+/**
+ * GstdSignalSubscriptionDeleter:
+ * Disconnects and releases signal subscriptions
+ */
+struct _GstdSignalSubscriptionDeleter
+{
+  GObject parent;
+};
+
+struct _GstdSignalSubscriptionDeleterClass
+{
+  GObjectClass parent_class;
+};
+
+
+static void
+gstd_ideleter_interface_init (GstdIDeleterInterface * iface)
+{
+  iface->delete = gstd_signal_subscription_deleter_delete;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdSignalSubscriptionDeleter,
+    gstd_signal_subscription_deleter, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE (GSTD_TYPE_IDELETER, gstd_ideleter_interface_init));
+
+static void
+gstd_signal_subscription_deleter_class_init (GstdSignalSubscriptionDeleterClass
+    * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_signal_subscription_deleter_debug,
+      "gstdsignalsubscriptiondeleter", debug_color,
+      "Gstd Signal Subscription Deleter category");
+}
+
+static void
+gstd_signal_subscription_deleter_init (GstdSignalSubscriptionDeleter * self)
+{
+  GST_INFO_OBJECT (self, "Initializing signal subscription deleter");
+}
+
+static GstdReturnCode
+gstd_signal_subscription_deleter_delete (GstdIDeleter * iface,
+    GstdObject * object)
+{
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (GSTD_IS_SIGNAL_SUBSCRIPTION (object),
+      GSTD_NULL_ARGUMENT);
+
+  /* Release any blocked reader before dropping the list reference */
+  gstd_signal_subscription_cancel (GSTD_SIGNAL_SUBSCRIPTION (object));
+  g_object_unref (object);
+
+  return GSTD_EOK;
+}
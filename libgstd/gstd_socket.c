@@ -24,7 +24,9 @@
 
 #include <string.h>
 
+#include "gstd_journal.h"
 #include "gstd_parser.h"
+#include "gstd_trace.h"
 
 #include "gstd_socket.h"
 
@@ -36,6 +38,25 @@ GST_DEBUG_CATEGORY_STATIC (gstd_socket_debug);
 
 G_DEFINE_TYPE (GstdSocket, gstd_socket, GSTD_TYPE_IPC);
 
+typedef struct _GstdSocketClient GstdSocketClient;
+
+/* A connection, shared between its worker and the monitor thread */
+struct _GstdSocketClient
+{
+  gint refcount;
+  GSocket *socket;
+  GMainContext *context;
+  GCancellable *cancellable;
+  gint request_timeout;
+  gint64 request_start;
+
+  /* Protected by the lock */
+  GMutex lock;
+  gboolean waiting;
+  GSource *watch;
+  GSource *deadline;
+};
+
 /* VTable */
 
 static gboolean
@@ -45,6 +66,24 @@ gstd_socket_callback (GSocketService * service,
 static void gstd_socket_dispose (GObject *);
 static GstdReturnCode gstd_socket_start (GstdIpc * base, GstdSession * session);
 static GstdReturnCode gstd_socket_stop (GstdIpc * base);
+static gpointer gstd_socket_monitor_thread (gpointer data);
+static gboolean gstd_socket_peer_closed (GSocket * socket,
+    GIOCondition condition, gpointer data);
+static gboolean gstd_socket_deadline_expired (gpointer data);
+static gboolean gstd_socket_deadline_dispatch (GSource * source,
+    GSourceFunc callback, gpointer data);
+static GstdSocketClient *gstd_socket_client_new (GstdSocket * self,
+    GSocket * socket);
+static gpointer gstd_socket_client_ref (GstdSocketClient * client);
+static void gstd_socket_client_unref (gpointer data);
+static void gstd_socket_client_close (GstdSocketClient * client);
+static void gstd_socket_client_watch (GstdSocketClient * client,
+    gboolean pending);
+static void gstd_socket_client_wait (gboolean waiting, gpointer data);
+
+static GSourceFuncs deadline_funcs = {
+  NULL, NULL, gstd_socket_deadline_dispatch, NULL
+};
 
 static void
 gstd_socket_class_init (GstdSocketClass * klass)
@@ -68,6 +107,12 @@ gstd_socket_init (GstdSocket * self)
   GstdIpc *base = GSTD_IPC (self);
   GST_INFO_OBJECT (self, "Initializing gstd Socket");
   self->service = NULL;
+  self->request_timeout = GSTD_SOCKET_DEFAULT_REQUEST_TIMEOUT;
+  self->monitor_context = NULL;
+  self->monitor_loop = NULL;
+  self->monitor_thread = NULL;
+  self->connections = NULL;
+  self->active_requests = NULL;
   base->enabled = FALSE;
 }
 
@@ -81,12 +126,226 @@ gstd_socket_dispose (GObject * object)
 
 
 
+static gpointer
+gstd_socket_monitor_thread (gpointer data)
+{
+  GstdSocket *self = GSTD_SOCKET (data);
+
+  g_main_context_push_thread_default (self->monitor_context);
+  g_main_loop_run (self->monitor_loop);
+  g_main_context_pop_thread_default (self->monitor_context);
+
+  return NULL;
+}
+
+static GstdSocketClient *
+gstd_socket_client_new (GstdSocket * self, GSocket * socket)
+{
+  GstdSocketClient *client = g_new0 (GstdSocketClient, 1);
+
+  client->refcount = 1;
+  client->socket = g_object_ref (socket);
+  client->context = g_main_context_ref (self->monitor_context);
+  client->cancellable = g_cancellable_new ();
+  client->request_timeout = self->request_timeout;
+  g_mutex_init (&client->lock);
+
+  /* Armed with a ready time while a request waits */
+  if (client->request_timeout >= 0) {
+    client->deadline = g_source_new (&deadline_funcs, sizeof (GSource));
+    g_source_set_callback (client->deadline, gstd_socket_deadline_expired,
+        gstd_socket_client_ref (client), gstd_socket_client_unref);
+    g_source_attach (client->deadline, client->context);
+  }
+
+  return client;
+}
+
+static gpointer
+gstd_socket_client_ref (GstdSocketClient * client)
+{
+  g_atomic_int_inc (&client->refcount);
+
+  return client;
+}
+
+static void
+gstd_socket_client_unref (gpointer data)
+{
+  GstdSocketClient *client = data;
+
+  if (!g_atomic_int_dec_and_test (&client->refcount)) {
+    return;
+  }
+
+  g_mutex_clear (&client->lock);
+  g_object_unref (client->cancellable);
+  g_main_context_unref (client->context);
+  g_object_unref (client->socket);
+  g_free (client);
+}
+
+/* Releases the sources, which hold references to the client */
+static void
+gstd_socket_client_close (GstdSocketClient * client)
+{
+  g_mutex_lock (&client->lock);
+
+  client->waiting = FALSE;
+  if (client->watch) {
+    g_source_destroy (client->watch);
+    g_source_unref (client->watch);
+    client->watch = NULL;
+  }
+  if (client->deadline) {
+    g_source_destroy (client->deadline);
+    g_source_unref (client->deadline);
+    client->deadline = NULL;
+  }
+
+  g_mutex_unlock (&client->lock);
+
+  gstd_socket_client_unref (client);
+}
+
+/* Called with the client lock. While the client has a pipelined request
+ * waiting to be read the socket stays readable, so only errors and
+ * hang ups are watched until the worker reads it.
+ */
+static void
+gstd_socket_client_watch (GstdSocketClient * client, gboolean pending)
+{
+  GIOCondition condition = G_IO_HUP | G_IO_ERR;
+
+  if (client->watch) {
+    g_source_destroy (client->watch);
+    g_source_unref (client->watch);
+  }
+
+  if (!pending) {
+    condition |= G_IO_IN;
+  }
+
+  client->watch = g_socket_create_source (client->socket, condition, NULL);
+  g_source_set_callback (client->watch, (GSourceFunc) gstd_socket_peer_closed,
+      gstd_socket_client_ref (client), gstd_socket_client_unref);
+  g_source_attach (client->watch, client->context);
+}
+
+/* Requests only notice the client going away while they block, so the
+ * socket is watched during those waits only
+ */
+static void
+gstd_socket_client_wait (gboolean waiting, gpointer data)
+{
+  GstdSocketClient *client = data;
+
+  g_mutex_lock (&client->lock);
+
+  client->waiting = waiting;
+
+  if (waiting) {
+    gstd_socket_client_watch (client,
+        g_socket_get_available_bytes (client->socket) > 0);
+  } else if (client->watch) {
+    g_source_destroy (client->watch);
+    g_source_unref (client->watch);
+    client->watch = NULL;
+  }
+
+  if (client->deadline) {
+    g_source_set_ready_time (client->deadline, waiting ?
+        client->request_start +
+        client->request_timeout * G_TIME_SPAN_MILLISECOND : -1);
+  }
+
+  g_mutex_unlock (&client->lock);
+}
+
+static gboolean
+gstd_socket_peer_closed (GSocket * socket, GIOCondition condition,
+    gpointer data)
+{
+  GstdSocketClient *client = data;
+
+  g_mutex_lock (&client->lock);
+
+  /* The wait ended while this was being dispatched */
+  if (!client->waiting || g_source_is_destroyed (g_main_current_source ())) {
+    goto out;
+  }
+
+  /* A readable socket with nothing to read means the peer closed its
+   * end. Otherwise the client pipelined its next request, which is left
+   * untouched for the worker to read once the current one finishes.
+   */
+  if ((condition & (G_IO_HUP | G_IO_ERR))
+      || g_socket_get_available_bytes (socket) <= 0) {
+    GST_INFO ("Peer hung up, cancelling its pending request");
+    g_cancellable_cancel (client->cancellable);
+  } else {
+    gstd_socket_client_watch (client, TRUE);
+  }
+
+out:
+  g_mutex_unlock (&client->lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+gstd_socket_deadline_dispatch (GSource * source, GSourceFunc callback,
+    gpointer data)
+{
+  g_source_set_ready_time (source, -1);
+
+  return callback (data);
+}
+
+static gboolean
+gstd_socket_deadline_expired (gpointer data)
+{
+  GstdSocketClient *client = data;
+
+  g_mutex_lock (&client->lock);
+  if (client->waiting) {
+    GST_INFO ("Request deadline expired, cancelling it");
+    g_cancellable_cancel (client->cancellable);
+  }
+  g_mutex_unlock (&client->lock);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GstdReturnCode
+gstd_socket_process_request (GstdSocket * self, GstdSocketClient * client,
+    const gchar * message, gchar ** output)
+{
+  GstdSession *session = GSTD_IPC (self)->session;
+  GstdReturnCode ret;
+
+  /* Blocking reads (bus messages, signals, subscriptions) pick the
+   * client cancellable up as the thread's current one and return early
+   * as if they had timed out once it is cancelled
+   */
+  client->request_start = g_get_monotonic_time ();
+  g_cancellable_reset (client->cancellable);
+
+  gstd_metrics_gauge_inc (self->active_requests);
+  ret = gstd_parser_parse_cmd (session, message, output);       // in the parser
+  gstd_metrics_gauge_dec (self->active_requests);
+
+  return ret;
+}
+
 static gboolean
 gstd_socket_callback (GSocketService * service,
     GSocketConnection * connection, GObject * source_object, gpointer user_data)
 {
 
-  GstdSession *session;
+  GstdSocket *self;
+  GstdSocketClient *client;
+  GSocket *socket;
   GInputStream *istream;
   GOutputStream *ostream;
   gint read;
@@ -96,19 +355,34 @@ gstd_socket_callback (GSocketService * service,
   gchar *message;
   GstdReturnCode ret;
   const gchar *description = NULL;
+  gint64 start;
+  gint64 reply_start;
+  GstdJournalProtocol protocol;
 
   g_return_val_if_fail (service, FALSE);
   g_return_val_if_fail (connection, FALSE);
   g_return_val_if_fail (user_data, FALSE);
 
-  session = GSTD_SESSION (user_data);
-  g_return_val_if_fail (session, FALSE);
+  self = GSTD_SOCKET (user_data);
+  g_return_val_if_fail (GSTD_IPC (self)->session, FALSE);
 
+  socket = g_socket_connection_get_socket (connection);
   istream = g_io_stream_get_input_stream (G_IO_STREAM (connection));
   ostream = g_io_stream_get_output_stream (G_IO_STREAM (connection));
 
   message = g_malloc (size);
 
+  /* Each connection is served by its own worker, for as long as it lasts */
+  protocol = G_SOCKET_FAMILY_UNIX == g_socket_get_family (socket) ?
+      GSTD_JOURNAL_PROTOCOL_UNIX : GSTD_JOURNAL_PROTOCOL_TCP;
+  gstd_journal_set_connection (protocol, gstd_journal_new_connection ());
+
+  gstd_metrics_gauge_inc (self->connections);
+
+  client = gstd_socket_client_new (self, socket);
+  g_cancellable_push_current (client->cancellable);
+  gstd_ipc_set_wait_func (gstd_socket_client_wait, client);
+
   while (TRUE) {
     read = g_input_stream_read (istream, message, size, NULL, NULL);
 
@@ -117,8 +391,10 @@ gstd_socket_callback (GSocketService * service,
       break;
     }
     message[read] = '\0';
+    gstd_trace_instant ("receive", message);
 
-    ret = gstd_parser_parse_cmd (session, message, &output);    // in the parser
+    start = gstd_trace_now ();
+    ret = gstd_socket_process_request (self, client, message, &output);
 
     /* Prepend the code to the output */
     description = gstd_return_code_to_string (ret);
@@ -129,15 +405,26 @@ gstd_socket_callback (GSocketService * service,
     g_free (output);
     output = NULL;
 
+    /* If the peer hung up this fails and the worker is released */
+    reply_start = gstd_trace_now ();
     read =
         g_output_stream_write (ostream, response, strlen (response) + 1, NULL,
         NULL);
+    gstd_trace_span ("reply", NULL, reply_start);
+    gstd_trace_span ("request", message, start);
+    g_free (response);
     if (read < 0) {
       break;
     }
-    g_free (response);
   }
 
+  gstd_ipc_set_wait_func (NULL, NULL);
+  g_cancellable_pop_current (client->cancellable);
+  gstd_socket_client_close (client);
+
+  gstd_metrics_gauge_dec (self->connections);
+  gstd_journal_set_connection (GSTD_JOURNAL_PROTOCOL_NONE, 0);
+
   g_free (message);
 
   return TRUE;
@@ -149,6 +436,7 @@ gstd_socket_start (GstdIpc * base, GstdSession * session)
   GstdSocket *self = GSTD_SOCKET (base);
   GSocketService *service;
   GstdReturnCode ret;
+  gchar *labels;
 
   GST_DEBUG_OBJECT (self, "Starting SOCKET");
 
@@ -162,8 +450,20 @@ gstd_socket_start (GstdIpc * base, GstdSession * session)
   if (ret != GSTD_EOK)
     return ret;
 
+  labels = g_strdup_printf ("ipc=\"%s\"", G_OBJECT_TYPE_NAME (self));
+  self->connections = gstd_metrics_gauge_get ("gstd_ipc_connections",
+      "Clients currently connected", labels);
+  self->active_requests = gstd_metrics_gauge_get ("gstd_ipc_active_requests",
+      "Requests currently being processed", labels);
+  g_free (labels);
+
+  self->monitor_context = g_main_context_new ();
+  self->monitor_loop = g_main_loop_new (self->monitor_context, FALSE);
+  self->monitor_thread = g_thread_new ("gstd-socket-monitor",
+      gstd_socket_monitor_thread, self);
+
   /* listen to the 'incoming' signal */
-  g_signal_connect (service, "run", G_CALLBACK (gstd_socket_callback), session);
+  g_signal_connect (service, "run", G_CALLBACK (gstd_socket_callback), self);
 
   /* start the socket service */
   g_socket_service_start (service);
@@ -182,6 +482,17 @@ gstd_socket_stop (GstdIpc * base)
   g_return_val_if_fail (session, GSTD_NULL_ARGUMENT);
 
   GST_DEBUG_OBJECT (self, "Entering SOCKET stop ");
+
+  if (self->monitor_thread) {
+    g_main_loop_quit (self->monitor_loop);
+    g_thread_join (self->monitor_thread);
+    g_main_loop_unref (self->monitor_loop);
+    g_main_context_unref (self->monitor_context);
+    self->monitor_thread = NULL;
+    self->monitor_loop = NULL;
+    self->monitor_context = NULL;
+  }
+
   if (self->service) {
     service = self->service;
     listener = G_SOCKET_LISTENER (service);
@@ -23,8 +23,11 @@
 #include <gio/gio.h>
 
 #include "gstd_ipc.h"
+#include "gstd_metrics.h"
 
 G_BEGIN_DECLS
+/* Requests may block for as long as they want by default */
+#define GSTD_SOCKET_DEFAULT_REQUEST_TIMEOUT -1
 #define GSTD_TYPE_SOCKET \
   (gstd_socket_get_type())
 #define GSTD_SOCKET(obj) \
@@ -44,6 +47,17 @@ struct _GstdSocket
 {
   GstdIpc parent;
   GSocketService *service;
+
+  /* Maximum time in milliseconds a single request may block, -1 for none */
+  gint request_timeout;
+
+  /* Watches peers of in-flight requests for hangups and deadlines */
+  GMainContext *monitor_context;
+  GMainLoop *monitor_loop;
+  GThread *monitor_thread;
+
+  GstdMetricsGauge *connections;
+  GstdMetricsGauge *active_requests;
 };
 
 struct _GstdSocketClass
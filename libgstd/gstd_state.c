@@ -24,6 +24,7 @@
 
 #include <gst/gst.h>
 
+#include "gstd_probes.h"
 #include "gstd_state.h"
 
 enum
@@ -239,9 +240,13 @@ gstd_state_update (GstdObject * object, const gchar * sstate)
   gstret = gst_element_set_state (self->target, state);
   if (GST_STATE_CHANGE_FAILURE == gstret) {
     GST_ERROR_OBJECT (self, "Failed to change the state of the pipeline");
+    GSTD_PROBE3 (pipeline__state, GST_ELEMENT_NAME (self->target), state,
+        GSTD_STATE_ERROR);
     return GSTD_STATE_ERROR;
   }
 
+  GSTD_PROBE3 (pipeline__state, GST_ELEMENT_NAME (self->target), state,
+      GSTD_EOK);
   self->state = state;
 
   return GSTD_EOK;
@@ -167,6 +167,12 @@ gstd_tcp_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
           "means unlimited (default -1)",
         "tcp-max-threads"}
     ,
+    {"tcp-request-timeout", 0, 0, G_OPTION_ARG_INT,
+          &GSTD_SOCKET (base)->request_timeout,
+          "Max time in milliseconds a request may block waiting for bus "
+          "messages or signals. -1 means no limit (default -1)",
+        "tcp-request-timeout"}
+    ,
     {NULL}
   };
   GST_DEBUG_OBJECT (self, "TCP init group callback ");
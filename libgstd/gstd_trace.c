@@ -0,0 +1,311 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <json-glib/json-glib.h>
+#include <string.h>
+
+#include "gstd_trace.h"
+#include "gstd_shards.h"
+
+/* Gstd Trace debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_trace_debug);
+#define GST_CAT_DEFAULT gstd_trace_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+typedef struct _GstdTraceEvent GstdTraceEvent;
+typedef struct _GstdTraceRing GstdTraceRing;
+typedef struct _GstdTraceWriter GstdTraceWriter;
+
+struct _GstdTraceEvent
+{
+  const gchar *name;
+  /* Microseconds of monotonic time */
+  gint64 ts;
+  /* Duration of spans, -1 for instant events */
+  gint64 dur;
+  gchar detail[GSTD_TRACE_DETAIL_SIZE];
+};
+
+/* Events recorded by a single thread. Only the owner writes the
+ * events, then publishes them by bumping the count. A ring found with
+ * an old generation belongs to a previous recording and is reset by
+ * its owner. The rings of exiting threads are kept until the next
+ * recording starts, their events are still needed by the next write.
+ */
+struct _GstdTraceRing
+{
+  GstdShard shard;
+  guint count;
+  GstdTraceEvent events[GSTD_TRACE_RING_SIZE];
+};
+
+struct _GstdTraceWriter
+{
+  JsonBuilder *builder;
+  guint events;
+};
+
+static void gstd_trace_init_debug (void);
+static void gstd_trace_ring_clear (gpointer data, gpointer user_data);
+static void gstd_trace_record (const gchar * name, const gchar * detail,
+    gint64 ts, gint64 dur);
+static void gstd_trace_add_event (JsonBuilder * builder, guint tid,
+    const GstdTraceEvent * event);
+static void gstd_trace_add_ring (gpointer data, gpointer user_data);
+
+static GMutex trace_lock;
+static GstdShards trace_rings = GSTD_SHARDS_INIT (GstdTraceRing,
+    gstd_trace_ring_clear, NULL);
+static gint trace_recording = FALSE;
+static gchar *trace_filename = NULL;
+
+static void
+gstd_trace_init_debug (void)
+{
+  static gsize init = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&init)) {
+    /* Initialize debug category with nice colors */
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_trace_debug, "gstdtrace", debug_color,
+        "Gstd Trace category");
+    g_once_init_leave (&init, 1);
+  }
+}
+
+static void
+gstd_trace_ring_clear (gpointer data, gpointer user_data)
+{
+  GstdTraceRing *ring = data;
+
+  g_atomic_int_set (&ring->count, 0);
+}
+
+static void
+gstd_trace_record (const gchar * name, const gchar * detail, gint64 ts,
+    gint64 dur)
+{
+  GstdTraceRing *ring;
+  GstdTraceEvent *event;
+  guint count;
+
+  ring = gstd_shards_get (&trace_rings);
+
+  count = ring->count;
+  event = &ring->events[count % GSTD_TRACE_RING_SIZE];
+  event->name = name;
+  event->ts = ts;
+  event->dur = dur;
+  if (detail) {
+    g_strlcpy (event->detail, detail, GSTD_TRACE_DETAIL_SIZE);
+  } else {
+    event->detail[0] = '\0';
+  }
+
+  g_atomic_int_set (&ring->count, count + 1);
+}
+
+gint64
+gstd_trace_now (void)
+{
+  if (G_LIKELY (!g_atomic_int_get (&trace_recording))) {
+    return 0;
+  }
+
+  return g_get_monotonic_time ();
+}
+
+void
+gstd_trace_span (const gchar * name, const gchar * detail, gint64 start)
+{
+  gint64 now;
+
+  g_return_if_fail (name);
+
+  if (G_LIKELY (0 == start) || !g_atomic_int_get (&trace_recording)) {
+    return;
+  }
+
+  now = g_get_monotonic_time ();
+  gstd_trace_record (name, detail, start, now - start);
+}
+
+void
+gstd_trace_instant (const gchar * name, const gchar * detail)
+{
+  g_return_if_fail (name);
+
+  if (G_LIKELY (!g_atomic_int_get (&trace_recording))) {
+    return;
+  }
+
+  gstd_trace_record (name, detail, g_get_monotonic_time (), -1);
+}
+
+void
+gstd_trace_start (const gchar * filename)
+{
+  gstd_trace_init_debug ();
+
+  g_mutex_lock (&trace_lock);
+  g_free (trace_filename);
+  trace_filename = g_strdup (filename);
+  g_mutex_unlock (&trace_lock);
+
+  /* Every ring resets itself on its next event */
+  gstd_shards_reset (&trace_rings);
+  g_atomic_int_set (&trace_recording, TRUE);
+
+  GST_INFO ("Started recording a trace");
+}
+
+static void
+gstd_trace_add_event (JsonBuilder * builder, guint tid,
+    const GstdTraceEvent * event)
+{
+  json_builder_begin_object (builder);
+
+  json_builder_set_member_name (builder, "name");
+  json_builder_add_string_value (builder, event->name);
+
+  json_builder_set_member_name (builder, "cat");
+  json_builder_add_string_value (builder, "gstd");
+
+  json_builder_set_member_name (builder, "ph");
+  if (event->dur < 0) {
+    json_builder_add_string_value (builder, "i");
+    json_builder_set_member_name (builder, "s");
+    json_builder_add_string_value (builder, "t");
+  } else {
+    json_builder_add_string_value (builder, "X");
+    json_builder_set_member_name (builder, "dur");
+    json_builder_add_int_value (builder, event->dur);
+  }
+
+  json_builder_set_member_name (builder, "ts");
+  json_builder_add_int_value (builder, event->ts);
+
+  json_builder_set_member_name (builder, "pid");
+  json_builder_add_int_value (builder, 1);
+
+  json_builder_set_member_name (builder, "tid");
+  json_builder_add_int_value (builder, tid);
+
+  if (event->detail[0]) {
+    json_builder_set_member_name (builder, "args");
+    json_builder_begin_object (builder);
+    json_builder_set_member_name (builder, "detail");
+    json_builder_add_string_value (builder, event->detail);
+    json_builder_end_object (builder);
+  }
+
+  json_builder_end_object (builder);
+}
+
+static void
+gstd_trace_add_ring (gpointer data, gpointer user_data)
+{
+  GstdTraceRing *ring = data;
+  GstdTraceWriter *writer = user_data;
+  guint count;
+  guint first;
+  guint i;
+
+  count = g_atomic_int_get (&ring->count);
+  first = count > GSTD_TRACE_RING_SIZE ? count - GSTD_TRACE_RING_SIZE : 0;
+  for (i = first; i < count; i++) {
+    gstd_trace_add_event (writer->builder, ring->shard.id,
+        &ring->events[i % GSTD_TRACE_RING_SIZE]);
+    writer->events++;
+  }
+}
+
+GstdReturnCode
+gstd_trace_stop (const gchar * filename, GError ** error)
+{
+  GstdTraceWriter writer;
+  JsonBuilder *builder;
+  JsonGenerator *generator;
+  JsonNode *root;
+  gboolean written;
+  gchar *path;
+
+  gstd_trace_init_debug ();
+
+  g_mutex_lock (&trace_lock);
+  path = g_strdup (filename ? filename : trace_filename);
+  g_mutex_unlock (&trace_lock);
+
+  if (!path) {
+    GST_ERROR ("No file to write the trace to");
+    return GSTD_MISSING_ARGUMENT;
+  }
+
+  if (!g_atomic_int_compare_and_exchange (&trace_recording, TRUE, FALSE)) {
+    GST_ERROR ("No trace is being recorded");
+    g_free (path);
+    return GSTD_MISSING_INITIALIZATION;
+  }
+
+  builder = json_builder_new ();
+  json_builder_begin_object (builder);
+
+  json_builder_set_member_name (builder, "displayTimeUnit");
+  json_builder_add_string_value (builder, "ms");
+
+  json_builder_set_member_name (builder, "traceEvents");
+  json_builder_begin_array (builder);
+
+  /* A thread that saw the trace as recording right before it stopped
+     may still be writing its last event, at worst that event comes
+     out garbled if its ring wrapped around */
+  writer.builder = builder;
+  writer.events = 0;
+  gstd_shards_foreach (&trace_rings, gstd_trace_add_ring, &writer);
+
+  json_builder_end_array (builder);
+  json_builder_end_object (builder);
+
+  root = json_builder_get_root (builder);
+  generator = json_generator_new ();
+  json_generator_set_root (generator, root);
+  written = json_generator_to_file (generator, path, error);
+
+  json_node_free (root);
+  g_object_unref (generator);
+  g_object_unref (builder);
+
+  if (!written) {
+    GST_ERROR ("Unable to write trace to \"%s\"", path);
+    g_free (path);
+    return GSTD_BAD_VALUE;
+  }
+
+  GST_INFO ("Wrote %u trace events to \"%s\"", writer.events, path);
+  g_free (path);
+
+  return GSTD_EOK;
+}
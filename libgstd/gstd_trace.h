@@ -0,0 +1,93 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_TRACE_H__
+#define __GSTD_TRACE_H__
+
+#include <gst/gst.h>
+
+#include "gstd_return_codes.h"
+
+G_BEGIN_DECLS
+
+/* Events kept per thread, older events are overwritten */
+#define GSTD_TRACE_RING_SIZE 2048
+
+/* Longest detail string kept per event, including the terminator */
+#define GSTD_TRACE_DETAIL_SIZE 48
+
+/**
+ * gstd_trace_start:
+ * @filename: (nullable): Where to write the timeline once stopped
+ *
+ * Discards any previous recording and starts recording events.
+ */
+void gstd_trace_start (const gchar * filename);
+
+/**
+ * gstd_trace_stop:
+ * @filename: (nullable): Where to write the recorded timeline, NULL to
+ * use the one given to gstd_trace_start()
+ * @error: Return location for a #GError
+ *
+ * Stops recording and writes the events still held by the per thread
+ * rings as a Chrome trace-event JSON file, which Perfetto and
+ * chrome://tracing can load.
+ *
+ * Returns: GSTD_EOK on success, GSTD_MISSING_INITIALIZATION if the
+ * trace was not started, GSTD_MISSING_ARGUMENT if no file was given or
+ * GSTD_BAD_VALUE if the file can't be written
+ */
+GstdReturnCode gstd_trace_stop (const gchar * filename, GError ** error);
+
+/**
+ * gstd_trace_now:
+ *
+ * Marks the beginning of a span. This is a single atomic read when
+ * not recording.
+ *
+ * Returns: The current monotonic time, or 0 if not recording
+ */
+gint64 gstd_trace_now (void);
+
+/**
+ * gstd_trace_span:
+ * @name: (transfer none): The span name, must outlive the process
+ * @detail: (nullable): Free form detail, truncated if too long
+ * @start: The value returned by gstd_trace_now() when the span began
+ *
+ * Records a span that ends now in the calling thread ring. Spans
+ * started while not recording are ignored.
+ */
+void gstd_trace_span (const gchar * name, const gchar * detail,
+    gint64 start);
+
+/**
+ * gstd_trace_instant:
+ * @name: (transfer none): The event name, must outlive the process
+ * @detail: (nullable): Free form detail, truncated if too long
+ *
+ * Records an instant event in the calling thread ring, if recording.
+ */
+void gstd_trace_instant (const gchar * name, const gchar * detail);
+
+G_END_DECLS
+
+#endif // __GSTD_TRACE_H__
@@ -0,0 +1,812 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstd_atomic.h"
+#include "gstd_tracer.h"
+
+/* Gstd Tracer debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_tracer_debug);
+#define GST_CAT_DEFAULT gstd_tracer_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Ghost pads nest one level per bin, this is plenty */
+#define GSTD_TRACER_MAX_PROXY_DEPTH 16
+
+/* Memory attributed to a pipeline. Tagged memories keep a reference,
+   since they may outlive the pipeline */
+typedef struct _GstdMemoryAccount GstdMemoryAccount;
+struct _GstdMemoryAccount
+{
+  gint refcount;
+  /* Taken only when a memory is first seen or freed, which pools keep
+     rare */
+  GMutex lock;
+  gsize current;
+  gsize peak;
+};
+
+/* Counters attached to every source pad that has seen dataflow. Only
+   the streaming thread that holds the pad's stream lock writes them,
+   readers load them atomically without locking */
+typedef struct _GstdTracerPad GstdTracerPad;
+struct _GstdTracerPad
+{
+  GstdPadStats stats;
+
+  /* Buffers of the push in progress, credited as dropped if the
+     peer refuses them */
+  guint pending;
+
+  /* Element the pad pushes to, valid while links matches the global
+     link generation */
+  GstElement *downstream;
+  gint links;
+
+  /* Account of the pipeline the pad belongs to, looked up once */
+  gboolean resolved;
+  GstdMemoryAccount *account;
+};
+
+/* A memory tagged as allocated by a pipeline */
+typedef struct _GstdTracerMemory GstdTracerMemory;
+struct _GstdTracerMemory
+{
+  GstdMemoryAccount *account;
+  gsize size;
+};
+
+/* Latency samples of an element, only present once the latency was
+   requested. Elements with several streaming threads write
+   concurrently, so these are protected by the lock */
+typedef struct _GstdTracerElement GstdTracerElement;
+struct _GstdTracerElement
+{
+  GMutex lock;
+  GstClockTime samples[GSTD_TRACER_LATENCY_WINDOW];
+  guint64 count;
+};
+
+/* A buffer that entered an element in the current thread, waiting for
+   the element to push it downstream */
+typedef struct _GstdTracerEntry GstdTracerEntry;
+struct _GstdTracerEntry
+{
+  GstElement *element;
+  GstClockTime ts;
+  gboolean done;
+};
+
+struct _GstdTracer
+{
+  GstTracer parent;
+};
+
+struct _GstdTracerClass
+{
+  GstTracerClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdTracer, gstd_tracer, GST_TYPE_TRACER);
+
+static GQuark gstd_tracer_pad_quark;
+static GQuark gstd_tracer_element_quark;
+static GQuark gstd_tracer_memory_quark;
+static GQuark gstd_tracer_account_quark;
+
+/* Serializes the creation of the per element latency samples */
+static GMutex gstd_tracer_element_lock;
+
+/* Stack of GstdTracerEntry, one per nested push in the thread */
+static GPrivate gstd_tracer_entries =
+G_PRIVATE_INIT ((GDestroyNotify) g_array_unref);
+
+/* Keep the tracer alive for the lifetime of the process */
+static GstTracer *gstd_tracer_instance;
+
+/* Amount of gstd_tracer_acquire() without a matching release. GStreamer
+   can't unregister hooks, so they bail out early while there are none */
+static gint gstd_tracer_users;
+
+/* Amount of elements whose latency is measured. Pushes are only
+   tracked through the thread's stack while there is any */
+static gint gstd_tracer_latency_watchers;
+
+/* Bumped on every link change in the process, invalidating the
+   downstream element cached by the pads */
+static gint gstd_tracer_links = 1;
+
+static gboolean gstd_tracer_active (void);
+static GstdTracerPad *gstd_tracer_pad_get (GstPad * pad);
+static void gstd_tracer_pad_free (GstdTracerPad * tpad);
+static GstdMemoryAccount *gstd_tracer_account_ref (GstdMemoryAccount *
+    account);
+static void gstd_tracer_account_unref (GstdMemoryAccount * account);
+static void gstd_tracer_memory_free (GstdTracerMemory * tmem);
+static void gstd_tracer_tag_buffer (GstPad * pad, GstdTracerPad * tpad,
+    GstBuffer * buffer);
+static GstdTracerElement *gstd_tracer_element_get (GstElement * element,
+    gboolean create);
+static void gstd_tracer_element_free (GstdTracerElement * telement);
+static GArray *gstd_tracer_get_entries (void);
+static GstElement *gstd_tracer_downstream (GstPad * pad);
+static GstElement *gstd_tracer_pad_downstream (GstPad * pad,
+    GstdTracerPad * tpad);
+static GstdTracerPad *gstd_tracer_account (GstPad * pad, GstClockTime ts,
+    guint buffers, gsize bytes);
+static gboolean gstd_tracer_measuring (void);
+static void gstd_tracer_enter (GstPad * pad, GstdTracerPad * tpad,
+    GstClockTime ts);
+static void gstd_tracer_leave (void);
+static void gstd_tracer_pad_link_post (GObject * self, GstClockTime ts,
+    GstPad * srcpad, GstPad * sinkpad, GstPadLinkReturn res);
+static void gstd_tracer_pad_unlink_post (GObject * self, GstClockTime ts,
+    GstPad * srcpad, GstPad * sinkpad, gboolean res);
+static void gstd_tracer_pad_push_pre (GObject * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer);
+static void gstd_tracer_pad_push_list_pre (GObject * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list);
+static void gstd_tracer_pad_push_post (GObject * self, GstClockTime ts,
+    GstPad * pad, GstFlowReturn res);
+static void gstd_tracer_pad_pull_range_post (GObject * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer, GstFlowReturn res);
+
+static void
+gstd_tracer_class_init (GstdTracerClass * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_tracer_debug, "gstdtracer", debug_color,
+      "Gstd Tracer category");
+
+  gstd_tracer_pad_quark = g_quark_from_static_string ("gstd-tracer-pad");
+  gstd_tracer_element_quark =
+      g_quark_from_static_string ("gstd-tracer-element");
+  gstd_tracer_memory_quark = g_quark_from_static_string ("gstd-tracer-memory");
+  gstd_tracer_account_quark =
+      g_quark_from_static_string ("gstd-tracer-account");
+}
+
+static void
+gstd_tracer_init (GstdTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  GST_INFO_OBJECT (self, "Initializing gstd tracer");
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (gstd_tracer_pad_push_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (gstd_tracer_pad_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (gstd_tracer_pad_push_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (gstd_tracer_pad_push_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (gstd_tracer_pad_pull_range_post));
+  gst_tracing_register_hook (tracer, "pad-link-post",
+      G_CALLBACK (gstd_tracer_pad_link_post));
+  gst_tracing_register_hook (tracer, "pad-unlink-post",
+      G_CALLBACK (gstd_tracer_pad_unlink_post));
+}
+
+static gboolean
+gstd_tracer_active (void)
+{
+  return g_atomic_int_get (&gstd_tracer_users) > 0;
+}
+
+static gboolean
+gstd_tracer_measuring (void)
+{
+  return g_atomic_int_get (&gstd_tracer_latency_watchers) > 0;
+}
+
+static GstdTracerPad *
+gstd_tracer_pad_get (GstPad * pad)
+{
+  GstdTracerPad *tpad;
+
+  tpad = g_object_get_qdata (G_OBJECT (pad), gstd_tracer_pad_quark);
+  if (!tpad) {
+    tpad = g_new0 (GstdTracerPad, 1);
+    tpad->stats.first = GST_CLOCK_TIME_NONE;
+    g_object_set_qdata_full (G_OBJECT (pad), gstd_tracer_pad_quark, tpad,
+        (GDestroyNotify) gstd_tracer_pad_free);
+  }
+
+  return tpad;
+}
+
+static void
+gstd_tracer_pad_free (GstdTracerPad * tpad)
+{
+  if (tpad->account) {
+    gstd_tracer_account_unref (tpad->account);
+  }
+  g_free (tpad);
+}
+
+static GstdMemoryAccount *
+gstd_tracer_account_ref (GstdMemoryAccount * account)
+{
+  g_atomic_int_inc (&account->refcount);
+  return account;
+}
+
+static void
+gstd_tracer_account_unref (GstdMemoryAccount * account)
+{
+  if (g_atomic_int_dec_and_test (&account->refcount)) {
+    g_mutex_clear (&account->lock);
+    g_free (account);
+  }
+}
+
+static void
+gstd_tracer_memory_free (GstdTracerMemory * tmem)
+{
+  g_mutex_lock (&tmem->account->lock);
+  tmem->account->current -= tmem->size;
+  g_mutex_unlock (&tmem->account->lock);
+  gstd_tracer_account_unref (tmem->account);
+  g_free (tmem);
+}
+
+static void
+gstd_tracer_tag_buffer (GstPad * pad, GstdTracerPad * tpad,
+    GstBuffer * buffer)
+{
+  GstdTracerMemory *tmem;
+  GstObject *top;
+  GstObject *parent;
+  GstMemory *memory;
+  guint n;
+  guint i;
+
+  if (!tpad->resolved) {
+    top = gst_object_ref (GST_OBJECT (pad));
+    while ((parent = gst_object_get_parent (top))) {
+      gst_object_unref (top);
+      top = parent;
+    }
+
+    tpad->account = g_object_get_qdata (G_OBJECT (top),
+        gstd_tracer_account_quark);
+    if (tpad->account) {
+      gstd_tracer_account_ref (tpad->account);
+    }
+    gst_object_unref (top);
+
+    /* Pads are never looked up again, even if they end up in a
+       different pipeline later */
+    tpad->resolved = TRUE;
+  }
+
+  if (!tpad->account) {
+    return;
+  }
+
+  /* Memory is attributed to the first pipeline that pushes it, which
+     is the one that allocated it or owns the pool it comes from */
+  n = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n; i++) {
+    memory = gst_buffer_peek_memory (buffer, i);
+    while (memory->parent) {
+      memory = memory->parent;
+    }
+
+    if (gst_mini_object_get_qdata (GST_MINI_OBJECT (memory),
+            gstd_tracer_memory_quark)) {
+      continue;
+    }
+
+    tmem = g_new (GstdTracerMemory, 1);
+    tmem->account = gstd_tracer_account_ref (tpad->account);
+    tmem->size = memory->maxsize;
+    gst_mini_object_set_qdata (GST_MINI_OBJECT (memory),
+        gstd_tracer_memory_quark, tmem,
+        (GDestroyNotify) gstd_tracer_memory_free);
+
+    g_mutex_lock (&tpad->account->lock);
+    tpad->account->current += tmem->size;
+    tpad->account->peak = MAX (tpad->account->peak, tpad->account->current);
+    g_mutex_unlock (&tpad->account->lock);
+  }
+}
+
+static void
+gstd_tracer_element_free (GstdTracerElement * telement)
+{
+  g_atomic_int_add (&gstd_tracer_latency_watchers, -1);
+  g_mutex_clear (&telement->lock);
+  g_free (telement);
+}
+
+static GstdTracerElement *
+gstd_tracer_element_get (GstElement * element, gboolean create)
+{
+  GstdTracerElement *telement;
+
+  telement = g_object_get_qdata (G_OBJECT (element),
+      gstd_tracer_element_quark);
+  if (telement || !create) {
+    return telement;
+  }
+
+  g_mutex_lock (&gstd_tracer_element_lock);
+  telement = g_object_get_qdata (G_OBJECT (element),
+      gstd_tracer_element_quark);
+  if (!telement) {
+    telement = g_new0 (GstdTracerElement, 1);
+    g_mutex_init (&telement->lock);
+    g_atomic_int_inc (&gstd_tracer_latency_watchers);
+    g_object_set_qdata_full (G_OBJECT (element), gstd_tracer_element_quark,
+        telement, (GDestroyNotify) gstd_tracer_element_free);
+  }
+  g_mutex_unlock (&gstd_tracer_element_lock);
+
+  return telement;
+}
+
+static GArray *
+gstd_tracer_get_entries (void)
+{
+  GArray *entries;
+
+  entries = g_private_get (&gstd_tracer_entries);
+  if (!entries) {
+    entries = g_array_new (FALSE, FALSE, sizeof (GstdTracerEntry));
+    g_private_set (&gstd_tracer_entries, entries);
+  }
+
+  return entries;
+}
+
+static GstElement *
+gstd_tracer_downstream (GstPad * pad)
+{
+  GstPad *peer;
+  GstPad *internal;
+  GstElement *element = NULL;
+  guint depth;
+
+  peer = gst_pad_get_peer (pad);
+
+  /* Look through ghost pads for the element that will actually
+     process the data */
+  for (depth = 0; peer && GST_IS_PROXY_PAD (peer); depth++) {
+    if (depth == GSTD_TRACER_MAX_PROXY_DEPTH) {
+      gst_object_unref (peer);
+      return NULL;
+    }
+
+    internal = GST_PAD (gst_proxy_pad_get_internal (GST_PROXY_PAD (peer)));
+    gst_object_unref (peer);
+    if (!internal) {
+      return NULL;
+    }
+
+    peer = gst_pad_get_peer (internal);
+    gst_object_unref (internal);
+  }
+
+  if (peer) {
+    element = gst_pad_get_parent_element (peer);
+    gst_object_unref (peer);
+  }
+
+  /* The element outlives the push since it is linked, only the
+     pointer is kept */
+  if (element) {
+    gst_object_unref (element);
+  }
+
+  return element;
+}
+
+/* Resolving the peer takes a few locks and refs, so it is only done
+   again after something was linked or unlinked */
+static GstElement *
+gstd_tracer_pad_downstream (GstPad * pad, GstdTracerPad * tpad)
+{
+  gint links;
+
+  links = g_atomic_int_get (&gstd_tracer_links);
+  if (tpad->links != links) {
+    tpad->downstream = gstd_tracer_downstream (pad);
+    tpad->links = links;
+  }
+
+  return tpad->downstream;
+}
+
+static GstdTracerPad *
+gstd_tracer_account (GstPad * pad, GstClockTime ts, guint buffers,
+    gsize bytes)
+{
+  GstdTracerPad *tpad;
+
+  tpad = gstd_tracer_pad_get (pad);
+
+  if (!GST_CLOCK_TIME_IS_VALID (gstd_atomic_uint64_get (&tpad->stats.first))) {
+    gstd_atomic_uint64_set (&tpad->stats.first, ts);
+  }
+  gstd_atomic_uint64_add (&tpad->stats.buffers, buffers);
+  gstd_atomic_uint64_add (&tpad->stats.bytes, bytes);
+  tpad->pending = buffers;
+
+  return tpad;
+}
+
+static void
+gstd_tracer_enter (GstPad * pad, GstdTracerPad * tpad, GstClockTime ts)
+{
+  GArray *entries;
+  GstElement *element;
+  GstdTracerEntry *entry;
+  GstdTracerEntry next;
+  GstdTracerElement *telement;
+  guint i;
+
+  entries = gstd_tracer_get_entries ();
+  element = GST_PAD_PARENT (pad);
+
+  /* The element latency is the time between the buffer entering it
+     and its first push downstream, in the same thread */
+  for (i = entries->len; i > 0; i--) {
+    entry = &g_array_index (entries, GstdTracerEntry, i - 1);
+    if (entry->element != element) {
+      continue;
+    }
+
+    /* Only elements whose latency was requested are sampled */
+    if (!entry->done && element) {
+      telement = gstd_tracer_element_get (element, FALSE);
+      if (telement) {
+        g_mutex_lock (&telement->lock);
+        telement->samples[telement->count % GSTD_TRACER_LATENCY_WINDOW] =
+            GST_CLOCK_DIFF (entry->ts, ts);
+        telement->count++;
+        g_mutex_unlock (&telement->lock);
+      }
+      entry->done = TRUE;
+    }
+    break;
+  }
+
+  /* Always push an entry so the post hook stays balanced */
+  next.element = gstd_tracer_pad_downstream (pad, tpad);
+  next.ts = ts;
+  next.done = FALSE;
+  g_array_append_val (entries, next);
+}
+
+static void
+gstd_tracer_leave (void)
+{
+  GArray *entries;
+
+  entries = gstd_tracer_get_entries ();
+  if (entries->len > 0) {
+    g_array_set_size (entries, entries->len - 1);
+  }
+}
+
+static void
+gstd_tracer_pad_push_pre (GObject * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  GstdTracerPad *tpad;
+
+  if (!gstd_tracer_active ()) {
+    return;
+  }
+
+  /* Ghost and proxy pads just forward to the real pads, which are
+     accounted by their own hooks */
+  if (GST_IS_PROXY_PAD (pad)) {
+    return;
+  }
+
+  tpad = gstd_tracer_account (pad, ts, 1, gst_buffer_get_size (buffer));
+  gstd_tracer_tag_buffer (pad, tpad, buffer);
+  if (gstd_tracer_measuring ()) {
+    gstd_tracer_enter (pad, tpad, ts);
+  }
+}
+
+static void
+gstd_tracer_pad_push_list_pre (GObject * self, GstClockTime ts, GstPad * pad,
+    GstBufferList * list)
+{
+  GstdTracerPad *tpad;
+  guint length;
+  guint i;
+  gsize bytes = 0;
+
+  if (!gstd_tracer_active ()) {
+    return;
+  }
+
+  if (GST_IS_PROXY_PAD (pad)) {
+    return;
+  }
+
+  length = gst_buffer_list_length (list);
+  for (i = 0; i < length; i++) {
+    bytes += gst_buffer_get_size (gst_buffer_list_get (list, i));
+  }
+
+  tpad = gstd_tracer_account (pad, ts, length, bytes);
+  for (i = 0; i < length; i++) {
+    gstd_tracer_tag_buffer (pad, tpad, gst_buffer_list_get (list, i));
+  }
+  if (gstd_tracer_measuring ()) {
+    gstd_tracer_enter (pad, tpad, ts);
+  }
+}
+
+static void
+gstd_tracer_pad_push_post (GObject * self, GstClockTime ts, GstPad * pad,
+    GstFlowReturn res)
+{
+  GstdTracerPad *tpad;
+
+  if (!gstd_tracer_active ()) {
+    return;
+  }
+
+  if (GST_IS_PROXY_PAD (pad)) {
+    return;
+  }
+
+  /* A push in flight when tracing or measuring is turned on or off
+     leaves the thread's stack off by one, which at most costs a bogus
+     latency sample */
+  if (gstd_tracer_measuring ()) {
+    gstd_tracer_leave ();
+  }
+
+  tpad = g_object_get_qdata (G_OBJECT (pad), gstd_tracer_pad_quark);
+  if (!tpad) {
+    return;
+  }
+
+  /* Flushing is the pipeline shutting down or seeking, not the peer
+     refusing data */
+  if (GST_FLOW_OK != res && GST_FLOW_FLUSHING != res) {
+    gstd_atomic_uint64_add (&tpad->stats.dropped, tpad->pending);
+  }
+  tpad->pending = 0;
+}
+
+static void
+gstd_tracer_pad_pull_range_post (GObject * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer, GstFlowReturn res)
+{
+  GstdTracerPad *tpad;
+  GstPad *peer;
+
+  if (!gstd_tracer_active ()) {
+    return;
+  }
+
+  if (GST_FLOW_OK != res || !buffer) {
+    return;
+  }
+
+  /* The sink pad pulls, but the data is produced by its peer. Credit
+     the source pad so both scheduling modes report the same way */
+  peer = gst_pad_get_peer (pad);
+  if (!peer) {
+    return;
+  }
+
+  if (!GST_IS_PROXY_PAD (peer)) {
+    tpad = gstd_tracer_account (peer, ts, 1, gst_buffer_get_size (buffer));
+    gstd_tracer_tag_buffer (peer, tpad, buffer);
+  }
+  gst_object_unref (peer);
+}
+
+static void
+gstd_tracer_pad_link_post (GObject * self, GstClockTime ts,
+    GstPad * srcpad, GstPad * sinkpad, GstPadLinkReturn res)
+{
+  /* Not gated on the users, cached peers must not survive a pause in
+     the tracing */
+  if (GST_PAD_LINK_OK == res) {
+    g_atomic_int_inc (&gstd_tracer_links);
+  }
+}
+
+static void
+gstd_tracer_pad_unlink_post (GObject * self, GstClockTime ts,
+    GstPad * srcpad, GstPad * sinkpad, gboolean res)
+{
+  if (res) {
+    g_atomic_int_inc (&gstd_tracer_links);
+  }
+}
+
+static gint
+gstd_tracer_compare_time (gconstpointer a, gconstpointer b)
+{
+  GstClockTime ta = *(const GstClockTime *) a;
+  GstClockTime tb = *(const GstClockTime *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+void
+gstd_tracer_acquire (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    /* Instantiating hooks the tracer up, registering it makes it show
+       up along with the rest of the tracers */
+    gstd_tracer_instance = g_object_new (GSTD_TYPE_TRACER, NULL);
+    gst_object_ref_sink (gstd_tracer_instance);
+    if (!gst_tracer_register (NULL, GSTD_TRACER_NAME, GSTD_TYPE_TRACER)) {
+      GST_WARNING_OBJECT (gstd_tracer_instance,
+          "Unable to register the gstd tracer");
+    }
+    g_once_init_leave (&init, 1);
+  }
+
+  g_atomic_int_inc (&gstd_tracer_users);
+}
+
+void
+gstd_tracer_release (void)
+{
+  g_return_if_fail (gstd_tracer_active ());
+
+  if (g_atomic_int_dec_and_test (&gstd_tracer_users)) {
+    GST_DEBUG_OBJECT (gstd_tracer_instance, "No users left, tracing stopped");
+  }
+}
+
+gboolean
+gstd_tracer_get_pad_stats (GstPad * pad, GstdPadStats * stats)
+{
+  GstdTracerPad *tpad;
+
+  g_return_val_if_fail (GST_IS_PAD (pad), FALSE);
+  g_return_val_if_fail (stats, FALSE);
+
+  tpad = g_object_get_qdata (G_OBJECT (pad), gstd_tracer_pad_quark);
+  if (!tpad) {
+    memset (stats, 0, sizeof (GstdPadStats));
+    stats->first = GST_CLOCK_TIME_NONE;
+    return FALSE;
+  }
+
+  stats->buffers = gstd_atomic_uint64_get (&tpad->stats.buffers);
+  stats->bytes = gstd_atomic_uint64_get (&tpad->stats.bytes);
+  stats->dropped = gstd_atomic_uint64_get (&tpad->stats.dropped);
+  stats->first = gstd_atomic_uint64_get (&tpad->stats.first);
+
+  return TRUE;
+}
+
+void
+gstd_tracer_watch_latency (GstElement * element)
+{
+  g_return_if_fail (GST_IS_ELEMENT (element));
+
+  gstd_tracer_element_get (element, TRUE);
+}
+
+gboolean
+gstd_tracer_get_latency (GstElement * element, GstdLatencyStats * stats)
+{
+  GstdTracerElement *telement;
+  GstClockTime samples[GSTD_TRACER_LATENCY_WINDOW];
+  GstClockTime sum = 0;
+  guint size;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (element), FALSE);
+  g_return_val_if_fail (stats, FALSE);
+
+  memset (stats, 0, sizeof (GstdLatencyStats));
+
+  telement = gstd_tracer_element_get (element, FALSE);
+  if (!telement) {
+    return FALSE;
+  }
+
+  /* Copy the window out so sorting doesn't hold the streaming
+     threads back */
+  g_mutex_lock (&telement->lock);
+  stats->count = telement->count;
+  size = MIN (telement->count, GSTD_TRACER_LATENCY_WINDOW);
+  memcpy (samples, telement->samples, size * sizeof (GstClockTime));
+  g_mutex_unlock (&telement->lock);
+
+  if (0 == size) {
+    return FALSE;
+  }
+
+  qsort (samples, size, sizeof (GstClockTime), gstd_tracer_compare_time);
+
+  for (i = 0; i < size; i++) {
+    sum += samples[i];
+  }
+
+  stats->samples = size;
+  stats->min = samples[0];
+  stats->max = samples[size - 1];
+  stats->avg = sum / size;
+  /* Nearest rank */
+  stats->p99 = samples[(size * 99 + 99) / 100 - 1];
+
+  return TRUE;
+}
+
+void
+gstd_tracer_track_memory (GstElement * pipeline)
+{
+  GstdMemoryAccount *account;
+
+  g_return_if_fail (GST_IS_ELEMENT (pipeline));
+
+  account = g_new0 (GstdMemoryAccount, 1);
+  account->refcount = 1;
+  g_mutex_init (&account->lock);
+  g_object_set_qdata_full (G_OBJECT (pipeline), gstd_tracer_account_quark,
+      account, (GDestroyNotify) gstd_tracer_account_unref);
+}
+
+gboolean
+gstd_tracer_get_memory (GstElement * pipeline, gsize * current, gsize * peak)
+{
+  GstdMemoryAccount *account;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (pipeline), FALSE);
+  g_return_val_if_fail (current, FALSE);
+  g_return_val_if_fail (peak, FALSE);
+
+  account = g_object_get_qdata (G_OBJECT (pipeline),
+      gstd_tracer_account_quark);
+  if (!account) {
+    *current = *peak = 0;
+    return FALSE;
+  }
+
+  g_mutex_lock (&account->lock);
+  *current = account->current;
+  *peak = account->peak;
+  g_mutex_unlock (&account->lock);
+
+  return TRUE;
+}
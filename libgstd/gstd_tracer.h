@@ -0,0 +1,150 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_TRACER_H__
+#define __GSTD_TRACER_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_TRACER \
+  (gstd_tracer_get_type())
+#define GSTD_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_TRACER,GstdTracer))
+#define GSTD_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_TRACER,GstdTracerClass))
+#define GSTD_IS_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_TRACER))
+#define GSTD_IS_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_TRACER))
+#define GSTD_TRACER_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_TRACER, GstdTracerClass))
+typedef struct _GstdTracer GstdTracer;
+typedef struct _GstdTracerClass GstdTracerClass;
+typedef struct _GstdPadStats GstdPadStats;
+typedef struct _GstdLatencyStats GstdLatencyStats;
+
+/* Name the tracer is registered with */
+#define GSTD_TRACER_NAME "gstdstats"
+
+/* Amount of most recent samples the latency is computed from */
+#define GSTD_TRACER_LATENCY_WINDOW 1024
+
+/* Dataflow counters of a source pad */
+struct _GstdPadStats
+{
+  /* Buffers pushed or pulled through the pad */
+  guint64 buffers;
+  /* Bytes pushed or pulled through the pad */
+  guint64 bytes;
+  /* Buffers the peer did not accept */
+  guint64 dropped;
+  /* Time of the first buffer, as returned by gst_util_get_timestamp() */
+  GstClockTime first;
+};
+
+/* Processing latency of an element, in nanoseconds */
+struct _GstdLatencyStats
+{
+  /* Buffers measured since the element was created */
+  guint64 count;
+  /* Buffers in the rolling window the rest of the fields describe */
+  guint samples;
+  GstClockTime min;
+  GstClockTime avg;
+  GstClockTime p99;
+  GstClockTime max;
+};
+
+GType gstd_tracer_get_type (void);
+
+/**
+ * Registers the gstd tracer, if not done already, and adds a user of
+ * it. The hooks are installed for the lifetime of the process, but
+ * they only trace the dataflow while there is at least one user.
+ **/
+void gstd_tracer_acquire (void);
+
+/**
+ * Removes a user added with gstd_tracer_acquire(). The dataflow stops
+ * being traced once the last user is gone.
+ **/
+void gstd_tracer_release (void);
+
+/**
+ * Takes a snapshot of the dataflow counters of a source pad
+ *
+ * \param pad The source pad to query
+ * \param stats Where to store the counters
+ *
+ * \return TRUE if a buffer ever went through the pad, FALSE otherwise
+ **/
+gboolean gstd_tracer_get_pad_stats (GstPad * pad, GstdPadStats * stats);
+
+/**
+ * Starts measuring the processing latency of an element, if not done
+ * already. The measurement lasts for the lifetime of the element.
+ *
+ * \param element The element to measure
+ **/
+void gstd_tracer_watch_latency (GstElement * element);
+
+/**
+ * Computes the processing latency of an element over the most recent
+ * buffers since gstd_tracer_watch_latency() was called. The latency
+ * is the time from a buffer entering the element to the element's
+ * first push downstream in the same thread, so sources, sinks and
+ * elements that hand buffers to another thread (such as queues) are
+ * not measured.
+ *
+ * \param element The element to query
+ * \param stats Where to store the latency
+ *
+ * \return TRUE if the element has latency samples, FALSE otherwise
+ **/
+gboolean gstd_tracer_get_latency (GstElement * element,
+    GstdLatencyStats * stats);
+
+/**
+ * Starts attributing memory to a pipeline. Memory is attributed to the
+ * first tracked pipeline that pushes it, until it is freed. Memory is
+ * only tagged while the tracer has users, see gstd_tracer_acquire().
+ *
+ * \param pipeline The top level element to attribute memory to
+ **/
+void gstd_tracer_track_memory (GstElement * pipeline);
+
+/**
+ * Reads the memory attributed to a pipeline
+ *
+ * \param pipeline A pipeline passed to gstd_tracer_track_memory()
+ * \param current Where to store the bytes currently allocated
+ * \param peak Where to store the most bytes ever allocated at once
+ *
+ * \return TRUE if the pipeline is tracked, FALSE otherwise
+ **/
+gboolean gstd_tracer_get_memory (GstElement * pipeline, gsize * current,
+    gsize * peak);
+
+G_END_DECLS
+#endif // __GSTD_TRACER_H__
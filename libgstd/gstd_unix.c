@@ -186,6 +186,12 @@ gstd_unix_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
           "Number of ports to use starting at base-port (default 1)",
         "unix-num-ports"}
     ,
+    {"unix-request-timeout", 0, 0, G_OPTION_ARG_INT,
+          &GSTD_SOCKET (base)->request_timeout,
+          "Max time in milliseconds a request may block waiting for bus "
+          "messages or signals. -1 means no limit (default -1)",
+        "unix-request-timeout"}
+    ,
     {NULL}
   };
   GST_DEBUG_OBJECT (self, "UNIX init group callback ");
@@ -29,7 +29,9 @@
 
 #include "gstd_http.h"
 #include "gstd_ipc.h"
+#include "gstd_journal.h"
 #include "gstd_log.h"
+#include "gstd_shm_publisher.h"
 #include "gstd_tcp.h"
 #include "gstd_unix.h"
 
@@ -52,12 +54,19 @@ enum _SupportedIpcs
 static GType gstd_supported_ipc_to_ipc (const SupportedIpcs code);
 static void gstd_init (int argc, char *argv[]);
 static void gstd_set_ipc (GstD * gstd);
+static GOptionGroup *gstd_get_metrics_option_group (GstD * gstd);
+static GOptionGroup *gstd_get_journal_option_group (GstD * gstd);
 
 struct _GstD
 {
   GstdSession *session;
   GstdIpc **ipc_array;
   guint num_ipcs;
+  gchar *shm_path;
+  gint shm_interval;
+  GstdShmPublisher *shm_publisher;
+  gchar *journal_path;
+  gboolean journal_open;
 };
 
 static GType
@@ -117,6 +126,50 @@ gstd_set_ipc (GstD * gstd)
   gstd->ipc_array = ipc_array;
 }
 
+static GOptionGroup *
+gstd_get_metrics_option_group (GstD * gstd)
+{
+  GOptionGroup *group = NULL;
+  GOptionEntry metrics_args[] = {
+    {"metrics-shm-path", 0, 0, G_OPTION_ARG_FILENAME, &gstd->shm_path,
+          "Publish metrics to a memory mapped file, i.e.: "
+          "/dev/shm/gstd-metrics (default disabled)",
+        "metrics-shm-path"}
+    ,
+    {"metrics-shm-interval", 0, 0, G_OPTION_ARG_INT, &gstd->shm_interval,
+          "Milliseconds between updates of the metrics file (default 1000)",
+        "metrics-shm-interval"}
+    ,
+    {NULL}
+  };
+
+  group = g_option_group_new ("gstd-metrics", ("Metrics Options"),
+      ("Show Metrics Options"), NULL, NULL);
+  g_option_group_add_entries (group, metrics_args);
+
+  return group;
+}
+
+static GOptionGroup *
+gstd_get_journal_option_group (GstD * gstd)
+{
+  GOptionGroup *group = NULL;
+  GOptionEntry journal_args[] = {
+    {"journal-path", 0, 0, G_OPTION_ARG_FILENAME, &gstd->journal_path,
+          "Record every received command to a file that gstd-replay can "
+          "play back (default disabled)",
+        "journal-path"}
+    ,
+    {NULL}
+  };
+
+  group = g_option_group_new ("gstd-journal", ("Journal Options"),
+      ("Show Journal Options"), NULL, NULL);
+  g_option_group_add_entries (group, journal_args);
+
+  return group;
+}
+
 void
 gstd_context_add_group (GstD * gstd, GOptionContext * context)
 {
@@ -139,6 +192,9 @@ gstd_context_add_group (GstD * gstd, GOptionContext * context)
   }
 
   g_free (ipc_group_array);
+
+  g_option_context_add_group (context, gstd_get_metrics_option_group (gstd));
+  g_option_context_add_group (context, gstd_get_journal_option_group (gstd));
 }
 
 GstdReturnCode
@@ -156,6 +212,7 @@ gstd_new (GstD ** out, int argc, char *argv[])
   gstd->session = session;
   gstd->num_ipcs = 0;
   gstd->ipc_array = NULL;
+  gstd->shm_interval = GSTD_SHM_PUBLISHER_DEFAULT_INTERVAL;
 
   gstd_set_ipc (gstd);
 
@@ -179,6 +236,13 @@ gstd_start (GstD * gstd)
   g_return_val_if_fail (NULL != gstd->ipc_array, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (NULL != gstd->session, GSTD_NULL_ARGUMENT);
 
+  /* Validate the options before anything is started, so there is
+     nothing to tear down */
+  if (gstd->shm_path && gstd->shm_interval <= 0) {
+    g_printerr ("Invalid metrics interval : (%d)\n", gstd->shm_interval);
+    return FALSE;
+  }
+
   /* Verify if at least one IPC mechanism was selected */
   for (ipc_idx = 0; ipc_idx < gstd->num_ipcs; ipc_idx++) {
     g_object_get (G_OBJECT (gstd->ipc_array[ipc_idx]), "enabled",
@@ -194,6 +258,18 @@ gstd_start (GstD * gstd)
     g_object_set (G_OBJECT (gstd->ipc_array[0]), "enabled", TRUE, NULL);
   }
 
+  /* Journal before serving so the first commands are not missed */
+  if (gstd->journal_path) {
+    GError *error = NULL;
+
+    gstd->journal_open = gstd_journal_open (gstd->journal_path, &error);
+    if (!gstd->journal_open) {
+      g_printerr ("Couldn't open journal : (%s)\n", error->message);
+      g_error_free (error);
+      ret = FALSE;
+    }
+  }
+
   /* Run start for each IPC (each start method checks for the enabled flag) */
   for (ipc_idx = 0; ipc_idx < gstd->num_ipcs; ipc_idx++) {
     code = gstd_ipc_start (gstd->ipc_array[ipc_idx], gstd->session);
@@ -204,6 +280,15 @@ gstd_start (GstD * gstd)
     }
   }
 
+  if (gstd->shm_path) {
+    gstd->shm_publisher = gstd_shm_publisher_new (gstd->session,
+        gstd->shm_path, gstd->shm_interval, NULL);
+    if (!gstd->shm_publisher) {
+      g_printerr ("Couldn't publish metrics to : (%s)\n", gstd->shm_path);
+      ret = FALSE;
+    }
+  }
+
   return ret;
 }
 
@@ -214,6 +299,11 @@ gstd_stop (GstD * gstd)
   g_return_if_fail (NULL != gstd->ipc_array);
   g_return_if_fail (NULL != gstd->session);
 
+  if (gstd->shm_publisher) {
+    gstd_shm_publisher_free (gstd->shm_publisher);
+    gstd->shm_publisher = NULL;
+  }
+
   /* Run stop for each IPC */
   for (gint ipc_idx = 0; ipc_idx < gstd->num_ipcs; ipc_idx++) {
     if (NULL != gstd->ipc_array[ipc_idx]) {
@@ -221,6 +311,11 @@ gstd_stop (GstD * gstd)
       g_clear_object (&gstd->ipc_array[ipc_idx]);
     }
   }
+
+  if (gstd->journal_open) {
+    gstd_journal_close ();
+    gstd->journal_open = FALSE;
+  }
 }
 
 void
@@ -229,6 +324,8 @@ gstd_free (GstD * gstd)
   g_return_if_fail (NULL != gstd);
   gstd_stop (gstd);
   g_free (gstd->ipc_array);
+  g_free (gstd->shm_path);
+  g_free (gstd->journal_path);
   g_object_unref (gstd->session);
   g_free (gstd);
 }
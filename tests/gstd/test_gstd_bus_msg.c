@@ -0,0 +1,128 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_bus_msg.h"
+#include "gstd_pipeline_bus.h"
+
+static GstMessage *
+level_message (void)
+{
+  GstStructure *st;
+  GValue array = G_VALUE_INIT;
+  GValue value = G_VALUE_INIT;
+
+  g_value_init (&array, GST_TYPE_ARRAY);
+  g_value_init (&value, G_TYPE_DOUBLE);
+
+  g_value_set_double (&value, 1.0);
+  gst_value_array_append_value (&array, &value);
+  g_value_set_double (&value, 2.0);
+  gst_value_array_append_value (&array, &value);
+
+  st = gst_structure_new_empty ("level");
+  gst_structure_take_value (st, "peak", &array);
+  g_value_unset (&value);
+
+  return gst_message_new_element (NULL, st);
+}
+
+GST_START_TEST (test_packed_arrays)
+{
+  GstdBusMsg *msg;
+  gchar *outstring = NULL;
+
+  msg = gstd_bus_msg_factory_make_full (level_message (),
+      GSTD_BUS_MSG_FLAG_PACKED_ARRAYS);
+  fail_if (NULL == msg);
+
+  gstd_object_to_string (GSTD_OBJECT (msg), &outstring);
+
+  /* 1.0 and 2.0 as little endian doubles */
+  fail_if (NULL == strstr (outstring, "f64le"));
+  fail_if (NULL == strstr (outstring, "AAAAAAAA8D8AAAAAAAAAQA=="));
+
+  g_free (outstring);
+  g_object_unref (msg);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_decimation)
+{
+  GstdPipelineBus *gstdbus;
+  GstMessage *level;
+  GstMessage *eos;
+  gchar *decimation;
+
+  gstdbus = gstd_pipeline_bus_new (gst_bus_new ());
+  g_object_set (gstdbus, "decimation", "level=2", NULL);
+
+  /* A decimation with an invalid entry is rejected as a whole */
+  fail_if (gstd_pipeline_bus_check_decimation ("level=3,bogus"));
+  fail_if (gstd_pipeline_bus_check_decimation ("level=0"));
+  fail_unless (gstd_pipeline_bus_check_decimation ("level=3, rms=4,"));
+  g_object_set (gstdbus, "decimation", "level=3,bogus", NULL);
+  g_object_get (gstdbus, "decimation", &decimation, NULL);
+  fail_unless_equals_string (decimation, "level=2");
+  g_free (decimation);
+
+  level = level_message ();
+  eos = gst_message_new_eos (NULL);
+
+  /* One out of every two level messages goes through */
+  fail_if (gstd_pipeline_bus_decimate (gstdbus, level));
+  fail_unless (gstd_pipeline_bus_decimate (gstdbus, level));
+  fail_if (gstd_pipeline_bus_decimate (gstdbus, level));
+  fail_unless (gstd_pipeline_bus_decimate (gstdbus, level));
+
+  /* Other messages are never decimated */
+  fail_if (gstd_pipeline_bus_decimate (gstdbus, eos));
+
+  g_object_set (gstdbus, "decimation", NULL, NULL);
+  fail_if (gstd_pipeline_bus_decimate (gstdbus, level));
+  fail_if (gstd_pipeline_bus_decimate (gstdbus, level));
+
+  gst_message_unref (level);
+  gst_message_unref (eos);
+  g_object_unref (gstdbus);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_bus_msg_suite (void)
+{
+  Suite *suite = suite_create ("gstd_bus_msg");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_packed_arrays);
+  tcase_add_test (tc, test_decimation);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_bus_msg);
@@ -0,0 +1,439 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+/* The soak is too long and timing sensitive for the default test run,
+ * it only runs when given a length in seconds:
+ *   GSTD_SOAK_DURATION=3600 GSTD_SOAK_CLIENTS=16 ./test_gstd_churn_soak
+ */
+#define SOAK_DEFAULT_CLIENTS 4
+
+/* Tells automake and meson the test was skipped */
+#define SOAK_EXIT_SKIP 77
+
+/* Resources are sampled with every client paused between iterations.
+ * The first fifth of the samples is warm up, the baseline follows and
+ * the last 30% are compared against it. */
+#define SOAK_SAMPLES 30
+#define SOAK_BASELINE_FIRST 6
+#define SOAK_BASELINE_LAST 14
+#define SOAK_FINAL_FIRST 21
+
+/* Allowed growth from the baseline to the end of the run */
+#define SOAK_FDS_SLACK 2
+#define SOAK_THREADS_SLACK 2
+#define SOAK_INSTANCES_SLACK 16
+#define SOAK_RSS_SLACK (2 * 1024 * 1024)
+#define SOAK_RSS_FACTOR 1.05
+#define SOAK_LATENCY_SLACK (1 * G_TIME_SPAN_MILLISECOND)
+#define SOAK_LATENCY_FACTOR 2.0
+
+typedef struct _SoakSample SoakSample;
+typedef struct _SoakIteration SoakIteration;
+
+struct _SoakSample
+{
+  gint64 time;
+  gint64 fds;
+  gint64 threads;
+  gint64 rss;
+  gint64 instances;
+};
+
+struct _SoakIteration
+{
+  gint64 end;
+  gint64 latency;
+};
+
+static GstdSession *session;
+
+static GMutex lock;
+static GCond cond;
+static gboolean paused;
+static gboolean stopped;
+static gint active;
+static gint failures;
+static GArray *iterations;
+
+static void
+setup (void)
+{
+  session = gstd_session_new ("test_gstd_churn_soak");
+  iterations = g_array_new (FALSE, FALSE, sizeof (SoakIteration));
+  paused = FALSE;
+  stopped = FALSE;
+  active = 0;
+  failures = 0;
+}
+
+static void
+teardown (void)
+{
+  g_array_free (iterations, TRUE);
+  g_object_unref (session);
+}
+
+static gint
+env_int (const gchar * name, gint fallback)
+{
+  const gchar *value = g_getenv (name);
+
+  return value ? atoi (value) : fallback;
+}
+
+static gint64
+count_fds (void)
+{
+  GDir *dir;
+  gint64 count = 0;
+
+  dir = g_dir_open ("/proc/self/fd", 0, NULL);
+  if (!dir) {
+    return 0;
+  }
+
+  while (g_dir_read_name (dir)) {
+    count++;
+  }
+  g_dir_close (dir);
+
+  /* Not counting the descriptor of the listing itself */
+  return count - 1;
+}
+
+static gint64
+read_proc_value (const gchar * path, const gchar * key)
+{
+  gchar *contents = NULL;
+  gchar *found;
+  gint64 value = 0;
+
+  if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+    return 0;
+  }
+
+  found = strstr (contents, key);
+  if (found) {
+    value = g_ascii_strtoll (found + strlen (key), NULL, 10);
+  }
+  g_free (contents);
+
+  return value;
+}
+
+/* Only tracked with GOBJECT_DEBUG=instance-count, zero otherwise */
+static gint64
+count_instances (GType type)
+{
+  GType *children;
+  guint n_children;
+  gint64 count;
+  guint i;
+
+  count = g_type_get_instance_count (type);
+
+  children = g_type_children (type, &n_children);
+  for (i = 0; i < n_children; i++) {
+    count += count_instances (children[i]);
+  }
+  g_free (children);
+
+  return count;
+}
+
+static gboolean
+run_step (const gchar * cmd, const gchar * expected)
+{
+  gchar *response = NULL;
+  GstdReturnCode ret;
+  gboolean ok;
+
+  ret = gstd_parser_parse_cmd (session, cmd, &response);
+  ok = GSTD_EOK == ret && (!expected || (response
+          && strstr (response, expected)));
+  g_free (response);
+
+  return ok;
+}
+
+static gpointer
+soak_client (gpointer data)
+{
+  gint id = GPOINTER_TO_INT (data);
+  SoakIteration iteration;
+  gchar *create_cmd;
+  gchar *filter_cmd;
+  gchar *timeout_cmd;
+  gchar *play_cmd;
+  gchar *read_cmd;
+  gchar *delete_cmd;
+  gint64 start;
+  gboolean ok;
+
+  create_cmd = g_strdup_printf ("pipeline_create soak%d fakesrc num-buffers=10 "
+      "! fakesink", id);
+  filter_cmd = g_strdup_printf ("bus_filter soak%d eos", id);
+  timeout_cmd = g_strdup_printf ("bus_timeout soak%d %" G_GUINT64_FORMAT, id,
+      5 * GST_SECOND);
+  play_cmd = g_strdup_printf ("pipeline_play soak%d", id);
+  read_cmd = g_strdup_printf ("bus_read soak%d", id);
+  delete_cmd = g_strdup_printf ("pipeline_delete soak%d", id);
+
+  while (TRUE) {
+    g_mutex_lock (&lock);
+    while (paused && !stopped) {
+      g_cond_wait (&cond, &lock);
+    }
+    if (stopped) {
+      g_mutex_unlock (&lock);
+      break;
+    }
+    active++;
+    g_mutex_unlock (&lock);
+
+    start = g_get_monotonic_time ();
+    ok = run_step (create_cmd, NULL) && run_step (filter_cmd, NULL)
+        && run_step (timeout_cmd, NULL) && run_step (play_cmd, NULL)
+        && run_step (read_cmd, "eos");
+    /* Delete even after a failure, so the next iteration can start */
+    ok = run_step (delete_cmd, NULL) && ok;
+    iteration.end = g_get_monotonic_time ();
+    iteration.latency = iteration.end - start;
+
+    g_mutex_lock (&lock);
+    if (ok) {
+      g_array_append_val (iterations, iteration);
+    } else {
+      failures++;
+    }
+    active--;
+    g_cond_broadcast (&cond);
+    g_mutex_unlock (&lock);
+  }
+
+  g_free (create_cmd);
+  g_free (filter_cmd);
+  g_free (timeout_cmd);
+  g_free (play_cmd);
+  g_free (read_cmd);
+  g_free (delete_cmd);
+
+  return NULL;
+}
+
+static void
+take_sample (SoakSample * sample)
+{
+  /* Wait for every client to be in between iterations */
+  g_mutex_lock (&lock);
+  paused = TRUE;
+  while (active) {
+    g_cond_wait (&cond, &lock);
+  }
+  g_mutex_unlock (&lock);
+
+  sample->time = g_get_monotonic_time ();
+  sample->fds = count_fds ();
+  sample->threads = read_proc_value ("/proc/self/status", "Threads:");
+  sample->rss = read_proc_value ("/proc/self/status", "VmRSS:") * 1024;
+  sample->instances = count_instances (G_TYPE_OBJECT);
+
+  g_mutex_lock (&lock);
+  paused = FALSE;
+  g_cond_broadcast (&cond);
+  g_mutex_unlock (&lock);
+}
+
+static gint64
+sample_max (SoakSample * samples, gsize offset, gint first, gint last)
+{
+  gint64 value = G_MININT64;
+  gint i;
+
+  for (i = first; i <= last; i++) {
+    value = MAX (value, G_STRUCT_MEMBER (gint64, &samples[i], offset));
+  }
+
+  return value;
+}
+
+static gint64
+sample_min (SoakSample * samples, gsize offset, gint first, gint last)
+{
+  gint64 value = G_MAXINT64;
+  gint i;
+
+  for (i = first; i <= last; i++) {
+    value = MIN (value, G_STRUCT_MEMBER (gint64, &samples[i], offset));
+  }
+
+  return value;
+}
+
+static gint
+compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+static gint64
+median_latency (gint64 from, gint64 to)
+{
+  GArray *latencies;
+  SoakIteration *iteration;
+  gint64 median = 0;
+  guint i;
+
+  latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+  for (i = 0; i < iterations->len; i++) {
+    iteration = &g_array_index (iterations, SoakIteration, i);
+    if (iteration->end >= from && iteration->end < to) {
+      g_array_append_val (latencies, iteration->latency);
+    }
+  }
+
+  if (latencies->len) {
+    g_array_sort (latencies, compare_latency);
+    median = g_array_index (latencies, gint64, latencies->len / 2);
+  }
+  g_array_free (latencies, TRUE);
+
+  return median;
+}
+
+/* Grows only if every final sample is above every baseline sample */
+#define assert_no_growth(samples, field, slack, factor) G_STMT_START {   \
+  gint64 base = sample_max (samples, G_STRUCT_OFFSET (SoakSample, field), \
+      SOAK_BASELINE_FIRST, SOAK_BASELINE_LAST);                         \
+  gint64 final = sample_min (samples, G_STRUCT_OFFSET (SoakSample, field),\
+      SOAK_FINAL_FIRST, SOAK_SAMPLES - 1);                              \
+  GST_INFO (#field ": baseline %" G_GINT64_FORMAT ", final %"            \
+      G_GINT64_FORMAT, base, final);                                    \
+  fail_unless (final <= base * (factor) + (slack),                      \
+      #field " trended upward from %" G_GINT64_FORMAT " to %"            \
+      G_GINT64_FORMAT, base, final);                                    \
+} G_STMT_END
+
+GST_START_TEST (test_churn_soak)
+{
+  SoakSample samples[SOAK_SAMPLES];
+  GThread **threads;
+  gint duration;
+  gint clients;
+  gint64 start;
+  gint64 wait;
+  gint64 base_latency;
+  gint64 final_latency;
+  gint i;
+
+  duration = env_int ("GSTD_SOAK_DURATION", 0);
+  clients = env_int ("GSTD_SOAK_CLIENTS", SOAK_DEFAULT_CLIENTS);
+  fail_unless (duration > 0 && clients > 0);
+
+  threads = g_new0 (GThread *, clients);
+  for (i = 0; i < clients; i++) {
+    threads[i] = g_thread_new ("soak", soak_client, GINT_TO_POINTER (i));
+  }
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < SOAK_SAMPLES; i++) {
+    wait = start + (gint64) duration * G_USEC_PER_SEC * (i + 1) /
+        SOAK_SAMPLES - g_get_monotonic_time ();
+    if (wait > 0) {
+      g_usleep (wait);
+    }
+    take_sample (&samples[i]);
+  }
+
+  g_mutex_lock (&lock);
+  stopped = TRUE;
+  g_cond_broadcast (&cond);
+  g_mutex_unlock (&lock);
+
+  for (i = 0; i < clients; i++) {
+    g_thread_join (threads[i]);
+  }
+  g_free (threads);
+
+  GST_INFO ("%u iterations, %d failures", iterations->len, failures);
+  fail_if (failures, "%d iterations failed", failures);
+  fail_if (0 == iterations->len);
+
+  assert_no_growth (samples, fds, SOAK_FDS_SLACK, 1);
+  assert_no_growth (samples, threads, SOAK_THREADS_SLACK, 1);
+  assert_no_growth (samples, instances, SOAK_INSTANCES_SLACK, 1);
+  assert_no_growth (samples, rss, SOAK_RSS_SLACK, SOAK_RSS_FACTOR);
+
+  base_latency = median_latency (samples[SOAK_BASELINE_FIRST].time,
+      samples[SOAK_BASELINE_LAST].time);
+  final_latency = median_latency (samples[SOAK_FINAL_FIRST].time,
+      G_MAXINT64);
+  GST_INFO ("latency: baseline %" G_GINT64_FORMAT " us, final %"
+      G_GINT64_FORMAT " us", base_latency, final_latency);
+  fail_unless (final_latency <= base_latency * SOAK_LATENCY_FACTOR +
+      SOAK_LATENCY_SLACK, "latency drifted from %" G_GINT64_FORMAT " to %"
+      G_GINT64_FORMAT " us", base_latency, final_latency);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_churn_soak_suite (void)
+{
+  Suite *suite = suite_create ("gstd_churn_soak");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, env_int ("GSTD_SOAK_DURATION", 0) + 60);
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_churn_soak);
+
+  return suite;
+}
+
+int
+main (int argc, char **argv)
+{
+  Suite *suite;
+
+  if (!g_getenv ("GSTD_SOAK_DURATION")) {
+    g_print ("Set GSTD_SOAK_DURATION to run the churn soak\n");
+    return SOAK_EXIT_SKIP;
+  }
+
+  gst_check_init (&argc, &argv);
+  suite = gstd_churn_soak_suite ();
+
+  return gst_check_run_suite (suite, "gstd_churn_soak", __FILE__);
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <glib/gstdio.h>
+#include <gst/check/gstcheck.h>
+#include <unistd.h>
+
+#include "gstd_journal.h"
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+GST_START_TEST (test_journal)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdJournalReader *reader;
+  GstdJournalRecord record;
+  GstdReturnCode ret;
+  GError *error = NULL;
+  gchar *response = NULL;
+  gchar *filename;
+  guint connection;
+  gint fd;
+
+  fd = g_file_open_tmp ("gstd-journal-XXXXXX", &filename, NULL);
+  fail_if (fd < 0);
+  close (fd);
+
+  fail_unless (gstd_journal_open (filename, &error));
+
+  ret = gstd_parser_parse_cmd (test_session, "list_pipelines", &response);
+  fail_if (ret);
+  g_free (response);
+  response = NULL;
+
+  connection = gstd_journal_new_connection ();
+  gstd_journal_set_connection (GSTD_JOURNAL_PROTOCOL_UNIX, connection);
+  ret = gstd_parser_parse_cmd (test_session, "read /pipelines", &response);
+  fail_if (ret);
+  g_free (response);
+  response = NULL;
+  gstd_journal_set_connection (GSTD_JOURNAL_PROTOCOL_NONE, 0);
+
+  gstd_journal_close ();
+
+  reader = gstd_journal_reader_new (filename, &error);
+  fail_if (NULL == reader);
+  fail_if (gstd_journal_reader_get_start (reader) <= 0);
+
+  fail_unless (gstd_journal_reader_next (reader, &record, &error));
+  fail_unless_equals_string (record.command, "list_pipelines");
+  fail_unless_equals_int (record.connection, 0);
+  fail_unless_equals_int (record.protocol, GSTD_JOURNAL_PROTOCOL_NONE);
+  g_free (record.command);
+
+  fail_unless (gstd_journal_reader_next (reader, &record, &error));
+  fail_unless_equals_string (record.command, "read /pipelines");
+  fail_unless_equals_int (record.connection, connection);
+  fail_unless_equals_int (record.protocol, GSTD_JOURNAL_PROTOCOL_UNIX);
+  g_free (record.command);
+
+  /* A clean end of the journal is not an error */
+  fail_if (gstd_journal_reader_next (reader, &record, &error));
+  fail_if (NULL != error);
+  gstd_journal_reader_free (reader);
+
+  g_unlink (filename);
+  g_free (filename);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_journal_suite (void)
+{
+  Suite *suite = suite_create ("gstd_journal");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_journal);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_journal);
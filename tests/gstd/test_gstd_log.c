@@ -0,0 +1,234 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <glib/gstdio.h>
+#include <gst/check/gstcheck.h>
+
+#include "gstd_log.h"
+#include "gstd_pipeline_debug.h"
+
+GST_DEBUG_CATEGORY_STATIC (gstd_test_log);
+GST_DEBUG_CATEGORY_STATIC (test_log);
+
+static gchar *tmpdir;
+static gchar *gstd_path;
+static gchar *gst_path;
+
+static void
+setup (void)
+{
+  tmpdir = g_dir_make_tmp ("gstd-log-XXXXXX", NULL);
+  fail_if (NULL == tmpdir);
+  gstd_path = g_build_filename (tmpdir, "gstd.log", NULL);
+  gst_path = g_build_filename (tmpdir, "gst.log", NULL);
+
+  GST_DEBUG_CATEGORY_INIT (gstd_test_log, "gstdtestlog", 0, "gstd test");
+  GST_DEBUG_CATEGORY_INIT (test_log, "testlog", 0, "gst test");
+  gst_debug_set_active (TRUE);
+  gst_debug_set_threshold_for_name ("gstdtestlog", GST_LEVEL_WARNING);
+  gst_debug_set_threshold_for_name ("testlog", GST_LEVEL_WARNING);
+}
+
+static void
+teardown (void)
+{
+  GDir *dir;
+  const gchar *name;
+  gchar *path;
+
+  dir = g_dir_open (tmpdir, 0, NULL);
+  while ((name = g_dir_read_name (dir))) {
+    path = g_build_filename (tmpdir, name, NULL);
+    g_unlink (path);
+    g_free (path);
+  }
+  g_dir_close (dir);
+  g_rmdir (tmpdir);
+
+  g_free (tmpdir);
+  g_free (gstd_path);
+  g_free (gst_path);
+}
+
+static gchar *
+read_log (const gchar * path)
+{
+  gchar *contents = NULL;
+
+  fail_unless (g_file_get_contents (path, &contents, NULL, NULL));
+
+  return contents;
+}
+
+GST_START_TEST (test_routing)
+{
+  gchar *contents;
+
+  fail_unless (gstd_log_init (gstd_path, gst_path, 0, 0));
+  gstd_log_start ();
+
+  GST_CAT_WARNING (gstd_test_log, "to the gstd log");
+  GST_CAT_WARNING (test_log, "to the gst log");
+
+  /* Stopping writes whatever is still queued */
+  gstd_log_deinit ();
+
+  contents = read_log (gstd_path);
+  fail_if (NULL == strstr (contents, "to the gstd log"));
+  fail_unless (NULL == strstr (contents, "to the gst log"));
+  g_free (contents);
+
+  contents = read_log (gst_path);
+  fail_if (NULL == strstr (contents, "to the gst log"));
+  fail_unless (NULL == strstr (contents, "to the gstd log"));
+  g_free (contents);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_overflow)
+{
+  gchar *contents;
+  gint i;
+
+  /* Without a writer the ring of this thread fills up */
+  fail_unless (gstd_log_init (gstd_path, gst_path, 0, 0));
+  for (i = 0; i < 4096; i++) {
+    GST_CAT_WARNING (gstd_test_log, "record %d", i);
+  }
+  gstd_log_deinit ();
+
+  contents = read_log (gstd_path);
+  fail_if (NULL == strstr (contents, "record 0\n"));
+  fail_unless (NULL == strstr (contents, "record 4095\n"));
+  fail_if (NULL == strstr (contents, "gstd: dropped "));
+  g_free (contents);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rotation)
+{
+  gchar *contents;
+  gchar *rotated;
+
+  fail_unless (gstd_log_init (gstd_path, gst_path, 1, 2));
+  GST_CAT_WARNING (gstd_test_log, "first batch");
+  gstd_log_deinit ();
+
+  /* The batch went over the size and was rotated out */
+  rotated = g_strdup_printf ("%s.1", gstd_path);
+  contents = read_log (rotated);
+  fail_if (NULL == strstr (contents, "first batch"));
+  g_free (contents);
+  g_free (rotated);
+
+  contents = read_log (gstd_path);
+  fail_unless_equals_string (contents, "");
+  g_free (contents);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pipeline_debug)
+{
+  GstElement *scoped;
+  GstElement *other;
+  GstElement *scoped_child;
+  GstElement *other_child;
+  GstdPipelineDebug *debug;
+  gchar *contents;
+  gchar *path;
+
+  scoped = gst_pipeline_new ("scoped");
+  other = gst_pipeline_new ("other");
+  scoped_child = gst_bin_new ("scoped_child");
+  other_child = gst_bin_new ("other_child");
+  gst_bin_add (GST_BIN (scoped), scoped_child);
+  gst_bin_add (GST_BIN (other), other_child);
+
+  fail_unless (gstd_log_init (gstd_path, gst_path, 0, 0));
+  gstd_log_start ();
+
+  debug = gstd_pipeline_debug_new (scoped);
+  g_object_set (debug, "threshold", "testlog:5", "enable", TRUE, NULL);
+
+  /* An invalid threshold is refused and the previous one kept */
+  fail_if (gstd_pipeline_debug_check_threshold ("testlog:bogus"));
+  g_object_set (debug, "threshold", "testlog:bogus", NULL);
+
+  /* The category is raised so the messages reach the log functions */
+  fail_unless_equals_int (gst_debug_category_get_threshold (test_log),
+      GST_LEVEL_DEBUG);
+
+  GST_CAT_DEBUG_OBJECT (test_log, scoped_child, "scoped message");
+  GST_CAT_DEBUG_OBJECT (test_log, other_child, "unscoped message");
+  GST_CAT_WARNING_OBJECT (test_log, other_child, "global message");
+
+  /* A separate file takes the scoped messages out of the usual logs */
+  path = g_build_filename (tmpdir, "scoped.log", NULL);
+  g_object_set (debug, "file", path, NULL);
+  GST_CAT_DEBUG_OBJECT (test_log, scoped_child, "filed message");
+
+  g_object_unref (debug);
+  fail_unless_equals_int (gst_debug_category_get_threshold (test_log),
+      GST_LEVEL_WARNING);
+
+  gstd_log_deinit ();
+
+  contents = read_log (gst_path);
+  fail_if (NULL == strstr (contents, "scoped message"));
+  fail_if (NULL == strstr (contents, "global message"));
+  fail_unless (NULL == strstr (contents, "unscoped message"));
+  fail_unless (NULL == strstr (contents, "filed message"));
+  g_free (contents);
+
+  contents = read_log (path);
+  fail_if (NULL == strstr (contents, "filed message"));
+  g_free (contents);
+  g_free (path);
+
+  gst_object_unref (scoped);
+  gst_object_unref (other);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_log_suite (void)
+{
+  Suite *suite = suite_create ("gstd_log");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_routing);
+  tcase_add_test (tc, test_overflow);
+  tcase_add_test (tc, test_rotation);
+  tcase_add_test (tc, test_pipeline_debug);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_log);
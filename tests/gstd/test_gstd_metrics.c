@@ -0,0 +1,315 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <fcntl.h>
+#include <glib/gstdio.h>
+#include <gst/check/gstcheck.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "gstd_metrics.h"
+#include "gstd_parser.h"
+#include "gstd_session.h"
+#include "gstd_shm_metrics.h"
+#include "gstd_shm_publisher.h"
+
+static GstdSession *session;
+
+static void
+setup (void)
+{
+  session = gstd_session_new ("test_gstd_metrics");
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (session);
+}
+
+static void
+run (const gchar * cmd)
+{
+  gchar *response = NULL;
+
+  gstd_parser_parse_cmd (session, cmd, &response);
+  g_free (response);
+}
+
+static gpointer
+run_in_thread (gpointer data)
+{
+  run (data);
+
+  return NULL;
+}
+
+GST_START_TEST (test_command_metrics)
+{
+  gchar *metrics;
+
+  run ("pipeline_create metrics_pipe fakesrc ! fakesink");
+  run ("pipeline_play metrics_pipe_missing");
+
+  metrics = gstd_metrics_render (session);
+
+  fail_if (NULL == strstr (metrics,
+          "gstd_command_requests_total{command=\"pipeline_create\"} 1\n"));
+  fail_if (NULL == strstr (metrics,
+          "gstd_command_errors_total{command=\"pipeline_play\"} 1\n"));
+  fail_if (NULL == strstr (metrics,
+          "gstd_command_duration_seconds_bucket{command=\"pipeline_create\","
+          "le=\"+Inf\"} 1\n"));
+  fail_if (NULL == strstr (metrics,
+          "gstd_pipeline_state{pipeline=\"metrics_pipe\"} 1\n"));
+  fail_if (NULL == strstr (metrics,
+          "gstd_pipeline_errors_total{pipeline=\"metrics_pipe\"} 0\n"));
+
+  g_free (metrics);
+
+  run ("pipeline_delete metrics_pipe");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_exited_thread_metrics)
+{
+  GThread *thread;
+  gchar *metrics;
+
+  /* Counters outlive the threads that recorded them */
+  thread = g_thread_new ("metrics", run_in_thread, (gpointer) "list_signals");
+  g_thread_join (thread);
+
+  metrics = gstd_metrics_render (session);
+  fail_if (NULL == strstr (metrics,
+          "gstd_command_requests_total{command=\"list_signals\"} 1\n"));
+  g_free (metrics);
+}
+
+GST_END_TEST;
+
+/* Reads a counter of the entry with the given name in a JSON response */
+static guint64
+named_member (const gchar * response, const gchar * name,
+    const gchar * member)
+{
+  gchar *needle;
+  const gchar *found;
+  guint64 value;
+
+  needle = g_strdup_printf ("\"%s\"", name);
+  found = strstr (response, needle);
+  g_free (needle);
+  fail_if (NULL == found);
+
+  needle = g_strdup_printf ("\"%s\" : ", member);
+  found = strstr (found, needle);
+  fail_if (NULL == found);
+  value = g_ascii_strtoull (found + strlen (needle), NULL, 10);
+  g_free (needle);
+
+  return value;
+}
+
+GST_START_TEST (test_lock_stats)
+{
+  gchar *response = NULL;
+
+  /* Locks are only accounted while enabled */
+  run ("pipeline_create locks_pipe fakesrc ! fakesink");
+  run ("debug_locks true");
+  run ("pipeline_create_ref locks_ref_pipe fakesrc ! fakesink");
+  run ("pipeline_delete_ref locks_ref_pipe");
+
+  gstd_parser_parse_cmd (session, "read /debug/locks", &response);
+  fail_if (NULL == strstr (response, "\"enabled\" : true"));
+  fail_unless_equals_uint64 (1, named_member (response, "session-create-ref",
+          "acquisitions"));
+  fail_unless_equals_uint64 (1, named_member (response, "session-delete-ref",
+          "acquisitions"));
+  fail_unless (named_member (response, "list-find", "acquisitions") > 0);
+  fail_unless_equals_uint64 (0, named_member (response, "pipeline-play-ref",
+          "acquisitions"));
+  g_free (response);
+
+  /* Enabling again starts a new measurement */
+  run ("debug_locks false");
+  run ("debug_locks true");
+  response = NULL;
+  gstd_parser_parse_cmd (session, "read /debug/locks", &response);
+  fail_unless_equals_uint64 (0, named_member (response, "session-create-ref",
+          "acquisitions"));
+  g_free (response);
+
+  run ("debug_locks false");
+  run ("pipeline_delete locks_pipe");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_instances)
+{
+  gchar *response = NULL;
+  guint64 live;
+  guint64 created;
+
+  run ("pipeline_create instances_pipe fakesrc ! fakesink name=sink");
+
+  gstd_parser_parse_cmd (session, "read /debug/instances", &response);
+  fail_unless (named_member (response, "GstdPipeline", "live") >= 1);
+  live = named_member (response, "GstdJsonBuilder", "live");
+  created = named_member (response, "GstdJsonBuilder", "created");
+  g_free (response);
+
+  /* Every response uses transient formatters that must not leak */
+  run ("list_elements instances_pipe");
+  run ("element_get instances_pipe sink sync");
+
+  response = NULL;
+  gstd_parser_parse_cmd (session, "read /debug/instances", &response);
+  fail_unless_equals_uint64 (live, named_member (response,
+          "GstdJsonBuilder", "live"));
+  fail_unless (named_member (response, "GstdJsonBuilder", "created") >
+      created);
+  g_free (response);
+
+  run ("pipeline_delete instances_pipe");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_gauges)
+{
+  GstdMetricsGauge *gauge;
+  gchar *metrics;
+
+  gauge = gstd_metrics_gauge_get ("gstd_test_gauge", "A test gauge",
+      "ipc=\"test\"");
+  fail_unless (gauge == gstd_metrics_gauge_get ("gstd_test_gauge",
+          "A test gauge", "ipc=\"test\""));
+
+  gstd_metrics_gauge_inc (gauge);
+  gstd_metrics_gauge_inc (gauge);
+  gstd_metrics_gauge_dec (gauge);
+
+  metrics = gstd_metrics_render (session);
+  fail_if (NULL == strstr (metrics, "# TYPE gstd_test_gauge gauge\n"));
+  fail_if (NULL == strstr (metrics, "gstd_test_gauge{ipc=\"test\"} 1\n"));
+  g_free (metrics);
+}
+
+GST_END_TEST;
+
+static void
+read_page (const GstdShmMetrics * page, GstdShmMetrics * copy)
+{
+  guint32 sequence;
+
+  do {
+    sequence = __atomic_load_n (&page->sequence, __ATOMIC_ACQUIRE);
+    if (sequence & 1) {
+      continue;
+    }
+    memcpy (copy, page, sizeof (*copy));
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  } while ((sequence & 1)
+      || sequence != __atomic_load_n (&page->sequence, __ATOMIC_RELAXED));
+}
+
+GST_START_TEST (test_shm_page)
+{
+  GstdShmPublisher *publisher;
+  GstdShmMetrics *page;
+  GstdShmMetrics *copy;
+  gchar *path;
+  gint fd;
+  gint i;
+
+  fd = g_file_open_tmp ("gstd-metrics-XXXXXX", &path, NULL);
+  fail_if (fd < 0);
+  close (fd);
+
+  run ("pipeline_create shm_pipe fakesrc ! fakesink");
+
+  publisher = gstd_shm_publisher_new (session, path, 10, NULL);
+  fail_if (NULL == publisher);
+
+  fd = g_open (path, O_RDONLY, 0);
+  fail_if (fd < 0);
+  page = mmap (NULL, sizeof (*page), PROT_READ, MAP_SHARED, fd, 0);
+  fail_if (MAP_FAILED == page);
+  close (fd);
+
+  fail_unless_equals_int (page->magic, GSTD_SHM_METRICS_MAGIC);
+  fail_unless_equals_int (page->version, GSTD_SHM_METRICS_VERSION);
+
+  /* Wait for an update that saw the pipeline */
+  copy = g_new0 (GstdShmMetrics, 1);
+  for (i = 0; i < 100; i++) {
+    read_page (page, copy);
+    if (copy->n_pipelines > 0) {
+      break;
+    }
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+
+  fail_unless_equals_int (copy->n_pipelines, 1);
+  fail_unless_equals_string (copy->pipelines[0].name, "shm_pipe");
+  fail_unless_equals_int (copy->pipelines[0].state, GST_STATE_NULL);
+  fail_unless_equals_int (copy->pipelines[0].bus_errors, 0);
+  fail_unless (copy->requests >= 1);
+
+  g_free (copy);
+  munmap (page, sizeof (*page));
+  gstd_shm_publisher_free (publisher);
+
+  /* The page is removed once the publisher stops */
+  fail_if (g_file_test (path, G_FILE_TEST_EXISTS));
+  g_free (path);
+
+  run ("pipeline_delete shm_pipe");
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_metrics_suite (void)
+{
+  Suite *suite = suite_create ("gstd_metrics");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_command_metrics);
+  tcase_add_test (tc, test_exited_thread_metrics);
+  tcase_add_test (tc, test_lock_stats);
+  tcase_add_test (tc, test_instances);
+  tcase_add_test (tc, test_gauges);
+  tcase_add_test (tc, test_shm_page);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_metrics);
@@ -0,0 +1,159 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <json-glib/json-glib.h>
+
+#include "gstd_parser.h"
+#include "gstd_pipeline.h"
+#include "gstd_session.h"
+
+static JsonObject *
+read_element (JsonParser * parser, GstdSession * session, const gchar * name)
+{
+  GstdObject *node;
+  GstdReturnCode ret;
+  JsonArray *elements;
+  JsonObject *element;
+  gchar *outstring;
+  guint i;
+
+  ret = gstd_get_by_uri (session, "/pipelines/p0/qos", &node);
+  fail_if (ret);
+  fail_if (NULL == node);
+
+  ret = gstd_object_to_string (node, &outstring);
+  fail_if (ret);
+  fail_unless (json_parser_load_from_data (parser, outstring, -1, NULL));
+  g_free (outstring);
+  gst_object_unref (node);
+
+  elements =
+      json_object_get_array_member (json_node_get_object
+      (json_parser_get_root (parser)), "elements");
+  for (i = 0; i < json_array_get_length (elements); i++) {
+    element = json_array_get_object_element (elements, i);
+    if (!g_strcmp0 (name, json_object_get_string_member (element, "name"))) {
+      return element;
+    }
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_pipeline_qos)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  GstElement *sink;
+  GstdObject *node;
+  GstBus *bus;
+  GstMessage *msg;
+  JsonParser *parser;
+  JsonObject *element;
+  GstdReturnCode ret;
+  gchar *response = NULL;
+
+  ret = gstd_get_by_uri (test_session, "/pipelines", &node);
+  fail_if (ret);
+  ret = gstd_object_create (node, "p0", "fakesrc ! fakesink name=sink");
+  fail_if (ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p0", &node);
+  fail_if (ret);
+  pipeline = gstd_pipeline_get_pipeline (GSTD_PIPELINE (node));
+  gst_object_unref (node);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  fail_if (NULL == sink);
+
+  msg = gst_message_new_qos (GST_OBJECT (sink), TRUE, 0, 0, 0, GST_MSECOND);
+  gst_message_set_qos_values (msg, 2 * GST_MSECOND, 0.5, 1000000);
+  gst_message_set_qos_stats (msg, GST_FORMAT_BUFFERS, 10, 2);
+  gst_element_post_message (sink, msg);
+
+  parser = json_parser_new ();
+  element = read_element (parser, test_session, "sink");
+  fail_if (NULL == element);
+  fail_unless_equals_int (json_object_get_int_member (element, "messages"), 1);
+  fail_unless (json_object_get_boolean_member (element, "live"));
+  fail_unless_equals_string (json_object_get_string_member (element,
+          "format"), "buffers");
+  fail_unless_equals_int (json_object_get_int_member (element, "processed"),
+      10);
+  fail_unless_equals_int (json_object_get_int_member (element, "dropped"), 2);
+  fail_unless_equals_int64 (json_object_get_int_member (element, "jitter"),
+      2 * GST_MSECOND);
+  fail_unless_equals_float (json_object_get_double_member (element,
+          "proportion"), 0.5);
+  fail_unless_equals_int (json_object_get_int_member (element, "quality"),
+      1000000);
+
+  /* Forwarded by default */
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_QOS);
+  fail_if (NULL == msg);
+  gst_message_unref (msg);
+
+  ret = gstd_parser_parse_cmd (test_session, "bus_qos_forward p0 false",
+      &response);
+  fail_if (ret);
+  g_free (response);
+
+  msg = gst_message_new_qos (GST_OBJECT (sink), TRUE, 0, 0, 0, GST_MSECOND);
+  gst_element_post_message (sink, msg);
+
+  /* Still aggregated, but not delivered */
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_QOS);
+  fail_unless (NULL == msg);
+  gst_object_unref (bus);
+
+  element = read_element (parser, test_session, "sink");
+  fail_if (NULL == element);
+  fail_unless_equals_int (json_object_get_int_member (element, "messages"), 2);
+  fail_unless_equals_int64 (json_object_get_int_member (element,
+          "jitter-max"), 2 * GST_MSECOND);
+
+  g_object_unref (parser);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_pipeline_qos_suite (void)
+{
+  Suite *suite = suite_create ("gstd_pipeline_qos");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_pipeline_qos);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_pipeline_qos);
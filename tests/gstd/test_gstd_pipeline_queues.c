@@ -0,0 +1,217 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <json-glib/json-glib.h>
+
+#include "gstd_pipeline.h"
+#include "gstd_pipeline_queues.h"
+#include "gstd_session.h"
+
+static GstElement *
+create_pipeline (GstdSession * session, const gchar * description)
+{
+  GstdObject *node;
+  GstElement *pipeline;
+  GstdReturnCode ret;
+
+  ret = gstd_get_by_uri (session, "/pipelines", &node);
+  fail_if (ret);
+  ret = gstd_object_create (node, "p0", description);
+  fail_if (ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (session, "/pipelines/p0", &node);
+  fail_if (ret);
+  pipeline = gstd_pipeline_get_pipeline (GSTD_PIPELINE (node));
+  gst_object_unref (node);
+
+  return pipeline;
+}
+
+static JsonObject *
+read_object (JsonParser * parser, GstdObject * node)
+{
+  GstdReturnCode ret;
+  gchar *outstring;
+
+  ret = gstd_object_to_string (node, &outstring);
+  fail_if (ret);
+  fail_unless (json_parser_load_from_data (parser, outstring, -1, NULL));
+  g_free (outstring);
+
+  return json_node_get_object (json_parser_get_root (parser));
+}
+
+static JsonObject *
+find_queue (JsonObject * root, const gchar * name)
+{
+  JsonArray *queues;
+  JsonObject *queue;
+  guint i;
+
+  queues = json_object_get_array_member (root, "queues");
+  for (i = 0; i < json_array_get_length (queues); i++) {
+    queue = json_array_get_object_element (queues, i);
+    if (!g_strcmp0 (name, json_object_get_string_member (queue, "name"))) {
+      return queue;
+    }
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_pipeline_queues)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  GstdObject *node;
+  JsonParser *parser;
+  JsonObject *root;
+  JsonObject *queue;
+  GstdReturnCode ret;
+
+  pipeline = create_pipeline (test_session,
+      "fakesrc num-buffers=10 ! queue name=q max-size-buffers=5 "
+      "! fakesink sync=false");
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p0/queues", &node);
+  fail_if (ret);
+  fail_if (NULL == node);
+
+  parser = json_parser_new ();
+  root = read_object (parser, node);
+  fail_unless_equals_int (json_object_get_int_member (root, "high-water"), 0);
+  fail_unless_equals_int (json_object_get_int_member (root, "low-water"), 0);
+
+  queue = find_queue (root, "q");
+  fail_if (NULL == queue);
+  fail_unless_equals_string (json_object_get_string_member (queue,
+          "factory"), "queue");
+  fail_unless_equals_int (json_object_get_int_member (queue,
+          "max-size-buffers"), 5);
+  fail_unless_equals_int (json_object_get_int_member (queue,
+          "current-level-buffers"), 0);
+  fail_unless_equals_int (json_object_get_int_member (queue, "percent"), 0);
+
+  /* Low must be below high */
+  fail_unless_equals_int (gstd_object_update (node, "10 50"), GSTD_BAD_VALUE);
+  fail_unless_equals_int (gstd_object_update (node, "101 50"),
+      GSTD_BAD_VALUE);
+  fail_if (gstd_object_update (node, "75 25"));
+
+  root = read_object (parser, node);
+  fail_unless_equals_int (json_object_get_int_member (root, "high-water"), 75);
+  fail_unless_equals_int (json_object_get_int_member (root, "low-water"), 25);
+
+  g_object_unref (parser);
+  gst_object_unref (node);
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_queue_watermarks)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  GstdObject *node;
+  GstBus *bus;
+  GstMessage *msg;
+  const GstStructure *structure;
+  GstdReturnCode ret;
+  gboolean high = FALSE;
+  gboolean low = FALSE;
+  guint threshold;
+
+  /* The slow identity lets the queue fill up */
+  pipeline = create_pipeline (test_session,
+      "fakesrc num-buffers=20 ! queue max-size-buffers=4 max-size-bytes=0 "
+      "max-size-time=0 ! identity sleep-time=5000 ! fakesink sync=false");
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p0/queues", &node);
+  fail_if (ret);
+  ret = gstd_object_update (node, "75 25");
+  fail_if (ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p0/state", &node);
+  fail_if (ret);
+  ret = gstd_object_update (node, "playing");
+  fail_if (ret);
+
+  bus = gst_element_get_bus (pipeline);
+  while ((msg = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+              GST_MESSAGE_EOS | GST_MESSAGE_ELEMENT))) {
+    if (GST_MESSAGE_EOS == GST_MESSAGE_TYPE (msg)) {
+      gst_message_unref (msg);
+      break;
+    }
+
+    structure = gst_message_get_structure (msg);
+    if (gst_structure_has_name (structure, GSTD_PIPELINE_QUEUES_MESSAGE)) {
+      fail_unless (gst_structure_get_uint (structure, "threshold",
+              &threshold));
+      if (!g_strcmp0 ("high", gst_structure_get_string (structure, "level"))) {
+        fail_unless_equals_int (threshold, 75);
+        high = TRUE;
+      } else {
+        /* Low is only notified after high */
+        fail_unless (high);
+        fail_unless_equals_int (threshold, 25);
+        low = TRUE;
+      }
+    }
+    gst_message_unref (msg);
+  }
+  gst_object_unref (bus);
+
+  fail_unless (high);
+  fail_unless (low);
+
+  ret = gstd_object_update (node, "null");
+  fail_if (ret);
+  gst_object_unref (node);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_pipeline_queues_suite (void)
+{
+  Suite *suite = suite_create ("gstd_pipeline_queues");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_pipeline_queues);
+  tcase_add_test (tc, test_queue_watermarks);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_pipeline_queues);
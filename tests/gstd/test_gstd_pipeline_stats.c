@@ -0,0 +1,322 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <json-glib/json-glib.h>
+
+#include "gstd_pipeline.h"
+#include "gstd_session.h"
+#include "gstd_tracer.h"
+
+static void
+play_pipeline (GstdSession * session, GstElement * pipeline)
+{
+  GstdObject *node;
+  GstBus *bus;
+  GstMessage *msg;
+  GstdReturnCode ret;
+
+  ret = gstd_get_by_uri (session, "/pipelines/p0/state", &node);
+  fail_if (ret);
+  ret = gstd_object_update (node, "playing");
+  fail_if (ret);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND, GST_MESSAGE_EOS);
+  fail_if (NULL == msg);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  ret = gstd_object_update (node, "null");
+  fail_if (ret);
+  gst_object_unref (node);
+}
+
+static JsonObject *
+read_object (JsonParser * parser, GstdSession * session, const gchar * uri)
+{
+  GstdObject *node;
+  GstdReturnCode ret;
+  gchar *outstring;
+
+  ret = gstd_get_by_uri (session, uri, &node);
+  fail_if (ret);
+  fail_if (NULL == node);
+
+  ret = gstd_object_to_string (node, &outstring);
+  fail_if (ret);
+  fail_unless (json_parser_load_from_data (parser, outstring, -1, NULL));
+  g_free (outstring);
+  gst_object_unref (node);
+
+  return json_node_get_object (json_parser_get_root (parser));
+}
+
+/* Looks up the object with the given name in an array member */
+static JsonObject *
+find_named (JsonObject * root, const gchar * member, const gchar * name)
+{
+  JsonArray *array;
+  JsonObject *object;
+  guint i;
+
+  array = json_object_get_array_member (root, member);
+  for (i = 0; i < json_array_get_length (array); i++) {
+    object = json_array_get_object_element (array, i);
+    if (!g_strcmp0 (name, json_object_get_string_member (object, "name"))) {
+      return object;
+    }
+  }
+
+  return NULL;
+}
+
+static GstElement *
+run_pipeline (GstdSession * session, const gchar * description)
+{
+  GstdObject *node;
+  GstElement *pipeline;
+  GstdReturnCode ret;
+
+  ret = gstd_get_by_uri (session, "/pipelines", &node);
+  fail_if (ret);
+  ret = gstd_object_create (node, "p0", description);
+  fail_if (ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (session, "/pipelines/p0", &node);
+  fail_if (ret);
+  pipeline = gstd_pipeline_get_pipeline (GSTD_PIPELINE (node));
+  gst_object_unref (node);
+
+  play_pipeline (session, pipeline);
+
+  return pipeline;
+}
+
+GST_START_TEST (test_push_counters)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  GstElement *src;
+  GstPad *pad;
+  GstdPadStats stats;
+
+  pipeline = run_pipeline (test_session,
+      "fakesrc name=src num-buffers=10 sizetype=fixed sizemax=100 "
+      "! fakesink sync=false");
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  pad = gst_element_get_static_pad (src, "src");
+
+  fail_unless (gstd_tracer_get_pad_stats (pad, &stats));
+  fail_unless_equals_uint64 (stats.buffers, 10);
+  fail_unless_equals_uint64 (stats.bytes, 1000);
+  fail_unless_equals_uint64 (stats.dropped, 0);
+  fail_unless (GST_CLOCK_TIME_IS_VALID (stats.first));
+
+  gst_object_unref (pad);
+  gst_object_unref (src);
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_read_stats)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  JsonParser *parser;
+  JsonObject *root;
+  JsonObject *element;
+
+  pipeline = run_pipeline (test_session,
+      "fakesrc name=src num-buffers=10 sizetype=fixed sizemax=100 "
+      "! identity name=id ! fakesink name=sink sync=false");
+
+  parser = json_parser_new ();
+  root = read_object (parser, test_session, "/pipelines/p0/stats");
+
+  element = find_named (root, "elements", "src");
+  fail_if (NULL == element);
+  fail_unless_equals_int (json_object_get_int_member (element, "buffers"), 10);
+  fail_unless_equals_int (json_object_get_int_member (element, "bytes"),
+      1000);
+  fail_unless_equals_int (json_object_get_int_member (element, "dropped"), 0);
+  fail_unless (json_object_get_double_member (element,
+          "buffers-per-second") > 0);
+
+  element = find_named (root, "elements", "id");
+  fail_if (NULL == element);
+  fail_unless_equals_int (json_object_get_int_member (element, "buffers"), 10);
+
+  /* Sinks have no source pads to account data on */
+  element = find_named (root, "elements", "sink");
+  fail_if (NULL == element);
+  fail_unless_equals_int (json_object_get_int_member (element, "buffers"), 0);
+
+  g_object_unref (parser);
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_element_latency)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  GstElement *identity;
+  GstdObject *node;
+  GstdLatencyStats stats;
+  JsonParser *parser;
+  JsonObject *root;
+  GstdReturnCode ret;
+  gchar *outstring;
+
+  /* identity sleeps for a millisecond before pushing each buffer */
+  pipeline = run_pipeline (test_session,
+      "fakesrc num-buffers=10 ! identity name=id sleep-time=1000 "
+      "! fakesink sync=false");
+
+  identity = gst_bin_get_by_name (GST_BIN (pipeline), "id");
+  fail_if (gstd_tracer_get_latency (identity, &stats));
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p0/elements/id/latency",
+      &node);
+  fail_if (ret);
+  fail_if (NULL == node);
+
+  /* The first read starts the measurement */
+  ret = gstd_object_to_string (node, &outstring);
+  fail_if (ret);
+  g_free (outstring);
+
+  play_pipeline (test_session, pipeline);
+
+  fail_unless (gstd_tracer_get_latency (identity, &stats));
+  fail_unless_equals_uint64 (stats.count, 10);
+  fail_unless_equals_int (stats.samples, 10);
+  fail_unless (stats.min >= GST_MSECOND);
+  fail_unless (stats.min <= stats.avg);
+  fail_unless (stats.avg <= stats.p99);
+  fail_unless (stats.p99 <= stats.max);
+  gst_object_unref (identity);
+
+  parser = json_parser_new ();
+  root = read_object (parser, test_session,
+      "/pipelines/p0/elements/id/latency");
+  fail_unless_equals_int (json_object_get_int_member (root, "count"), 10);
+  fail_unless_equals_int (json_object_get_int_member (root, "samples"), 10);
+  fail_unless_equals_int64 (json_object_get_int_member (root, "p99"),
+      stats.p99);
+  fail_unless (json_object_has_member (json_object_get_object_member (root,
+              "pipeline"), "live"));
+  g_object_unref (parser);
+
+  gst_object_unref (node);
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pipeline_cpu)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  JsonParser *parser;
+  JsonObject *root;
+  JsonObject *element;
+
+  pipeline = run_pipeline (test_session,
+      "fakesrc name=src num-buffers=1000 ! fakesink sync=false");
+
+  parser = json_parser_new ();
+  root = read_object (parser, test_session, "/pipelines/p0/cpu");
+  fail_unless (json_object_get_double_member (root, "usage") >= 0);
+  element = find_named (root, "elements", "src");
+#ifdef __linux__
+  /* The source streaming thread was accounted before leaving */
+  fail_if (NULL == element);
+  fail_unless (json_object_get_int_member (element, "time") > 0);
+  fail_unless (json_object_get_int_member (root, "time") >=
+      json_object_get_int_member (element, "time"));
+#endif
+  g_object_unref (parser);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pipeline_memory)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstElement *pipeline;
+  JsonParser *parser;
+  JsonObject *root;
+  gsize current;
+  gsize peak;
+
+  pipeline = run_pipeline (test_session,
+      "fakesrc num-buffers=10 sizetype=fixed sizemax=4096 "
+      "! fakesink sync=false");
+
+  fail_unless (gstd_tracer_get_memory (pipeline, &current, &peak));
+  fail_unless (peak >= 4096);
+  fail_unless (current <= peak);
+
+  parser = json_parser_new ();
+  root = read_object (parser, test_session, "/pipelines/p0/memory");
+  fail_unless_equals_int64 (json_object_get_int_member (root, "peak"), peak);
+  fail_unless (json_object_get_int_member (root, "current") <=
+      json_object_get_int_member (root, "peak"));
+  g_object_unref (parser);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_pipeline_stats_suite (void)
+{
+  Suite *suite = suite_create ("gstd_pipeline_stats");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_push_counters);
+  tcase_add_test (tc, test_read_stats);
+  tcase_add_test (tc, test_element_latency);
+  tcase_add_test (tc, test_pipeline_cpu);
+  tcase_add_test (tc, test_pipeline_memory);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_pipeline_stats);
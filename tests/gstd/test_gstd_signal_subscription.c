@@ -0,0 +1,292 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_callback.h"
+#include "gstd_property.h"
+#include "gstd_signal.h"
+#include "gstd_signal_subscription.h"
+
+static GstElement *identity;
+static GstdSignal *handoff;
+static GstdObject *subscriptions;
+
+static void
+setup (void)
+{
+  identity = gst_element_factory_make ("identity", NULL);
+  handoff = g_object_new (GSTD_TYPE_SIGNAL, "name", "handoff", "target",
+      identity, NULL);
+
+  /* The list is only created once it is read */
+  fail_if (NULL != handoff->subscriptions);
+  fail_if (gstd_object_read (GSTD_OBJECT (handoff), "subscriptions",
+          &subscriptions));
+  fail_unless (GSTD_OBJECT (handoff->subscriptions) == subscriptions);
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (subscriptions);
+  g_object_unref (handoff);
+  gst_object_unref (identity);
+}
+
+static void
+emit_handoff (guint times)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+  guint i;
+
+  for (i = 0; i < times; i++) {
+    g_signal_emit_by_name (identity, "handoff", buffer);
+  }
+
+  gst_buffer_unref (buffer);
+}
+
+static GstdSignalSubscription *
+subscribe (const gchar * name, const gchar * description)
+{
+  GstdObject *subscription = NULL;
+  GstdReturnCode ret;
+
+  ret = gstd_object_create (subscriptions, name, description);
+  fail_if (ret);
+
+  ret = gstd_object_read (subscriptions, name,
+      &subscription);
+  fail_if (ret);
+  fail_if (NULL == subscription);
+
+  return GSTD_SIGNAL_SUBSCRIPTION (subscription);
+}
+
+GST_START_TEST (test_every_subscriber_receives)
+{
+  GstdSignalSubscription *first = subscribe ("first", NULL);
+  GstdSignalSubscription *second = subscribe ("second", NULL);
+  GstdObject *callback;
+  GstdReturnCode ret;
+
+  emit_handoff (2);
+
+  ret = gstd_object_read (GSTD_OBJECT (first), "callback", &callback);
+  fail_if (ret);
+  fail_unless (GSTD_IS_CALLBACK (callback));
+  g_object_unref (callback);
+
+  ret = gstd_object_read (GSTD_OBJECT (first), "callback", &callback);
+  fail_if (ret);
+  fail_unless (GSTD_IS_CALLBACK (callback));
+  g_object_unref (callback);
+
+  ret = gstd_object_read (GSTD_OBJECT (second), "callback", &callback);
+  fail_if (ret);
+  fail_unless (GSTD_IS_CALLBACK (callback));
+  g_object_unref (callback);
+
+  fail_unless_equals_uint64 (first->emitted, 2);
+  fail_unless_equals_uint64 (second->emitted, 2);
+
+  g_object_unref (first);
+  g_object_unref (second);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_overflow_drops_oldest)
+{
+  GstdSignalSubscription *subscription = subscribe ("bounded", "4");
+  GstdObject *callback;
+  guint64 queued;
+  guint64 dropped;
+
+  emit_handoff (10);
+
+  g_object_get (subscription, "queued", &queued, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (queued, 4);
+  fail_unless_equals_uint64 (dropped, 6);
+
+  /* Nothing left once the queue is drained */
+  g_object_set (subscription, "timeout", (gint64) 0, NULL);
+  while (queued--) {
+    gstd_object_read (GSTD_OBJECT (subscription), "callback", &callback);
+    fail_if (NULL == callback);
+    g_object_unref (callback);
+  }
+  gstd_object_read (GSTD_OBJECT (subscription), "callback", &callback);
+  fail_if (NULL != callback);
+
+  g_object_unref (subscription);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_count_only)
+{
+  GstdSignalSubscription *subscription = subscribe ("counter", "count-only");
+  GstdObject *callback;
+
+  emit_handoff (100);
+
+  gstd_object_read (GSTD_OBJECT (subscription), "callback", &callback);
+  fail_unless (GSTD_IS_CALLBACK (callback));
+  fail_unless_equals_uint64 (GSTD_CALLBACK (callback)->count, 100);
+  fail_unless_equals_int (GSTD_CALLBACK (callback)->n_params, 0);
+  fail_unless_equals_uint64 (subscription->dropped, 0);
+  g_object_unref (callback);
+
+  g_object_unref (subscription);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_unsubscribe)
+{
+  GstdSignalSubscription *subscription = subscribe ("gone", NULL);
+  GstdObject *callback;
+  GstdReturnCode ret;
+
+  ret = gstd_object_delete (subscriptions, "gone");
+  fail_if (ret);
+
+  /* A cancelled subscription doesn't block nor queue anymore */
+  emit_handoff (1);
+  gstd_object_read (GSTD_OBJECT (subscription), "callback", &callback);
+  fail_if (NULL != callback);
+
+  g_object_unref (subscription);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_bad_description)
+{
+  GstdReturnCode ret;
+
+  ret = gstd_object_create (subscriptions, "bad",
+      "lots");
+  fail_unless_equals_int (ret, GSTD_BAD_VALUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_property_latest_value_throttled)
+{
+  GstdProperty *silent;
+  GstdObject *subscription = NULL;
+  GstdObject *value;
+  GstdReturnCode ret;
+
+  silent = g_object_new (GSTD_TYPE_PROPERTY, "name", "silent", "target",
+      identity, "pspec", g_object_class_find_property (G_OBJECT_GET_CLASS
+          (identity), "silent"), NULL);
+
+  ret = gstd_object_read (GSTD_OBJECT (silent), "subscriptions",
+      &subscription);
+  fail_if (ret);
+
+  ret = gstd_object_create (subscription, "watch", "interval=60000000");
+  fail_if (ret);
+  g_object_unref (subscription);
+
+  ret = gstd_object_read (GSTD_OBJECT (silent->subscriptions), "watch",
+      &subscription);
+  fail_if (ret);
+  g_object_set (subscription, "timeout", (gint64) 0, NULL);
+
+  /* Several changes are coalesced into a single delivery */
+  g_object_set (identity, "silent", FALSE, NULL);
+  g_object_set (identity, "silent", TRUE, NULL);
+
+  gstd_object_read (subscription, "value", &value);
+  fail_unless (GSTD_IS_PROPERTY (value));
+  g_object_unref (value);
+
+  /* Further changes are held until the minimum interval expires */
+  g_object_set (identity, "silent", FALSE, NULL);
+  gstd_object_read (subscription, "value", &value);
+  fail_if (NULL != value);
+
+  g_object_unref (subscription);
+  g_object_unref (silent);
+}
+
+GST_END_TEST;
+
+static gpointer
+cancel_later (gpointer data)
+{
+  g_usleep (G_USEC_PER_SEC / 20);
+  g_cancellable_cancel (G_CANCELLABLE (data));
+
+  return NULL;
+}
+
+GST_START_TEST (test_cancelled_request)
+{
+  GstdSignalSubscription *subscription = subscribe ("hangup", NULL);
+  GCancellable *cancellable = g_cancellable_new ();
+  GstdObject *callback;
+  GThread *thread;
+
+  /* The default timeout blocks forever, only cancelling releases it */
+  thread = g_thread_new ("canceller", cancel_later, cancellable);
+
+  g_cancellable_push_current (cancellable);
+  gstd_object_read (GSTD_OBJECT (subscription), "callback", &callback);
+  g_cancellable_pop_current (cancellable);
+
+  fail_if (NULL != callback);
+
+  g_thread_join (thread);
+  g_object_unref (cancellable);
+  g_object_unref (subscription);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_signal_subscription_suite (void)
+{
+  Suite *suite = suite_create ("gstd_signal_subscription");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_every_subscriber_receives);
+  tcase_add_test (tc, test_overflow_drops_oldest);
+  tcase_add_test (tc, test_count_only);
+  tcase_add_test (tc, test_unsubscribe);
+  tcase_add_test (tc, test_bad_description);
+  tcase_add_test (tc, test_property_latest_value_throttled);
+  tcase_add_test (tc, test_cancelled_request);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_signal_subscription);
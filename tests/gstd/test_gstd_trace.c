@@ -0,0 +1,137 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <glib/gstdio.h>
+#include <gst/check/gstcheck.h>
+#include <json-glib/json-glib.h>
+#include <unistd.h>
+
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+/* Returns the first complete event with the given name */
+static JsonObject *
+find_span (JsonArray * events, const gchar * name)
+{
+  JsonObject *event;
+  guint i;
+
+  for (i = 0; i < json_array_get_length (events); i++) {
+    event = json_array_get_object_element (events, i);
+    if (!g_strcmp0 (name, json_object_get_string_member (event, "name"))
+        && !g_strcmp0 ("X", json_object_get_string_member (event, "ph"))) {
+      return event;
+    }
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_trace)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdReturnCode ret;
+  JsonParser *parser;
+  JsonArray *events;
+  JsonObject *command;
+  JsonObject *resolve;
+  gchar *response = NULL;
+  gchar *filename;
+  gchar *stop;
+  gint fd;
+
+  fd = g_file_open_tmp ("gstd-trace-XXXXXX.json", &filename, NULL);
+  fail_if (fd < 0);
+  close (fd);
+
+  /* An empty action is not taken as a start */
+  ret = gstd_parser_parse_cmd (test_session, "trace ", &response);
+  fail_unless_equals_int (ret, GSTD_BAD_COMMAND);
+  g_free (response);
+  response = NULL;
+
+  /* Nothing to write before the trace starts */
+  ret = gstd_parser_parse_cmd (test_session, "trace stop", &response);
+  fail_if (GSTD_EOK == ret);
+  g_free (response);
+  response = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "trace start", &response);
+  fail_if (ret);
+  g_free (response);
+  response = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "list_pipelines", &response);
+  fail_if (ret);
+  g_free (response);
+  response = NULL;
+
+  stop = g_strdup_printf ("trace stop %s", filename);
+  ret = gstd_parser_parse_cmd (test_session, stop, &response);
+  fail_if (ret);
+  g_free (response);
+  g_free (stop);
+
+  parser = json_parser_new ();
+  fail_unless (json_parser_load_from_file (parser, filename, NULL));
+  events =
+      json_object_get_array_member (json_node_get_object
+      (json_parser_get_root (parser)), "traceEvents");
+  fail_if (NULL == events);
+
+  command = find_span (events, "list_pipelines");
+  fail_if (NULL == command);
+  resolve = find_span (events, "resolve");
+  fail_if (NULL == resolve);
+
+  /* The lookup happens within the command, in the same thread */
+  fail_unless_equals_int (json_object_get_int_member (resolve, "tid"),
+      json_object_get_int_member (command, "tid"));
+  fail_unless (json_object_get_int_member (resolve, "ts") >=
+      json_object_get_int_member (command, "ts"));
+  fail_unless (json_object_get_int_member (resolve, "dur") >= 0);
+  fail_unless (json_object_get_int_member (resolve, "dur") <=
+      json_object_get_int_member (command, "dur"));
+
+  g_object_unref (parser);
+  g_unlink (filename);
+  g_free (filename);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+static Suite *
+gstd_trace_suite (void)
+{
+  Suite *suite = suite_create ("gstd_trace");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_test (tc, test_trace);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_trace);
@@ -0,0 +1,349 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <glib/gstdio.h>
+#include <gst/check/gstcheck.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstd.h"
+#include "libgstc.h"
+
+/* Latency budgets for a single request, in microseconds. They hold on
+ * a stock CI runner with room to spare, tighten them on a quiet
+ * machine to catch smaller regressions:
+ *   GSTD_LATENCY_SET_P99=200 GSTD_LATENCY_GET_P99=200 ./test_libgstc_latency
+ */
+#define LATENCY_DEFAULT_SET_P99 1000
+#define LATENCY_DEFAULT_GET_P99 1000
+#define LATENCY_DEFAULT_ITERATIONS 2000
+#define LATENCY_WARMUP 200
+
+#define LATENCY_ADDRESS "127.0.0.1"
+#define LATENCY_UNIX_BASE_NAME "gstd_unix_socket"
+#define LATENCY_TIMEOUT 5000    /* milliseconds */
+#define LATENCY_MAX_RESPONSE 65536
+
+#define PIPELINE_NAME "p0"
+#define ELEMENT_NAME "sink"
+#define PROPERTY_NAME "silent"
+#define PROPERTY_URI \
+  "/pipelines/" PIPELINE_NAME "/elements/" ELEMENT_NAME "/properties/" \
+  PROPERTY_NAME
+
+typedef gboolean (*LatencyRequest) (guint iteration);
+
+/* Test Fixture */
+static GstD *gstd;
+static GMainLoop *loop;
+static GThread *loop_thread;
+static gchar *tmpdir;
+static gchar *unix_base;
+static guint tcp_port;
+static GstClient *client;
+static GSocketConnection *unix_connection;
+
+static gint
+env_int (const gchar * name, gint fallback)
+{
+  const gchar *value = g_getenv (name);
+
+  return value ? atoi (value) : fallback;
+}
+
+/* Lets the kernel pick a port nothing else is listening on */
+static guint
+find_free_port (void)
+{
+  GSocket *socket;
+  GSocketAddress *address;
+  GSocketAddress *local;
+  guint port;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, NULL);
+  fail_if (NULL == socket);
+
+  address = g_inet_socket_address_new_from_string (LATENCY_ADDRESS, 0);
+  fail_unless (g_socket_bind (socket, address, TRUE, NULL));
+  local = g_socket_get_local_address (socket, NULL);
+  fail_if (NULL == local);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (local));
+
+  g_object_unref (local);
+  g_object_unref (address);
+  g_object_unref (socket);
+
+  return port;
+}
+
+static void
+setup (void)
+{
+  GOptionContext *context;
+  GSocketClient *socket_client;
+  GSocketAddress *address;
+  GError *error = NULL;
+  gchar **args;
+  gchar *path;
+
+  tmpdir = g_dir_make_tmp ("gstd-latency-XXXXXX", NULL);
+  fail_if (NULL == tmpdir);
+  unix_base = g_build_filename (tmpdir, LATENCY_UNIX_BASE_NAME, NULL);
+  tcp_port = find_free_port ();
+
+  /* Configure the daemon just like its command line would */
+  args = g_new0 (gchar *, 7);
+  args[0] = g_strdup ("test_libgstc_latency");
+  args[1] = g_strdup ("--enable-tcp-protocol");
+  args[2] = g_strdup ("--tcp-address=" LATENCY_ADDRESS);
+  args[3] = g_strdup_printf ("--tcp-base-port=%u", tcp_port);
+  args[4] = g_strdup ("--enable-unix-protocol");
+  args[5] = g_strdup_printf ("--unix-base-path=%s", unix_base);
+
+  fail_if (gstd_new (&gstd, 0, NULL));
+  context = g_option_context_new (NULL);
+  gstd_context_add_group (gstd, context);
+  fail_unless (g_option_context_parse_strv (context, &args, &error));
+  g_option_context_free (context);
+  g_strfreev (args);
+
+  /* The daemon accepts connections from the default main context */
+  loop = g_main_loop_new (NULL, FALSE);
+  loop_thread = g_thread_new ("gstd-main-loop", (GThreadFunc) g_main_loop_run,
+      loop);
+
+  fail_unless (gstd_start (gstd));
+  fail_if (gstd_create (gstd, "/pipelines", PIPELINE_NAME,
+          "fakesrc ! fakesink name=" ELEMENT_NAME));
+
+  fail_if (gstc_client_new (LATENCY_ADDRESS, tcp_port, LATENCY_TIMEOUT, 1,
+          &client));
+
+  /* libgstc only speaks TCP, so the unix socket is driven directly */
+  path = g_strdup_printf ("%s_0", unix_base);
+  address = g_unix_socket_address_new (path);
+  socket_client = g_socket_client_new ();
+  unix_connection = g_socket_client_connect (socket_client,
+      G_SOCKET_CONNECTABLE (address), NULL, &error);
+  fail_if (NULL == unix_connection);
+
+  g_object_unref (socket_client);
+  g_object_unref (address);
+  g_free (path);
+}
+
+static void
+teardown (void)
+{
+  gchar *path;
+
+  g_clear_object (&unix_connection);
+  gstc_client_free (client);
+  gstd_free (gstd);
+
+  g_main_loop_quit (loop);
+  g_thread_join (loop_thread);
+  g_main_loop_unref (loop);
+
+  path = g_strdup_printf ("%s_0", unix_base);
+  g_unlink (path);
+  g_free (path);
+  g_rmdir (tmpdir);
+  g_free (unix_base);
+  g_free (tmpdir);
+}
+
+/* Sends a request the way libgstc would and waits for the whole
+ * response, which the daemon terminates with a NUL */
+static gboolean
+unix_send (const gchar * request)
+{
+  GInputStream *istream;
+  GOutputStream *ostream;
+  gchar buffer[LATENCY_MAX_RESPONSE];
+  gsize received = 0;
+  gssize read;
+
+  istream = g_io_stream_get_input_stream (G_IO_STREAM (unix_connection));
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (unix_connection));
+
+  if (!g_output_stream_write_all (ostream, request, strlen (request), NULL,
+          NULL, NULL)) {
+    return FALSE;
+  }
+
+  do {
+    read = g_input_stream_read (istream, buffer + received,
+        sizeof (buffer) - received, NULL, NULL);
+    if (read <= 0) {
+      return FALSE;
+    }
+    received += read;
+  } while (buffer[received - 1] != '\0' && received < sizeof (buffer));
+
+  return buffer[received - 1] == '\0'
+      && NULL != strstr (buffer, "\"code\" : 0,");
+}
+
+static gboolean
+tcp_set (guint iteration)
+{
+  return GSTC_OK == gstc_element_set (client, PIPELINE_NAME, ELEMENT_NAME,
+      PROPERTY_NAME, "%s", iteration % 2 ? "true" : "false");
+}
+
+static gboolean
+tcp_get (guint iteration)
+{
+  gchar value[16];
+
+  return GSTC_OK == gstc_element_get (client, PIPELINE_NAME, ELEMENT_NAME,
+      PROPERTY_NAME, "%15s", value);
+}
+
+static gboolean
+unix_set (guint iteration)
+{
+  return unix_send (iteration % 2 ? "update " PROPERTY_URI " true" :
+      "update " PROPERTY_URI " false");
+}
+
+static gboolean
+unix_get (guint iteration)
+{
+  return unix_send ("read " PROPERTY_URI);
+}
+
+static gint
+compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* Nearest rank percentile over a sorted array */
+static gint64
+percentile (GArray * sorted, gdouble percentile)
+{
+  guint rank;
+
+  rank = (guint) (percentile * sorted->len + 0.999999);
+  rank = CLAMP (rank, 1, sorted->len);
+
+  return g_array_index (sorted, gint64, rank - 1);
+}
+
+static void
+assert_latency (const gchar * name, LatencyRequest request,
+    const gchar * budget_env, gint budget_default)
+{
+  GArray *latencies;
+  gint iterations;
+  gint budget;
+  gint64 start;
+  gint64 latency;
+  gint64 p50;
+  gint64 p99;
+  gint i;
+
+  iterations = env_int ("GSTD_LATENCY_ITERATIONS", LATENCY_DEFAULT_ITERATIONS);
+  budget = env_int (budget_env, budget_default);
+  fail_unless (iterations > 0 && budget > 0);
+
+  /* Let the daemon threads and the allocator settle */
+  for (i = 0; i < LATENCY_WARMUP; i++) {
+    fail_unless (request (i), "%s request %d failed", name, i);
+  }
+
+  latencies = g_array_sized_new (FALSE, FALSE, sizeof (gint64), iterations);
+  for (i = 0; i < iterations; i++) {
+    start = g_get_monotonic_time ();
+    fail_unless (request (i), "%s request %d failed", name, i);
+    latency = g_get_monotonic_time () - start;
+    g_array_append_val (latencies, latency);
+  }
+
+  g_array_sort (latencies, compare_latency);
+  p50 = percentile (latencies, 0.50);
+  p99 = percentile (latencies, 0.99);
+  g_array_free (latencies, TRUE);
+
+  g_print ("%s: p50 %" G_GINT64_FORMAT " us, p99 %" G_GINT64_FORMAT
+      " us, budget %d us\n", name, p50, p99, budget);
+
+  fail_unless (p99 <= budget, "%s p99 of %" G_GINT64_FORMAT
+      " us exceeds the %d us budget (%s)", name, p99, budget, budget_env);
+}
+
+GST_START_TEST (test_tcp_element_set_latency)
+{
+  assert_latency ("tcp set", tcp_set, "GSTD_LATENCY_SET_P99",
+      LATENCY_DEFAULT_SET_P99);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_tcp_element_get_latency)
+{
+  assert_latency ("tcp get", tcp_get, "GSTD_LATENCY_GET_P99",
+      LATENCY_DEFAULT_GET_P99);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_unix_element_set_latency)
+{
+  assert_latency ("unix set", unix_set, "GSTD_LATENCY_SET_P99",
+      LATENCY_DEFAULT_SET_P99);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_unix_element_get_latency)
+{
+  assert_latency ("unix get", unix_get, "GSTD_LATENCY_GET_P99",
+      LATENCY_DEFAULT_GET_P99);
+}
+
+GST_END_TEST;
+
+static Suite *
+libgstc_latency_suite (void)
+{
+  Suite *suite = suite_create ("libgstc_latency");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_tcp_element_set_latency);
+  tcase_add_test (tc, test_tcp_element_get_latency);
+  tcase_add_test (tc, test_unix_element_set_latency);
+  tcase_add_test (tc, test_unix_element_get_latency);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (libgstc_latency);